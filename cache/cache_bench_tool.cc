@@ -12,6 +12,10 @@
 #include <set>
 #include <sstream>
 
+#ifdef NUMA
+#include <numa.h>
+#endif
+
 #include "cache/cache_key.h"
 #include "cache/sharded_cache.h"
 #include "db/db_impl/db_impl.h"
@@ -19,6 +23,7 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
@@ -52,6 +57,15 @@ DEFINE_int32(
     eviction_effort_cap,
     ROCKSDB_NAMESPACE::HyperClockCacheOptions(1, 1).eviction_effort_cap,
     "HyperClockCacheOptions::eviction_effort_cap");
+DEFINE_bool(frequency_admission, false,
+            "HyperClockCacheOptions::frequency_admission");
+DEFINE_bool(lru_batched_promotion, false, "LRUCacheOptions::batched_promotion");
+DEFINE_bool(numa_aware, false, "ShardedCacheOptions::numa_aware");
+DEFINE_uint32(numa_replication_threshold, 0,
+              "ShardedCacheOptions::numa_replication_threshold");
+DEFINE_bool(pin_threads, false,
+            "Run each thread on the CPUs of one NUMA node, spreading the "
+            "threads evenly over the nodes. Requires NUMA support.");
 
 DEFINE_double(resident_ratio, 0.25,
               "Ratio of keys fitting in cache to keyspace.");
@@ -119,6 +133,18 @@ DEFINE_string(secondary_cache_uri, "",
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_string(flash_cache_path, "",
+              "If not empty, use a three-tier cache (see NewTieredCache) of "
+              "the cache_type cache, a compressed secondary cache and a "
+              "FlashSecondaryCache with its segment files in this directory");
+
+DEFINE_uint64(flash_cache_size, 4 * GiB,
+              "(-flash_cache_path) FlashSecondaryCacheOptions::capacity");
+
+DEFINE_double(compressed_secondary_ratio, 0.2,
+              "(-flash_cache_path) Portion of cache_size used by the "
+              "compressed secondary cache");
+
 DEFINE_bool(use_jemalloc_no_dump_allocator, false,
             "Whether to use JemallocNoDumpAllocator");
 
@@ -346,8 +372,31 @@ void ConfigureSecondaryCache(ShardedCacheOptions& opts) {
   }
 }
 
+// Returns a three-tier cache with the given primary cache.
+std::shared_ptr<Cache> NewThreeTierCache(ShardedCacheOptions* opts,
+                                         PrimaryCacheType cache_type) {
+  FlashSecondaryCacheOptions flash_opts;
+  flash_opts.path = FLAGS_flash_cache_path;
+  flash_opts.capacity = FLAGS_flash_cache_size;
+  std::shared_ptr<SecondaryCache> flash_cache;
+  Status s = NewFlashSecondaryCache(flash_opts, &flash_cache);
+  if (!s.ok()) {
+    fprintf(stderr, "Failed to create the flash cache: %s\n",
+            s.ToString().c_str());
+    exit(1);
+  }
+  TieredCacheOptions tiered_opts;
+  tiered_opts.cache_opts = opts;
+  tiered_opts.cache_type = cache_type;
+  tiered_opts.adm_policy = TieredAdmissionPolicy::kAdmPolicyThreeQueue;
+  tiered_opts.total_capacity = FLAGS_cache_size;
+  tiered_opts.compressed_secondary_ratio = FLAGS_compressed_secondary_ratio;
+  tiered_opts.nvm_sec_cache = flash_cache;
+  return NewTieredCache(tiered_opts);
+}
+
 ShardedCacheBase* AsShardedCache(Cache* c) {
-  if (!FLAGS_secondary_cache_uri.empty()) {
+  if (!FLAGS_secondary_cache_uri.empty() || !FLAGS_flash_cache_path.empty()) {
     c = static_cast_with_check<CacheWrapper>(c)->GetTarget().get();
   }
   return static_cast_with_check<ShardedCacheBase>(c);
@@ -395,6 +444,9 @@ class CacheBench {
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
       opts.eviction_effort_cap = FLAGS_eviction_effort_cap;
+      opts.frequency_admission = FLAGS_frequency_admission;
+      opts.numa_aware = FLAGS_numa_aware;
+      opts.numa_replication_threshold = FLAGS_numa_replication_threshold;
       if (FLAGS_cache_type == "fixed_hyper_clock_cache" ||
           FLAGS_cache_type == "hyper_clock_cache") {
         opts.estimated_entry_charge = FLAGS_value_bytes_estimate > 0
@@ -408,16 +460,27 @@ class CacheBench {
         fprintf(stderr, "Cache type not supported.\n");
         exit(1);
       }
-      ConfigureSecondaryCache(opts);
-      cache_ = opts.MakeSharedCache();
+      if (!FLAGS_flash_cache_path.empty()) {
+        cache_ = NewThreeTierCache(&opts, PrimaryCacheType::kCacheTypeHCC);
+      } else {
+        ConfigureSecondaryCache(opts);
+        cache_ = opts.MakeSharedCache();
+      }
     } else if (FLAGS_cache_type == "lru_cache") {
       LRUCacheOptions opts(FLAGS_cache_size, FLAGS_num_shard_bits,
                            false /* strict_capacity_limit */,
                            0.5 /* high_pri_pool_ratio */);
       opts.hash_seed = BitwiseAnd(FLAGS_seed, INT32_MAX);
       opts.memory_allocator = allocator;
-      ConfigureSecondaryCache(opts);
-      cache_ = NewLRUCache(opts);
+      opts.numa_aware = FLAGS_numa_aware;
+      opts.numa_replication_threshold = FLAGS_numa_replication_threshold;
+      opts.batched_promotion = FLAGS_lru_batched_promotion;
+      if (!FLAGS_flash_cache_path.empty()) {
+        cache_ = NewThreeTierCache(&opts, PrimaryCacheType::kCacheTypeLRU);
+      } else {
+        ConfigureSecondaryCache(opts);
+        cache_ = NewLRUCache(opts);
+      }
     } else {
       fprintf(stderr, "Cache type not supported.\n");
       exit(1);
@@ -426,6 +489,21 @@ class CacheBench {
 
   ~CacheBench() = default;
 
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper, Cache::Handle** handle) {
+    if (FLAGS_flash_cache_path.empty()) {
+      return cache_->Insert(key, value, helper, FLAGS_value_bytes, handle);
+    }
+    // The three-tier cache fills the flash tier with the compressed form of
+    // the blocks inserted. The values are random, so pass them as is,
+    // labeled as compressed for the compressed secondary cache to take them
+    // on their way up, as CreateFn ignores the compression type.
+    return cache_->Insert(
+        key, value, helper, FLAGS_value_bytes, handle, Cache::Priority::LOW,
+        Slice(static_cast<char*>(value), FLAGS_value_bytes),
+        kLZ4Compression);
+  }
+
   void PopulateCache() {
     Random64 rnd(FLAGS_seed);
     KeyGen keygen;
@@ -448,9 +526,8 @@ class CacheBench {
       }
       keys_since_last_not_found = 0;
 
-      Status s =
-          cache_->Insert(key, createValue(rnd, cache_->memory_allocator()),
-                         &helper1, FLAGS_value_bytes);
+      Status s = Insert(key, createValue(rnd, cache_->memory_allocator()),
+                        &helper1, /*handle=*/nullptr);
       assert(s.ok());
 
       handle = cache_->Lookup(key);
@@ -538,6 +615,15 @@ class CacheBench {
 
     printf("Final pinned count: %zu\n", shared.GetPinnedCount());
 
+    ShardedCacheBase* sharded = AsShardedCache(cache_.get());
+    if (sharded->GetNumNumaNodes() > 1) {
+      ShardedCacheBase::NumaStats numa_stats = sharded->GetNumaStats();
+      printf("NUMA lookups: %" PRIu64 " local hits, %" PRIu64
+             " remote hits, %" PRIu64 " misses, %" PRIu64 " replications\n",
+             numa_stats.local_hits, numa_stats.remote_hits, numa_stats.misses,
+             numa_stats.replications);
+    }
+
     if (FLAGS_histograms) {
       printf("\nOperation latency (ns):\n");
       HistogramImpl combined;
@@ -657,6 +743,9 @@ class CacheBench {
 
   static void ThreadBody(ThreadState* thread) {
     SharedState* shared = thread->shared;
+    if (FLAGS_pin_threads) {
+      PinToNumaNode(thread->tid);
+    }
 
     {
       MutexLock l(shared->GetMutex());
@@ -679,6 +768,21 @@ class CacheBench {
     }
   }
 
+  static void PinToNumaNode(uint32_t tid) {
+#ifdef NUMA
+    if (numa_available() >= 0) {
+      int node = static_cast<int>(tid) % numa_num_configured_nodes();
+      if (numa_run_on_node(node) == 0) {
+        numa_set_localalloc();
+        return;
+      }
+    }
+#else
+    (void)tid;
+#endif
+    fprintf(stderr, "Failed to pin thread to a NUMA node\n");
+  }
+
   void OperateCache(ThreadState* thread) {
     // To use looked-up values
     uint64_t result = 0;
@@ -734,22 +838,22 @@ class CacheBench {
         } else {
           ++lookup_misses;
           // do insert
-          Status s = cache_->Insert(
-              key, createValue(thread->rnd, cache_->memory_allocator()),
-              &helper2, FLAGS_value_bytes, &pinned.emplace_back());
+          Status s =
+              Insert(key, createValue(thread->rnd, cache_->memory_allocator()),
+                     &helper2, &pinned.emplace_back());
           assert(s.ok());
         }
       } else if (random_op < insert_threshold_) {
         // do insert
-        Status s = cache_->Insert(
-            key, createValue(thread->rnd, cache_->memory_allocator()), &helper3,
-            FLAGS_value_bytes, &pinned.emplace_back());
+        Status s =
+            Insert(key, createValue(thread->rnd, cache_->memory_allocator()),
+                   &helper3, &pinned.emplace_back());
         assert(s.ok());
       } else if (random_op < blind_insert_threshold_) {
         // insert without keeping a handle
-        Status s = cache_->Insert(
-            key, createValue(thread->rnd, cache_->memory_allocator()), &helper3,
-            FLAGS_value_bytes);
+        Status s =
+            Insert(key, createValue(thread->rnd, cache_->memory_allocator()),
+                   &helper3, /*handle=*/nullptr);
         assert(s.ok());
       } else if (random_op < lookup_threshold_) {
         // do lookup
@@ -821,6 +925,14 @@ class CacheBench {
     printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
     printf("Cache size          : %s\n",
            BytesToHumanString(FLAGS_cache_size).c_str());
+    if (!FLAGS_flash_cache_path.empty()) {
+      printf("Compressed ratio    : %g\n", FLAGS_compressed_secondary_ratio);
+      printf("Flash cache size    : %s\n",
+             BytesToHumanString(FLAGS_flash_cache_size).c_str());
+      printf("Flash cache path    : %s\n", FLAGS_flash_cache_path.c_str());
+    }
+    printf("NUMA nodes          : %u\n",
+           AsShardedCache(cache_.get())->GetNumNumaNodes());
     printf("Num shard bits      : %d\n",
            AsShardedCache(cache_.get())->GetNumShardBits());
     printf("Max key             : %" PRIu64 "\n", max_key_);
@@ -147,7 +147,17 @@ inline bool ClockUpdate(ClockHandle& h, BaseClockTable::EvictionData* data,
     return false;
   }
   // Otherwise, remove entry (either unreferenced invisible or
-  // unreferenced and expired visible).
+  // unreferenced and expired visible), unless frequency admission keeps a
+  // visible one.
+  if (data->admission_sketch != nullptr &&
+      (meta >> ClockHandle::kStateShift == ClockHandle::kStateVisible) &&
+      data->admission_sketch->Estimate(h.hashed_key) >=
+          data->admission_freq) {
+    // The victim is estimated at least as popular as the new entry, so the
+    // new entry is rejected instead (TinyLFU).
+    data->admission_rejected = true;
+    return false;
+  }
   if (h.meta.CasStrong(meta, (uint64_t{ClockHandle::kStateConstruction}
                               << ClockHandle::kStateShift) |
                                  (meta & ClockHandle::kHitBitMask))) {
@@ -375,6 +385,68 @@ uint32_t SanitizeEncodeEecAndScl(int eviction_effort_cap,
 
 }  // namespace
 
+ClockFrequencySketch::ClockFrequencySketch(size_t num_slots)
+    // At least one counter per slot in each row, rounded up to a power of
+    // two, with a minimum so that tiny tables still get a usable sketch.
+    : row_bits_(std::min(
+          30, std::max(8, FloorLog2((std::max(num_slots, size_t{1}) << 1) -
+                                    1)))),
+      words_(new RelaxedAtomic<uint64_t>[(size_t{kNumRows} << row_bits_) /
+                                         16]) {}
+
+inline size_t ClockFrequencySketch::CounterIndex(
+    const UniqueId64x2& hashed_key, int row) const {
+  // Multiplicative hashing with a different odd multiplier for each row.
+  // (The upper bits of hashed_key[0] are mostly the same within a shard.)
+  static constexpr uint64_t kMultipliers[kNumRows] = {
+      0x9E3779B97F4A7C15U, 0xC2B2AE3D27D4EB4FU, 0x165667B19E3779F9U,
+      0x85EBCA77C2B2AE63U};
+  uint64_t h = (hashed_key[0] ^ hashed_key[1]) * kMultipliers[row];
+  return (size_t{static_cast<unsigned>(row)} << row_bits_) +
+         static_cast<size_t>(h >> (64 - row_bits_));
+}
+
+void ClockFrequencySketch::Increment(const UniqueId64x2& hashed_key) {
+  for (int row = 0; row < kNumRows; ++row) {
+    size_t index = CounterIndex(hashed_key, row);
+    RelaxedAtomic<uint64_t>& word = words_[index / 16];
+    int shift = static_cast<int>(index % 16) * 4;
+    uint64_t old_word = word.LoadRelaxed();
+    do {
+      if (((old_word >> shift) & kCounterMask) == kCounterMask) {
+        // Saturated
+        break;
+      }
+    } while (!word.CasWeakRelaxed(old_word, old_word + (uint64_t{1} << shift)));
+  }
+}
+
+uint32_t ClockFrequencySketch::Estimate(const UniqueId64x2& hashed_key) const {
+  uint64_t min_count = kCounterMask;
+  for (int row = 0; row < kNumRows; ++row) {
+    size_t index = CounterIndex(hashed_key, row);
+    int shift = static_cast<int>(index % 16) * 4;
+    min_count = std::min(
+        min_count, (words_[index / 16].LoadRelaxed() >> shift) & kCounterMask);
+  }
+  return static_cast<uint32_t>(min_count);
+}
+
+void ClockFrequencySketch::MaybeAge() {
+  size_t insertions = insertions_.LoadRelaxed();
+  if (insertions < (size_t{1} << row_bits_) / 2) {
+    return;
+  }
+  // NOTE: only one thread at a time starts a sweep of the table
+  insertions_.FetchSubRelaxed(insertions);
+  size_t num_words = (size_t{kNumRows} << row_bits_) / 16;
+  for (size_t i = 0; i < num_words; ++i) {
+    // Halve each 4-bit counter (racing increments might be lost)
+    words_[i].StoreRelaxed((words_[i].LoadRelaxed() >> 1) &
+                           uint64_t{0x7777777777777777});
+  }
+}
+
 void ClockHandleBasicData::FreeData(MemoryAllocator* allocator) const {
   if (helper->del_cb) {
     helper->del_cb(value, allocator);
@@ -427,7 +499,8 @@ typename Table::HandleImpl* BaseClockTable::CreateStandalone(
     // Case strict_capacity_limit == false
     bool success = ChargeUsageMaybeEvictNonStrict<Table>(
         total_charge, capacity,
-        /*need_evict_for_occupancy=*/false, eec_and_scl, state);
+        /*need_evict_for_occupancy=*/false, eec_and_scl,
+        /*admission_key=*/nullptr, state);
     if (!success) {
       // Force the issue
       usage_.FetchAddRelaxed(total_charge);
@@ -496,7 +569,8 @@ Status BaseClockTable::ChargeUsageMaybeEvictStrict(
 template <class Table>
 inline bool BaseClockTable::ChargeUsageMaybeEvictNonStrict(
     size_t total_charge, size_t capacity, bool need_evict_for_occupancy,
-    uint32_t eviction_effort_cap, typename Table::InsertState& state) {
+    uint32_t eviction_effort_cap, const UniqueId64x2* admission_key,
+    typename Table::InsertState& state) {
   // For simplicity, we consider that either the cache can accept the insert
   // with no evictions, or we must evict enough to make (at least) enough
   // space. It could lead to unnecessary failures or excessive evictions in
@@ -532,8 +606,20 @@ inline bool BaseClockTable::ChargeUsageMaybeEvictNonStrict(
   }
   EvictionData data;
   if (need_evict_charge > 0) {
+    if (frequency_sketch_ != nullptr && admission_key != nullptr) {
+      data.admission_sketch = frequency_sketch_.get();
+      data.admission_freq = frequency_sketch_->Estimate(*admission_key);
+    }
     static_cast<Table*>(this)->Evict(need_evict_charge, state, &data,
                                      eviction_effort_cap);
+    if (UNLIKELY(data.admission_rejected)) {
+      // Anything evicted before finding a more popular victim stays evicted,
+      // but the new entry is not charged.
+      occupancy_.FetchSub(data.freed_count);
+      usage_.FetchSubRelaxed(data.freed_charge);
+      admission_rejected_count_.FetchAddRelaxed(1);
+      return false;
+    }
     // Deal with potential occupancy deficit
     if (UNLIKELY(need_evict_for_occupancy) && data.freed_count == 0) {
       assert(data.freed_charge == 0);
@@ -589,6 +675,10 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
   typename Table::InsertState state;
   derived.StartInsert(state);
 
+  if (UNLIKELY(frequency_sketch_ != nullptr)) {
+    frequency_sketch_->IncrementForInsert(proto.hashed_key);
+  }
+
   // Do we have the available occupancy? Optimistically assume we do
   // and deal with it if we don't.
   size_t old_occupancy = occupancy_.FetchAdd(1);
@@ -614,7 +704,8 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
   } else {
     // Case strict_capacity_limit == false
     bool success = ChargeUsageMaybeEvictNonStrict<Table>(
-        total_charge, capacity, need_evict_for_occupancy, eec_and_scl, state);
+        total_charge, capacity, need_evict_for_occupancy, eec_and_scl,
+        &proto.hashed_key, state);
     if (!success) {
       // Revert occupancy
       occupancy_.FetchSubRelaxed(1);
@@ -734,6 +825,9 @@ FixedHyperClockTable::FixedHyperClockTable(
       CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
     usage_.FetchAddRelaxed(size_t{GetTableSize()} * sizeof(HandleImpl));
   }
+  if (opts.frequency_admission) {
+    frequency_sketch_.reset(new ClockFrequencySketch(GetTableSize()));
+  }
 
   static_assert(sizeof(HandleImpl) == 64U,
                 "Expecting size / alignment with common cache line size");
@@ -1133,6 +1227,12 @@ inline void FixedHyperClockTable::Evict(size_t requested_charge, InsertState&,
       old_clock_pointer + (ClockHandle::kMaxCountdown << length_bits_);
 
   for (;;) {
+    if (UNLIKELY(frequency_sketch_ != nullptr) &&
+        BottomNBits(old_clock_pointer, length_bits_) < step_size) {
+      // Starting another sweep of the table
+      frequency_sketch_->MaybeAge();
+    }
+
     for (size_t i = 0; i < step_size; i++) {
       HandleImpl& h = array_[ModTableSize(Lower32of64(old_clock_pointer + i))];
       bool evicting = ClockUpdate(h, data);
@@ -1143,7 +1243,7 @@ inline void FixedHyperClockTable::Evict(size_t requested_charge, InsertState&,
     }
 
     // Loop exit condition
-    if (data->freed_charge >= requested_charge) {
+    if (data->freed_charge >= requested_charge || data->admission_rejected) {
       return;
     }
     if (old_clock_pointer >= max_clock_pointer) {
@@ -1299,6 +1399,7 @@ typename ClockCacheShard<Table>::HandleImpl* ClockCacheShard<Table>::Lookup(
   if (UNLIKELY(key.size() != kCacheKeySize)) {
     return nullptr;
   }
+  table_.RecordAccess(hashed_key);
   return table_.Lookup(hashed_key);
 }
 
@@ -1559,6 +1660,7 @@ void BaseHyperClockCache<Table>::ReportProblems(
   if (info_log->GetInfoLogLevel() <= InfoLogLevel::DEBUG_LEVEL) {
     LoadVarianceStats slot_stats;
     uint64_t eviction_effort_exceeded_count = 0;
+    uint64_t admission_rejected_count = 0;
     this->ForEachShard([&](const BaseHyperClockCache<Table>::Shard* shard) {
       size_t count = shard->GetTableAddressCount();
       for (size_t i = 0; i < count; ++i) {
@@ -1566,12 +1668,17 @@ void BaseHyperClockCache<Table>::ReportProblems(
       }
       eviction_effort_exceeded_count +=
           shard->GetTable().GetEvictionEffortExceededCount();
+      admission_rejected_count +=
+          shard->GetTable().GetAdmissionRejectedCount();
     });
     ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
                        "Slot occupancy stats: %s", slot_stats.Report().c_str());
     ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
                        "Eviction effort exceeded: %" PRIu64,
                        eviction_effort_exceeded_count);
+    ROCKS_LOG_AT_LEVEL(info_log, InfoLogLevel::DEBUG_LEVEL,
+                       "Frequency admission rejected: %" PRIu64,
+                       admission_rejected_count);
   }
 }
 
@@ -1990,6 +2097,11 @@ AutoHyperClockTable::AutoHyperClockTable(
     // NOTE: ignoring page boundaries for simplicity
     usage_.FetchAddRelaxed(size_t{GetTableSize()} * sizeof(HandleImpl));
   }
+  if (opts.frequency_admission) {
+    // Sized for the table at full capacity
+    frequency_sketch_.reset(new ClockFrequencySketch(CalcMaxUsableLength(
+        capacity, opts.min_avg_value_size, metadata_charge_policy)));
+  }
 
   static_assert(sizeof(HandleImpl) == 64U,
                 "Expecting size / alignment with common cache line size");
@@ -3508,6 +3620,9 @@ void AutoHyperClockTable::Evict(size_t requested_charge, InsertState& state,
     uint64_t old_clock_pointer = clock_pointer_.FetchAddRelaxed(step_size);
 
     if (UNLIKELY((old_clock_pointer & clock_pointer_mask) == 0)) {
+      if (frequency_sketch_ != nullptr) {
+        frequency_sketch_->MaybeAge();
+      }
       // Back at the beginning. See if clock_pointer_mask should be updated.
       uint64_t mask = BottomNBits(
           UINT64_MAX, LengthInfoToMinShift(state.saved_length_info));
@@ -3541,7 +3656,7 @@ void AutoHyperClockTable::Evict(size_t requested_charge, InsertState& state,
     to_finish_eviction.clear();
 
     // Loop exit conditions
-    if (data->freed_charge >= requested_charge) {
+    if (data->freed_charge >= requested_charge || data->admission_rejected) {
       return;
     }
 
@@ -20,6 +20,7 @@
 #include "cache/cache_key.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
+#include "port/likely.h"
 #include "port/malloc.h"
 #include "port/mmap.h"
 #include "port/port.h"
@@ -373,14 +374,60 @@ struct ClockHandle : public ClockHandleBasicData {
   mutable AcqRelAtomic<uint64_t> meta{};
 };  // struct ClockHandle
 
+// A count-min sketch estimating how often each key was recently accessed,
+// for the TinyLFU admission of HyperClockCacheOptions::frequency_admission.
+// Counters are 4 bits, packed sixteen to a word, and updated lock-free with
+// relaxed atomics. A lost update, such as an increment racing with Age(),
+// only makes an estimate slightly off, which is fine for a heuristic.
+class ClockFrequencySketch {
+ public:
+  // Sized for a table of `num_slots` entries
+  explicit ClockFrequencySketch(size_t num_slots);
+
+  // Counts an access to the key. Saturated counters are only read, so that
+  // lookups of hot keys do not keep writing to shared cache lines.
+  void Increment(const UniqueId64x2& hashed_key);
+
+  // Counts an insertion, which also counts as an access to the key
+  void IncrementForInsert(const UniqueId64x2& hashed_key) {
+    Increment(hashed_key);
+    insertions_.FetchAddRelaxed(1);
+  }
+
+  // The estimated number of recent accesses to the key, saturating at 15
+  uint32_t Estimate(const UniqueId64x2& hashed_key) const;
+
+  // Called when the clock pointer completes a sweep of the table. Halves all
+  // the counters if there have been enough insertions since the last time,
+  // so that the estimates decay as entries age in the clock, but a clock
+  // spinning through the table without much turnover does not wipe all the
+  // history.
+  void MaybeAge();
+
+ private:
+  static constexpr int kNumRows = 4;
+  static constexpr uint64_t kCounterMask = 15;
+
+  size_t CounterIndex(const UniqueId64x2& hashed_key, int row) const;
+
+  // log2 of the number of counters in each row
+  const int row_bits_;
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> words_;
+  // Insertions since the counters were last halved
+  RelaxedAtomic<size_t> insertions_{};
+};
+
 class BaseClockTable {
  public:
   struct BaseOpts {
-    explicit BaseOpts(int _eviction_effort_cap)
-        : eviction_effort_cap(_eviction_effort_cap) {}
+    explicit BaseOpts(int _eviction_effort_cap,
+                      bool _frequency_admission = false)
+        : eviction_effort_cap(_eviction_effort_cap),
+          frequency_admission(_frequency_admission) {}
     explicit BaseOpts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {}
+        : BaseOpts(opts.eviction_effort_cap, opts.frequency_admission) {}
     int eviction_effort_cap;
+    bool frequency_admission;
   };
 
   BaseClockTable(CacheMetadataChargePolicy metadata_charge_policy,
@@ -419,10 +466,27 @@ class BaseClockTable {
     return eviction_effort_exceeded_count_.LoadRelaxed();
   }
 
+  uint64_t GetAdmissionRejectedCount() const {
+    return admission_rejected_count_.LoadRelaxed();
+  }
+
+  // Counts a lookup of the key for frequency_admission, if enabled
+  void RecordAccess(const UniqueId64x2& hashed_key) {
+    if (UNLIKELY(frequency_sketch_ != nullptr)) {
+      frequency_sketch_->Increment(hashed_key);
+    }
+  }
+
   struct EvictionData {
     size_t freed_charge = 0;
     size_t freed_count = 0;
     size_t seen_pinned_count = 0;
+    // With frequency_admission, the sketch and the estimated frequency of
+    // the entry being inserted. An eviction victim estimated at least as
+    // popular as the new entry is kept, and the insertion rejected.
+    const ClockFrequencySketch* admission_sketch = nullptr;
+    uint32_t admission_freq = 0;
+    bool admission_rejected = false;
   };
 
   void TrackAndReleaseEvictedEntry(ClockHandle* h);
@@ -458,13 +522,16 @@ class BaseClockTable {
   // means that updating `usage_` always succeeds even if forced to exceed
   // capacity. If `need_evict_for_occupancy`, then eviction of at least one
   // entry is required, and the operation should return false if such eviction
-  // is not possible. `usage_` is not updated in that case. Otherwise, returns
-  // true, indicating success.
+  // is not possible. `usage_` is not updated in that case. Likewise with
+  // frequency_admission and non-null `admission_key`, if an eviction victim
+  // is estimated to be at least as popular as the new entry for that key.
+  // Otherwise, returns true, indicating success.
   // NOTE: occupancy_ is not managed in this function
   template <class Table>
   bool ChargeUsageMaybeEvictNonStrict(size_t total_charge, size_t capacity,
                                       bool need_evict_for_occupancy,
                                       uint32_t eviction_effort_cap,
+                                      const UniqueId64x2* admission_key,
                                       typename Table::InsertState& state);
 
  protected:  // data
@@ -486,6 +553,14 @@ class BaseClockTable {
   // (Relaxed: a simple stat counter.)
   RelaxedAtomic<uint64_t> eviction_effort_exceeded_count_{};
 
+  // Counter for number of insertions rejected by frequency_admission.
+  // (Relaxed: a simple stat counter.)
+  RelaxedAtomic<uint64_t> admission_rejected_count_{};
+
+  // For frequency_admission, or nullptr if disabled. Set up by the derived
+  // table constructor, which knows the size of the table.
+  std::unique_ptr<ClockFrequencySketch> frequency_sketch_;
+
   // TODO: is this separation needed if we don't do background evictions?
   ALIGN_AS(CACHE_LINE_SIZE)
   // Number of elements in the table.
@@ -1010,6 +1085,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
   static inline uint32_t HashPieceForSharding(HashCref hash) {
     return Upper32of64(hash[0]);
   }
+  // See ReverseHash()
+  static constexpr bool kKeyFromHash = true;
   static inline HashVal ComputeHash(const Slice& key, uint32_t seed) {
     assert(key.size() == kCacheKeySize);
     HashVal in;
@@ -0,0 +1,495 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// A record is the masked crc32c of the rest of the record, the sizes of the
+// key and the value, the compression type and the cache tier of the value,
+// then the key and the value.
+constexpr size_t kRecordHeaderSize = 14;
+
+const std::string kSegmentFileSuffix = ".fsc";
+}  // namespace
+
+class FlashSecondaryCache::ResultHandle : public SecondaryCacheResultHandle {
+ public:
+  ResultHandle(FileSystem* fs, const Slice& key,
+               const Cache::CacheItemHelper* helper,
+               Cache::CreateContext* create_context, size_t size)
+      : fs_(fs),
+        key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context),
+        size_(size),
+        scratch_(new char[size]) {}
+
+  ~ResultHandle() override {
+    if (io_handle_ != nullptr) {
+      if (!IsReady()) {
+        std::vector<void*> io_handles{io_handle_};
+        fs_->AbortIO(io_handles).PermitUncheckedError();
+      }
+      del_fn_(io_handle_);
+    }
+  }
+
+  bool IsReady() override { return ready_.load(std::memory_order_acquire); }
+
+  void Wait() override {
+    if (!IsReady()) {
+      std::vector<void*> io_handles{io_handle_};
+      fs_->Poll(io_handles, 1).PermitUncheckedError();
+      if (!IsReady()) {
+        Complete(Slice(), IOStatus::IOError("Read not completed"));
+      }
+    }
+  }
+
+  Cache::ObjectPtr Value() override {
+    assert(IsReady());
+    return value_;
+  }
+
+  size_t Size() override { return Value() ? charge_ : 0; }
+
+  char* scratch() { return scratch_.get(); }
+
+  void* io_handle() const { return io_handle_; }
+
+  // Reads the record at `offset` in the segment asynchronously. The handle
+  // is ready once the read completes, possibly before this returns.
+  IOStatus ReadAsync(std::shared_ptr<Segment> segment, uint64_t offset) {
+    segment_ = std::move(segment);
+    FSReadRequest req;
+    req.offset = offset;
+    req.len = size_;
+    req.scratch = scratch_.get();
+    IOStatus s = segment_->file->ReadAsync(req, IOOptions(), &OnReadDone, this,
+                                           &io_handle_, &del_fn_,
+                                           /*dbg=*/nullptr);
+    if (!s.ok()) {
+      // Nothing was submitted.
+      if (io_handle_ != nullptr) {
+        del_fn_(io_handle_);
+        io_handle_ = nullptr;
+      }
+      segment_.reset();
+    }
+    return s;
+  }
+
+  // Checks the record read, and creates the object from its value. The
+  // object is left null if anything fails, for the lookup to be a miss.
+  void Complete(const Slice& record, const IOStatus& s) {
+    if (s.ok() && record.size() == size_) {
+      const char* p = record.data();
+      const uint32_t key_size = DecodeFixed32(p + 4);
+      const uint32_t value_size = DecodeFixed32(p + 8);
+      if (kRecordHeaderSize + key_size + value_size == size_ &&
+          crc32c::Unmask(DecodeFixed32(p)) == crc32c::Value(p + 4, size_ - 4) &&
+          Slice(p + kRecordHeaderSize, key_size) == key_) {
+        Status create_status = helper_->create_cb(
+            Slice(p + kRecordHeaderSize + key_size, value_size),
+            static_cast<CompressionType>(p[12]), static_cast<CacheTier>(p[13]),
+            create_context_, /*allocator=*/nullptr, &value_, &charge_);
+        if (!create_status.ok()) {
+          value_ = nullptr;
+        }
+      }
+    }
+    segment_.reset();
+    ready_.store(true, std::memory_order_release);
+  }
+
+ private:
+  static void OnReadDone(FSReadRequest& req, void* cb_arg) {
+    static_cast<ResultHandle*>(cb_arg)->Complete(req.result, req.status);
+  }
+
+  FileSystem* const fs_;
+  const std::string key_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+  const size_t size_;
+  std::unique_ptr<char[]> scratch_;
+  // Keeps the segment file open while the read is in flight.
+  std::shared_ptr<Segment> segment_;
+  void* io_handle_ = nullptr;
+  IOHandleDeleter del_fn_;
+  std::atomic<bool> ready_{false};
+  Cache::ObjectPtr value_ = nullptr;
+  size_t charge_ = 0;
+};
+
+FlashSecondaryCache::FlashSecondaryCache(const FlashSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.fs ? opts.fs : FileSystem::Default()),
+      max_segments_(opts.capacity / opts.segment_size) {}
+
+FlashSecondaryCache::~FlashSecondaryCache() {
+  if (writer_ != nullptr) {
+    writer_->Close(IOOptions(), /*dbg=*/nullptr).PermitUncheckedError();
+  }
+  // The entries are lost with the index.
+  for (const auto& segment : segments_) {
+    fs_->DeleteFile(segment->fname, IOOptions(), /*dbg=*/nullptr)
+        .PermitUncheckedError();
+  }
+}
+
+Status FlashSecondaryCache::Open() {
+  IOStatus s =
+      fs_->CreateDirIfMissing(opts_.path, IOOptions(), /*dbg=*/nullptr);
+  std::vector<std::string> children;
+  if (s.ok()) {
+    s = fs_->GetChildren(opts_.path, IOOptions(), &children, /*dbg=*/nullptr);
+  }
+  for (const auto& child : children) {
+    if (s.ok() && EndsWith(child, kSegmentFileSuffix)) {
+      s = fs_->DeleteFile(opts_.path + "/" + child, IOOptions(),
+                          /*dbg=*/nullptr);
+    }
+  }
+  if (s.ok()) {
+    MutexLock l(&write_mutex_);
+    s = StartSegment();
+  }
+  return s;
+}
+
+Status FlashSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                   const Cache::CacheItemHelper* helper,
+                                   bool /*force_insert*/) {
+  if (!helper->IsSecondaryCacheCompatible()) {
+    return Status::OK();
+  }
+  const size_t size = helper->size_cb(value);
+  return Append(key, size, kNoCompression, CacheTier::kVolatileTier,
+                [&](char* buf) {
+                  return helper->saveto_cb(value, /*from_offset=*/0, size, buf);
+                });
+}
+
+Status FlashSecondaryCache::InsertSaved(const Slice& key, const Slice& saved,
+                                        CompressionType type,
+                                        CacheTier source) {
+  return Append(key, saved.size(), type, source, [&](char* buf) {
+    memcpy(buf, saved.data(), saved.size());
+    return Status::OK();
+  });
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> FlashSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool /*advise_erase*/,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  assert(helper);
+  // The entries only go away with their segment.
+  kept_in_sec_cache = true;
+  Location location;
+  if (!FindLocation(GetSliceNPHash64(key), &location)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<ResultHandle> handle(new ResultHandle(
+      fs_.get(), key, helper, create_context, location.size));
+  if (ReadBuffered(location, handle->scratch())) {
+    handle->Complete(Slice(handle->scratch(), location.size), IOStatus::OK());
+  } else {
+    std::shared_ptr<Segment> segment = GetSegment(location.segment);
+    if (segment == nullptr) {
+      // Reclaimed since
+      return nullptr;
+    }
+    IOStatus s = IOStatus::NotSupported();
+    if (!wait) {
+      s = handle->ReadAsync(segment, location.offset);
+    }
+    if (s.IsNotSupported()) {
+      Slice record;
+      s = segment->file->Read(location.offset, location.size, IOOptions(),
+                              &record, handle->scratch(), /*dbg=*/nullptr);
+      handle->Complete(record, s);
+    } else if (!s.ok()) {
+      return nullptr;
+    }
+  }
+  if (handle->IsReady() && handle->Value() == nullptr) {
+    return nullptr;
+  }
+  return handle;
+}
+
+void FlashSecondaryCache::Erase(const Slice& key) {
+  const uint64_t hash = GetSliceNPHash64(key);
+  IndexShard& shard = GetIndexShard(hash);
+  MutexLock l(&shard.mutex);
+  shard.map.erase(hash);
+}
+
+void FlashSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<void*> io_handles;
+  for (auto handle : handles) {
+    if (!handle->IsReady()) {
+      io_handles.push_back(static_cast<ResultHandle*>(handle)->io_handle());
+    }
+  }
+  if (!io_handles.empty()) {
+    fs_->Poll(io_handles, io_handles.size()).PermitUncheckedError();
+  }
+  // In case polling failed
+  for (auto handle : handles) {
+    handle->Wait();
+  }
+}
+
+Status FlashSecondaryCache::GetCapacity(size_t& capacity) {
+  capacity = opts_.capacity;
+  return Status::OK();
+}
+
+std::string FlashSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(1000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    segment_size : %" ROCKSDB_PRIszt "\n",
+           opts_.segment_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    write_buffer_size : %" ROCKSDB_PRIszt "\n",
+           opts_.write_buffer_size);
+  ret.append(buffer);
+  return ret;
+}
+
+size_t FlashSecondaryCache::TEST_GetNumSegments() {
+  ReadLock l(&segments_mutex_);
+  return segments_.size();
+}
+
+bool FlashSecondaryCache::FindLocation(uint64_t hash, Location* location) {
+  IndexShard& shard = GetIndexShard(hash);
+  MutexLock l(&shard.mutex);
+  auto it = shard.map.find(hash);
+  if (it == shard.map.end()) {
+    return false;
+  }
+  *location = it->second;
+  return true;
+}
+
+std::shared_ptr<FlashSecondaryCache::Segment> FlashSecondaryCache::GetSegment(
+    uint32_t id) {
+  ReadLock l(&segments_mutex_);
+  if (segments_.empty() || id < segments_.front()->id) {
+    return nullptr;
+  }
+  const size_t i = id - segments_.front()->id;
+  return i < segments_.size() ? segments_[i] : nullptr;
+}
+
+Status FlashSecondaryCache::Append(
+    const Slice& key, size_t size, CompressionType type, CacheTier source,
+    const std::function<Status(char* buf)>& fill) {
+  const uint64_t hash = GetSliceNPHash64(key);
+  Location location;
+  if (FindLocation(hash, &location)) {
+    return Status::OK();
+  }
+  const size_t record_size = kRecordHeaderSize + key.size() + size;
+  if (record_size > opts_.segment_size) {
+    return Status::OK();
+  }
+
+  MutexLock l(&write_mutex_);
+  if (current_ != nullptr &&
+      segment_offset_ + record_size > opts_.segment_size) {
+    IOStatus s = FlushWriteBuffer();
+    if (s.ok()) {
+      s = writer_->Close(IOOptions(), /*dbg=*/nullptr);
+    }
+    writer_.reset();
+    current_.reset();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  if (current_ == nullptr) {
+    IOStatus s = StartSegment();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  const size_t start = write_buffer_.size();
+  write_buffer_.resize(start + record_size);
+  char* p = &write_buffer_[start];
+  Status s = fill(p + kRecordHeaderSize + key.size());
+  if (!s.ok()) {
+    write_buffer_.resize(start);
+    return s;
+  }
+  EncodeFixed32(p + 4, static_cast<uint32_t>(key.size()));
+  EncodeFixed32(p + 8, static_cast<uint32_t>(size));
+  p[12] = static_cast<char>(type);
+  p[13] = static_cast<char>(source);
+  memcpy(p + kRecordHeaderSize, key.data(), key.size());
+  EncodeFixed32(p, crc32c::Mask(crc32c::Value(p + 4, record_size - 4)));
+
+  location.segment = current_->id;
+  location.offset = static_cast<uint32_t>(segment_offset_);
+  location.size = static_cast<uint32_t>(record_size);
+  segment_offset_ += record_size;
+  current_->key_hashes.push_back(hash);
+  {
+    IndexShard& shard = GetIndexShard(hash);
+    MutexLock sl(&shard.mutex);
+    shard.map[hash] = location;
+  }
+
+  if (write_buffer_.size() >= opts_.write_buffer_size) {
+    s = FlushWriteBuffer();
+  }
+  return s;
+}
+
+bool FlashSecondaryCache::ReadBuffered(const Location& location,
+                                       char* scratch) {
+  // The segments before the current one are entirely written, and so is the
+  // current one up to flushed_offset_, which is reset before
+  // current_segment_id_ changes.
+  if (location.segment != current_segment_id_.load(std::memory_order_acquire) ||
+      location.offset < flushed_offset_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  MutexLock l(&write_mutex_);
+  const size_t flushed = flushed_offset_.load(std::memory_order_relaxed);
+  if (current_ == nullptr || location.segment != current_->id ||
+      location.offset < flushed) {
+    return false;
+  }
+  assert(location.offset + location.size <= segment_offset_);
+  memcpy(scratch, write_buffer_.data() + (location.offset - flushed),
+         location.size);
+  return true;
+}
+
+IOStatus FlashSecondaryCache::FlushWriteBuffer() {
+  if (write_buffer_.empty()) {
+    return IOStatus::OK();
+  }
+  IOStatus s = writer_->Append(write_buffer_, IOOptions(), /*dbg=*/nullptr);
+  if (s.ok()) {
+    s = writer_->Flush(IOOptions(), /*dbg=*/nullptr);
+  }
+  // Even on error, the entries are then read from the file, and missed.
+  write_buffer_.clear();
+  flushed_offset_.store(segment_offset_, std::memory_order_release);
+  return s;
+}
+
+IOStatus FlashSecondaryCache::StartSegment() {
+  auto segment = std::make_shared<Segment>();
+  segment->id = next_segment_id_;
+  segment->fname = SegmentFileName(segment->id);
+  const FileOptions file_opts;
+  IOStatus s = fs_->NewWritableFile(segment->fname, file_opts, &writer_,
+                                    /*dbg=*/nullptr);
+  if (s.ok()) {
+    s = fs_->NewRandomAccessFile(segment->fname, file_opts, &segment->file,
+                                 /*dbg=*/nullptr);
+    if (!s.ok()) {
+      writer_.reset();
+      fs_->DeleteFile(segment->fname, IOOptions(), /*dbg=*/nullptr)
+          .PermitUncheckedError();
+    }
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  ++next_segment_id_;
+  segment_offset_ = 0;
+  flushed_offset_.store(0, std::memory_order_relaxed);
+  current_segment_id_.store(segment->id, std::memory_order_release);
+  current_ = segment;
+  {
+    WriteLock l(&segments_mutex_);
+    segments_.push_back(std::move(segment));
+  }
+  while (segments_.size() > max_segments_) {
+    ReclaimOldestSegment();
+  }
+  return s;
+}
+
+void FlashSecondaryCache::ReclaimOldestSegment() {
+  std::shared_ptr<Segment> segment;
+  {
+    WriteLock l(&segments_mutex_);
+    segment = std::move(segments_.front());
+    segments_.pop_front();
+  }
+  for (uint64_t hash : segment->key_hashes) {
+    IndexShard& shard = GetIndexShard(hash);
+    MutexLock l(&shard.mutex);
+    auto it = shard.map.find(hash);
+    if (it != shard.map.end() && it->second.segment == segment->id) {
+      shard.map.erase(it);
+    }
+  }
+  // The lookups in flight keep the file open.
+  fs_->DeleteFile(segment->fname, IOOptions(), /*dbg=*/nullptr)
+      .PermitUncheckedError();
+}
+
+std::string FlashSecondaryCache::SegmentFileName(uint32_t id) const {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%08" PRIu32, id);
+  return opts_.path + buf + kSegmentFileSuffix;
+}
+
+Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                              std::shared_ptr<SecondaryCache>* result) {
+  if (opts.path.empty()) {
+    return Status::InvalidArgument("FlashSecondaryCacheOptions::path is empty");
+  }
+  if (opts.segment_size == 0 ||
+      opts.segment_size > std::numeric_limits<uint32_t>::max()) {
+    return Status::InvalidArgument(
+        "FlashSecondaryCacheOptions::segment_size must be in (0, 4GB)");
+  }
+  if (opts.capacity / opts.segment_size < 2) {
+    return Status::InvalidArgument(
+        "FlashSecondaryCacheOptions::capacity must be at least twice "
+        "segment_size");
+  }
+  auto cache = std::make_shared<FlashSecondaryCache>(opts);
+  Status s = cache->Open();
+  if (s.ok()) {
+    *result = std::move(cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,153 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// FlashSecondaryCache is a SecondaryCache on local flash, meant as the
+// non-volatile tier of a TieredCache (TieredCacheOptions::nvm_sec_cache).
+//
+// The entries are appended, with their key and a checksum, to large segment
+// files, through a write buffer. Only an index from the hash of the key to
+// the location of the entry is kept in memory, in shards with their own
+// mutex. Space is reclaimed a whole segment at a time, oldest first (FIFO):
+// its file is deleted and the index entries pointing to it are removed.
+//
+// Lookup() with wait=false issues an FSRandomAccessFile::ReadAsync() and
+// returns a handle that becomes ready on the completion of the read, which
+// with the posix FileSystem and io_uring is reaped by Wait() or WaitAll()
+// through FileSystem::Poll(). Entries still in the write buffer, and
+// FileSystems without async reads, are served synchronously.
+class FlashSecondaryCache : public SecondaryCache {
+ public:
+  explicit FlashSecondaryCache(const FlashSecondaryCacheOptions& opts);
+  ~FlashSecondaryCache() override;
+
+  // No copying allowed
+  FlashSecondaryCache(const FlashSecondaryCache&) = delete;
+  FlashSecondaryCache& operator=(const FlashSecondaryCache&) = delete;
+
+  // Creates the directory, deletes the segment files left there by a
+  // previous instance and starts the first segment.
+  Status Open();
+
+  const char* Name() const override { return "FlashSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved, CompressionType type,
+                     CacheTier source) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  size_t TEST_GetNumSegments();
+
+ private:
+  class ResultHandle;
+
+  struct Segment {
+    uint32_t id = 0;
+    std::string fname;
+    std::unique_ptr<FSRandomAccessFile> file;
+    // Hashes of the keys of the entries written to the segment, to remove
+    // them from the index when reclaiming it. Written under write_mutex_.
+    std::vector<uint64_t> key_hashes;
+  };
+
+  struct Location {
+    uint32_t segment;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  static constexpr int kNumIndexShardBits = 4;
+
+  struct IndexShard {
+    port::Mutex mutex;
+    std::unordered_map<uint64_t, Location> map;
+  };
+
+  IndexShard& GetIndexShard(uint64_t hash) {
+    return index_[hash >> (64 - kNumIndexShardBits)];
+  }
+
+  bool FindLocation(uint64_t hash, Location* location);
+
+  std::shared_ptr<Segment> GetSegment(uint32_t id);
+
+  // Appends an entry of `size` bytes, which `fill` writes to the given
+  // buffer. Skips the entry if the key is already in the cache.
+  Status Append(const Slice& key, size_t size, CompressionType type,
+                CacheTier source,
+                const std::function<Status(char* buf)>& fill);
+
+  // Copies the record at `location` to `scratch` if it is in the write
+  // buffer, and returns whether it was.
+  bool ReadBuffered(const Location& location, char* scratch);
+
+  // The following REQUIRE: write_mutex_ held
+  IOStatus FlushWriteBuffer();
+  IOStatus StartSegment();
+  void ReclaimOldestSegment();
+
+  std::string SegmentFileName(uint32_t id) const;
+
+  const FlashSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+  const size_t max_segments_;
+
+  std::array<IndexShard, size_t{1} << kNumIndexShardBits> index_;
+
+  // The segments by increasing id, the last one being written.
+  port::RWMutex segments_mutex_;
+  std::deque<std::shared_ptr<Segment>> segments_;
+
+  // Serializes the writes.
+  port::Mutex write_mutex_;
+  std::shared_ptr<Segment> current_;
+  std::unique_ptr<FSWritableFile> writer_;
+  uint32_t next_segment_id_ = 0;
+  // The size of the current segment, including the write buffer.
+  size_t segment_offset_ = 0;
+  std::string write_buffer_;
+  // The id of the current segment, and the offset of its write buffer, for
+  // the lookups to tell whether an entry is in the write buffer without
+  // locking write_mutex_.
+  std::atomic<uint32_t> current_segment_id_{0};
+  std::atomic<size_t> flushed_offset_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,358 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "file/file_util.h"
+#include "rocksdb/cache.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Defers the async reads until they are polled, like io_uring would.
+class DeferredReadFileSystem : public FileSystemWrapper {
+ public:
+  struct PendingRead {
+    FSReadRequest req;
+    std::function<void(FSReadRequest&, void*)> cb;
+    void* cb_arg;
+    FSRandomAccessFile* file;
+    bool done = false;
+  };
+
+  explicit DeferredReadFileSystem(const std::shared_ptr<FileSystem>& target)
+      : FileSystemWrapper(target) {}
+
+  static const char* kClassName() { return "DeferredReadFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& opts,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    std::unique_ptr<FSRandomAccessFile> file;
+    IOStatus s = target()->NewRandomAccessFile(fname, opts, &file, dbg);
+    if (s.ok()) {
+      result->reset(new DeferredReadFile(std::move(file), this));
+    }
+    return s;
+  }
+
+  IOStatus Poll(std::vector<void*>& io_handles,
+                size_t /*min_completions*/) override {
+    for (void* io_handle : io_handles) {
+      auto read = static_cast<PendingRead*>(io_handle);
+      if (!read->done) {
+        read->done = true;
+        read->req.status =
+            read->file->Read(read->req.offset, read->req.len, IOOptions(),
+                             &read->req.result, read->req.scratch, nullptr);
+        read->cb(read->req, read->cb_arg);
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  IOStatus AbortIO(std::vector<void*>& io_handles) override {
+    for (void* io_handle : io_handles) {
+      auto read = static_cast<PendingRead*>(io_handle);
+      if (!read->done) {
+        read->done = true;
+        read->req.status = IOStatus::Aborted();
+        read->cb(read->req, read->cb_arg);
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  int num_async_reads = 0;
+
+ private:
+  class DeferredReadFile : public FSRandomAccessFileOwnerWrapper {
+   public:
+    DeferredReadFile(std::unique_ptr<FSRandomAccessFile>&& file,
+                     DeferredReadFileSystem* fs)
+        : FSRandomAccessFileOwnerWrapper(std::move(file)), fs_(fs) {}
+
+    IOStatus ReadAsync(FSReadRequest& req, const IOOptions& /*opts*/,
+                       std::function<void(FSReadRequest&, void*)> cb,
+                       void* cb_arg, void** io_handle, IOHandleDeleter* del_fn,
+                       IODebugContext* /*dbg*/) override {
+      auto read = new PendingRead;
+      read->req.offset = req.offset;
+      read->req.len = req.len;
+      read->req.scratch = req.scratch;
+      read->cb = cb;
+      read->cb_arg = cb_arg;
+      read->file = target();
+      *io_handle = read;
+      *del_fn = [](void* p) { delete static_cast<PendingRead*>(p); };
+      ++fs_->num_async_reads;
+      return IOStatus::OK();
+    }
+
+   private:
+    DeferredReadFileSystem* fs_;
+  };
+};
+}  // namespace
+
+class FlashSecondaryCacheTest
+    : public testing::Test,
+      public secondary_cache_test_util::WithCacheType {
+ public:
+  FlashSecondaryCacheTest()
+      : path_(test::PerThreadDBPath("flash_secondary_cache_test")) {
+    opts_.path = path_;
+    opts_.capacity = 256 << 10;
+    opts_.segment_size = 64 << 10;
+    opts_.write_buffer_size = 16 << 10;
+  }
+
+  ~FlashSecondaryCacheTest() override {
+    sec_cache_.reset();
+    EXPECT_OK(DestroyDir(Env::Default(), path_));
+  }
+
+  const std::string& Type() const override {
+    static const std::string type = kLRU;
+    return type;
+  }
+
+ protected:
+  void Open() {
+    sec_cache_.reset();
+    ASSERT_OK(NewFlashSecondaryCache(opts_, &sec_cache_));
+  }
+
+  static std::string Key(int i) {
+    // 16 bytes for HCC compatibility
+    char buf[17];
+    snprintf(buf, sizeof(buf), "____key%09d", i);
+    return buf;
+  }
+
+  // Returns the value found for `key`, or "NOT_FOUND".
+  std::string Get(const std::string& key, bool wait = true) {
+    bool kept_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache_->Lookup(key, GetHelper(), this, wait,
+                           /*advise_erase=*/true, /*stats=*/nullptr,
+                           kept_in_sec_cache);
+    if (handle == nullptr) {
+      return "NOT_FOUND";
+    }
+    EXPECT_TRUE(kept_in_sec_cache);
+    if (!handle->IsReady()) {
+      sec_cache_->WaitAll({handle.get()});
+      EXPECT_TRUE(handle->IsReady());
+    }
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    if (item == nullptr) {
+      return "NOT_FOUND";
+    }
+    EXPECT_EQ(handle->Size(), item->Size());
+    return item->ToString();
+  }
+
+  FlashSecondaryCache* flash_cache() {
+    return static_cast<FlashSecondaryCache*>(sec_cache_.get());
+  }
+
+  std::string path_;
+  FlashSecondaryCacheOptions opts_;
+  std::shared_ptr<SecondaryCache> sec_cache_;
+};
+
+TEST_F(FlashSecondaryCacheTest, Basic) {
+  Open();
+  Random rnd(301);
+  ASSERT_EQ(Get(Key(0)), "NOT_FOUND");
+
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.size());
+  ASSERT_OK(sec_cache_->Insert(Key(1), &item1, GetHelper(),
+                               /*force_insert=*/false));
+  // From the write buffer
+  ASSERT_EQ(Get(Key(1)), str1);
+  ASSERT_EQ(Get(Key(1), /*wait=*/false), str1);
+
+  std::string str2 = rnd.RandomString(20000);
+  ASSERT_OK(sec_cache_->InsertSaved(Key(2), str2, kNoCompression,
+                                    CacheTier::kVolatileTier));
+  // From the file, as the write buffer overflowed
+  ASSERT_EQ(Get(Key(2)), str2);
+  ASSERT_EQ(Get(Key(1), /*wait=*/false), str1);
+  ASSERT_EQ(Get(Key(0)), "NOT_FOUND");
+
+  // Not secondary cache compatible
+  ASSERT_OK(sec_cache_->Insert(Key(3), &item1, GetHelper(
+                                   CacheEntryRole::kDataBlock,
+                                   /*secondary_compatible=*/false),
+                               /*force_insert=*/true));
+  ASSERT_EQ(Get(Key(3)), "NOT_FOUND");
+
+  sec_cache_->Erase(Key(1));
+  ASSERT_EQ(Get(Key(1)), "NOT_FOUND");
+  ASSERT_EQ(Get(Key(2)), str2);
+
+  SetFailCreate(true);
+  ASSERT_EQ(Get(Key(2)), "NOT_FOUND");
+  SetFailCreate(false);
+
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache_->GetCapacity(capacity));
+  ASSERT_EQ(capacity, opts_.capacity);
+}
+
+TEST_F(FlashSecondaryCacheTest, ReclaimSegments) {
+  Open();
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(rnd.RandomString(4000));
+    ASSERT_OK(sec_cache_->InsertSaved(Key(i), values.back(), kNoCompression,
+                                      CacheTier::kVolatileTier));
+    ASSERT_LE(flash_cache()->TEST_GetNumSegments(), 4U);
+  }
+  // 16 entries per segment, so the last 4 segments hold the last 3 * 16 + 8
+  // entries.
+  for (int i = 0; i < 200; ++i) {
+    std::string value = Get(Key(i), /*wait=*/i % 2 == 0);
+    if (i < 200 - 56) {
+      ASSERT_EQ(value, "NOT_FOUND");
+    } else {
+      ASSERT_EQ(value, values[i]);
+    }
+  }
+
+  std::vector<std::string> children;
+  ASSERT_OK(Env::Default()->GetChildren(path_, &children));
+  ASSERT_EQ(children.size(), 4U);
+
+  // Reinserting an entry still in the cache does not write it again.
+  ASSERT_OK(sec_cache_->InsertSaved(Key(199), "other", kNoCompression,
+                                    CacheTier::kVolatileTier));
+  ASSERT_EQ(Get(Key(199)), values[199]);
+}
+
+TEST_F(FlashSecondaryCacheTest, AsyncLookup) {
+  auto fs = std::make_shared<DeferredReadFileSystem>(FileSystem::Default());
+  opts_.fs = fs;
+  Open();
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(rnd.RandomString(5000));
+    ASSERT_OK(sec_cache_->InsertSaved(Key(i), values.back(), kNoCompression,
+                                      CacheTier::kVolatileTier));
+  }
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  for (int i = 0; i < 10; ++i) {
+    bool kept_in_sec_cache = false;
+    handles.push_back(sec_cache_->Lookup(Key(i), GetHelper(), this,
+                                         /*wait=*/false, /*advise_erase=*/true,
+                                         /*stats=*/nullptr,
+                                         kept_in_sec_cache));
+    ASSERT_NE(handles.back(), nullptr);
+  }
+  // The last 2 entries are still in the write buffer
+  ASSERT_EQ(fs->num_async_reads, 8);
+  std::vector<SecondaryCacheResultHandle*> to_wait;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(handles[i]->IsReady(), i >= 8);
+    if (i % 3 != 0) {
+      to_wait.push_back(handles[i].get());
+    }
+  }
+  sec_cache_->WaitAll(to_wait);
+  for (int i = 0; i < 10; ++i) {
+    if (i % 3 == 0 && i < 8) {
+      ASSERT_FALSE(handles[i]->IsReady());
+      if (i == 6) {
+        // Aborted on destruction
+        handles[i].reset();
+        continue;
+      }
+      handles[i]->Wait();
+    }
+    ASSERT_TRUE(handles[i]->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handles[i]->Value()));
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(item->ToString(), values[i]);
+  }
+}
+
+TEST_F(FlashSecondaryCacheTest, Reopen) {
+  Open();
+  ASSERT_OK(sec_cache_->InsertSaved(Key(1), "value", kNoCompression,
+                                    CacheTier::kVolatileTier));
+  ASSERT_EQ(Get(Key(1)), "value");
+  // The files are deleted with the cache, or else on startup.
+  sec_cache_.reset();
+  std::vector<std::string> children;
+  ASSERT_OK(Env::Default()->GetChildren(path_, &children));
+  ASSERT_TRUE(children.empty());
+  ASSERT_OK(WriteStringToFile(Env::Default(), "garbage",
+                              path_ + "/00000007.fsc"));
+  ASSERT_OK(WriteStringToFile(Env::Default(), "other", path_ + "/other"));
+  Open();
+  ASSERT_EQ(Get(Key(1)), "NOT_FOUND");
+  ASSERT_OK(Env::Default()->GetChildren(path_, &children));
+  std::sort(children.begin(), children.end());
+  ASSERT_EQ(children, std::vector<std::string>({"00000000.fsc", "other"}));
+}
+
+TEST_F(FlashSecondaryCacheTest, InvalidOptions) {
+  std::shared_ptr<SecondaryCache> sec_cache;
+  FlashSecondaryCacheOptions opts = opts_;
+  opts.capacity = opts.segment_size;
+  ASSERT_TRUE(NewFlashSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+  opts = opts_;
+  opts.path.clear();
+  ASSERT_TRUE(NewFlashSecondaryCache(opts, &sec_cache).IsInvalidArgument());
+  ASSERT_EQ(sec_cache, nullptr);
+}
+
+TEST_F(FlashSecondaryCacheTest, WithPrimaryCache) {
+  Open();
+  std::shared_ptr<Cache> cache =
+      NewCache(/*capacity=*/4000, /*num_shard_bits=*/0,
+               /*strict_capacity_limit=*/false, sec_cache_);
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(cache->Insert(Key(i), new TestItem(values[i].data(), 1000),
+                            GetHelper(), 1000));
+  }
+  // Evicted from the primary cache into the flash cache
+  for (int i = 0; i < 10; ++i) {
+    Cache::Handle* handle = cache->Lookup(Key(i), GetHelper(), this,
+                                          Cache::Priority::LOW);
+    ASSERT_NE(handle, nullptr) << i;
+    ASSERT_EQ(static_cast<TestItem*>(cache->Value(handle))->ToString(),
+              values[i]);
+    cache->Release(handle);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -9,20 +9,39 @@
 
 #include "cache/lru_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <optional>
 
 #include "cache/secondary_cache_adapter.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/statistics_impl.h"
 #include "port/lang.h"
 #include "util/distributed_mutex.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
 
+// Holds mutex_, or rw_mutex_ in exclusive mode with batched promotion
+class LRUCacheShard::ExclusiveLock {
+ public:
+  explicit ExclusiveLock(const LRUCacheShard& shard) {
+    if (shard.hit_buffers_ != nullptr) {
+      write_lock_.emplace(&shard.rw_mutex_);
+    } else {
+      mutex_lock_.emplace(shard.mutex_);
+    }
+  }
+
+ private:
+  std::optional<DMutexLock> mutex_lock_;
+  std::optional<WriteLock> write_lock_;
+};
+
 LRUHandleTable::LRUHandleTable(int max_upper_hash_bits,
                                MemoryAllocator* allocator)
     : length_bits_(/* historical starting size*/ 4),
@@ -119,7 +138,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             const Cache::EvictionCallback* eviction_callback)
+                             const Cache::EvictionCallback* eviction_callback,
+                             bool batched_promotion)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
       high_pri_pool_usage_(0),
@@ -133,6 +153,8 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
       usage_(0),
       lru_usage_(0),
       mutex_(use_adaptive_mutex),
+      hit_buffers_(batched_promotion ? new CoreLocalArray<HitBuffer>()
+                                     : nullptr),
       eviction_callback_(*eviction_callback) {
   // Make empty circular linked list.
   lru_.next = &lru_;
@@ -145,17 +167,25 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
 void LRUCacheShard::EraseUnRefEntries() {
   autovector<LRUHandle*> last_reference_list;
   {
-    DMutexLock l(mutex_);
-    while (lru_.next != &lru_) {
-      LRUHandle* old = lru_.next;
-      // LRU list contains only elements which can be evicted.
-      assert(old->InCache() && !old->HasRefs());
+    ExclusiveLock l(*this);
+    ApplyHits();
+    LRUHandle* old = lru_.next;
+    while (old != &lru_) {
+      LRUHandle* next = old->next;
+      assert(old->InCache());
+      if (old->HasRefs()) {
+        // Referenced entries stay in the LRU list with batched promotion
+        assert(hit_buffers_ != nullptr);
+        old = next;
+        continue;
+      }
       LRU_Remove(old);
       table_.Remove(old->key(), old->hash);
       old->SetInCache(false);
       assert(usage_ >= old->total_charge);
       usage_ -= old->total_charge;
       last_reference_list.push_back(old);
+      old = next;
     }
   }
 
@@ -172,7 +202,7 @@ void LRUCacheShard::ApplyToSomeEntries(
   // The state is essentially going to be the starting hash, which works
   // nicely even if we resize between calls because we use upper-most
   // hash bits for table indexes.
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   int length_bits = table_.GetLengthBits();
   size_t length = size_t{1} << length_bits;
 
@@ -202,14 +232,16 @@ void LRUCacheShard::ApplyToSomeEntries(
 
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                                     LRUHandle** lru_bottom_pri) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
+  ApplyHits();
   *lru = &lru_;
   *lru_low_pri = lru_low_pri_;
   *lru_bottom_pri = lru_bottom_pri_;
 }
 
 size_t LRUCacheShard::TEST_GetLRUSize() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
+  ApplyHits();
   LRUHandle* lru_handle = lru_.next;
   size_t lru_size = 0;
   while (lru_handle != &lru_) {
@@ -220,12 +252,12 @@ size_t LRUCacheShard::TEST_GetLRUSize() {
 }
 
 double LRUCacheShard::GetHighPriPoolRatio() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return high_pri_pool_ratio_;
 }
 
 double LRUCacheShard::GetLowPriPoolRatio() {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return low_pri_pool_ratio_;
 }
 
@@ -322,16 +354,53 @@ void LRUCacheShard::MaintainPoolSize() {
 
 void LRUCacheShard::EvictFromLRU(size_t charge,
                                  autovector<LRUHandle*>* deleted) {
-  while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
-    // LRU list contains only elements which can be evicted.
-    assert(old->InCache() && !old->HasRefs());
+  LRUHandle* old = lru_.next;
+  while ((usage_ + charge) > capacity_ && old != &lru_) {
+    LRUHandle* next = old->next;
+    // LRU list contains only elements which can be evicted, except with
+    // batched promotion.
+    assert(old->InCache());
+    if (old->HasRefs()) {
+      assert(hit_buffers_ != nullptr);
+      old = next;
+      continue;
+    }
     LRU_Remove(old);
     table_.Remove(old->key(), old->hash);
     old->SetInCache(false);
     assert(usage_ >= old->total_charge);
     usage_ -= old->total_charge;
     deleted->push_back(old);
+    old = next;
+  }
+}
+
+bool LRUCacheShard::RecordHit(LRUHandle* e) {
+  HitBuffer* buffer = hit_buffers_->Access();
+  uint32_t pos = buffer->size.fetch_add(1, std::memory_order_relaxed);
+  if (pos < kHitBufferSize) {
+    buffer->handles[pos] = e;
+  }
+  // Further hits are dropped until the buffer is applied
+  return pos + 1 == kHitBufferSize;
+}
+
+void LRUCacheShard::ApplyHits() {
+  if (hit_buffers_ == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < hit_buffers_->Size(); i++) {
+    HitBuffer* buffer = hit_buffers_->AccessAtCore(i);
+    uint32_t size = std::min(buffer->size.load(std::memory_order_relaxed),
+                             kHitBufferSize);
+    for (uint32_t j = 0; j < size; j++) {
+      LRUHandle* e = buffer->handles[j];
+      assert(e->InCache());
+      LRU_Remove(e);
+      e->SetHit();
+      LRU_Insert(e);
+    }
+    buffer->size.store(0, std::memory_order_relaxed);
   }
 }
 
@@ -354,7 +423,8 @@ void LRUCacheShard::NotifyEvicted(
 void LRUCacheShard::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
+    ApplyHits();
     capacity_ = capacity;
     high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
     low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
@@ -365,7 +435,7 @@ void LRUCacheShard::SetCapacity(size_t capacity) {
 }
 
 void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   strict_capacity_limit_ = strict_capacity_limit;
 }
 
@@ -374,7 +444,8 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
   autovector<LRUHandle*> last_reference_list;
 
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
+    ApplyHits();
 
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty.
@@ -408,11 +479,15 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
           assert(usage_ >= old->total_charge);
           usage_ -= old->total_charge;
           last_reference_list.push_back(old);
+        } else if (hit_buffers_ != nullptr) {
+          // Referenced entries are in the LRU list with batched promotion
+          LRU_Remove(old);
         }
       }
-      if (handle == nullptr) {
+      if (handle == nullptr || hit_buffers_ != nullptr) {
         LRU_Insert(e);
-      } else {
+      }
+      if (handle != nullptr) {
         // If caller already holds a ref, no need to take one here.
         if (!e->HasRefs()) {
           e->Ref();
@@ -432,7 +507,26 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
                                  Cache::CreateContext* /*create_context*/,
                                  Cache::Priority /*priority*/,
                                  Statistics* /*stats*/) {
-  DMutexLock l(mutex_);
+  if (hit_buffers_ != nullptr) {
+    LRUHandle* e;
+    bool apply_hits = false;
+    {
+      ReadLock l(&rw_mutex_);
+      e = table_.Lookup(key, hash);
+      if (e != nullptr) {
+        assert(e->InCache());
+        e->Ref();
+        apply_hits = RecordHit(e);
+      }
+    }
+    if (apply_hits) {
+      ExclusiveLock l(*this);
+      ApplyHits();
+    }
+    return e;
+  }
+
+  ExclusiveLock l(*this);
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -448,7 +542,13 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
 }
 
 bool LRUCacheShard::Ref(LRUHandle* e) {
-  DMutexLock l(mutex_);
+  if (hit_buffers_ != nullptr) {
+    // Referenced entries can't be freed, and don't move in the LRU list
+    assert(e->HasRefs());
+    e->Ref();
+    return true;
+  }
+  ExclusiveLock l(*this);
   // To create another reference - entry must be already externally referenced.
   assert(e->HasRefs());
   e->Ref();
@@ -456,14 +556,14 @@ bool LRUCacheShard::Ref(LRUHandle* e) {
 }
 
 void LRUCacheShard::SetHighPriorityPoolRatio(double high_pri_pool_ratio) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   high_pri_pool_ratio_ = high_pri_pool_ratio;
   high_pri_pool_capacity_ = capacity_ * high_pri_pool_ratio_;
   MaintainPoolSize();
 }
 
 void LRUCacheShard::SetLowPriorityPoolRatio(double low_pri_pool_ratio) {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   low_pri_pool_ratio_ = low_pri_pool_ratio;
   low_pri_pool_capacity_ = capacity_ * low_pri_pool_ratio_;
   MaintainPoolSize();
@@ -474,10 +574,48 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
   if (e == nullptr) {
     return false;
   }
+  if (hit_buffers_ != nullptr && !erase_if_last_ref) {
+    // The entry stays in the LRU list, so the exclusive lock is only needed
+    // to free it
+    bool last_reference;
+    bool in_cache;
+    bool over_capacity;
+    {
+      ReadLock l(&rw_mutex_);
+      last_reference = e->Unref();
+      in_cache = e->InCache();
+      over_capacity = usage_ > capacity_;
+    }
+    if (!last_reference) {
+      return false;
+    }
+    if (in_cache) {
+      if (over_capacity) {
+        // `e` might be gone already, but can be evicted like any other entry
+        autovector<LRUHandle*> last_reference_list;
+        {
+          ExclusiveLock l(*this);
+          ApplyHits();
+          EvictFromLRU(0, &last_reference_list);
+        }
+        NotifyEvicted(last_reference_list);
+      }
+      return false;
+    }
+    // Erased or standalone, and no longer reachable by other threads
+    {
+      ExclusiveLock l(*this);
+      assert(usage_ >= e->total_charge);
+      usage_ -= e->total_charge;
+    }
+    e->Free(table_.GetAllocator());
+    return true;
+  }
   bool must_free;
   bool was_in_cache;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
+    ApplyHits();
     must_free = e->Unref();
     was_in_cache = e->InCache();
     if (must_free && was_in_cache) {
@@ -485,6 +623,10 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
       if (usage_ > capacity_ || erase_if_last_ref) {
         // The LRU list must be empty since the cache is full.
         assert(lru_.next == &lru_ || erase_if_last_ref);
+        if (hit_buffers_ != nullptr) {
+          // Referenced entries are in the LRU list with batched promotion
+          LRU_Remove(e);
+        }
         // Take this opportunity and remove the item.
         table_.Remove(e->key(), e->hash);
         e->SetInCache(false);
@@ -568,7 +710,8 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
   autovector<LRUHandle*> last_reference_list;
 
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
+    ApplyHits();
 
     EvictFromLRU(e->total_charge, &last_reference_list);
 
@@ -592,7 +735,8 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
   LRUHandle* e;
   bool last_reference = false;
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
+    ApplyHits();
     e = table_.Remove(key, hash);
     if (e != nullptr) {
       assert(e->InCache());
@@ -603,6 +747,9 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
         assert(usage_ >= e->total_charge);
         usage_ -= e->total_charge;
         last_reference = true;
+      } else if (hit_buffers_ != nullptr) {
+        // Referenced entries are in the LRU list with batched promotion
+        LRU_Remove(e);
       }
     }
   }
@@ -615,23 +762,32 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
 }
 
 size_t LRUCacheShard::GetUsage() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return usage_;
 }
 
 size_t LRUCacheShard::GetPinnedUsage() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   assert(usage_ >= lru_usage_);
-  return usage_ - lru_usage_;
+  size_t pinned_usage = usage_ - lru_usage_;
+  if (hit_buffers_ != nullptr) {
+    // Referenced entries are in the LRU list with batched promotion
+    for (const LRUHandle* e = lru_.next; e != &lru_; e = e->next) {
+      if (e->HasRefs()) {
+        pinned_usage += e->total_charge;
+      }
+    }
+  }
+  return pinned_usage;
 }
 
 size_t LRUCacheShard::GetOccupancyCount() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return table_.GetOccupancyCount();
 }
 
 size_t LRUCacheShard::GetTableAddressCount() const {
-  DMutexLock l(mutex_);
+  ExclusiveLock l(*this);
   return size_t{1} << table_.GetLengthBits();
 }
 
@@ -639,11 +795,13 @@ void LRUCacheShard::AppendPrintableOptions(std::string& str) const {
   const int kBufferSize = 200;
   char buffer[kBufferSize];
   {
-    DMutexLock l(mutex_);
+    ExclusiveLock l(*this);
     snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
              high_pri_pool_ratio_);
     snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
              "    low_pri_pool_ratio: %.3lf\n", low_pri_pool_ratio_);
+    snprintf(buffer + strlen(buffer), kBufferSize - strlen(buffer),
+             "    batched_promotion: %d\n", hit_buffers_ != nullptr);
   }
   str.append(buffer);
 }
@@ -656,7 +814,7 @@ LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
                            /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           alloc, &eviction_callback_, opts.batched_promotion);
   });
 }
 
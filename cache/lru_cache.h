@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -17,7 +18,9 @@
 #include "port/malloc.h"
 #include "port/port.h"
 #include "util/autovector.h"
+#include "util/core_local.h"
 #include "util/distributed_mutex.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
@@ -46,6 +49,10 @@ namespace lru_cache {
 // possibly different value). To move from state 2 to state 1, use
 // LRUCacheShard::Lookup.
 // While refs > 0, public properties like value and deleter must not change.
+//
+// With LRUCacheOptions::batched_promotion, entries in the hash table are
+// always in the LRU list, referenced or not, and eviction skips the
+// referenced ones.
 
 struct LRUHandle : public Cache::Handle {
   Cache::ObjectPtr value;
@@ -58,7 +65,8 @@ struct LRUHandle : public Cache::Handle {
   // The hash of key(). Used for fast sharding and comparisons.
   uint32_t hash;
   // The number of external refs to this entry. The cache itself is not counted.
-  uint32_t refs;
+  // Atomic as it changes under the shared lock with batched promotion.
+  std::atomic<uint32_t> refs;
 
   // Mutable flags - access controlled by mutex
   // The m_ and M_ prefixes (and im_ and IM_ later) are to hopefully avoid
@@ -96,17 +104,17 @@ struct LRUHandle : public Cache::Handle {
   uint32_t GetHash() const { return hash; }
 
   // Increase the reference count by 1.
-  void Ref() { refs++; }
+  void Ref() { refs.fetch_add(1, std::memory_order_relaxed); }
 
   // Just reduce the reference count by 1. Return true if it was last reference.
   bool Unref() {
-    assert(refs > 0);
-    refs--;
-    return refs == 0;
+    uint32_t old_refs = refs.fetch_sub(1, std::memory_order_acq_rel);
+    assert(old_refs > 0);
+    return old_refs == 1;
   }
 
   // Return true if there are external refs, false otherwise.
-  bool HasRefs() const { return refs > 0; }
+  bool HasRefs() const { return refs.load(std::memory_order_acquire) > 0; }
 
   bool InCache() const { return m_flags & M_IN_CACHE; }
   bool IsHighPri() const { return im_flags & IM_IS_HIGH_PRI; }
@@ -271,7 +279,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                const Cache::EvictionCallback* eviction_callback);
+                const Cache::EvictionCallback* eviction_callback,
+                bool batched_promotion = false);
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -282,6 +291,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   static inline HashVal ComputeHash(const Slice& key, uint32_t seed) {
     return Lower32of64(GetSliceNPHash64(key, seed));
   }
+  static inline HashVal ReplaceShardingBits(HashCref hash, uint32_t piece,
+                                            uint32_t mask) {
+    return (hash & ~mask) | (piece & mask);
+  }
 
   // Separate from constructor so caller can easily make an array of LRUCache
   // if current usage is more than new capacity, the function will attempt to
@@ -351,6 +364,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
  private:
   friend class LRUCache;
+  class ExclusiveLock;
+
   // Insert an item into the hash table and, if handle is null, insert into
   // the LRU list. Older items are evicted as necessary. Frees `item` on
   // non-OK status.
@@ -371,6 +386,17 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   void NotifyEvicted(const autovector<LRUHandle*>& evicted_handles);
 
+  // With batched promotion, records a hit of `e` for ApplyHits(), under the
+  // shared lock. Returns true when the buffer just filled up, and the hits
+  // should be applied.
+  bool RecordHit(LRUHandle* e);
+
+  // With batched promotion, moves the entries recorded by RecordHit() to the
+  // head of the LRU list (or of their pool). Must be called under the
+  // exclusive lock before any entry is removed from the hash table, so that
+  // the buffers never point to freed entries.
+  void ApplyHits();
+
   LRUHandle* CreateHandle(const Slice& key, uint32_t hash,
                           Cache::ObjectPtr value,
                           const Cache::CacheItemHelper* helper, size_t charge);
@@ -436,6 +462,24 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   // don't mind mutex_ invoking the non-const actions.
   mutable DMutex mutex_;
 
+  // Used instead of mutex_ with batched promotion, where Lookup(), Ref() and
+  // most Release() calls only hold it in shared mode, so they can't modify
+  // the state above.
+  mutable port::RWMutex rw_mutex_;
+
+  static constexpr uint32_t kHitBufferSize = 16;
+
+  struct ALIGN_AS(CACHE_LINE_SIZE) HitBuffer {
+    // Number of hits recorded, which can go over kHitBufferSize while the
+    // buffer is full
+    std::atomic<uint32_t> size{0};
+    // Written under the shared lock, at distinct positions
+    LRUHandle* handles[kHitBufferSize];
+  };
+
+  // Only with batched promotion
+  std::unique_ptr<CoreLocalArray<HitBuffer>> hit_buffers_;
+
   // A reference to Cache::eviction_callback_
   const Cache::EvictionCallback& eviction_callback_;
 };
@@ -45,15 +45,16 @@ class LRUCacheTest : public testing::Test {
 
   void NewCache(size_t capacity, double high_pri_pool_ratio = 0.0,
                 double low_pri_pool_ratio = 1.0,
-                bool use_adaptive_mutex = kDefaultToAdaptiveMutex) {
+                bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+                bool batched_promotion = false) {
     DeleteCache();
     cache_ = static_cast<LRUCacheShard*>(
         port::cacheline_aligned_alloc(sizeof(LRUCacheShard)));
-    new (cache_) LRUCacheShard(capacity, /*strict_capacity_limit=*/false,
-                               high_pri_pool_ratio, low_pri_pool_ratio,
-                               use_adaptive_mutex, kDontChargeCacheMetadata,
-                               /*max_upper_hash_bits=*/24,
-                               /*allocator*/ nullptr, &eviction_callback_);
+    new (cache_) LRUCacheShard(
+        capacity, /*strict_capacity_limit=*/false, high_pri_pool_ratio,
+        low_pri_pool_ratio, use_adaptive_mutex, kDontChargeCacheMetadata,
+        /*max_upper_hash_bits=*/24,
+        /*allocator*/ nullptr, &eviction_callback_, batched_promotion);
   }
 
   void Insert(const std::string& key,
@@ -372,6 +373,111 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"x", "y", "g", "z", "d", "m"}, 2, 2, 2);
 }
 
+TEST_F(LRUCacheTest, BatchedPromotion) {
+  // Allocate 2 cache entries to high-pri pool and 3 to low-pri pool.
+  NewCache(5, /* high_pri_pool_ratio */ 0.40, /* low_pri_pool_ratio */ 0.60,
+           kDefaultToAdaptiveMutex, /* batched_promotion */ true);
+
+  Insert("a", Cache::Priority::LOW);
+  Insert("b", Cache::Priority::LOW);
+  Insert("c", Cache::Priority::LOW);
+  Insert("x", Cache::Priority::HIGH);
+  Insert("y", Cache::Priority::HIGH);
+  ValidateLRUList({"a", "b", "c", "x", "y"}, 2, 3);
+
+  // The recorded hits are applied before reading the LRU list, with the same
+  // effect as without batched promotion
+  ASSERT_TRUE(Lookup("a"));
+  ValidateLRUList({"b", "c", "x", "y", "a"}, 2, 3);
+
+  // And before evicting entries
+  ASSERT_TRUE(Lookup("b"));
+  Insert("d", Cache::Priority::LOW);
+  ValidateLRUList({"x", "y", "d", "a", "b"}, 2, 3);
+
+  // Many hits are applied without other operations
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(Lookup(i % 2 == 0 ? "x" : "y"));
+  }
+  ValidateLRUList({"d", "a", "b", "x", "y"}, 2, 3);
+}
+
+TEST_F(LRUCacheTest, BatchedPromotionReferencedEntries) {
+  NewCache(3, /* high_pri_pool_ratio */ 0.0, /* low_pri_pool_ratio */ 1.0,
+           kDefaultToAdaptiveMutex, /* batched_promotion */ true);
+
+  LRUHandle* handle = nullptr;
+  ASSERT_OK(cache_->Insert("a", 0 /*hash*/, nullptr /*value*/,
+                           &kNoopCacheItemHelper, 1 /*charge*/, &handle,
+                           Cache::Priority::LOW));
+  ASSERT_NE(handle, nullptr);
+  Insert("b");
+  Insert("c");
+  // Referenced entries stay in the LRU list, but are not evicted
+  ValidateLRUList({"a", "b", "c"}, 0, 3);
+  Insert("d");
+  ValidateLRUList({"a", "c", "d"}, 0, 3);
+  ASSERT_EQ(3, cache_->GetUsage());
+  ASSERT_EQ(1, cache_->GetPinnedUsage());
+
+  ASSERT_TRUE(cache_->Ref(handle));
+  ASSERT_FALSE(cache_->Release(handle, true /*useful*/, false /*erase*/));
+  ASSERT_EQ(1, cache_->GetPinnedUsage());
+
+  // Erased entries are freed by their last release
+  Erase("a");
+  ValidateLRUList({"c", "d"}, 0, 2);
+  ASSERT_EQ(3, cache_->GetUsage());
+  ASSERT_TRUE(cache_->Release(handle, true /*useful*/, false /*erase*/));
+  ASSERT_EQ(2, cache_->GetUsage());
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+
+  handle = cache_->Lookup("c", 0 /*hash*/, nullptr, nullptr,
+                          Cache::Priority::LOW, nullptr);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_TRUE(cache_->Release(handle, true /*useful*/, true /*erase*/));
+  ValidateLRUList({"d"}, 0, 1);
+  ASSERT_EQ(1, cache_->GetUsage());
+}
+
+TEST_F(LRUCacheTest, BatchedPromotionConcurrentOps) {
+  NewCache(64, /* high_pri_pool_ratio */ 0.5, /* low_pri_pool_ratio */ 0.0,
+           kDefaultToAdaptiveMutex, /* batched_promotion */ true);
+
+  std::vector<port::Thread> threads;
+  for (uint32_t t = 0; t < 8; t++) {
+    threads.emplace_back([this, t]() {
+      Random rnd(t);
+      for (int i = 0; i < 10000; i++) {
+        std::string key = std::to_string(rnd.Uniform(128));
+        switch (rnd.Uniform(8)) {
+          case 0:
+            Insert(key, Cache::Priority::HIGH);
+            break;
+          case 1:
+            Erase(key);
+            break;
+          case 2: {
+            auto handle = cache_->Lookup(key, 0 /*hash*/, nullptr, nullptr,
+                                         Cache::Priority::LOW, nullptr);
+            Lookup(key);
+            cache_->Release(handle, true /*useful*/, true /*erase*/);
+            break;
+          }
+          default:
+            Lookup(key);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, cache_->GetPinnedUsage());
+  ASSERT_EQ(cache_->GetUsage(), cache_->TEST_GetLRUSize());
+  ASSERT_LE(cache_->GetUsage(), 64);
+}
+
 namespace clock_cache {
 
 template <class ClockCache>
@@ -393,11 +499,13 @@ class ClockCacheTest : public testing::Test {
   }
 
   void NewShard(size_t capacity, bool strict_capacity_limit = true,
-                int eviction_effort_cap = 30) {
+                int eviction_effort_cap = 30,
+                bool frequency_admission = false) {
     DeleteShard();
     shard_ = static_cast<Shard*>(port::cacheline_aligned_alloc(sizeof(Shard)));
 
     TableOpts opts{1 /*value_size*/, eviction_effort_cap};
+    opts.frequency_admission = frequency_admission;
     new (shard_)
         Shard(capacity, strict_capacity_limit, kDontChargeCacheMetadata,
               /*allocator*/ nullptr, &eviction_callback_, &hash_seed_, opts);
@@ -741,6 +849,97 @@ TYPED_TEST(ClockCacheTest, ClockEvictionEffortCapTest) {
   }
 }
 
+TYPED_TEST(ClockCacheTest, FrequencyAdmissionTest) {
+  for (bool frequency_admission : {false, true}) {
+    SCOPED_TRACE("frequency_admission = " +
+                 std::to_string(frequency_admission));
+    constexpr size_t kCapacity = 6;
+    this->NewShard(kCapacity, /*strict_capacity_limit*/ false,
+                   /*eviction_effort_cap*/ 30, frequency_admission);
+    auto& shard = *this->shard_;
+
+    // A working set that is looked up often, but (for a quick test) without
+    // raising the clock countdowns
+    for (size_t i = 0; i < kCapacity; ++i) {
+      ASSERT_OK(this->Insert(this->CheapHash(i), Cache::Priority::BOTTOM));
+    }
+    for (int round = 0; round < 4; ++round) {
+      for (size_t i = 0; i < kCapacity; ++i) {
+        ASSERT_TRUE(this->Lookup(this->CheapHash(i), /*useful*/ false));
+      }
+    }
+
+    // A scan: each key is looked up once, missing, then inserted
+    constexpr size_t kScanCount = 40;
+    for (size_t i = 100; i < 100 + kScanCount; ++i) {
+      ASSERT_FALSE(this->Lookup(this->CheapHash(i)));
+      ASSERT_OK(this->Insert(this->CheapHash(i)));
+    }
+
+    size_t hot_count = 0;
+    for (size_t i = 0; i < kCapacity; ++i) {
+      hot_count += this->Lookup(this->CheapHash(i), /*useful*/ false);
+    }
+    size_t scan_count = 0;
+    for (size_t i = 100; i < 100 + kScanCount; ++i) {
+      scan_count += this->Lookup(this->CheapHash(i), /*useful*/ false);
+    }
+    if (frequency_admission) {
+      // The scan could not evict the more popular working set
+      EXPECT_EQ(hot_count, kCapacity);
+      EXPECT_EQ(scan_count, 0U);
+      EXPECT_EQ(shard.GetTable().GetAdmissionRejectedCount(), kScanCount);
+    } else {
+      EXPECT_EQ(hot_count, 0U);
+      EXPECT_GT(scan_count, 0U);
+      EXPECT_EQ(shard.GetTable().GetAdmissionRejectedCount(), 0U);
+    }
+    EXPECT_LE(shard.GetUsage(), kCapacity);
+
+    // A key more popular than the working set is admitted
+    UniqueId64x2 popular = this->CheapHash(1000);
+    for (int round = 0; round < 8; ++round) {
+      ASSERT_FALSE(this->Lookup(popular));
+    }
+    ASSERT_OK(this->Insert(popular));
+    EXPECT_TRUE(this->Lookup(popular));
+  }
+}
+
+TEST(ClockFrequencySketchTest, IncrementAndAge) {
+  ClockFrequencySketch sketch(/*num_slots*/ 100);
+  UniqueId64x2 hot{0x1234567890ABCDEFU, 0xFEDCBA0987654321U};
+  UniqueId64x2 cold{0x1111111111111111U, 0x2222222222222222U};
+  EXPECT_EQ(sketch.Estimate(hot), 0U);
+  for (int i = 0; i < 8; ++i) {
+    sketch.Increment(hot);
+  }
+  sketch.Increment(cold);
+  EXPECT_EQ(sketch.Estimate(hot), 8U);
+  EXPECT_EQ(sketch.Estimate(cold), 1U);
+
+  // Saturates
+  for (int i = 0; i < 20; ++i) {
+    sketch.Increment(hot);
+  }
+  EXPECT_EQ(sketch.Estimate(hot), 15U);
+
+  // Not enough insertions yet to age
+  sketch.MaybeAge();
+  EXPECT_EQ(sketch.Estimate(hot), 15U);
+
+  // Sized to 256 counters per row, so halved after 128 insertions
+  for (int i = 0; i < 128; ++i) {
+    sketch.IncrementForInsert(cold);
+  }
+  EXPECT_EQ(sketch.Estimate(cold), 15U);
+  sketch.MaybeAge();
+  EXPECT_EQ(sketch.Estimate(hot), 7U);
+  EXPECT_EQ(sketch.Estimate(cold), 7U);
+  sketch.MaybeAge();
+  EXPECT_EQ(sketch.Estimate(hot), 7U);
+}
+
 namespace {
 struct DeleteCounter {
   int deleted = 0;
@@ -1551,6 +1750,95 @@ TEST_P(BasicSecondaryCacheTest, FullCapacityTest) {
 // efficiency) so can demote the over-capacity item to secondary cache. Also, we
 // intend to add support for demotion in Release, but that currently causes too
 // much unit test churn.
+class LRUCacheNumaTest : public testing::Test,
+                         public secondary_cache_test_util::WithCacheType {
+ public:
+  const std::string& Type() const override {
+    static const std::string type = kLRU;
+    return type;
+  }
+
+  std::string LookupValue(Cache* cache, const Slice& key) {
+    Cache::Handle* handle = cache->Lookup(key, GetHelper(), this);
+    if (handle == nullptr) {
+      return "";
+    }
+    std::string value =
+        static_cast<TestItem*>(cache->Value(handle))->ToString();
+    cache->Release(handle);
+    return value;
+  }
+
+  Status InsertValue(Cache* cache, const Slice& key, const std::string& value) {
+    return cache->Insert(key, new TestItem(value.data(), value.size()),
+                         GetHelper(), value.size());
+  }
+};
+
+TEST_F(LRUCacheNumaTest, LocalFirstAndReplication) {
+  int current_node = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ShardedCacheBase::DetermineNumaNodeBits",
+      [](void* arg) { *static_cast<int*>(arg) = 2; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "ShardedCacheBase::GetCurrentNumaNode",
+      [&](void* arg) { *static_cast<int*>(arg) = current_node; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  LRUCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 2;
+  opts.numa_aware = true;
+  opts.numa_replication_threshold = 2;
+  opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  std::shared_ptr<Cache> cache = opts.MakeSharedCache();
+  auto* sharded = static_cast_with_check<ShardedCacheBase>(cache.get());
+  ASSERT_EQ(sharded->GetNumNumaNodes(), 2U);
+
+  CacheKey key = CacheKey::CreateUniqueForCacheLifetime(cache.get());
+  ASSERT_OK(InsertValue(cache.get(), key.AsSlice(), "value1"));
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "value1");
+  ASSERT_EQ(sharded->GetNumaStats().local_hits, 1U);
+
+  // Remote hits from the other node, until the entry is hot enough to be
+  // copied there
+  current_node = 1;
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "value1");
+  ASSERT_EQ(sharded->GetNumaStats().replications, 0U);
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "value1");
+  ASSERT_EQ(sharded->GetNumaStats().remote_hits, 2U);
+  ASSERT_EQ(sharded->GetNumaStats().replications, 1U);
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "value1");
+  ASSERT_EQ(sharded->GetNumaStats().local_hits, 2U);
+  ASSERT_EQ(cache->GetUsage(), 2 * std::string("value1").size());
+
+  // Insert replaces the copies on all nodes
+  current_node = 0;
+  ASSERT_OK(InsertValue(cache.get(), key.AsSlice(), "value2"));
+  current_node = 1;
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "value2");
+  ASSERT_EQ(sharded->GetNumaStats().remote_hits, 3U);
+
+  // Not replicated by lookups without a helper
+  for (int i = 0; i < 3; i++) {
+    Cache::Handle* handle = cache->Lookup(key.AsSlice());
+    ASSERT_NE(handle, nullptr);
+    cache->Release(handle);
+  }
+  ASSERT_EQ(sharded->GetNumaStats().replications, 1U);
+
+  // Erase removes all copies
+  cache->Erase(key.AsSlice());
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "");
+  current_node = 0;
+  ASSERT_EQ(LookupValue(cache.get(), key.AsSlice()), "");
+  ASSERT_EQ(sharded->GetNumaStats().misses, 2U);
+  ASSERT_EQ(cache->GetUsage(), 0U);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheCorrectness1) {
   if (IsHyperClock()) {
     // See CORRECTION above
@@ -0,0 +1,226 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/quota_cache.h"
+
+#include <functional>
+
+#include "cache/cache_entry_roles.h"
+#include "monitoring/statistics_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// The object inserted in the shared cache for an entry of a QuotaCache
+struct QuotaCacheEntry {
+  Cache::ObjectPtr obj;
+  const Cache::CacheItemHelper* helper;
+  size_t charge;
+  std::shared_ptr<QuotaCache::Usage> usage;
+};
+
+void DeleteEntry(Cache::ObjectPtr obj, MemoryAllocator* allocator) {
+  auto* entry = static_cast<QuotaCacheEntry*>(obj);
+  if (entry->helper->del_cb) {
+    entry->helper->del_cb(entry->obj, allocator);
+  }
+  entry->usage->Release(entry->helper->role, entry->charge);
+  delete entry;
+}
+
+size_t EntrySize(Cache::ObjectPtr obj) {
+  auto* entry = static_cast<QuotaCacheEntry*>(obj);
+  return entry->helper->size_cb(entry->obj);
+}
+
+Status SaveEntry(Cache::ObjectPtr from_obj, size_t from_offset, size_t length,
+                 char* out_buf) {
+  auto* entry = static_cast<QuotaCacheEntry*>(from_obj);
+  return entry->helper->saveto_cb(entry->obj, from_offset, length, out_buf);
+}
+
+Status CreateEntry(const Slice& /*data*/, CompressionType /*type*/,
+                   CacheTier /*source*/, Cache::CreateContext* /*context*/,
+                   MemoryAllocator* /*allocator*/, Cache::ObjectPtr* /*out_obj*/,
+                   size_t* /*out_charge*/) {
+  // Lookups through a QuotaCache pass the helper of the caller, whose
+  // create_cb is used to promote entries from a secondary cache.
+  return Status::NotSupported("Cannot create a QuotaCache entry");
+}
+
+struct QuotaCacheHelpers {
+  std::array<Cache::CacheItemHelper, kNumCacheEntryRoles> basic;
+  std::array<Cache::CacheItemHelper, kNumCacheEntryRoles> secondary_compat;
+
+  QuotaCacheHelpers() {
+    for (uint32_t i = 0; i < kNumCacheEntryRoles; ++i) {
+      CacheEntryRole role = static_cast<CacheEntryRole>(i);
+      basic[i] = Cache::CacheItemHelper(role, &DeleteEntry);
+      // Not the temporary
+      basic[i].without_secondary_compat = &basic[i];
+      secondary_compat[i] =
+          Cache::CacheItemHelper(role, &DeleteEntry, &EntrySize, &SaveEntry,
+                                 &CreateEntry, &basic[i]);
+    }
+  }
+
+  bool Contains(const Cache::CacheItemHelper* helper) const {
+    std::less<const Cache::CacheItemHelper*> less;
+    return (!less(helper, basic.data()) &&
+            less(helper, basic.data() + basic.size())) ||
+           (!less(helper, secondary_compat.data()) &&
+            less(helper, secondary_compat.data() + secondary_compat.size()));
+  }
+};
+
+const QuotaCacheHelpers& GetQuotaCacheHelpers() {
+  static const QuotaCacheHelpers helpers;
+  return helpers;
+}
+
+}  // namespace
+
+QuotaCache::QuotaCache(const QuotaCacheOptions& opts)
+    : CacheWrapper(opts.cache),
+      opts_(opts),
+      role_quotas_(),
+      usage_(std::make_shared<Usage>()) {
+  for (const auto& role_quota : opts.role_quotas) {
+    role_quotas_[static_cast<size_t>(role_quota.first)] = role_quota.second;
+  }
+}
+
+QuotaCache::Admission QuotaCache::Charge(CacheEntryRole role, size_t charge) {
+  const CacheQuota& role_quota = role_quotas_[static_cast<size_t>(role)];
+  size_t total_usage = usage_->total.FetchAddRelaxed(charge) + charge;
+  size_t role_usage =
+      usage_->roles[static_cast<size_t>(role)].FetchAddRelaxed(charge) +
+      charge;
+  auto exceeds = [](size_t usage, size_t limit) {
+    return limit > 0 && usage > limit;
+  };
+
+  Admission admission = Admission::kAdmit;
+  if (exceeds(total_usage, opts_.total.hard_limit) ||
+      exceeds(role_usage, role_quota.hard_limit)) {
+    admission = Admission::kReject;
+  } else if (exceeds(total_usage, opts_.total.soft_limit) ||
+             exceeds(role_usage, role_quota.soft_limit)) {
+    // Only borrow capacity that no other user of the cache needs right now
+    if (target_->GetUsage() + charge <= target_->GetCapacity()) {
+      admission = Admission::kBorrow;
+    } else {
+      admission = Admission::kReject;
+    }
+  }
+  if (admission == Admission::kReject) {
+    usage_->Release(role, charge);
+  }
+  return admission;
+}
+
+Status QuotaCache::Insert(const Slice& key, ObjectPtr obj,
+                          const CacheItemHelper* helper, size_t charge,
+                          Handle** handle, Priority priority,
+                          const Slice& compressed_val, CompressionType type) {
+  const CacheEntryRole role = helper->role;
+  if (role == CacheEntryRole::kMisc) {
+    // Not subject to quotas, and might be shared with users of the cache not
+    // going through this QuotaCache (e.g. CacheEntryStatsCollector), so it
+    // must not be wrapped.
+    return target_->Insert(key, obj, helper, charge, handle, priority,
+                           compressed_val, type);
+  }
+  Admission admission = Charge(role, charge);
+  if (admission == Admission::kReject) {
+    rejected_count_.FetchAddRelaxed(1);
+    RecordTick(opts_.statistics.get(), BLOCK_CACHE_QUOTA_REJECTED);
+    if (handle == nullptr) {
+      // As if inserted and immediately evicted
+      if (helper->del_cb) {
+        helper->del_cb(obj, target_->memory_allocator());
+      }
+      return Status::OK();
+    }
+    // Give the caller a handle to an entry kept out of the cache. Like a
+    // HyperClockCache insertion that could not go into its table, this is
+    // reported with OkOverwritten.
+    *handle = target_->CreateStandalone(key, obj, helper, charge,
+                                        /*allow_uncharged=*/true);
+    if (*handle == nullptr) {
+      return Status::MemoryLimit("Insert failed because of cache quota");
+    }
+    return Status::OkOverwritten();
+  }
+  if (admission == Admission::kBorrow) {
+    // Evicted first when the capacity is needed back
+    priority = Priority::BOTTOM;
+    borrowed_count_.FetchAddRelaxed(1);
+    RecordTick(opts_.statistics.get(), BLOCK_CACHE_QUOTA_BORROWED);
+  }
+
+  const QuotaCacheHelpers& helpers = GetQuotaCacheHelpers();
+  const size_t role_index = static_cast<size_t>(role);
+  const CacheItemHelper* entry_helper =
+      helper->IsSecondaryCacheCompatible()
+          ? &helpers.secondary_compat[role_index]
+          : &helpers.basic[role_index];
+  auto* entry = new QuotaCacheEntry{obj, helper, charge, usage_};
+  Status s = target_->Insert(key, entry, entry_helper, charge, handle,
+                             priority, compressed_val, type);
+  if (!s.ok()) {
+    // The caller keeps the ownership of obj
+    usage_->Release(role, charge);
+    delete entry;
+  }
+  return s;
+}
+
+Cache::ObjectPtr QuotaCache::Value(Handle* handle) {
+  ObjectPtr value = target_->Value(handle);
+  if (GetQuotaCacheHelpers().Contains(target_->GetCacheItemHelper(handle))) {
+    return static_cast<QuotaCacheEntry*>(value)->obj;
+  }
+  return value;
+}
+
+const Cache::CacheItemHelper* QuotaCache::GetCacheItemHelper(
+    Handle* handle) const {
+  const CacheItemHelper* helper = target_->GetCacheItemHelper(handle);
+  if (GetQuotaCacheHelpers().Contains(helper)) {
+    return static_cast<QuotaCacheEntry*>(target_->Value(handle))->helper;
+  }
+  return helper;
+}
+
+void QuotaCache::GetQuotaStats(
+    std::map<std::string, std::string>* values) const {
+  auto add = [values](const std::string& part, size_t usage,
+                      const CacheQuota& quota) {
+    (*values)[part + ".usage"] = std::to_string(usage);
+    (*values)[part + ".soft-limit"] = std::to_string(quota.soft_limit);
+    (*values)[part + ".hard-limit"] = std::to_string(quota.hard_limit);
+  };
+  add("total", usage_->total.LoadRelaxed(), opts_.total);
+  for (uint32_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    size_t usage = usage_->roles[i].LoadRelaxed();
+    const CacheQuota& quota = role_quotas_[i];
+    if (usage > 0 || quota.soft_limit > 0 || quota.hard_limit > 0) {
+      add(kCacheEntryRoleToHyphenString[i], usage, quota);
+    }
+  }
+  (*values)["borrowed"] = std::to_string(borrowed_count_.LoadRelaxed());
+  (*values)["rejected"] = std::to_string(rejected_count_.LoadRelaxed());
+}
+
+std::shared_ptr<Cache> NewQuotaCache(const QuotaCacheOptions& opts) {
+  if (opts.cache == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<QuotaCache>(opts);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,91 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A view of a cache shared with other QuotaCaches (see NewQuotaCache()),
+// limiting the usage of the entries inserted through it, in total and per
+// CacheEntryRole.
+//
+// To know when its entries leave the shared cache, QuotaCache inserts them
+// with an object wrapping the caller's object, helper and charge, and with a
+// helper of its own (per role, and with or without secondary cache support)
+// whose callbacks unwrap the object, forward to the caller's helper and
+// release the usage. Value() and GetCacheItemHelper() unwrap, so that users
+// of the cache only see their own objects and helpers. Entries created
+// otherwise, like the standalone handles returned for rejected insertions or
+// entries promoted from a secondary cache, are not wrapped and not counted.
+// Neither are entries with role kMisc, which can be shared by all the users
+// of the cache.
+class QuotaCache : public CacheWrapper {
+ public:
+  explicit QuotaCache(const QuotaCacheOptions& opts);
+
+  static const char* kClassName() { return "QuotaCache"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(
+      const Slice& key, ObjectPtr obj, const CacheItemHelper* helper,
+      size_t charge, Handle** handle = nullptr,
+      Priority priority = Priority::LOW, const Slice& compressed_val = Slice(),
+      CompressionType type = CompressionType::kNoCompression) override;
+
+  ObjectPtr Value(Handle* handle) override;
+
+  const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
+
+  // Adds the usage and limits of this cache to `values`, with keys
+  // "<part>.usage", "<part>.soft-limit" and "<part>.hard-limit", where
+  // <part> is "total" or the hyphenated name of a role with a quota or some
+  // usage, plus the counts of "borrowed" and "rejected" insertions.
+  void GetQuotaStats(std::map<std::string, std::string>* values) const;
+
+  size_t GetQuotaUsage() const { return usage_->total.LoadRelaxed(); }
+
+  size_t GetQuotaUsage(CacheEntryRole role) const {
+    return usage_->roles[static_cast<size_t>(role)].LoadRelaxed();
+  }
+
+  // Usage of the entries inserted through a QuotaCache. Shared with the
+  // entries, which can outlive the QuotaCache.
+  struct Usage {
+    RelaxedAtomic<size_t> total{};
+    std::array<RelaxedAtomic<size_t>, kNumCacheEntryRoles> roles;
+
+    void Release(CacheEntryRole role, size_t charge) {
+      total.FetchSubRelaxed(charge);
+      roles[static_cast<size_t>(role)].FetchSubRelaxed(charge);
+    }
+  };
+
+ private:
+  enum class Admission {
+    kAdmit,
+    kBorrow,
+    kReject,
+  };
+
+  // Charges the entry to the usage if the quotas allow inserting it.
+  Admission Charge(CacheEntryRole role, size_t charge);
+
+  const QuotaCacheOptions opts_;
+  std::array<CacheQuota, kNumCacheEntryRoles> role_quotas_;
+  std::shared_ptr<Usage> usage_;
+  RelaxedAtomic<uint64_t> borrowed_count_{};
+  RelaxedAtomic<uint64_t> rejected_count_{};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,214 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/quota_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/statistics.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::GetTestingCacheTypes;
+using secondary_cache_test_util::WithCacheTypeParam;
+
+class QuotaCacheTest : public testing::Test, public WithCacheTypeParam {
+ public:
+  static constexpr size_t kValueSize = 1000;
+
+  QuotaCacheTest() { estimated_value_size_ = kValueSize; }
+
+  void NewCaches(size_t capacity, const CacheQuota& total,
+                 std::map<CacheEntryRole, CacheQuota> role_quotas = {}) {
+    cache_ = NewCache(capacity, /*num_shard_bits*/ 0,
+                      /*strict_capacity_limit*/ false);
+    statistics_ = CreateDBStatistics();
+    QuotaCacheOptions opts;
+    opts.cache = cache_;
+    opts.total = total;
+    opts.role_quotas = std::move(role_quotas);
+    opts.statistics = statistics_;
+    quota_cache_ = NewQuotaCache(opts);
+    ASSERT_NE(quota_cache_, nullptr);
+  }
+
+  // 16 bytes for HCC compatibility
+  static std::string Key(int i) {
+    std::string key;
+    PutFixed64(&key, 0x1234);
+    PutFixed64(&key, static_cast<uint64_t>(i));
+    return key;
+  }
+
+  static TestItem* NewItem(int i) {
+    std::string value(kValueSize, static_cast<char>('a' + i % 26));
+    return new TestItem(value.data(), value.size());
+  }
+
+  Status Insert(Cache* cache, int i,
+                CacheEntryRole role = CacheEntryRole::kDataBlock,
+                Cache::Handle** handle = nullptr) {
+    TestItem* item = NewItem(i);
+    Status s =
+        cache->Insert(Key(i), item, GetHelper(role), kValueSize, handle);
+    if (!s.ok()) {
+      delete item;
+    }
+    return s;
+  }
+
+  bool Contains(int i) {
+    Cache::Handle* handle = cache_->Lookup(Key(i));
+    if (handle == nullptr) {
+      return false;
+    }
+    cache_->Release(handle);
+    return true;
+  }
+
+  QuotaCache& GetQuotaCache() {
+    return *static_cast<QuotaCache*>(quota_cache_.get());
+  }
+
+  std::shared_ptr<Cache> cache_;
+  std::shared_ptr<Cache> quota_cache_;
+  std::shared_ptr<Statistics> statistics_;
+};
+
+TEST_P(QuotaCacheTest, HardLimit) {
+  NewCaches(100 * kValueSize, CacheQuota{0, 20 * kValueSize},
+            {{CacheEntryRole::kDataBlock, CacheQuota{0, 10 * kValueSize}}});
+  QuotaCache& quota_cache = GetQuotaCache();
+
+  for (int i = 0; i < 15; ++i) {
+    ASSERT_OK(Insert(quota_cache_.get(), i));
+  }
+  EXPECT_EQ(quota_cache.GetQuotaUsage(CacheEntryRole::kDataBlock),
+            10 * kValueSize);
+  for (int i = 0; i < 15; ++i) {
+    EXPECT_EQ(Contains(i), i < 10);
+  }
+  EXPECT_EQ(statistics_->getTickerCount(BLOCK_CACHE_QUOTA_REJECTED), 5);
+
+  // Other roles are only limited by the total
+  for (int i = 100; i < 115; ++i) {
+    ASSERT_OK(Insert(quota_cache_.get(), i, CacheEntryRole::kIndexBlock));
+  }
+  EXPECT_EQ(quota_cache.GetQuotaUsage(CacheEntryRole::kIndexBlock),
+            10 * kValueSize);
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 20 * kValueSize);
+
+  // Entries inserted directly into the shared cache are not limited
+  for (int i = 200; i < 230; ++i) {
+    ASSERT_OK(Insert(cache_.get(), i));
+    EXPECT_TRUE(Contains(i));
+  }
+
+  // Usage is released when entries leave the cache
+  cache_->Erase(Key(0));
+  EXPECT_EQ(quota_cache.GetQuotaUsage(CacheEntryRole::kDataBlock),
+            9 * kValueSize);
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 19 * kValueSize);
+  ASSERT_OK(Insert(quota_cache_.get(), 42));
+  EXPECT_TRUE(Contains(42));
+
+  std::map<std::string, std::string> values;
+  quota_cache.GetQuotaStats(&values);
+  EXPECT_EQ(values["total.usage"], std::to_string(20 * kValueSize));
+  EXPECT_EQ(values["total.hard-limit"], std::to_string(20 * kValueSize));
+  EXPECT_EQ(values["data-block.usage"], std::to_string(10 * kValueSize));
+  EXPECT_EQ(values["data-block.hard-limit"], std::to_string(10 * kValueSize));
+  EXPECT_EQ(values["index-block.soft-limit"], "0");
+  EXPECT_EQ(values.count("filter-block.usage"), 0);
+  EXPECT_EQ(values["rejected"], "10");
+  EXPECT_EQ(values["borrowed"], "0");
+
+  cache_->EraseUnRefEntries();
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 0);
+}
+
+TEST_P(QuotaCacheTest, RejectedWithHandle) {
+  NewCaches(100 * kValueSize, CacheQuota{0, 1 * kValueSize});
+
+  Cache::Handle* handle1 = nullptr;
+  ASSERT_OK(Insert(quota_cache_.get(), 1, CacheEntryRole::kDataBlock,
+                   &handle1));
+  ASSERT_NE(handle1, nullptr);
+  // The cache user sees its own object and helper
+  EXPECT_EQ(static_cast<TestItem*>(quota_cache_->Value(handle1))->ToString(),
+            std::string(kValueSize, 'b'));
+  EXPECT_EQ(quota_cache_->GetCacheItemHelper(handle1), GetHelper());
+
+  // Over the hard limit: a standalone handle, not in the cache
+  Cache::Handle* handle2 = nullptr;
+  Status s =
+      Insert(quota_cache_.get(), 2, CacheEntryRole::kDataBlock, &handle2);
+  ASSERT_OK(s);
+  EXPECT_TRUE(s.IsOkOverwritten());
+  ASSERT_NE(handle2, nullptr);
+  EXPECT_EQ(static_cast<TestItem*>(quota_cache_->Value(handle2))->ToString(),
+            std::string(kValueSize, 'c'));
+  EXPECT_EQ(quota_cache_->GetCacheItemHelper(handle2), GetHelper());
+  EXPECT_FALSE(Contains(2));
+
+  quota_cache_->Release(handle1);
+  quota_cache_->Release(handle2);
+  EXPECT_TRUE(Contains(1));
+  EXPECT_FALSE(Contains(2));
+  EXPECT_EQ(GetQuotaCache().GetQuotaUsage(), 1 * kValueSize);
+}
+
+TEST_P(QuotaCacheTest, SoftLimitBorrowing) {
+  NewCaches(20 * kValueSize, CacheQuota{5 * kValueSize, 0});
+  QuotaCache& quota_cache = GetQuotaCache();
+
+  // The shared cache is idle, so the soft limit can be exceeded
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Insert(quota_cache_.get(), i));
+    EXPECT_TRUE(Contains(i));
+  }
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 10 * kValueSize);
+  EXPECT_EQ(statistics_->getTickerCount(BLOCK_CACHE_QUOTA_BORROWED), 5);
+
+  // Other users of the cache take the capacity back
+  for (int i = 0; i < 10; ++i) {
+    cache_->Erase(Key(i));
+  }
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 0);
+  std::vector<Cache::Handle*> handles(15);
+  for (int i = 0; i < 15; ++i) {
+    ASSERT_OK(Insert(cache_.get(), 100 + i, CacheEntryRole::kDataBlock,
+                     &handles[i]));
+  }
+
+  // Up to the soft limit, but no more borrowing while the cache is full
+  for (int i = 10; i < 20; ++i) {
+    ASSERT_OK(Insert(quota_cache_.get(), i));
+  }
+  EXPECT_EQ(quota_cache.GetQuotaUsage(), 5 * kValueSize);
+  EXPECT_EQ(statistics_->getTickerCount(BLOCK_CACHE_QUOTA_BORROWED), 5);
+  EXPECT_EQ(statistics_->getTickerCount(BLOCK_CACHE_QUOTA_REJECTED), 5);
+
+  for (auto* handle : handles) {
+    cache_->Release(handle);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(QuotaCacheTest, QuotaCacheTest,
+                        GetTestingCacheTypes());
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
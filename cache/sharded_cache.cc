@@ -13,8 +13,13 @@
 #include <cstdint>
 #include <memory>
 
+#ifdef NUMA
+#include <numa.h>
+#endif
+
 #include "env/unique_id_gen.h"
 #include "rocksdb/env.h"
+#include "test_util/sync_point.h"
 #include "util/hash.h"
 #include "util/math.h"
 #include "util/mutexlock.h"
@@ -55,6 +60,26 @@ uint32_t DetermineSeed(int32_t hash_seed_option) {
     return val & kSeedMask;
   }
 }
+
+// Shards are divided evenly among a power of two number of NUMA nodes
+int DetermineNumaNodeBits(const ShardedCacheOptions& opts) {
+  if (!opts.numa_aware) {
+    return 0;
+  }
+  int num_nodes = 1;
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    num_nodes = numa_num_configured_nodes();
+  }
+#endif
+  TEST_SYNC_POINT_CALLBACK("ShardedCacheBase::DetermineNumaNodeBits",
+                           &num_nodes);
+  int bits = 0;
+  while (bits < opts.num_shard_bits && (2 << bits) <= num_nodes) {
+    ++bits;
+  }
+  return bits;
+}
 }  // namespace
 
 ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
@@ -63,7 +88,14 @@ ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
       shard_mask_((uint32_t{1} << opts.num_shard_bits) - 1),
       hash_seed_(DetermineSeed(opts.hash_seed)),
       strict_capacity_limit_(opts.strict_capacity_limit),
-      capacity_(opts.capacity) {}
+      capacity_(opts.capacity),
+      numa_node_bits_(DetermineNumaNodeBits(opts)),
+      numa_shard_bits_(opts.num_shard_bits - numa_node_bits_),
+      numa_replication_threshold_(opts.numa_replication_threshold) {
+  if (numa_node_bits_ > 0) {
+    numa_nodes_.reset(new NumaNodeData[GetNumNumaNodes()]);
+  }
+}
 
 size_t ShardedCacheBase::ComputePerShardCapacity(size_t capacity) const {
   uint32_t num_shards = GetNumShards();
@@ -126,6 +158,61 @@ std::string ShardedCacheBase::GetPrintableOptions() const {
   return ret;
 }
 
+ShardedCacheBase::NumaStats ShardedCacheBase::GetNumaStats() const {
+  NumaStats stats;
+  for (uint32_t i = 0; numa_nodes_ && i < GetNumNumaNodes(); i++) {
+    const NumaNodeData& node_data = numa_nodes_[i];
+    stats.local_hits += node_data.local_hits.LoadRelaxed();
+    stats.remote_hits += node_data.remote_hits.LoadRelaxed();
+    stats.misses += node_data.misses.LoadRelaxed();
+    stats.replications += node_data.replications.LoadRelaxed();
+  }
+  return stats;
+}
+
+uint32_t ShardedCacheBase::GetCurrentNumaNode() const {
+  int node = 0;
+#ifdef NUMA
+  int cpu = port::PhysicalCoreID();
+  if (cpu >= 0) {
+    node = std::max(numa_node_of_cpu(cpu), 0);
+  }
+#endif
+  TEST_SYNC_POINT_CALLBACK("ShardedCacheBase::GetCurrentNumaNode", &node);
+  return static_cast<uint32_t>(node) & (GetNumNumaNodes() - 1);
+}
+
+void ShardedCacheBase::SetPreferredNumaNode(uint32_t node) {
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    numa_set_preferred(static_cast<int>(node));
+  }
+#else
+  (void)node;
+#endif
+}
+
+void ShardedCacheBase::ResetNumaMemoryPolicy() {
+#ifdef NUMA
+  if (numa_available() >= 0) {
+    numa_set_localalloc();
+  }
+#endif
+}
+
+bool ShardedCacheBase::ShouldReplicate(uint32_t node, uint32_t hash_piece) {
+  uint32_t slot = (hash_piece * 0x9E3779B9U) >> (32 - kNumaHotKeyBits);
+  auto& count = numa_nodes_[node].remote_hit_counts[slot];
+  // Racy, but only needs to be approximate
+  uint32_t new_count = count.LoadRelaxed() + 1U;
+  if (new_count >= numa_replication_threshold_) {
+    count.StoreRelaxed(0);
+    return true;
+  }
+  count.StoreRelaxed(static_cast<uint8_t>(std::min(new_count, 255U)));
+  return false;
+}
+
 int GetDefaultCacheShardBits(size_t capacity, size_t min_shard_size) {
   int num_shard_bits = 0;
   size_t num_shards = capacity / min_shard_size;
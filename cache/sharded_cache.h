@@ -9,13 +9,16 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "port/lang.h"
 #include "port/port.h"
 #include "rocksdb/advanced_cache.h"
+#include "util/atomic.h"
 #include "util/hash.h"
 #include "util/mutexlock.h"
 
@@ -40,6 +43,17 @@ class CacheShardBase {
   static inline uint32_t HashPieceForSharding(HashCref hash) {
     return Lower32of64(hash);
   }
+  // Returns `hash` with the bits of HashPieceForSharding() selected by `mask`
+  // replaced by those of `piece`. Only needed if !kKeyFromHash.
+  static inline HashVal ReplaceShardingBits(HashCref hash, uint32_t piece,
+                                            uint32_t mask) {
+    return (hash & ~uint64_t{mask}) | (piece & mask);
+  }
+  // Whether the key of an entry is recovered from its hash rather than
+  // stored. Otherwise, ShardedCache can place an entry in another shard than
+  // the one its key hashes to (see ShardedCacheOptions::numa_aware), by
+  // changing the sharding bits of its hash.
+  static constexpr bool kKeyFromHash = false;
   void AppendPrintableOptions(std::string& /*str*/) const {}
 
   // Must be provided for concept CacheShard (TODO with C++20 support)
@@ -108,11 +122,39 @@ class ShardedCacheBase : public Cache {
 
   uint32_t GetHashSeed() const override { return hash_seed_; }
 
+  // See ShardedCacheOptions::numa_aware. 1 if not NUMA aware.
+  uint32_t GetNumNumaNodes() const { return uint32_t{1} << numa_node_bits_; }
+
+  // Lookups by NUMA locality, summed over nodes. Only counted for caches that
+  // place entries on the node of the inserting thread.
+  struct NumaStats {
+    uint64_t local_hits = 0;
+    uint64_t remote_hits = 0;
+    uint64_t misses = 0;
+    // Entries copied to the local node after remote hits
+    uint64_t replications = 0;
+  };
+  NumaStats GetNumaStats() const;
+
  protected:  // fns
   virtual void AppendPrintableOptions(std::string& str) const = 0;
   size_t GetPerShardCapacity() const;
   size_t ComputePerShardCapacity(size_t capacity) const;
 
+  // NUMA node of the calling thread, in [0, GetNumNumaNodes())
+  uint32_t GetCurrentNumaNode() const;
+  // Shards are divided among NUMA nodes in contiguous ranges
+  uint32_t GetShardNumaNode(uint32_t shard) const {
+    return shard >> numa_shard_bits_;
+  }
+  // Until ResetNumaMemoryPolicy(), new memory pages touched by the calling
+  // thread are preferably allocated on `node`
+  static void SetPreferredNumaNode(uint32_t node);
+  static void ResetNumaMemoryPolicy();
+  // Counts a hit from `node` on an entry in another node's shard, returning
+  // true when the entry has been hit often enough to replicate it on `node`
+  bool ShouldReplicate(uint32_t node, uint32_t hash_piece);
+
  protected:                        // data
   std::atomic<uint64_t> last_id_;  // For NewId
   const uint32_t shard_mask_;
@@ -122,6 +164,24 @@ class ShardedCacheBase : public Cache {
   bool strict_capacity_limit_;
   size_t capacity_;
   mutable port::Mutex config_mutex_;
+
+  // NUMA awareness. numa_node_bits_ == 0 if not NUMA aware.
+  const int numa_node_bits_;
+  const int numa_shard_bits_;  // Bits of shard index within a node
+  const uint32_t numa_replication_threshold_;
+
+  static constexpr int kNumaHotKeyBits = 10;
+  // Per node data, updated by the threads of that node
+  struct ALIGN_AS(CACHE_LINE_SIZE) NumaNodeData {
+    RelaxedAtomic<uint64_t> local_hits{};
+    RelaxedAtomic<uint64_t> remote_hits{};
+    RelaxedAtomic<uint64_t> misses{};
+    RelaxedAtomic<uint64_t> replications{};
+    // Saturating counts of remote hits, by hash of the key
+    std::array<RelaxedAtomic<uint8_t>, size_t{1} << kNumaHotKeyBits>
+        remote_hit_counts;
+  };
+  std::unique_ptr<NumaNodeData[]> numa_nodes_;
 };
 
 // Generic cache interface that shards cache by hash of keys. 2^num_shard_bits
@@ -180,6 +240,19 @@ class ShardedCache : public ShardedCacheBase {
       CompressionType /*type*/ = CompressionType::kNoCompression) override {
     assert(helper);
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (!CacheShard::kKeyFromHash) {
+      if (numa_node_bits_ > 0) {
+        // Into a shard of the local node, replacing the copies on other nodes
+        const uint32_t node = GetCurrentNumaNode();
+        for (uint32_t n = 0; n < GetNumNumaNodes(); n++) {
+          if (n != node) {
+            HashVal remote_hash = GetNumaHash(hash, n);
+            GetShard(remote_hash).Erase(key, remote_hash);
+          }
+        }
+        hash = GetNumaHash(hash, node);
+      }
+    }
     auto h_out = reinterpret_cast<HandleImpl**>(handle);
     return GetShard(hash).Insert(key, hash, obj, helper, charge, h_out,
                                  priority);
@@ -190,6 +263,11 @@ class ShardedCache : public ShardedCacheBase {
                            bool allow_uncharged) override {
     assert(helper);
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (!CacheShard::kKeyFromHash) {
+      if (numa_node_bits_ > 0) {
+        hash = GetNumaHash(hash, GetCurrentNumaNode());
+      }
+    }
     HandleImpl* result = GetShard(hash).CreateStandalone(
         key, hash, obj, helper, charge, allow_uncharged);
     return static_cast<Handle*>(result);
@@ -200,6 +278,11 @@ class ShardedCache : public ShardedCacheBase {
                  Priority priority = Priority::LOW,
                  Statistics* stats = nullptr) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (!CacheShard::kKeyFromHash) {
+      if (numa_node_bits_ > 0) {
+        return NumaLookup(key, hash, helper, create_context, priority, stats);
+      }
+    }
     HandleImpl* result = GetShard(hash).Lookup(key, hash, helper,
                                                create_context, priority, stats);
     return static_cast<Handle*>(result);
@@ -207,6 +290,15 @@ class ShardedCache : public ShardedCacheBase {
 
   void Erase(const Slice& key) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if constexpr (!CacheShard::kKeyFromHash) {
+      if (numa_node_bits_ > 0) {
+        for (uint32_t n = 0; n < GetNumNumaNodes(); n++) {
+          HashVal node_hash = GetNumaHash(hash, n);
+          GetShard(node_hash).Erase(key, node_hash);
+        }
+        return;
+      }
+    }
     GetShard(hash).Erase(key, hash);
   }
 
@@ -302,10 +394,103 @@ class ShardedCache : public ShardedCacheBase {
 
   // Must be called exactly once by derived class constructor
   void InitShards(const std::function<void(CacheShard*)>& placement_new) {
-    ForEachShard(placement_new);
+    if (numa_node_bits_ > 0) {
+      // So that the memory allocated by each shard (e.g. its table) is on
+      // its node
+      uint32_t num_shards = GetNumShards();
+      for (uint32_t i = 0; i < num_shards; i++) {
+        SetPreferredNumaNode(GetShardNumaNode(i));
+        placement_new(shards_ + i);
+      }
+      ResetNumaMemoryPolicy();
+    } else {
+      ForEachShard(placement_new);
+    }
     destroy_shards_in_dtor_ = true;
   }
 
+  // The hash of the copy of an entry on a NUMA node: the same shard index
+  // within the node's range of shards as the key would get without NUMA
+  // awareness.
+  HashVal GetNumaHash(HashCref hash, uint32_t node) const {
+    uint32_t shard = (node << numa_shard_bits_) |
+                     (CacheShard::HashPieceForSharding(hash) &
+                      ((uint32_t{1} << numa_shard_bits_) - 1));
+    return CacheShard::ReplaceShardingBits(hash, shard, shard_mask_);
+  }
+
+  // Lookup in the shards of the local node first, then of the other nodes
+  Handle* NumaLookup(const Slice& key, HashCref hash,
+                     const CacheItemHelper* helper,
+                     CreateContext* create_context, Priority priority,
+                     Statistics* stats) {
+    const uint32_t node = GetCurrentNumaNode();
+    NumaNodeData& node_data = numa_nodes_[node];
+    HashVal local_hash = GetNumaHash(hash, node);
+    HandleImpl* result = GetShard(local_hash).Lookup(
+        key, local_hash, helper, create_context, priority, stats);
+    if (result != nullptr) {
+      node_data.local_hits.FetchAddRelaxed(1);
+      return static_cast<Handle*>(result);
+    }
+    for (uint32_t n = 0; n < GetNumNumaNodes(); n++) {
+      if (n == node) {
+        continue;
+      }
+      HashVal remote_hash = GetNumaHash(hash, n);
+      result = GetShard(remote_hash).Lookup(key, remote_hash, helper,
+                                            create_context, priority, stats);
+      if (result != nullptr) {
+        node_data.remote_hits.FetchAddRelaxed(1);
+        if (numa_replication_threshold_ > 0 && helper != nullptr &&
+            helper->create_cb != nullptr &&
+            ShouldReplicate(node, CacheShard::HashPieceForSharding(hash))) {
+          Replicate(key, local_hash, result, helper, create_context, priority,
+                    &node_data);
+        }
+        return static_cast<Handle*>(result);
+      }
+    }
+    node_data.misses.FetchAddRelaxed(1);
+    return nullptr;
+  }
+
+  // Inserts a copy of the entry of `handle`, created on the calling thread
+  // (so normally on its node) with the helper of the lookup, like a
+  // promotion from a secondary cache
+  void Replicate(const Slice& key, HashCref local_hash, HandleImpl* handle,
+                 const CacheItemHelper* helper, CreateContext* create_context,
+                 Priority priority, NumaNodeData* node_data) {
+    const CacheItemHelper* entry_helper =
+        GetCacheItemHelper(static_cast<Handle*>(handle));
+    if (!entry_helper->IsSecondaryCacheCompatible()) {
+      return;
+    }
+    ObjectPtr value = Value(static_cast<Handle*>(handle));
+    size_t size = entry_helper->size_cb(value);
+    std::unique_ptr<char[]> buf(new char[size]);
+    if (!entry_helper->saveto_cb(value, 0, size, buf.get()).ok()) {
+      return;
+    }
+    ObjectPtr copy = nullptr;
+    size_t charge = 0;
+    if (!helper
+             ->create_cb(Slice(buf.get(), size), kNoCompression,
+                         CacheTier::kVolatileTier, create_context,
+                         memory_allocator(), &copy, &charge)
+             .ok()) {
+      return;
+    }
+    Status s = GetShard(local_hash).Insert(key, local_hash, copy, helper,
+                                           charge, /*handle=*/nullptr,
+                                           priority);
+    if (s.ok()) {
+      node_data->replications.FetchAddRelaxed(1);
+    } else if (helper->del_cb) {
+      helper->del_cb(copy, memory_allocator());
+    }
+  }
+
   void AppendPrintableOptions(std::string& str) const override {
     shards_[0].AppendPrintableOptions(str);
   }
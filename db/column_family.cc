@@ -20,12 +20,15 @@
 #include "db/blob/blob_source.h"
 #include "db/compaction/compaction_picker.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_lazy_level.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/db_impl/db_impl.h"
 #include "db/internal_stats.h"
 #include "db/job_context.h"
+#include "db/negative_lookup_cache.h"
 #include "db/range_del_aggregator.h"
+#include "db/scan_cache.h"
 #include "db/table_properties_collector.h"
 #include "db/version_set.h"
 #include "db/write_controller.h"
@@ -249,12 +252,14 @@ ColumnFamilyOptions SanitizeCfOptions(const ImmutableDBOptions& db_options,
   if (result.num_levels < 1) {
     result.num_levels = 1;
   }
-  if (result.compaction_style == kCompactionStyleLevel &&
+  if ((result.compaction_style == kCompactionStyleLevel ||
+       result.compaction_style == kCompactionStyleLazyLevel) &&
       result.num_levels < 2) {
     result.num_levels = 2;
   }
 
-  if (result.compaction_style == kCompactionStyleUniversal &&
+  if ((result.compaction_style == kCompactionStyleUniversal ||
+       result.compaction_style == kCompactionStyleLazyLevel) &&
       db_options.allow_ingest_behind && result.num_levels < 3) {
     result.num_levels = 3;
   }
@@ -626,6 +631,19 @@ ColumnFamilyData::ColumnFamilyData(
                           internal_stats_->GetBlobFileReadHist(), io_tracer));
     blob_source_.reset(new BlobSource(ioptions_, mutable_cf_options_, db_id,
                                       db_session_id, blob_file_cache_.get()));
+    if (ioptions_.scan_cache != nullptr &&
+        ioptions_.user_comparator->timestamp_size() == 0 &&
+        !ioptions_.inplace_update_support && !ioptions_.unordered_write) {
+      scan_cache_versions_.reset(
+          new ScanCacheVersions(ioptions_.scan_cache.get(),
+                                mutable_cf_options_.prefix_extractor));
+    }
+    if (ioptions_.negative_lookup_cache_size > 0 &&
+        ioptions_.user_comparator->timestamp_size() == 0 &&
+        !ioptions_.inplace_update_support && !ioptions_.unordered_write) {
+      negative_lookup_cache_.reset(
+          new NegativeLookupCache(ioptions_.negative_lookup_cache_size));
+    }
 
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
@@ -636,6 +654,9 @@ ColumnFamilyData::ColumnFamilyData(
     } else if (ioptions_.compaction_style == kCompactionStyleFIFO) {
       compaction_picker_.reset(
           new FIFOCompactionPicker(ioptions_, &internal_comparator_));
+    } else if (ioptions_.compaction_style == kCompactionStyleLazyLevel) {
+      compaction_picker_.reset(
+          new LazyLevelCompactionPicker(ioptions_, &internal_comparator_));
     } else if (ioptions_.compaction_style == kCompactionStyleNone) {
       compaction_picker_.reset(
           new NullCompactionPicker(ioptions_, &internal_comparator_));
@@ -1185,8 +1206,12 @@ uint64_t ColumnFamilyData::GetLiveSstFilesSize() const {
 
 MemTable* ColumnFamilyData::ConstructNewMemtable(
     const MutableCFOptions& mutable_cf_options, SequenceNumber earliest_seq) {
-  return new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
-                      write_buffer_manager_, earliest_seq, id_);
+  MemTable* mem =
+      new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
+                   write_buffer_manager_, earliest_seq, id_);
+  mem->SetScanCacheVersions(scan_cache_versions_.get());
+  mem->SetNegativeLookupCache(negative_lookup_cache_.get());
+  return mem;
 }
 
 void ColumnFamilyData::CreateNewMemtable(SequenceNumber earliest_seq) {
@@ -1392,6 +1417,13 @@ void ColumnFamilyData::InstallSuperVersion(
     // down is needed.
     super_version_->write_stall_condition =
         RecalculateWriteStallConditions(new_superversion->mutable_cf_options);
+    if (scan_cache_versions_ != nullptr &&
+        (ioptions_.compaction_filter != nullptr ||
+         ioptions_.compaction_filter_factory != nullptr ||
+         ioptions_.compaction_style == kCompactionStyleFIFO)) {
+      // Flushes and compactions might have dropped entries
+      scan_cache_versions_->Invalidate();
+    }
   } else {
     super_version_->write_stall_condition =
         old_superversion->write_stall_condition;
@@ -1579,6 +1611,22 @@ Status ColumnFamilyData::ValidateOptions(
           "level0_file_num_compaction_trigger.");
     }
   }
+
+  if (cf_options.compaction_style == kCompactionStyleLazyLevel) {
+    const auto& lazy_level_options = cf_options.compaction_options_lazy_level;
+    if (lazy_level_options.size_ratio < 2) {
+      return Status::InvalidArgument(
+          "CompactionOptionsLazyLevel::size_ratio should be at least 2.");
+    }
+    if (lazy_level_options.max_sorted_runs < 1 ||
+        std::any_of(lazy_level_options.max_sorted_runs_per_level.begin(),
+                    lazy_level_options.max_sorted_runs_per_level.end(),
+                    [](int max_sorted_runs) { return max_sorted_runs < 1; })) {
+      return Status::InvalidArgument(
+          "CompactionOptionsLazyLevel::max_sorted_runs and "
+          "max_sorted_runs_per_level should be at least 1.");
+    }
+  }
   return s;
 }
 
@@ -50,6 +50,8 @@ class InstrumentedMutexLock;
 struct SuperVersionContext;
 class BlobFileCache;
 class BlobSource;
+class NegativeLookupCache;
+class ScanCacheVersions;
 
 extern const double kIncSlowdownRatio;
 // This file contains a list of data structures for managing column family
@@ -415,6 +417,14 @@ class ColumnFamilyData {
   TableCache* table_cache() const { return table_cache_.get(); }
   BlobFileCache* blob_file_cache() const { return blob_file_cache_.get(); }
   BlobSource* blob_source() const { return blob_source_.get(); }
+  // nullptr unless DBOptions::scan_cache can be used for this column family
+  ScanCacheVersions* scan_cache_versions() const {
+    return scan_cache_versions_.get();
+  }
+  // nullptr unless negative_lookup_cache_size is set and supported
+  NegativeLookupCache* negative_lookup_cache() const {
+    return negative_lookup_cache_.get();
+  }
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -631,6 +641,8 @@ class ColumnFamilyData {
   std::unique_ptr<TableCache> table_cache_;
   std::unique_ptr<BlobFileCache> blob_file_cache_;
   std::unique_ptr<BlobSource> blob_source_;
+  std::unique_ptr<ScanCacheVersions> scan_cache_versions_;
+  std::unique_ptr<NegativeLookupCache> negative_lookup_cache_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
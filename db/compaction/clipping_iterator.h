@@ -193,6 +193,22 @@ class ClippingIterator : public InternalIterator {
     return iter_->IsDeleteRangeSentinelKey();
   }
 
+  bool GetRawDataBlock(RawDataBlock* block) override {
+    assert(valid_);
+    if (!iter_->GetRawDataBlock(block)) {
+      // May have failed with an error
+      UpdateAndEnforceUpperBound();
+      return false;
+    }
+    return !end_ || cmp_->Compare(block->last_key, *end_) < 0;
+  }
+
+  void SkipRawDataBlock() override {
+    assert(valid_);
+    iter_->SkipRawDataBlock();
+    UpdateAndEnforceUpperBound();
+  }
+
  private:
   void UpdateValid() {
     assert(!iter_->Valid() || iter_->status().ok());
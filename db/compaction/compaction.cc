@@ -936,7 +936,8 @@ bool Compaction::ShouldFormSubcompactions() const {
 
   if (cfd_->ioptions().compaction_style == kCompactionStyleLevel) {
     return (start_level_ == 0 || is_manual_compaction_) && output_level_ > 0;
-  } else if (cfd_->ioptions().compaction_style == kCompactionStyleUniversal) {
+  } else if (cfd_->ioptions().compaction_style == kCompactionStyleUniversal ||
+             cfd_->ioptions().compaction_style == kCompactionStyleLazyLevel) {
     return number_levels_ > 1 && output_level_ > 0;
   } else {
     return false;
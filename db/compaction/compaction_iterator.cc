@@ -143,7 +143,9 @@ void CompactionIterator::ResetRecordCounts() {
 }
 
 void CompactionIterator::SeekToFirst() {
-  NextFromInput();
+  if (CopyRawDataBlocks()) {
+    NextFromInput();
+  }
   PrepareOutput();
 }
 
@@ -206,7 +208,11 @@ void CompactionIterator::Next() {
     if (!at_next_) {
       AdvanceInputIter();
     }
-    NextFromInput();
+    if (CopyRawDataBlocks()) {
+      NextFromInput();
+    } else {
+      validity_info_.Invalidate();
+    }
   }
 
   if (Valid()) {
@@ -217,6 +223,38 @@ void CompactionIterator::Next() {
   PrepareOutput();
 }
 
+bool CompactionIterator::CopyRawDataBlocks() {
+  if (!raw_data_block_func_ || clear_and_output_next_key_ ||
+      (range_del_agg_ != nullptr && !range_del_agg_->IsEmpty())) {
+    return true;
+  }
+  RawDataBlock block;
+  while (input_.Valid() && !IsPausingManualCompaction() && !IsShuttingDown() &&
+         input_.GetRawDataBlock(&block)) {
+    // The last input key can be an older version of the first one
+    if (has_current_user_key_ &&
+        cmp_->Compare(ExtractUserKey(block.first_key), current_user_key_) <=
+            0) {
+      break;
+    }
+    bool copied = false;
+    status_ = raw_data_block_func_(block, &copied);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (!copied) {
+      break;
+    }
+    iter_stats_.num_input_records += block.num_entries;
+    iter_stats_.total_input_raw_key_bytes += block.raw_key_size;
+    iter_stats_.total_input_raw_value_bytes += block.raw_value_size;
+    has_current_user_key_ = false;
+    last_key_seq_zeroed_ = false;
+    input_.SkipRawDataBlock();
+  }
+  return true;
+}
+
 bool CompactionIterator::InvokeFilterIfNeeded(bool* need_skip,
                                               Slice* skip_until) {
   if (!compaction_filter_) {
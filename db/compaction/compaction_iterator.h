@@ -26,6 +26,12 @@ class BlobFileBuilder;
 class BlobFetcher;
 class PrefetchBufferCollection;
 
+// Adds a data block of the input of a compaction to its output as is, and
+// sets `*copied`, or leaves `*copied` false for the entries of the block to
+// be processed one by one.
+using CompactionRawDataBlockFunc =
+    std::function<Status(const RawDataBlock& block, bool* copied)>;
+
 // A wrapper of internal iterator whose purpose is to count how
 // many entries there are in the iterator.
 class SequenceIterWrapper : public InternalIterator {
@@ -72,10 +78,23 @@ class SequenceIterWrapper : public InternalIterator {
     return inner_iter_->IsDeleteRangeSentinelKey();
   }
 
+  bool GetRawDataBlock(RawDataBlock* block) override {
+    if (!inner_iter_->GetRawDataBlock(block)) {
+      return false;
+    }
+    raw_block_num_entries_ = block->num_entries;
+    return true;
+  }
+  void SkipRawDataBlock() override {
+    num_itered_ += raw_block_num_entries_;
+    inner_iter_->SkipRawDataBlock();
+  }
+
  private:
   InternalKeyComparator icmp_;
   InternalIterator* inner_iter_;  // not owned
   uint64_t num_itered_ = 0;
+  uint64_t raw_block_num_entries_ = 0;
   bool need_count_entries_;
   bool has_num_itered_ = true;
 };
@@ -230,6 +249,16 @@ class CompactionIterator {
 
   void ResetRecordCounts();
 
+  // Makes the iterator pass the input data blocks which can be copied as is
+  // to `func`, in between the records it produces, instead of processing
+  // their entries. Only for compactions where such entries would be output
+  // unchanged, e.g. without a compaction filter.
+  //
+  // REQUIRED: Call before SeekToFirst().
+  void SetRawDataBlockFunc(CompactionRawDataBlockFunc func) {
+    raw_data_block_func_ = std::move(func);
+  }
+
   // Seek to the beginning of the compaction iterator output.
   //
   // REQUIRED: Call only once.
@@ -477,6 +506,12 @@ class CompactionIterator {
   // Max seqno that can be zeroed out at last level (various reasons)
   const SequenceNumber preserve_seqno_after_ = kMaxSequenceNumber;
 
+  // Passes the data blocks at the input position to raw_data_block_func_,
+  // until one is not copied. Returns false on an error, in status_.
+  bool CopyRawDataBlocks();
+
+  CompactionRawDataBlockFunc raw_data_block_func_;
+
   void AdvanceInputIter() { input_.Next(); }
 
   void SkipUntil(const Slice& skip_until) { input_.Seek(skip_until); }
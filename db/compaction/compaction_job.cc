@@ -23,6 +23,7 @@
 #include "db/builder.h"
 #include "db/compaction/clipping_iterator.h"
 #include "db/compaction/compaction_state.h"
+#include "db/compaction/pipelined_input_iterator.h"
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
 #include "db/error_handler.h"
@@ -55,6 +56,7 @@
 #include "table/table_builder.h"
 #include "table/unique_id_impl.h"
 #include "test_util/sync_point.h"
+#include "util/compression.h"
 #include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -1031,6 +1033,16 @@ Status CompactionJob::Install(bool* compaction_released) {
   stream << "num_single_delete_fallthrough"
          << compaction_job_stats_->num_single_del_fallthru;
 
+  if (compact_->compaction->immutable_options()
+          .compaction_pipeline_buffer_size > 0) {
+    stream << "pipeline_input_busy_micros"
+           << compaction_job_stats_->pipeline_input_busy_micros;
+    stream << "pipeline_input_stall_micros"
+           << compaction_job_stats_->pipeline_input_stall_micros;
+    stream << "pipeline_merge_stall_micros"
+           << compaction_job_stats_->pipeline_merge_stall_micros;
+  }
+
   if (measure_io_stats_) {
     stream << "file_write_nanos" << compaction_job_stats_->file_write_nanos;
     stream << "file_range_sync_nanos"
@@ -1188,6 +1200,10 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   const WriteOptions write_options(Env::IOPriority::IO_LOW,
                                    Env::IOActivity::kCompaction);
 
+  // Before reading the inputs, so that the block cache only reflects the
+  // other reads
+  CollectHotKeyRanges(sub_compact, read_options);
+
   // Remove the timestamps from boundaries because boundaries created in
   // GenSubcompactionBoundaries doesn't strip away the timestamp.
   size_t ts_sz = cfd->user_comparator()->timestamp_size();
@@ -1206,13 +1222,36 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  // With a pipelined input, the input iterators run on another thread, and
+  // their range tombstones are passed on to the aggregator of the
+  // subcompaction by PipelinedInputIterator.
+  const size_t pipeline_buffer_size =
+      sub_compact->compaction->immutable_options()
+          .compaction_pipeline_buffer_size;
+  std::unique_ptr<PipelinedRangeDelAggregator> pipelined_range_del_agg;
+  if (pipeline_buffer_size > 0) {
+    pipelined_range_del_agg = std::make_unique<PipelinedRangeDelAggregator>(
+        &cfd->internal_comparator());
+  }
+
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
   std::unique_ptr<InternalIterator> raw_input(versions_->MakeInputIterator(
-      read_options, sub_compact->compaction, sub_compact->RangeDelAgg(),
+      read_options, sub_compact->compaction,
+      pipelined_range_del_agg
+          ? static_cast<RangeDelAggregator*>(pipelined_range_del_agg.get())
+          : sub_compact->RangeDelAgg(),
       file_options_for_read_, start, end));
   InternalIterator* input = raw_input.get();
 
+  std::unique_ptr<PipelinedInputIterator> pipelined_input;
+  if (pipelined_range_del_agg) {
+    pipelined_input = std::make_unique<PipelinedInputIterator>(
+        input, pipelined_range_del_agg.get(), sub_compact->RangeDelAgg(),
+        pipeline_buffer_size, db_options_.clock);
+    input = pipelined_input.get();
+  }
+
   IterKey start_ikey;
   IterKey end_ikey;
   Slice start_slice;
@@ -1255,7 +1294,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   std::unique_ptr<InternalIterator> clip;
   if (start.has_value() || end.has_value()) {
     clip = std::make_unique<ClippingIterator>(
-        raw_input.get(), start.has_value() ? &start_slice : nullptr,
+        input, start.has_value() ? &start_slice : nullptr,
         end.has_value() ? &end_slice : nullptr, &cfd->internal_comparator());
     input = clip.get();
   }
@@ -1351,7 +1390,6 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
           ->DoesInputReferenceBlobFiles() /* must_count_input_entries */,
       sub_compact->compaction, compaction_filter, shutting_down_,
       db_options_.info_log, full_history_ts_low, preserve_seqno_after_);
-  c_iter->SeekToFirst();
 
   const auto& c_iter_stats = c_iter->iter_stats();
 
@@ -1372,6 +1410,46 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
             sub_compact->end.has_value() ? &end_user_key : nullptr);
       };
 
+  // The data blocks output unchanged can be copied as is when no entry could
+  // be transformed on the way
+  const auto* output_table_options =
+      mutable_cf_options.table_factory->GetOptions<BlockBasedTableOptions>();
+  const bool copy_data_blocks =
+      sub_compact->compaction->immutable_options()
+          .compaction_copy_data_blocks &&
+      output_table_options != nullptr && compaction_filter == nullptr &&
+      snapshot_checker_ == nullptr && ts_sz == 0 &&
+      full_history_ts_low == nullptr && !pipelined_input &&
+      !blob_file_builder &&
+      !sub_compact->compaction->DoesInputReferenceBlobFiles() &&
+      !sub_compact->compaction->SupportsPerKeyPlacement() &&
+      sub_compact->compaction->output_compression_opts().max_dict_bytes == 0 &&
+      sub_compact->compaction->output_compression_opts().parallel_threads <= 1;
+  if (copy_data_blocks) {
+    const CompressionType output_compression =
+        sub_compact->compaction->output_compression();
+    const uint32_t output_format_version =
+        output_table_options->format_version;
+    c_iter->SetRawDataBlockFunc(
+        [sub_compact, output_compression, output_format_version,
+         &open_file_func, &close_file_func](const RawDataBlock& block, bool* copied) {
+          *copied = false;
+          if (block.compression_type != output_compression ||
+              (output_compression != kNoCompression &&
+               GetCompressFormatForVersion(block.format_version) !=
+                   GetCompressFormatForVersion(output_format_version))) {
+            return Status::OK();
+          }
+          Status s = sub_compact->AddRawDataBlockToOutput(
+              block, open_file_func, close_file_func, copied);
+          if (*copied) {
+            sub_compact->compaction_job_stats.num_data_blocks_copied++;
+          }
+          return s;
+        });
+  }
+  c_iter->SeekToFirst();
+
   Status status;
   TEST_SYNC_POINT_CALLBACK(
       "CompactionJob::ProcessKeyValueCompaction()::Processing",
@@ -1519,6 +1597,19 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   status = sub_compact->CloseCompactionFiles(status, open_file_func,
                                              close_file_func);
 
+  if (copy_data_blocks) {
+    uint64_t num_output_data_blocks = 0;
+    for (const auto& output : sub_compact->GetOutputs()) {
+      if (output.table_properties) {
+        num_output_data_blocks += output.table_properties->num_data_blocks;
+      }
+    }
+    sub_compact->compaction_job_stats.num_data_blocks_rewritten =
+        num_output_data_blocks -
+        std::min(num_output_data_blocks,
+                 sub_compact->compaction_job_stats.num_data_blocks_copied);
+  }
+
   if (blob_file_builder) {
     if (status.ok()) {
       status = blob_file_builder->Finish();
@@ -1535,6 +1626,21 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   RecordTick(stats_, COMPACTION_CPU_TOTAL_TIME,
              cur_cpu_micros - last_cpu_micros);
 
+  if (pipelined_input) {
+    pipelined_input->Stop();
+    sub_compact->compaction_job_stats.pipeline_input_busy_micros =
+        pipelined_input->GetInputBusyMicros();
+    sub_compact->compaction_job_stats.pipeline_input_stall_micros =
+        pipelined_input->GetInputStallMicros();
+    sub_compact->compaction_job_stats.pipeline_merge_stall_micros =
+        pipelined_input->GetStallMicros();
+    // The input thread's CPU time is not included in CPUMicros() above
+    sub_compact->compaction_job_stats.cpu_micros +=
+        pipelined_input->GetInputCpuMicros();
+    RecordTick(stats_, COMPACTION_CPU_TOTAL_TIME,
+               pipelined_input->GetInputCpuMicros());
+  }
+
   if (measure_io_stats_) {
     sub_compact->compaction_job_stats.file_write_nanos +=
         IOSTATS(write_nanos) - prev_write_nanos;
@@ -2062,6 +2168,7 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       0 /* oldest_key_time */, current_time, db_id_, db_session_id_,
       sub_compact->compaction->max_output_file_size(), file_number,
       penultimate_after_seqno_ /*last_level_inclusive_max_seqno_threshold*/);
+  tboptions.hot_key_ranges = &sub_compact->hot_key_ranges;
 
   outputs.NewBuilder(tboptions);
 
@@ -2069,6 +2176,49 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
   return s;
 }
 
+void CompactionJob::CollectHotKeyRanges(SubcompactionState* sub_compact,
+                                        const ReadOptions& read_options) {
+  const Compaction* c = sub_compact->compaction;
+  const MutableCFOptions& mutable_cf_options = c->mutable_cf_options();
+  const auto* table_options =
+      mutable_cf_options.table_factory->GetOptions<BlockBasedTableOptions>();
+  if (table_options == nullptr ||
+      table_options->prepopulate_block_cache !=
+          BlockBasedTableOptions::PrepopulateBlockCache::
+              kFlushAndHotCompaction ||
+      table_options->block_cache == nullptr) {
+    return;
+  }
+  ColumnFamilyData* cfd = c->column_family_data();
+  const Comparator* ucmp = cfd->user_comparator();
+  std::vector<std::pair<std::string, std::string>> ranges;
+  for (size_t i = 0; i < c->num_input_levels(); i++) {
+    for (const FileMetaData* f : *c->inputs(i)) {
+      // Best effort: a file that can't be checked is considered cold
+      cfd->table_cache()
+          ->GetCachedKeyRanges(read_options, cfd->internal_comparator(), *f,
+                               mutable_cf_options, &ranges)
+          .PermitUncheckedError();
+    }
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [ucmp](const std::pair<std::string, std::string>& a,
+                   const std::pair<std::string, std::string>& b) {
+              return ucmp->Compare(a.first, b.first) < 0;
+            });
+  auto& merged = sub_compact->hot_key_ranges;
+  for (auto& range : ranges) {
+    if (!merged.empty() &&
+        ucmp->Compare(range.first, merged.back().second) <= 0) {
+      if (ucmp->Compare(range.second, merged.back().second) > 0) {
+        merged.back().second = std::move(range.second);
+      }
+    } else {
+      merged.push_back(std::move(range));
+    }
+  }
+}
+
 void CompactionJob::CleanupCompaction() {
   for (SubcompactionState& sub_compact : compact_->sub_compact_states) {
     sub_compact.Cleanup(table_cache_.get());
@@ -222,6 +222,10 @@ class CompactionJob {
 
   // Iterate through input and compact the kv-pairs.
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+  // Sets the hot_key_ranges of the subcompaction, with
+  // PrepopulateBlockCache::kFlushAndHotCompaction
+  void CollectHotKeyRanges(SubcompactionState* sub_compact,
+                           const ReadOptions& read_options);
 
   CompactionState* compact_;
   InternalStats::CompactionStatsFull compaction_stats_;
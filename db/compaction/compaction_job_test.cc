@@ -1693,6 +1693,9 @@ TEST_F(CompactionJobTest, ResultSerialization) {
   result.stats.num_output_files = rnd.Uniform(1000);
   result.stats.is_full_compaction = rnd.OneIn(2);
   result.stats.num_single_del_mismatch = rnd64.Uniform(UINT64_MAX);
+  result.stats.pipeline_merge_stall_micros = rnd64.Uniform(UINT64_MAX);
+  result.stats.num_data_blocks_copied = rnd64.Uniform(UINT64_MAX);
+  result.stats.num_data_blocks_rewritten = rnd64.Uniform(UINT64_MAX);
   result.stats.num_input_files = 9;
 
   std::string output;
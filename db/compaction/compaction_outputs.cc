@@ -228,9 +228,7 @@ uint64_t CompactionOutputs::GetCurrentKeyGrandparentOverlappedBytes(
   return overlapped_bytes;
 }
 
-bool CompactionOutputs::ShouldStopBefore(const CompactionIterator& c_iter) {
-  assert(c_iter.Valid());
-  const Slice& internal_key = c_iter.key();
+bool CompactionOutputs::ShouldStopBefore(const Slice& internal_key) {
 #ifndef NDEBUG
   bool should_stop = false;
   std::pair<bool*, const Slice> p{&should_stop, internal_key};
@@ -265,7 +263,8 @@ bool CompactionOutputs::ShouldStopBefore(const CompactionIterator& c_iter) {
 
   // If there's user defined partitioner, check that first
   if (partitioner_ && partitioner_->ShouldPartition(PartitionerRequest(
-                          last_key_for_partitioner_, c_iter.user_key(),
+                          last_key_for_partitioner_,
+                          ExtractUserKey(internal_key),
                           current_output_file_size_)) == kRequired) {
     return true;
   }
@@ -367,7 +366,7 @@ Status CompactionOutputs::AddToOutput(
     return s;
   }
   const Slice& key = c_iter.key();
-  if (ShouldStopBefore(c_iter) && HasBuilder()) {
+  if (ShouldStopBefore(key) && HasBuilder()) {
     s = close_file_func(*this, c_iter.InputStatus(), key);
     if (!s.ok()) {
       return s;
@@ -435,6 +434,81 @@ Status CompactionOutputs::AddToOutput(
   return s;
 }
 
+Status CompactionOutputs::AddRawDataBlockToOutput(
+    const RawDataBlock& block, const CompactionFileOpenFunc& open_file_func,
+    const CompactionFileCloseFunc& close_file_func, bool* copied) {
+  *copied = false;
+  // Outputs can only be cut before the block
+  if (partitioner_ || !files_to_cut_for_ttl_.empty() ||
+      (local_output_split_key_ != nullptr && !is_split_)) {
+    return Status::OK();
+  }
+
+  Status s;
+  if (ShouldStopBefore(block.first_key) && HasBuilder()) {
+    s = close_file_func(*this, Status::OK(), block.first_key);
+    if (!s.ok()) {
+      return s;
+    }
+    // reset grandparent information
+    grandparent_boundary_switched_num_ = 0;
+    grandparent_overlapped_bytes_ =
+        GetCurrentKeyGrandparentOverlappedBytes(block.first_key);
+    range_tombstone_lower_bound_.Clear();
+  }
+
+  // Open output file if necessary
+  if (!HasBuilder()) {
+    s = open_file_func(*this);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // Per-key updates, before the builder consumes the entries
+  InternalIterator* entries = block.entries;
+  ParsedInternalKey ikey;
+  for (; entries->Valid(); entries->Next()) {
+    const Slice key = entries->key();
+    const Slice value = entries->value();
+    s = current_output().validator.Add(key, value);
+    if (s.ok()) {
+      s = ParseInternalKey(key, &ikey, /*log_err_key=*/false);
+    }
+    if (s.ok()) {
+      s = current_output().meta.UpdateBoundaries(key, value, ikey.sequence,
+                                                 ikey.type);
+    }
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  s = entries->status();
+  if (!s.ok()) {
+    return s;
+  }
+  entries->SeekToFirst();
+
+  assert(builder_ != nullptr);
+  if (!builder_->AddRawDataBlock(block)) {
+    // Not expected, as the callers check the compression of the block
+    s = builder_->status();
+    return s.ok() ? Status::NotSupported(
+                        "Cannot copy data block to compaction output")
+                  : s;
+  }
+  *copied = true;
+
+  stats_.num_output_records += block.num_entries;
+  current_output_file_size_ = builder_->EstimatedFileSize();
+  if (compaction_->output_level() > 0) {
+    // The grandparent boundaries crossed by the block are still accounted
+    // for in the decision to cut the output before the next key
+    UpdateGrandparentBoundaryInfo(block.last_key);
+  }
+  return s;
+}
+
 namespace {
 void SetMaxSeqAndTs(InternalKey& internal_key, const Slice& user_key,
                     const size_t ts_sz) {
@@ -754,7 +828,10 @@ Status CompactionOutputs::AddRangeDels(
 void CompactionOutputs::FillFilesToCutForTtl() {
   if (compaction_->immutable_options().compaction_style !=
           kCompactionStyleLevel ||
-      compaction_->immutable_options().compaction_pri != kMinOverlappingRatio ||
+      (compaction_->immutable_options().compaction_pri !=
+           kMinOverlappingRatio &&
+       compaction_->immutable_options().compaction_pri !=
+           kReadHeatAndOverlappingRatio) ||
       compaction_->mutable_cf_options().ttl == 0 ||
       compaction_->num_input_levels() < 2 || compaction_->bottommost_level()) {
     return;
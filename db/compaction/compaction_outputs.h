@@ -218,8 +218,8 @@ class CompactionOutputs {
   }
 
   // Returns true iff we should stop building the current output
-  // before processing the current key in compaction iterator.
-  bool ShouldStopBefore(const CompactionIterator& c_iter);
+  // before adding `internal_key`, the current key in compaction iterator.
+  bool ShouldStopBefore(const Slice& internal_key);
 
   void Cleanup() {
     if (builder_ != nullptr) {
@@ -253,6 +253,14 @@ class CompactionOutputs {
                      const CompactionFileOpenFunc& open_file_func,
                      const CompactionFileCloseFunc& close_file_func);
 
+  // Add a data block of the input to the output file as is, if it does not
+  // need to be split, and set `*copied`. If needed close and open new
+  // compaction output with the functions provided.
+  Status AddRawDataBlockToOutput(const RawDataBlock& block,
+                                 const CompactionFileOpenFunc& open_file_func,
+                                 const CompactionFileCloseFunc& close_file_func,
+                                 bool* copied);
+
   // Close the current output. `open_file_func` is needed for creating new file
   // for range-dels only output file.
   Status CloseOutput(const Status& curr_status,
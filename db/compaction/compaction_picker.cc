@@ -612,10 +612,11 @@ Compaction* CompactionPicker::CompactRange(
   assert(ioptions_.compaction_style != kCompactionStyleFIFO);
 
   if (input_level == ColumnFamilyData::kCompactAllLevels) {
-    assert(ioptions_.compaction_style == kCompactionStyleUniversal);
+    assert(ioptions_.compaction_style == kCompactionStyleUniversal ||
+           ioptions_.compaction_style == kCompactionStyleLazyLevel);
 
-    // Universal compaction with more than one level always compacts all the
-    // files together to the last level.
+    // Universal and lazy level compactions with more than one level always
+    // compact all the files together to the last level.
     assert(vstorage->num_levels() > 1);
     int max_output_level =
         vstorage->MaxOutputLevel(ioptions_.allow_ingest_behind);
@@ -0,0 +1,405 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_picker_lazy_level.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <climits>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "logging/log_buffer.h"
+#include "logging/logging.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+// A sorted run other than the last level: an L0 file or a non-empty level
+struct SortedRun {
+  int level;
+  // For an L0 sorted run
+  FileMetaData* file;
+  uint64_t compensated_size;
+  // Whether any file of the sorted run is being compacted
+  bool being_compacted;
+};
+
+// Returns the sorted runs before `last_level`, from the newest to the oldest
+std::vector<SortedRun> CalculateSortedRuns(const VersionStorageInfo& vstorage,
+                                           int last_level) {
+  std::vector<SortedRun> runs;
+  for (FileMetaData* f : vstorage.LevelFiles(0)) {
+    runs.push_back({0, f, f->compensated_file_size, f->being_compacted});
+  }
+  for (int level = 1; level < last_level; level++) {
+    const auto& files = vstorage.LevelFiles(level);
+    if (files.empty()) {
+      continue;
+    }
+    SortedRun run{level, nullptr, 0, false};
+    for (FileMetaData* f : files) {
+      run.compensated_size += f->compensated_file_size;
+      run.being_compacted = run.being_compacted || f->being_compacted;
+    }
+    runs.push_back(run);
+  }
+  return runs;
+}
+
+unsigned int SizeRatio(const MutableCFOptions& mutable_cf_options) {
+  return std::max(mutable_cf_options.compaction_options_lazy_level.size_ratio,
+                  2U);
+}
+
+// Returns the logical level of a sorted run of `size` bytes, the smallest i
+// such that size <= write_buffer_size * size_ratio^i
+int LogicalLevel(const MutableCFOptions& mutable_cf_options, uint64_t size) {
+  const uint64_t size_ratio = SizeRatio(mutable_cf_options);
+  uint64_t max_size = std::max<uint64_t>(mutable_cf_options.write_buffer_size,
+                                         1);
+  int logical_level = 0;
+  while (size > max_size) {
+    max_size = max_size > std::numeric_limits<uint64_t>::max() / size_ratio
+                   ? std::numeric_limits<uint64_t>::max()
+                   : max_size * size_ratio;
+    logical_level++;
+  }
+  return logical_level;
+}
+
+int MaxSortedRuns(const MutableCFOptions& mutable_cf_options,
+                  int logical_level) {
+  const auto& options = mutable_cf_options.compaction_options_lazy_level;
+  const int max_sorted_runs =
+      static_cast<size_t>(logical_level) <
+              options.max_sorted_runs_per_level.size()
+          ? options.max_sorted_runs_per_level[logical_level]
+          : options.max_sorted_runs;
+  return std::max(max_sorted_runs, 1);
+}
+
+// Calls `func(start, end, logical_level)` for each longest range
+// [start, end] of consecutive sorted runs of the same logical level, none of
+// which is being compacted, from the newest.
+template <typename Func>
+void ForEachLogicalLevel(const MutableCFOptions& mutable_cf_options,
+                         const std::vector<SortedRun>& runs, const Func& func) {
+  size_t start = 0;
+  while (start < runs.size()) {
+    if (runs[start].being_compacted) {
+      start++;
+      continue;
+    }
+    const int logical_level =
+        LogicalLevel(mutable_cf_options, runs[start].compensated_size);
+    size_t end = start;
+    while (end + 1 < runs.size() && !runs[end + 1].being_compacted &&
+           LogicalLevel(mutable_cf_options, runs[end + 1].compensated_size) ==
+               logical_level) {
+      end++;
+    }
+    func(start, end, logical_level);
+    start = end + 1;
+  }
+}
+
+// Returns the size of the files before `last_level` which are not being
+// compacted, and the size of `last_level`
+void GetSizes(const VersionStorageInfo& vstorage, int last_level,
+              uint64_t* other_size, uint64_t* last_level_size) {
+  *other_size = 0;
+  for (int level = 0; level < last_level; level++) {
+    for (FileMetaData* f : vstorage.LevelFiles(level)) {
+      if (!f->being_compacted) {
+        *other_size += f->compensated_file_size;
+      }
+    }
+  }
+  *last_level_size = 0;
+  for (FileMetaData* f : vstorage.LevelFiles(last_level)) {
+    *last_level_size += f->compensated_file_size;
+  }
+}
+
+// A helper class that forms the compactions of
+// LazyLevelCompactionPicker::PickCompaction()
+class LazyLevelCompactionBuilder {
+ public:
+  LazyLevelCompactionBuilder(const ImmutableOptions& ioptions,
+                             const std::string& cf_name,
+                             const MutableCFOptions& mutable_cf_options,
+                             const MutableDBOptions& mutable_db_options,
+                             VersionStorageInfo* vstorage,
+                             CompactionPicker* picker, LogBuffer* log_buffer)
+      : ioptions_(ioptions),
+        cf_name_(cf_name),
+        mutable_cf_options_(mutable_cf_options),
+        mutable_db_options_(mutable_db_options),
+        vstorage_(vstorage),
+        picker_(picker),
+        log_buffer_(log_buffer),
+        last_level_(vstorage->MaxOutputLevel(ioptions.allow_ingest_behind)),
+        runs_(CalculateSortedRuns(*vstorage, last_level_)) {}
+
+  Compaction* PickCompaction();
+
+ private:
+  // Merges the sorted runs of a logical level with too many sorted runs
+  Compaction* PickSortedRunsToMerge();
+  // Compacts a file of the oldest sorted run into the last level
+  Compaction* PickFileToLastLevel();
+
+  const ImmutableOptions& ioptions_;
+  const std::string& cf_name_;
+  const MutableCFOptions& mutable_cf_options_;
+  const MutableDBOptions& mutable_db_options_;
+  VersionStorageInfo* vstorage_;
+  CompactionPicker* picker_;
+  LogBuffer* log_buffer_;
+  const int last_level_;
+  const std::vector<SortedRun> runs_;
+};
+
+Compaction* LazyLevelCompactionBuilder::PickCompaction() {
+  // Merging the sorted runs first bounds the number of L0 files, which
+  // stalls the writes.
+  Compaction* c = PickSortedRunsToMerge();
+  if (c == nullptr) {
+    c = PickFileToLastLevel();
+  }
+  return c;
+}
+
+Compaction* LazyLevelCompactionBuilder::PickSortedRunsToMerge() {
+  size_t start = runs_.size();
+  size_t end = 0;
+  int logical_level = 0;
+  ForEachLogicalLevel(
+      mutable_cf_options_, runs_, [&](size_t s, size_t e, int l) {
+        if (start < runs_.size() ||
+            e - s + 1 <=
+                static_cast<size_t>(MaxSortedRuns(mutable_cf_options_, l))) {
+          return;
+        }
+        // Only one compaction of L0 files at a time, as with the other
+        // compaction styles
+        if (runs_[s].level == 0 && picker_->IsLevel0CompactionInProgress()) {
+          return;
+        }
+        start = s;
+        end = e;
+        logical_level = l;
+      });
+  if (start == runs_.size()) {
+    return nullptr;
+  }
+
+  // The output goes right above the next older sorted run, which is older
+  // than all the inputs. It can be L0, for a single output file.
+  const int start_level = runs_[start].level;
+  int output_level;
+  if (end + 1 < runs_.size()) {
+    output_level = std::max(runs_[end + 1].level - 1, 0);
+  } else {
+    output_level = last_level_ - 1;
+  }
+  assert(output_level >= runs_[end].level);
+
+  std::vector<CompactionInputFiles> inputs(output_level - start_level + 1);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    inputs[i].level = start_level + static_cast<int>(i);
+  }
+  for (size_t i = start; i <= end; i++) {
+    if (runs_[i].level == 0) {
+      inputs[0].files.push_back(runs_[i].file);
+    } else {
+      auto& files = inputs[runs_[i].level - start_level].files;
+      const auto& level_files = vstorage_->LevelFiles(runs_[i].level);
+      files.insert(files.end(), level_files.begin(), level_files.end());
+    }
+  }
+  if (output_level != 0 &&
+      picker_->FilesRangeOverlapWithCompaction(inputs, output_level,
+                                               Compaction::kInvalidLevel)) {
+    return nullptr;
+  }
+
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Lazy level: merging %" ROCKSDB_PRIszt
+                   " sorted runs of logical level %d into level %d",
+                   cf_name_.c_str(), end - start + 1, logical_level,
+                   output_level);
+  // The reasons are shared with universal compaction, which merges sorted
+  // runs for the same reason.
+  return new Compaction(
+      vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+      std::move(inputs), output_level,
+      MaxFileSizeForLevel(mutable_cf_options_, output_level,
+                          kCompactionStyleLazyLevel),
+      /* max_compaction_bytes */ LLONG_MAX, /* output_path_id */ 0,
+      GetCompressionType(vstorage_, mutable_cf_options_, output_level, 1),
+      GetCompressionOptions(mutable_cf_options_, vstorage_, output_level),
+      mutable_cf_options_.default_write_temperature,
+      /* max_subcompactions */ 0, /* grandparents */ {},
+      /* earliest_snapshot */ std::nullopt, /* snapshot_checker */ nullptr,
+      /* is manual */ false, /* trim_ts */ "", vstorage_->CompactionScore(0),
+      /* deletion_compaction */ false, /* l0_files_might_overlap */ true,
+      CompactionReason::kUniversalSortedRunNum);
+}
+
+Compaction* LazyLevelCompactionBuilder::PickFileToLastLevel() {
+  if (runs_.empty()) {
+    return nullptr;
+  }
+  uint64_t other_size;
+  uint64_t last_level_size;
+  GetSizes(*vstorage_, last_level_, &other_size, &last_level_size);
+  if (other_size == 0 ||
+      other_size * SizeRatio(mutable_cf_options_) < last_level_size) {
+    return nullptr;
+  }
+
+  // Only the oldest sorted run can move into the last level. Among its
+  // files, prefer the ones overlapping the least with the last level.
+  const SortedRun& oldest = runs_.back();
+  std::vector<std::pair<uint64_t, FileMetaData*>> candidates;
+  if (oldest.level == 0) {
+    if (oldest.being_compacted || picker_->IsLevel0CompactionInProgress()) {
+      return nullptr;
+    }
+    candidates.emplace_back(0, oldest.file);
+  } else {
+    for (FileMetaData* f : vstorage_->LevelFiles(oldest.level)) {
+      if (f->being_compacted) {
+        continue;
+      }
+      std::vector<FileMetaData*> overlapping;
+      vstorage_->GetOverlappingInputs(last_level_, &f->smallest, &f->largest,
+                                      &overlapping);
+      const uint64_t overlapping_bytes = TotalFileSize(overlapping);
+      candidates.emplace_back(
+          overlapping_bytes * 1024U / std::max<uint64_t>(
+                                          f->compensated_file_size, 1),
+          f);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<uint64_t, FileMetaData*>& a,
+                        const std::pair<uint64_t, FileMetaData*>& b) {
+                       return a.first < b.first;
+                     });
+  }
+
+  for (const auto& candidate : candidates) {
+    CompactionInputFiles start_level_inputs;
+    start_level_inputs.level = oldest.level;
+    start_level_inputs.files.push_back(candidate.second);
+    if (oldest.level > 0 &&
+        !picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                         &start_level_inputs)) {
+      continue;
+    }
+    CompactionInputFiles output_level_inputs;
+    output_level_inputs.level = last_level_;
+    InternalKey smallest;
+    InternalKey largest;
+    picker_->GetRange(start_level_inputs, &smallest, &largest);
+    vstorage_->GetOverlappingInputs(last_level_, &smallest, &largest,
+                                    &output_level_inputs.files);
+    if (picker_->AreFilesInCompaction(output_level_inputs.files) ||
+        (!output_level_inputs.empty() &&
+         !picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                          &output_level_inputs))) {
+      continue;
+    }
+    std::vector<CompactionInputFiles> inputs{start_level_inputs};
+    if (!output_level_inputs.empty()) {
+      inputs.push_back(output_level_inputs);
+    }
+    if (picker_->FilesRangeOverlapWithCompaction(inputs, last_level_,
+                                                 Compaction::kInvalidLevel)) {
+      continue;
+    }
+
+    ROCKS_LOG_BUFFER(log_buffer_,
+                     "[%s] Lazy level: compacting file %" PRIu64
+                     " of level %d into the last level %d",
+                     cf_name_.c_str(), candidate.second->fd.GetNumber(),
+                     oldest.level, last_level_);
+    // The last level is kept at least size_ratio times as large as the other
+    // sorted runs, which bounds the size amplification.
+    return new Compaction(
+        vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
+        std::move(inputs), last_level_,
+        MaxFileSizeForLevel(mutable_cf_options_, last_level_,
+                            kCompactionStyleLazyLevel),
+        mutable_cf_options_.max_compaction_bytes, /* output_path_id */ 0,
+        GetCompressionType(vstorage_, mutable_cf_options_, last_level_, 1),
+        GetCompressionOptions(mutable_cf_options_, vstorage_, last_level_),
+        mutable_cf_options_.default_write_temperature,
+        /* max_subcompactions */ 0, /* grandparents */ {},
+        /* earliest_snapshot */ std::nullopt, /* snapshot_checker */ nullptr,
+        /* is manual */ false, /* trim_ts */ "", vstorage_->CompactionScore(0),
+        /* deletion_compaction */ false, /* l0_files_might_overlap */ false,
+        CompactionReason::kUniversalSizeAmplification);
+  }
+  return nullptr;
+}
+}  // anonymous namespace
+
+bool LazyLevelCompactionPicker::NeedsCompaction(
+    const VersionStorageInfo* vstorage) const {
+  const int kLevel0 = 0;
+  return vstorage->CompactionScore(kLevel0) >= 1;
+}
+
+Compaction* LazyLevelCompactionPicker::PickCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options,
+    const std::vector<SequenceNumber>& /* existing_snapshots */,
+    const SnapshotChecker* /* snapshot_checker */,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  LazyLevelCompactionBuilder builder(ioptions_, cf_name, mutable_cf_options,
+                                     mutable_db_options, vstorage, this,
+                                     log_buffer);
+  Compaction* c = builder.PickCompaction();
+  TEST_SYNC_POINT_CALLBACK("LazyLevelCompactionPicker::PickCompaction:Return",
+                           c);
+  if (c == nullptr) {
+    return nullptr;
+  }
+  RegisterCompaction(c);
+  vstorage->ComputeCompactionScore(ioptions_, mutable_cf_options);
+  return c;
+}
+
+double LazyLevelCompactionPicker::ComputeScore(
+    const VersionStorageInfo& vstorage,
+    const MutableCFOptions& mutable_cf_options, int last_level) {
+  double score = 0;
+  const std::vector<SortedRun> runs =
+      CalculateSortedRuns(vstorage, last_level);
+  ForEachLogicalLevel(mutable_cf_options, runs,
+                      [&](size_t start, size_t end, int logical_level) {
+                        score = std::max(
+                            score,
+                            static_cast<double>(end - start + 1) /
+                                (MaxSortedRuns(mutable_cf_options,
+                                               logical_level) +
+                                 1));
+                      });
+  uint64_t other_size;
+  uint64_t last_level_size;
+  GetSizes(vstorage, last_level, &other_size, &last_level_size);
+  if (other_size > 0) {
+    score = std::max(score, static_cast<double>(other_size) *
+                                SizeRatio(mutable_cf_options) /
+                                std::max<uint64_t>(last_level_size, 1));
+  }
+  return score;
+}
+}  // namespace ROCKSDB_NAMESPACE
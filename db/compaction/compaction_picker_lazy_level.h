@@ -0,0 +1,47 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "db/compaction/compaction_picker.h"
+
+namespace ROCKSDB_NAMESPACE {
+// Picks the compactions of kCompactionStyleLazyLevel. As with universal
+// compaction, each L0 file and each non-empty level is a sorted run, and the
+// sorted runs are ordered from the newest (L0) to the oldest (the last level).
+// Two kinds of compactions are picked:
+// - The sorted runs other than the last level are grouped in logical levels
+//   by size (see CompactionOptionsLazyLevel). When consecutive sorted runs of
+//   a logical level are more than its maximum number of sorted runs, they are
+//   merged into one sorted run, output to the level right above the next
+//   older sorted run (tiering).
+// - When the last level is less than size_ratio times the size of the other
+//   sorted runs, a file of the oldest sorted run other than the last level
+//   is compacted with the overlapping files of the last level (leveling).
+class LazyLevelCompactionPicker : public CompactionPicker {
+ public:
+  LazyLevelCompactionPicker(const ImmutableOptions& ioptions,
+                            const InternalKeyComparator* icmp)
+      : CompactionPicker(ioptions, icmp) {}
+
+  Compaction* PickCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      const MutableDBOptions& mutable_db_options,
+      const std::vector<SequenceNumber>& existing_snapshots,
+      const SnapshotChecker* snapshot_checker, VersionStorageInfo* vstorage,
+      LogBuffer* log_buffer) override;
+
+  int MaxOutputLevel() const override { return NumberLevels() - 1; }
+
+  bool NeedsCompaction(const VersionStorageInfo* vstorage) const override;
+
+  // Returns the compaction score of the whole `vstorage`, which is at least 1
+  // when one of the compactions above is needed. It is stored as the score of
+  // level 0 by VersionStorageInfo::ComputeCompactionScore().
+  static double ComputeScore(const VersionStorageInfo& vstorage,
+                             const MutableCFOptions& mutable_cf_options,
+                             int last_level);
+};
+}  // namespace ROCKSDB_NAMESPACE
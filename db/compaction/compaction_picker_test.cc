@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction.h"
 #include "db/compaction/compaction_picker_fifo.h"
+#include "db/compaction/compaction_picker_lazy_level.h"
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/compaction/file_pri.h"
@@ -1568,6 +1569,45 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriReadHeatAndOverlapping) {
+  for (bool hot : {false, true}) {
+    SCOPED_TRACE("hot=" + std::to_string(hot));
+    NewVersionStorage(6, kCompactionStyleLevel);
+    ioptions_.compaction_pri = kReadHeatAndOverlappingRatio;
+    mutable_cf_options_.target_file_size_base = 100000000000;
+    mutable_cf_options_.target_file_size_multiplier = 10;
+    mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+    mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+
+    Add(2, 6U, "150", "179", 50000000U);  // Overlaps with file 26
+    Add(2, 7U, "180", "220", 50000000U);  // Overlaps with file 27, 28
+    Add(2, 8U, "721", "800", 50000000U);  // Overlaps with file 29
+
+    Add(3, 26U, "150", "179", 260000000U);
+    Add(3, 27U, "180", "200", 260000000U);
+    Add(3, 28U, "201", "220", 260000000U);
+    Add(3, 29U, "750", "900", 260000000U);
+    if (hot) {
+      // 3 times as many reads per byte as the level, which makes up for its
+      // twice larger overlapping ratio
+      file_map_[7U].first->stats.num_reads_sampled = 100 * 1024;
+    }
+    UpdateVersionStorageInfo();
+    LevelCompactionPicker local_level_compaction_picker =
+        LevelCompactionPicker(ioptions_, &icmp_);
+    std::unique_ptr<Compaction> compaction(
+        local_level_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+            vstorage_.get(), &log_buffer_));
+    ASSERT_TRUE(compaction.get() != nullptr);
+    ASSERT_EQ(1U, compaction->num_input_files(0));
+    // Without sampled reads, file 6 has the smallest overlapping ratio
+    ASSERT_EQ(hot ? 7U : 6U, compaction->input(0, 0)->fd.GetNumber());
+    DeleteVersionStorage();
+  }
+}
+
 TEST_F(CompactionPickerTest, CompactionPriRoundRobin) {
   std::vector<InternalKey> test_cursors = {InternalKey("249", 100, kTypeValue),
                                            InternalKey("600", 100, kTypeValue),
@@ -3784,6 +3824,155 @@ TEST_F(CompactionPickerTest, UniversalSizeAmpTierCompactionLastLevel) {
   ASSERT_EQ(compaction->input_levels(6)->num_files, 0);
 }
 
+TEST_F(CompactionPickerTest, LazyLevelMergeSortedRuns) {
+  const uint64_t kFileSize = 1000;
+  const int kNumLevels = 5;
+
+  ioptions_.compaction_style = kCompactionStyleLazyLevel;
+  mutable_cf_options_.write_buffer_size = kFileSize;
+  mutable_cf_options_.compaction_options_lazy_level.max_sorted_runs = 2;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  LazyLevelCompactionPicker lazy_level_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(kNumLevels, kCompactionStyleLazyLevel);
+  // Three sorted runs of logical level 0, and one of logical level 1
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "260", "300", kFileSize, 0, 301, 350);
+  Add(3, 4U, "100", "400", 5 * kFileSize, 0, 200, 250);
+  Add(4, 5U, "100", "400", 1000 * kFileSize, 0, 100, 150);
+  UpdateVersionStorageInfo();
+
+  ASSERT_TRUE(lazy_level_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      lazy_level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_,
+          /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+          vstorage_.get(), &log_buffer_));
+
+  // The L0 files are merged right above the next older sorted run
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSortedRunNum,
+            compaction->compaction_reason());
+  ASSERT_EQ(0, compaction->start_level());
+  ASSERT_EQ(2, compaction->output_level());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(0U, compaction->num_input_files(1));
+  ASSERT_EQ(0U, compaction->num_input_files(2));
+}
+
+TEST_F(CompactionPickerTest, LazyLevelMergeSortedRunsIntoL0) {
+  const uint64_t kFileSize = 1000;
+  const int kNumLevels = 5;
+
+  ioptions_.compaction_style = kCompactionStyleLazyLevel;
+  mutable_cf_options_.write_buffer_size = kFileSize;
+  mutable_cf_options_.compaction_options_lazy_level.max_sorted_runs = 4;
+  mutable_cf_options_.compaction_options_lazy_level.max_sorted_runs_per_level =
+      {2};
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  LazyLevelCompactionPicker lazy_level_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(kNumLevels, kCompactionStyleLazyLevel);
+  // The oldest L0 file is of logical level 1, and is not merged with the
+  // newer ones
+  Add(0, 1U, "150", "200", kFileSize, 0, 500, 550);
+  Add(0, 2U, "201", "250", kFileSize, 0, 401, 450);
+  Add(0, 3U, "260", "300", kFileSize, 0, 301, 350);
+  Add(0, 4U, "100", "400", 5 * kFileSize, 0, 200, 250);
+  Add(4, 5U, "100", "400", 1000 * kFileSize, 0, 100, 150);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      lazy_level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_,
+          /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+          vstorage_.get(), &log_buffer_));
+
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(0, compaction->output_level());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 2)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, LazyLevelFileToLastLevel) {
+  const uint64_t kFileSize = 1000;
+  const int kNumLevels = 5;
+
+  ioptions_.compaction_style = kCompactionStyleLazyLevel;
+  mutable_cf_options_.write_buffer_size = kFileSize;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  LazyLevelCompactionPicker lazy_level_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(kNumLevels, kCompactionStyleLazyLevel);
+  // The last level is less than 10 times the size of the rest of the data
+  Add(0, 1U, "150", "350", kFileSize, 0, 500, 550);
+  Add(2, 2U, "100", "199", kFileSize, 0, 200, 250);
+  Add(2, 3U, "200", "299", kFileSize, 0, 200, 250);
+  Add(2, 4U, "300", "399", kFileSize, 0, 200, 250);
+  Add(4, 5U, "100", "199", 20 * kFileSize, 0, 100, 150);
+  Add(4, 6U, "300", "399", 10 * kFileSize, 0, 100, 150);
+  UpdateVersionStorageInfo();
+
+  ASSERT_TRUE(lazy_level_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      lazy_level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_,
+          /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+          vstorage_.get(), &log_buffer_));
+
+  // The file of the oldest sorted run overlapping the least with the last
+  // level is moved into it
+  ASSERT_TRUE(compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSizeAmplification,
+            compaction->compaction_reason());
+  ASSERT_EQ(2, compaction->start_level());
+  ASSERT_EQ(4, compaction->output_level());
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(3U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_TRUE(compaction->IsTrivialMove());
+
+  // The next one is compacted with the overlapping last level file
+  std::unique_ptr<Compaction> compaction2(
+      lazy_level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_,
+          /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+          vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction2);
+  ASSERT_EQ(2, compaction2->start_level());
+  ASSERT_EQ(4, compaction2->output_level());
+  ASSERT_EQ(4U, compaction2->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction2->num_input_files(1));
+  ASSERT_EQ(6U, compaction2->input(1, 0)->fd.GetNumber());
+  ASSERT_FALSE(compaction2->IsTrivialMove());
+}
+
+TEST_F(CompactionPickerTest, LazyLevelNoCompactionNeeded) {
+  const uint64_t kFileSize = 1000;
+  const int kNumLevels = 5;
+
+  ioptions_.compaction_style = kCompactionStyleLazyLevel;
+  mutable_cf_options_.write_buffer_size = kFileSize;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  LazyLevelCompactionPicker lazy_level_compaction_picker(ioptions_, &icmp_);
+
+  NewVersionStorage(kNumLevels, kCompactionStyleLazyLevel);
+  Add(0, 1U, "150", "350", kFileSize, 0, 500, 550);
+  Add(0, 2U, "150", "350", kFileSize, 0, 400, 450);
+  Add(3, 3U, "100", "399", 8 * kFileSize, 0, 200, 250);
+  Add(4, 4U, "100", "399", 200 * kFileSize, 0, 100, 150);
+  UpdateVersionStorageInfo();
+
+  ASSERT_FALSE(lazy_level_compaction_picker.NeedsCompaction(vstorage_.get()));
+  std::unique_ptr<Compaction> compaction(
+      lazy_level_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, mutable_db_options_,
+          /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+          vstorage_.get(), &log_buffer_));
+  ASSERT_FALSE(compaction);
+}
+
 TEST_F(CompactionPickerU64TsTest, Overlap) {
   int num_levels = ioptions_.num_levels;
   NewVersionStorage(num_levels, kCompactionStyleLevel);
@@ -695,6 +695,26 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, num_single_del_mismatch),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"pipeline_input_busy_micros",
+         {offsetof(struct CompactionJobStats, pipeline_input_busy_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"pipeline_input_stall_micros",
+         {offsetof(struct CompactionJobStats, pipeline_input_stall_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"pipeline_merge_stall_micros",
+         {offsetof(struct CompactionJobStats, pipeline_merge_stall_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_data_blocks_copied",
+         {offsetof(struct CompactionJobStats, num_data_blocks_copied),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"num_data_blocks_rewritten",
+         {offsetof(struct CompactionJobStats, num_data_blocks_rewritten),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 namespace {
@@ -0,0 +1,265 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include <algorithm>
+
+#include "monitoring/iostats_context_imp.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+void PipelinedRangeDelAggregator::AddTombstones(
+    std::unique_ptr<FragmentedRangeTombstoneIterator> input_iter,
+    const InternalKey* smallest, const InternalKey* largest) {
+  PendingTombstones tombstones;
+  tombstones.index = 0;
+  tombstones.iter = std::move(input_iter);
+  tombstones.smallest = smallest;
+  tombstones.largest = largest;
+  pending_.push_back(std::move(tombstones));
+}
+
+void PipelinedRangeDelAggregator::TakePending(
+    size_t index, std::vector<PendingTombstones>* tombstones) {
+  for (auto& pending : pending_) {
+    pending.index = index;
+    tombstones->push_back(std::move(pending));
+  }
+  pending_.clear();
+}
+
+void PipelinedInputIterator::Batch::Clear() {
+  data.clear();
+  entries.clear();
+  tombstones.clear();
+  bytes_read = 0;
+  last = false;
+  status = Status::OK();
+}
+
+PipelinedInputIterator::PipelinedInputIterator(
+    InternalIterator* input, PipelinedRangeDelAggregator* input_range_del_agg,
+    RangeDelAggregator* range_del_agg, size_t buffer_size, SystemClock* clock)
+    : input_(input),
+      input_range_del_agg_(input_range_del_agg),
+      range_del_agg_(range_del_agg),
+      batch_size_(std::max(buffer_size / kNumBatches, size_t{1})),
+      clock_(clock),
+      batches_(new Batch[kNumBatches]),
+      can_read_(&mutex_),
+      can_fill_(&mutex_) {
+  for (size_t i = 0; i < kNumBatches; i++) {
+    free_.push_back(&batches_[i]);
+  }
+}
+
+PipelinedInputIterator::~PipelinedInputIterator() { Stop(); }
+
+void PipelinedInputIterator::SeekToFirst() {
+  Restart([this]() { input_->SeekToFirst(); });
+}
+
+void PipelinedInputIterator::Seek(const Slice& target) {
+  Restart([this, &target]() { input_->Seek(target); });
+}
+
+void PipelinedInputIterator::SeekToLast() {
+  assert(false);
+  status_ = Status::NotSupported("SeekToLast() not supported");
+}
+
+void PipelinedInputIterator::SeekForPrev(const Slice& /*target*/) {
+  assert(false);
+  status_ = Status::NotSupported("SeekForPrev() not supported");
+}
+
+void PipelinedInputIterator::Prev() {
+  assert(false);
+  status_ = Status::NotSupported("Prev() not supported");
+}
+
+void PipelinedInputIterator::Next() {
+  assert(Valid());
+  ++pos_;
+  AddTombstones(/*all=*/false);
+  if (pos_ == current_->entries.size() && !current_->last) {
+    NextBatch();
+  }
+}
+
+Slice PipelinedInputIterator::key() const {
+  assert(Valid());
+  const Entry& entry = current_->entries[pos_];
+  return Slice(current_->data.data() + entry.offset, entry.key_size);
+}
+
+Slice PipelinedInputIterator::value() const {
+  assert(Valid());
+  const Entry& entry = current_->entries[pos_];
+  return Slice(current_->data.data() + entry.offset + entry.key_size,
+               entry.value_size);
+}
+
+Status PipelinedInputIterator::status() const {
+  if (!status_.ok()) {
+    return status_;
+  }
+  if (current_ != nullptr && !Valid()) {
+    return current_->status;
+  }
+  return Status::OK();
+}
+
+bool PipelinedInputIterator::IsDeleteRangeSentinelKey() const {
+  assert(Valid());
+  return current_->entries[pos_].is_range_del_sentinel;
+}
+
+void PipelinedInputIterator::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    MutexLock l(&mutex_);
+    stop_ = true;
+    can_fill_.SignalAll();
+  }
+  thread_.join();
+}
+
+template <typename PositionFunc>
+void PipelinedInputIterator::Restart(const PositionFunc& position) {
+  Stop();
+  // The input files of the tombstones not added yet are not opened again
+  // (see RangeDelAggregator::AddFile()), so add them all. Adding them early
+  // is fine, as they are truncated to the bounds of their files.
+  if (current_ != nullptr) {
+    AddTombstones(/*all=*/true);
+    free_.push_back(current_);
+    current_ = nullptr;
+  }
+  for (Batch* batch : ready_) {
+    for (auto& tombstones : batch->tombstones) {
+      range_del_agg_->AddTombstones(std::move(tombstones.iter),
+                                    tombstones.smallest, tombstones.largest);
+    }
+    free_.push_back(batch);
+  }
+  ready_.clear();
+  status_ = Status::OK();
+  stop_ = false;
+
+  position();
+  thread_ = port::Thread([this]() { RunInput(); });
+  NextBatch();
+}
+
+void PipelinedInputIterator::RunInput() {
+  const uint64_t start_cpu_micros = clock_->CPUMicros();
+  uint64_t busy_start_micros = clock_->NowMicros();
+  uint64_t busy_micros = 0;
+  uint64_t stall_micros = 0;
+  IOSTATS_RESET(bytes_read);
+  bool done = false;
+  while (!done) {
+    Batch* batch;
+    {
+      MutexLock l(&mutex_);
+      if (free_.empty() && !stop_) {
+        const uint64_t stall_start_micros = clock_->NowMicros();
+        busy_micros += stall_start_micros - busy_start_micros;
+        while (free_.empty() && !stop_) {
+          can_fill_.Wait();
+        }
+        busy_start_micros = clock_->NowMicros();
+        stall_micros += busy_start_micros - stall_start_micros;
+      }
+      if (stop_) {
+        break;
+      }
+      batch = free_.back();
+      free_.pop_back();
+    }
+
+    batch->Clear();
+    while (input_->Valid() && batch->data.size() < batch_size_) {
+      input_range_del_agg_->TakePending(batch->entries.size(),
+                                        &batch->tombstones);
+      const Slice key = input_->key();
+      const Slice value = input_->value();
+      batch->entries.push_back({batch->data.size(),
+                                static_cast<uint32_t>(key.size()),
+                                static_cast<uint32_t>(value.size()),
+                                input_->IsDeleteRangeSentinelKey()});
+      batch->data.append(key.data(), key.size());
+      batch->data.append(value.data(), value.size());
+      input_->Next();
+    }
+    input_range_del_agg_->TakePending(batch->entries.size(),
+                                      &batch->tombstones);
+    if (!input_->Valid()) {
+      batch->last = true;
+      batch->status = input_->status();
+      done = true;
+    }
+    // Accounted for by the compaction thread
+    batch->bytes_read = IOSTATS(bytes_read);
+    IOSTATS_RESET(bytes_read);
+
+    MutexLock l(&mutex_);
+    ready_.push_back(batch);
+    can_read_.Signal();
+  }
+
+  busy_micros += clock_->NowMicros() - busy_start_micros;
+  const uint64_t cpu_micros = clock_->CPUMicros() - start_cpu_micros;
+  MutexLock l(&mutex_);
+  input_busy_micros_ += busy_micros;
+  input_stall_micros_ += stall_micros;
+  input_cpu_micros_ += cpu_micros;
+}
+
+void PipelinedInputIterator::NextBatch() {
+  if (current_ != nullptr) {
+    AddTombstones(/*all=*/true);
+  }
+  {
+    MutexLock l(&mutex_);
+    if (current_ != nullptr) {
+      free_.push_back(current_);
+      can_fill_.Signal();
+    }
+    if (ready_.empty()) {
+      const uint64_t stall_start_micros = clock_->NowMicros();
+      while (ready_.empty()) {
+        can_read_.Wait();
+      }
+      stall_micros_ += clock_->NowMicros() - stall_start_micros;
+    }
+    current_ = ready_.front();
+    ready_.pop_front();
+  }
+  pos_ = 0;
+  next_tombstones_ = 0;
+  IOSTATS_ADD(bytes_read, current_->bytes_read);
+  AddTombstones(/*all=*/false);
+  if (current_->entries.empty() && !current_->last) {
+    NextBatch();
+  }
+}
+
+void PipelinedInputIterator::AddTombstones(bool all) {
+  auto& tombstones = current_->tombstones;
+  while (next_tombstones_ < tombstones.size() &&
+         (all || tombstones[next_tombstones_].index <= pos_)) {
+    auto& pending = tombstones[next_tombstones_++];
+    range_del_agg_->AddTombstones(std::move(pending.iter), pending.smallest,
+                                  pending.largest);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
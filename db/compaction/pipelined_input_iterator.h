@@ -0,0 +1,168 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/range_del_aggregator.h"
+#include "port/port.h"
+#include "rocksdb/system_clock.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The range deletion aggregator given to the input iterators of a pipelined
+// compaction. It only collects the range tombstones of the input files as
+// they are opened on the input thread, for PipelinedInputIterator to add
+// them to the aggregator of the compaction, on the compaction thread, when
+// it gets to the entry at which they were added.
+class PipelinedRangeDelAggregator : public RangeDelAggregator {
+ public:
+  struct PendingTombstones {
+    // Position of the entry, in its batch, before which they were added
+    size_t index;
+    std::unique_ptr<FragmentedRangeTombstoneIterator> iter;
+    // Point to the file metadata or the compaction boundaries, which outlive
+    // the compaction. The aggregator keeps referring to them.
+    const InternalKey* smallest;
+    const InternalKey* largest;
+  };
+
+  explicit PipelinedRangeDelAggregator(const InternalKeyComparator* icmp)
+      : RangeDelAggregator(icmp) {}
+
+  void AddTombstones(
+      std::unique_ptr<FragmentedRangeTombstoneIterator> input_iter,
+      const InternalKey* smallest = nullptr,
+      const InternalKey* largest = nullptr) override;
+
+  // Only used on the compaction side
+  bool ShouldDelete(const ParsedInternalKey& /*parsed*/,
+                    RangeDelPositioningMode /*mode*/) override {
+    assert(false);
+    return false;
+  }
+  void InvalidateRangeDelMapPositions() override {}
+
+  bool IsEmpty() const override { return pending_.empty(); }
+
+  // Moves the tombstones added since the last call to `tombstones`, at
+  // `index`
+  void TakePending(size_t index, std::vector<PendingTombstones>* tombstones);
+
+ private:
+  std::vector<PendingTombstones> pending_;
+};
+
+// An InternalIterator over the entries of another one, which reads them
+// ahead on a separate thread, for compactions with
+// AdvancedColumnFamilyOptions::compaction_pipeline_buffer_size. The input
+// thread does the reading, decompression and merging of the input files,
+// and hands over copies of the entries in batches, through a bounded queue,
+// to the thread using this iterator.
+//
+// Only supports the forward iteration used by compactions. Seeking stops the
+// input thread, so it is meant to be rare.
+class PipelinedInputIterator : public InternalIterator {
+ public:
+  // `input` must use `input_range_del_agg`, and both must outlive this
+  // iterator. The range tombstones are added to `range_del_agg`.
+  PipelinedInputIterator(InternalIterator* input,
+                         PipelinedRangeDelAggregator* input_range_del_agg,
+                         RangeDelAggregator* range_del_agg, size_t buffer_size,
+                         SystemClock* clock);
+  ~PipelinedInputIterator() override;
+
+  bool Valid() const override {
+    return current_ != nullptr && pos_ < current_->entries.size();
+  }
+  void SeekToFirst() override;
+  void Seek(const Slice& target) override;
+  void Next() override;
+  Slice key() const override;
+  Slice value() const override;
+  Status status() const override;
+  bool IsDeleteRangeSentinelKey() const override;
+
+  // Unused InternalIterator methods
+  void SeekToLast() override;
+  void SeekForPrev(const Slice& target) override;
+  void Prev() override;
+
+  // Stops the input thread. The statistics below are final after this.
+  void Stop();
+
+  // Time the input thread spent reading, and stalled on a full queue
+  uint64_t GetInputBusyMicros() const { return input_busy_micros_; }
+  uint64_t GetInputStallMicros() const { return input_stall_micros_; }
+  uint64_t GetInputCpuMicros() const { return input_cpu_micros_; }
+  // Time this iterator waited for the input thread
+  uint64_t GetStallMicros() const { return stall_micros_; }
+
+ private:
+  static constexpr size_t kNumBatches = 4;
+
+  struct Entry {
+    size_t offset;
+    uint32_t key_size;
+    uint32_t value_size;
+    bool is_range_del_sentinel;
+  };
+
+  struct Batch {
+    // Keys and values of the entries
+    std::string data;
+    std::vector<Entry> entries;
+    // Sorted by index
+    std::vector<PipelinedRangeDelAggregator::PendingTombstones> tombstones;
+    uint64_t bytes_read = 0;
+    // Whether the input ended, with `status`, after the entries
+    bool last = false;
+    Status status;
+
+    void Clear();
+  };
+
+  // Restarts the input thread after `position` positions the input
+  template <typename PositionFunc>
+  void Restart(const PositionFunc& position);
+  void RunInput();
+  // Switches to the next batch from the input thread
+  void NextBatch();
+  // Adds the tombstones of the current batch up to the current entry
+  void AddTombstones(bool all);
+
+  InternalIterator* const input_;
+  PipelinedRangeDelAggregator* const input_range_del_agg_;
+  RangeDelAggregator* const range_del_agg_;
+  const size_t batch_size_;
+  SystemClock* const clock_;
+
+  std::unique_ptr<Batch[]> batches_;
+  Batch* current_ = nullptr;
+  size_t pos_ = 0;
+  size_t next_tombstones_ = 0;
+  Status status_;
+  port::Thread thread_;
+
+  // Protects the following state
+  port::Mutex mutex_;
+  port::CondVar can_read_;
+  port::CondVar can_fill_;
+  std::deque<Batch*> ready_;
+  std::vector<Batch*> free_;
+  bool stop_ = false;
+  uint64_t input_busy_micros_ = 0;
+  uint64_t input_stall_micros_ = 0;
+  uint64_t input_cpu_micros_ = 0;
+
+  uint64_t stall_micros_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
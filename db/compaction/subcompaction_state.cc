@@ -116,4 +116,12 @@ Status SubcompactionState::AddToOutput(
   return current_outputs_->AddToOutput(iter, open_file_func, close_file_func);
 }
 
+Status SubcompactionState::AddRawDataBlockToOutput(
+    const RawDataBlock& block, const CompactionFileOpenFunc& open_file_func,
+    const CompactionFileCloseFunc& close_file_func, bool* copied) {
+  current_outputs_ = &compaction_outputs_;
+  return current_outputs_->AddRawDataBlockToOutput(block, open_file_func,
+                                                   close_file_func, copied);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
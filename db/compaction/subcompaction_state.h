@@ -69,6 +69,10 @@ class SubcompactionState {
   // compaction job stats for this sub-compaction
   CompactionJobStats compaction_job_stats;
 
+  // The ranges of user keys of the input data blocks in the block cache, for
+  // PrepopulateBlockCache::kFlushAndHotCompaction. See TableBuilderOptions.
+  std::vector<std::pair<std::string, std::string>> hot_key_ranges;
+
   // sub-compaction job id, which is used to identify different sub-compaction
   // within the same compaction job.
   const uint32_t sub_job_id;
@@ -139,6 +143,7 @@ class SubcompactionState {
         notify_on_subcompaction_completion(
             state.notify_on_subcompaction_completion),
         compaction_job_stats(std::move(state.compaction_job_stats)),
+        hot_key_ranges(std::move(state.hot_key_ranges)),
         sub_job_id(state.sub_job_id),
         compaction_outputs_(std::move(state.compaction_outputs_)),
         penultimate_level_outputs_(std::move(state.penultimate_level_outputs_)),
@@ -184,6 +189,13 @@ class SubcompactionState {
                      const CompactionFileOpenFunc& open_file_func,
                      const CompactionFileCloseFunc& close_file_func);
 
+  // Add a data block of the input to the normal output group as is, if
+  // possible. See CompactionOutputs::AddRawDataBlockToOutput().
+  Status AddRawDataBlockToOutput(const RawDataBlock& block,
+                                 const CompactionFileOpenFunc& open_file_func,
+                                 const CompactionFileCloseFunc& close_file_func,
+                                 bool* copied);
+
   // Close all compaction output files, both output_to_penultimate_level outputs
   // and normal outputs.
   Status CloseCompactionFiles(const Status& curr_status,
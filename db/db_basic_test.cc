@@ -5165,6 +5165,100 @@ TEST_F(DBBasicTest, DisallowMemtableWrite) {
 
 // TODO: re-enable after we provide finer-grained control for WAL tracking to
 // meet the needs of different use cases, durability levels and recovery modes.
+TEST_F(DBBasicTest, NegativeLookupCache) {
+  Options options = CurrentOptions();
+  options.negative_lookup_cache_size = 64 << 10;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+  auto hits = [&]() {
+    return TestGetAndResetTickerCount(options, NEGATIVE_LOOKUP_CACHE_HIT);
+  };
+  auto misses = [&]() {
+    return TestGetAndResetTickerCount(options, NEGATIVE_LOOKUP_CACHE_MISS);
+  };
+
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 0);
+  ASSERT_EQ(misses(), 1);
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+  ASSERT_EQ(misses(), 0);
+  // Found keys are not cached
+  ASSERT_EQ(Get("a"), "va");
+  ASSERT_EQ(hits(), 0);
+  ASSERT_EQ(misses(), 0);
+
+  // Writes drop the cached misses
+  ASSERT_OK(Put("x", "vx"));
+  ASSERT_EQ(Get("x"), "vx");
+  ASSERT_EQ(hits(), 0);
+
+  // Deleted keys are cached, but still found at older snapshots
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Delete("x"));
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  ASSERT_EQ(misses(), 1);
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+  ASSERT_EQ(Get("x", snapshot), "vx");
+  ASSERT_EQ(hits(), 0);
+  // And misses at the snapshot can't be served at the latest sequence
+  // number, as there is a write in between
+  ASSERT_EQ(Get("y", snapshot), "NOT_FOUND");
+  ASSERT_EQ(misses(), 1);
+  ASSERT_OK(Put("y", "vy"));
+  ASSERT_EQ(Get("y"), "vy");
+  ASSERT_EQ(hits(), 0);
+  db_->ReleaseSnapshot(snapshot);
+
+  // Range deletions drop all the cached misses, as they can hide entries
+  // visible at older snapshots
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+  snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "y",
+                             "z"));
+  ASSERT_EQ(Get("y", snapshot), "vy");
+  ASSERT_EQ(Get("x", snapshot), "NOT_FOUND");
+  ASSERT_EQ(hits(), 0);
+  ASSERT_EQ(Get("y"), "NOT_FOUND");
+  ASSERT_EQ(Get("y"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+  db_->ReleaseSnapshot(snapshot);
+
+  // Cached misses survive flushes and compactions
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(Get("y"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+
+  // File ingestion drops all the cached misses
+  ASSERT_EQ(Get("k"), "NOT_FOUND");
+  ASSERT_EQ(Get("k"), "NOT_FOUND");
+  ASSERT_EQ(hits(), 1);
+  std::string file = dbname_ + "/negative_lookup_cache.sst";
+  SstFileWriter writer(EnvOptions(), options);
+  ASSERT_OK(writer.Open(file));
+  ASSERT_OK(writer.Put("k", "vk"));
+  ASSERT_OK(writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({file}, IngestExternalFileOptions()));
+  ASSERT_EQ(Get("k"), "vk");
+  ASSERT_EQ(hits(), 0);
+
+  // Not used when not reading all tiers
+  ASSERT_EQ(Get("x"), "NOT_FOUND");
+  misses();
+  ReadOptions read_options;
+  read_options.read_tier = kBlockCacheTier;
+  std::string value;
+  Status s = db_->Get(read_options, "x", &value);
+  ASSERT_TRUE(s.IsNotFound() || s.IsIncomplete());
+  ASSERT_EQ(hits(), 0);
+  ASSERT_EQ(misses(), 0);
+}
+
 TEST_F(DBBasicTest, DISABLED_ManualWalSync) {
   Options options = CurrentOptions();
   options.track_and_verify_wals_in_manifest = true;
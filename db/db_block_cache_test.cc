@@ -436,6 +436,113 @@ TEST_F(DBBlockCacheTest, IndexAndFilterBlocksStats) {
             filter_bytes_insert);
 }
 
+TEST_F(DBBlockCacheTest, QuotaCache) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.compression = kNoCompression;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  std::shared_ptr<Cache> cache = NewLRUCache(1 << 20, /*num_shard_bits=*/0);
+  QuotaCacheOptions quota_opts;
+  quota_opts.cache = cache;
+  quota_opts.role_quotas[CacheEntryRole::kDataBlock].hard_limit = 8 << 10;
+  quota_opts.statistics = options.statistics;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewQuotaCache(quota_opts);
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+
+  std::map<std::string, std::string> values_map;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheQuota, &values_map));
+  ASSERT_LE(std::stoull(values_map["data-block.usage"]), 8 << 10);
+  ASSERT_EQ(values_map["data-block.hard-limit"], std::to_string(8 << 10));
+  ASSERT_GT(std::stoull(values_map["rejected"]), 0);
+  ASSERT_EQ(values_map["rejected"],
+            std::to_string(TestGetTickerCount(options,
+                                              BLOCK_CACHE_QUOTA_REJECTED)));
+  std::string str;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kBlockCacheQuota, &str));
+  ASSERT_NE(str.find("data-block.usage: "), std::string::npos);
+
+  // Not available without a QuotaCache
+  table_options.block_cache = cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_FALSE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheQuota, &values_map));
+}
+
+TEST_F(DBBlockCacheTest, BlockCacheDumpFile) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.block_cache_dump_file = dbname_ + "/block_cache_dump";
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(4 << 20, /*num_shard_bits=*/0);
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.cache_index_and_filter_blocks = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  uint64_t num_data_blocks =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  ASSERT_GT(num_data_blocks, 0);
+  Close();
+  ASSERT_OK(env_->FileExists(options.block_cache_dump_file));
+
+  // The data and filter blocks are loaded into a new block cache on open
+  table_options.block_cache = NewLRUCache(4 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_OK(options.statistics->Reset());
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS), 0);
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT), 200);
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS), 0);
+
+  // Blocks of table files no longer live are not loaded
+  options.block_cache_dump_file.clear();
+  Reopen(options);
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  Close();
+  options.block_cache_dump_file = dbname_ + "/block_cache_dump";
+  table_options.block_cache = NewLRUCache(4 << 20, /*num_shard_bits=*/0);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_OK(options.statistics->Reset());
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS),
+            num_data_blocks);
+}
+
 #if (defined OS_LINUX || defined OS_WIN)
 TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringFlush) {
   Options options = CurrentOptions();
@@ -466,6 +573,66 @@ TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringFlush) {
             options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmCacheWithHotDataBlocksDuringCompaction) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Two files with cold blocks, as they are not warmed during flush
+  const int kNumKeys = 100;
+  std::string value(kValueSize, 'a');
+  for (char prefix : {'a', 'b'}) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(prefix + std::to_string(1000 + i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  auto st = options.statistics;
+  ASSERT_EQ(0, st->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD));
+
+  // Read the 'a' keys, which brings their blocks in cache
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(value, Get('a' + std::to_string(1000 + i)));
+  }
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"block_based_table_factory",
+        "{prepopulate_block_cache=kFlushAndHotCompaction;}"}}));
+  st->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD);
+
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForceOptimized;
+  ASSERT_OK(db_->CompactRange(cro, /*begin=*/nullptr, /*end=*/nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  // Only the blocks of the 'a' keys (and maybe one shared with 'b' keys)
+  // were warmed
+  const uint64_t warmed = st->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD);
+  ASSERT_GT(warmed, 0);
+  // From reading the compaction inputs
+  st->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(value, Get('a' + std::to_string(1000 + i)));
+  }
+  ASSERT_EQ(0, st->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(value, Get('b' + std::to_string(1000 + i)));
+  }
+  const uint64_t missed = st->getAndResetTickerCount(BLOCK_CACHE_DATA_MISS);
+  ASSERT_GT(missed, 0);
+  ASSERT_EQ(missed, st->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD));
+  // With the 'b' keys now in cache, the next compaction warms all the blocks
+  ASSERT_OK(db_->CompactRange(cro, /*begin=*/nullptr, /*end=*/nullptr));
+  ASSERT_EQ(warmed + missed, st->getAndResetTickerCount(BLOCK_CACHE_DATA_ADD));
+}
+
 // This test cache data, index and filter blocks during flush.
 class DBBlockCacheTest1 : public DBTestBase,
                           public ::testing::WithParamInterface<uint32_t> {
@@ -5113,7 +5113,7 @@ TEST_F(DBCompactionTest, LevelPeriodicCompaction) {
       ASSERT_EQ(2, periodic_compactions);
 
       MoveFilesToLevel(1);
-      ASSERT_EQ("0,3", FilesPerLevel());
+      ASSERT_EQ(0, NumTableFilesAtLevel(0));
 
       // Add another 50 hours and do another write
       env_->MockSleepForSeconds(50 * 60 * 60);
@@ -5221,7 +5221,7 @@ TEST_F(DBCompactionTest, LevelPeriodicCompactionOffpeak) {
     ASSERT_EQ("3", FilesPerLevel());
     ASSERT_EQ(0, periodic_compactions);
     MoveFilesToLevel(1);
-    ASSERT_EQ("0,3", FilesPerLevel());
+    ASSERT_EQ(0, NumTableFilesAtLevel(0));
 
     // Move clock forward by 4 days and check if it triggers periodic
     // comapaction at 1:15AM Day 4. Files created on Day 0 at 12:15AM is
@@ -5996,6 +5996,239 @@ TEST_F(DBCompactionTest, SubcompactionEvent) {
   ASSERT_GT(listener->GetTotalSubcompactionCount(), 0);
 }
 
+TEST_F(DBCompactionTest, PipelinedCompactionInput) {
+  class PipelineStatsListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.Add(ci.stats);
+    }
+    CompactionJobStats GetStats() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+   private:
+    std::mutex mutex_;
+    CompactionJobStats stats_;
+  };
+  // Drops the keys of every 5th block of 100 keys with range skips, which
+  // seek the compaction input
+  class SkipFilter : public CompactionFilter {
+   public:
+    Decision FilterV2(int /*level*/, const Slice& key, ValueType /*type*/,
+                      const Slice& /*existing_value*/,
+                      std::string* /*new_value*/,
+                      std::string* skip_until) const override {
+      int i = std::stoi(key.ToString().substr(3));
+      if (i / 100 % 5 == 2) {
+        *skip_until = Key(i / 100 * 100 + 100);
+        return Decision::kRemoveAndSkipUntil;
+      }
+      return Decision::kKeep;
+    }
+    const char* Name() const override { return "SkipFilter"; }
+  };
+  SkipFilter filter;
+
+  std::string expected;
+  for (size_t buffer_size : {0, 1, 4096, 1 << 20}) {
+    SCOPED_TRACE("buffer_size=" + std::to_string(buffer_size));
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.compaction_filter = &filter;
+    options.compaction_pipeline_buffer_size = buffer_size;
+    options.target_file_size_base = 16 << 10;
+    options.max_subcompactions = 2;
+    auto listener = std::make_shared<PipelineStatsListener>();
+    options.listeners.emplace_back(listener);
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(50)));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    for (int f = 0; f < 4; f++) {
+      for (int i = 0; i < 200; i++) {
+        const int k = static_cast<int>(rnd.Uniform(1000));
+        if (rnd.OneIn(4)) {
+          ASSERT_OK(Delete(Key(k)));
+        } else {
+          ASSERT_OK(Put(Key(k), rnd.RandomString(50)));
+        }
+      }
+      const int begin = static_cast<int>(rnd.Uniform(950));
+      ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                 Key(begin), Key(begin + 50)));
+      ASSERT_OK(Flush());
+    }
+
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    std::string contents;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      contents += iter->key().ToString() + "=" + iter->value().ToString() +
+                  "\n";
+    }
+    ASSERT_OK(iter->status());
+    if (buffer_size == 0) {
+      expected = contents;
+    } else {
+      ASSERT_EQ(expected, contents);
+    }
+
+    const CompactionJobStats stats = listener->GetStats();
+    if (buffer_size == 0) {
+      ASSERT_EQ(0, stats.pipeline_input_busy_micros);
+      ASSERT_EQ(0, stats.pipeline_input_stall_micros);
+      ASSERT_EQ(0, stats.pipeline_merge_stall_micros);
+    } else {
+      ASSERT_GT(stats.pipeline_input_busy_micros, 0);
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, CopyDataBlocks) {
+  class CopyStatsListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.Add(ci.stats);
+    }
+    CompactionJobStats GetStats() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+   private:
+    std::mutex mutex_;
+    CompactionJobStats stats_;
+  };
+
+  std::string expected;
+  for (bool copy_data_blocks : {false, true}) {
+    SCOPED_TRACE("copy_data_blocks=" + std::to_string(copy_data_blocks));
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    options.compaction_copy_data_blocks = copy_data_blocks;
+    options.paranoid_file_checks = true;
+    options.target_file_size_base = 64 << 10;
+    auto listener = std::make_shared<CopyStatsListener>();
+    options.listeners.emplace_back(listener);
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    for (int i = 0; i < 2000; i++) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    MoveFilesToLevel(1);
+    // Only the blocks of L1 overlapping with these need to be rewritten
+    for (int i = 500; i < 600; i++) {
+      if (i % 3 == 0) {
+        ASSERT_OK(Delete(Key(i)));
+      } else {
+        ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+      }
+    }
+    ASSERT_OK(Put(Key(1500), "new"));
+    ASSERT_OK(Put(Key(3000), "last"));
+    ASSERT_OK(Flush());
+
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    ASSERT_EQ(0, NumTableFilesAtLevel(0));
+    std::string contents;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      contents += iter->key().ToString() + "=" + iter->value().ToString() +
+                  "\n";
+    }
+    ASSERT_OK(iter->status());
+    if (!copy_data_blocks) {
+      expected = contents;
+    } else {
+      ASSERT_EQ(expected, contents);
+    }
+    ASSERT_EQ("new", Get(Key(1500)));
+    ASSERT_EQ("NOT_FOUND", Get(Key(501)));
+
+    const CompactionJobStats stats = listener->GetStats();
+    if (copy_data_blocks) {
+      ASSERT_GT(stats.num_data_blocks_copied, 0);
+      ASSERT_GT(stats.num_data_blocks_rewritten, 0);
+    } else {
+      ASSERT_EQ(0, stats.num_data_blocks_copied);
+      ASSERT_EQ(0, stats.num_data_blocks_rewritten);
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, LazyLevelCompaction) {
+  const int kNumLevels = 5;
+  const int kLastLevel = kNumLevels - 1;
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLazyLevel;
+  options.num_levels = kNumLevels;
+  options.write_buffer_size = 32 << 10;
+  options.target_file_size_base = 32 << 10;
+  options.compaction_options_lazy_level.size_ratio = 4;
+  options.compaction_options_lazy_level.max_sorted_runs = 2;
+  DestroyAndReopen(options);
+
+  auto verify = [&](const std::map<std::string, std::string>& expected) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto expected_iter = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_iter) {
+      ASSERT_NE(expected_iter, expected.end());
+      ASSERT_EQ(expected_iter->first, iter->key().ToString());
+      ASSERT_EQ(expected_iter->second, iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected_iter, expected.end());
+    for (const auto& kv : expected) {
+      ASSERT_EQ(kv.second, Get(kv.first));
+    }
+  };
+
+  Random rnd(301);
+  std::map<std::string, std::string> expected;
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 100; j++) {
+      const std::string key = Key(static_cast<int>(rnd.Uniform(2000)));
+      expected[key] = rnd.RandomString(200);
+      ASSERT_OK(Put(key, expected[key]));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+    // The last level is kept size_ratio times as large as the other levels
+    uint64_t other_size = 0;
+    for (int level = 0; level < kLastLevel; level++) {
+      other_size += SizeAtLevel(level);
+    }
+    ASSERT_LT(other_size * 4, SizeAtLevel(kLastLevel));
+  }
+  verify(expected);
+
+  // A manual compaction compacts all the files into the last level
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int level = 0; level < kLastLevel; level++) {
+    ASSERT_EQ(0, NumTableFilesAtLevel(level));
+  }
+  ASSERT_GT(NumTableFilesAtLevel(kLastLevel), 0);
+  verify(expected);
+
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"compaction_options_lazy_level", "{size_ratio=8;}"}}));
+  ASSERT_EQ(8, dbfull()->GetOptions().compaction_options_lazy_level.size_ratio);
+  ASSERT_NOK(dbfull()->SetOptions(
+      {{"compaction_options_lazy_level", "{size_ratio=1;}"}}));
+}
+
 TEST_F(DBCompactionTest, CompactFilesOutputRangeConflict) {
   // LSM setup:
   // L1:      [ba bz]
@@ -48,8 +48,10 @@
 #include "db/memtable.h"
 #include "db/memtable_list.h"
 #include "db/merge_context.h"
+#include "db/negative_lookup_cache.h"
 #include "db/periodic_task_scheduler.h"
 #include "db/range_tombstone_fragmenter.h"
+#include "db/scan_cache.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
 #include "db/transaction_log_impl.h"
@@ -91,6 +93,7 @@
 #include "rocksdb/write_buffer_manager.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_factory.h"
+#include "table/block_based/block_based_table_reader.h"
 #include "table/get_context.h"
 #include "table/merging_iterator.h"
 #include "table/multiget_context.h"
@@ -112,6 +115,7 @@
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/udt_util.h"
+#include "utilities/cache_dump_load_impl.h"
 #include "utilities/trace/replayer_impl.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -538,6 +542,16 @@ void DBImpl::UntrackDataFiles() {
 }
 
 Status DBImpl::CloseHelper() {
+  if (lock_free_wal_buffer_) {
+    // Write the WAL records still buffered while the WAL is open.
+    IOStatus io_s = lock_free_wal_buffer_->Close();
+    if (!io_s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Unable to write buffered WAL records on close: %s",
+                     io_s.ToString().c_str());
+    }
+  }
+
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
   mutex_.Lock();
@@ -598,6 +612,14 @@ Status DBImpl::CloseHelper() {
     cfd->UnrefAndTryDelete();
   }
 
+  if (opened_successfully_ &&
+      !immutable_db_options_.block_cache_dump_file.empty()) {
+    // While the table files are still open
+    mutex_.Unlock();
+    DumpBlockCache();
+    mutex_.Lock();
+  }
+
   if (default_cf_handle_ != nullptr || persist_stats_cf_handle_ != nullptr) {
     // we need to delete handle outside of lock because it does its own locking
     mutex_.Unlock();
@@ -1510,7 +1532,12 @@ int DBImpl::FindMinimumEmptyLevelFitting(
 Status DBImpl::FlushWAL(const WriteOptions& write_options, bool sync) {
   if (manual_wal_flush_) {
     IOStatus io_s;
-    {
+    if (lock_free_wal_buffer_) {
+      // Include the writes that bypassed the write thread.
+      io_s = lock_free_wal_buffer_->Flush(
+          lock_free_wal_buffer_->LastReserved());
+    }
+    if (io_s.ok()) {
       // We need to lock log_write_mutex_ since logs_ might change concurrently
       InstrumentedMutexLock wl(&log_write_mutex_);
       log::Writer* cur_log_writer = logs_.back().writer;
@@ -2341,6 +2368,33 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
     }
   }
 
+  // Repeated lookups of missing keys can be answered without the
+  // SuperVersion. Only for plain Get()s reading all tiers and range deletions.
+  NegativeLookupCache* negative_lookup_cache = nullptr;
+  uint64_t negative_lookup_epoch = 0;
+  if (cfd->negative_lookup_cache() != nullptr &&
+      last_seq_same_as_publish_seq_ && get_impl_options.get_value &&
+      get_impl_options.callback == nullptr &&
+      get_impl_options.value_found == nullptr &&
+      get_impl_options.is_blob_index == nullptr &&
+      read_options.read_tier == kReadAllTier &&
+      !read_options.ignore_range_deletions) {
+    negative_lookup_cache = cfd->negative_lookup_cache();
+    // Before acquiring the SuperVersion, so that misses are not inserted
+    // after an invalidation that they predate
+    negative_lookup_epoch = negative_lookup_cache->GetEpoch();
+    SequenceNumber read_seq =
+        read_options.snapshot != nullptr
+            ? static_cast<const SnapshotImpl*>(read_options.snapshot)->number_
+            : GetLastPublishedSequence();
+    if (negative_lookup_cache->Lookup(key, read_seq)) {
+      RecordTick(stats_, NEGATIVE_LOOKUP_CACHE_HIT);
+      RecordTick(stats_, NUMBER_KEYS_READ);
+      RecordInHistogram(stats_, BYTES_PER_READ, 0);
+      return Status::NotFound();
+    }
+  }
+
   // Acquire SuperVersion
   SuperVersion* sv = GetAndRefSuperVersion(cfd);
   if (read_options.timestamp && read_options.timestamp->size() > 0) {
@@ -2587,6 +2641,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
       }
       RecordTick(stats_, BYTES_READ, size);
       PERF_COUNTER_ADD(get_read_bytes, size);
+    } else if (negative_lookup_cache != nullptr && s.IsNotFound()) {
+      RecordTick(stats_, NEGATIVE_LOOKUP_CACHE_MISS);
+      negative_lookup_cache->Insert(key, snapshot, negative_lookup_epoch);
     }
 
     ReturnAndCleanupSuperVersion(cfd, sv);
@@ -3856,6 +3913,15 @@ Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
         cfd->user_comparator(), iter, sv->current, kMaxSequenceNumber,
         sv->mutable_cf_options.max_sequential_skip_in_iterations,
         nullptr /* read_callback */, cfh);
+  } else if (last_seq_same_as_publish_seq_ &&
+             ScanCacheIterator::IsSupported(read_options, cfd, sv)) {
+    // As in NewIteratorImpl(), the sequence number is read after referencing
+    // the super version
+    result = new ScanCacheIterator(
+        this, read_options, cfh, sv,
+        (read_options.snapshot != nullptr)
+            ? read_options.snapshot->GetSequenceNumber()
+            : versions_->LastSequence());
   } else {
     // Note: no need to consider the special case of
     // last_seq_same_as_publish_seq_==false since NewIterator is overridden in
@@ -4382,6 +4448,168 @@ Status DBImpl::GetPropertiesOfAllTables(ColumnFamilyHandle* column_family,
   return s;
 }
 
+void DBImpl::DumpBlockCache() {
+  const std::string& fname = immutable_db_options_.block_cache_dump_file;
+  std::vector<std::shared_ptr<Cache>> caches;
+  autovector<Version*> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped()) {
+        continue;
+      }
+      const auto* table_options =
+          cfd->GetLatestMutableCFOptions()
+              .table_factory->GetOptions<BlockBasedTableOptions>();
+      if (table_options == nullptr || table_options->block_cache == nullptr) {
+        continue;
+      }
+      if (std::find(caches.begin(), caches.end(),
+                    table_options->block_cache) == caches.end()) {
+        caches.push_back(table_options->block_cache);
+      }
+      versions.push_back(cfd->current());
+      versions.back()->Ref();
+    }
+  }
+
+  StopWatchNano sw(immutable_db_options_.clock, /*auto_start=*/true);
+  std::unique_ptr<CacheDumpWriter> writer;
+  IOStatus io_s = NewToFileCacheDumpWriter(immutable_db_options_.fs,
+                                           FileOptions(), fname, &writer);
+  if (io_s.ok()) {
+    CacheDumpOptions dump_options;
+    dump_options.clock = immutable_db_options_.clock;
+    CacheDumperImpl dumper(dump_options, caches, std::move(writer));
+    // Only the blocks of the live table files of this DB
+    io_s = status_to_io_status(dumper.SetDumpFilter({}));
+    // TODO: plumb Env::IOActivity, Env::IOPriority
+    const ReadOptions read_options;
+    for (Version* version : versions) {
+      if (!io_s.ok()) {
+        break;
+      }
+      TablePropertiesCollection props;
+      io_s = status_to_io_status(
+          version->GetPropertiesOfAllTables(read_options, &props));
+      for (const auto& file_props : props) {
+        dumper.AddDumpFilter(*file_props.second);
+      }
+    }
+    if (io_s.ok()) {
+      io_s = dumper.DumpCacheEntriesToWriter();
+    }
+  }
+
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (Version* version : versions) {
+      version->Unref();
+    }
+  }
+  if (io_s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Dumped block cache to %s in %" PRIu64 " us", fname.c_str(),
+                   sw.ElapsedNanos() / 1000);
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to dump block cache to %s: %s", fname.c_str(),
+                   io_s.ToString().c_str());
+  }
+}
+
+void DBImpl::LoadBlockCache() {
+  const std::string& fname = immutable_db_options_.block_cache_dump_file;
+  const std::shared_ptr<FileSystem>& fs = immutable_db_options_.fs;
+  if (fs->FileExists(fname, IOOptions(), nullptr).IsNotFound()) {
+    return;
+  }
+
+  // Where to insert the blocks of each live table file
+  BlockCacheRestoreTargets targets;
+  autovector<std::pair<Version*, std::shared_ptr<BlockCacheRestoreTarget>>>
+      cf_targets;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped()) {
+        continue;
+      }
+      const MutableCFOptions& mutable_cf_options =
+          cfd->GetLatestMutableCFOptions();
+      const auto* table_options =
+          mutable_cf_options.table_factory
+              ->GetOptions<BlockBasedTableOptions>();
+      if (table_options == nullptr || table_options->block_cache == nullptr) {
+        continue;
+      }
+      auto target = std::make_shared<BlockCacheRestoreTarget>();
+      target->cache = table_options->block_cache;
+      target->create_context = BlockCreateContext(
+          table_options, &cfd->ioptions(), cfd->ioptions().stats,
+          /*using_zstd*/ false,
+          mutable_cf_options.block_protection_bytes_per_key,
+          cfd->user_comparator());
+      cf_targets.emplace_back(cfd->current(), std::move(target));
+      cf_targets.back().first->Ref();
+    }
+  }
+
+  StopWatchNano sw(immutable_db_options_.clock, /*auto_start=*/true);
+  uint64_t num_restored = 0;
+  IOStatus io_s;
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  const ReadOptions read_options;
+  for (auto& cf_target : cf_targets) {
+    TablePropertiesCollection props;
+    io_s = status_to_io_status(
+        cf_target.first->GetPropertiesOfAllTables(read_options, &props));
+    if (!io_s.ok()) {
+      break;
+    }
+    for (const auto& file_props : props) {
+      OffsetableCacheKey base;
+      bool is_stable;
+      BlockBasedTable::SetupBaseCacheKey(file_props.second.get(),
+                                         /*cur_db_session_id*/ "",
+                                         /*cur_file_num*/ 0, &base, &is_stable);
+      if (is_stable) {
+        targets[base.CommonPrefixSlice().ToString()] = cf_target.second;
+      }
+    }
+  }
+  if (io_s.ok() && !targets.empty()) {
+    std::unique_ptr<CacheDumpReader> reader;
+    io_s = NewFromFileCacheDumpReader(fs, FileOptions(), fname, &reader);
+    if (io_s.ok()) {
+      CacheDumpedLoaderImpl loader(CacheDumpOptions(), BlockBasedTableOptions(),
+                                   /*secondary_cache*/ nullptr,
+                                   std::move(reader));
+      io_s = loader.RestoreCacheEntriesToBlockCache(
+          targets,
+          std::max(immutable_db_options_.max_file_opening_threads, 1),
+          &num_restored);
+    }
+  }
+
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto& cf_target : cf_targets) {
+      cf_target.first->Unref();
+    }
+  }
+  if (io_s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Loaded %" PRIu64
+                   " blocks into block cache from %s in %" PRIu64 " us",
+                   num_restored, fname.c_str(), sw.ElapsedNanos() / 1000);
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Unable to load block cache from %s: %s", fname.c_str(),
+                   io_s.ToString().c_str());
+  }
+}
+
 Status DBImpl::GetPropertiesOfTablesInRange(ColumnFamilyHandle* column_family,
                                             const Range* range, std::size_t n,
                                             TablePropertiesCollection* props) {
@@ -4936,6 +5164,9 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
     if (status.ok()) {
       InstallSuperVersionAndScheduleWork(
           cfd, job_context.superversion_contexts.data());
+      if (cfd->scan_cache_versions() != nullptr) {
+        cfd->scan_cache_versions()->Invalidate();
+      }
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
@@ -6035,6 +6266,12 @@ Status DBImpl::IngestExternalFiles(
         auto* cfd = ingestion_jobs[i].GetColumnFamilyData();
         assert(!cfd->IsDropped());
         InstallSuperVersionAndScheduleWork(cfd, &sv_ctxs[i]);
+        if (cfd->scan_cache_versions() != nullptr) {
+          cfd->scan_cache_versions()->Invalidate();
+        }
+        if (cfd->negative_lookup_cache() != nullptr) {
+          cfd->negative_lookup_cache()->Invalidate();
+        }
 #ifndef NDEBUG
         if (0 == i && num_cfs > 1) {
           TEST_SYNC_POINT("DBImpl::IngestExternalFiles:InstallSVForFirstCF:0");
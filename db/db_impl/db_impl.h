@@ -31,6 +31,7 @@
 #include "db/flush_scheduler.h"
 #include "db/import_column_family_job.h"
 #include "db/internal_stats.h"
+#include "db/lock_free_wal_buffer.h"
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
 #include "db/memtable_list.h"
@@ -1578,6 +1579,21 @@ class DBImpl : public DB {
                                 uint64_t log_ref, SequenceNumber seq,
                                 const size_t sub_batch_cnt);
 
+  // Writes the batch through lock_free_wal_buffer_ without joining the write
+  // thread, if it qualifies and the write thread is idle. Returns false if the
+  // batch must go through the write thread instead, otherwise the result of
+  // the write is in *status. See DBOptions::enable_lock_free_wal_buffer.
+  bool WriteLockFree(const WriteOptions& write_options, WriteBatch* my_batch,
+                     uint64_t* seq_used, Status* status);
+
+  // Writes a record of lock_free_wal_buffer_ to the current WAL.
+  IOStatus WriteLockFreeWalRecord(const Slice& record, SequenceNumber sequence);
+
+  // Writes the records of lock_free_wal_buffer_ to the WAL, before the write
+  // thread writes to the WAL or switches it.
+  // REQUIRES: this thread is the write thread leader
+  IOStatus DrainLockFreeWalBuffer();
+
   // Whether the batch requires to be assigned with an order
   enum AssignOrder : bool { kDontAssignOrder, kDoAssignOrder };
   // Whether it requires publishing last sequence or not
@@ -2261,7 +2277,14 @@ class DBImpl : public DB {
                         [&] { return pending_memtable_writes_.load() == 0; });
       }
     } else {
-      // (Writes are finished before the next write group starts.)
+      // (Writes are finished before the next write group starts, but the WAL
+      // records of those bypassing the write thread may still be buffered.)
+      IOStatus io_s = DrainLockFreeWalBuffer();
+      if (!io_s.ok()) {
+        mutex_.Unlock();
+        WALIOStatusCheck(io_s);
+        mutex_.Lock();
+      }
     }
 
     // Wait for any LockWAL to clear
@@ -2316,12 +2339,30 @@ class DBImpl : public DB {
                       LogFileNumberSize& log_file_number_size,
                       SequenceNumber sequence);
 
-  IOStatus WriteToWAL(const WriteThread::WriteGroup& write_group,
+  // `piece_crcs` are passed to log::Writer::AddRecord().
+  IOStatus WriteToWAL(const Slice& log_entry,
+                      const std::vector<log::Writer::PieceCrc>* piece_crcs,
+                      const WriteOptions& write_options,
+                      log::Writer* log_writer, uint64_t* log_used,
+                      uint64_t* log_size,
+                      LogFileNumberSize& log_file_number_size,
+                      SequenceNumber sequence);
+
+  IOStatus WriteToWAL(WriteThread::WriteGroup& write_group,
                       log::Writer* log_writer, uint64_t* log_used,
                       bool need_log_sync, bool need_log_dir_sync,
                       SequenceNumber sequence,
                       LogFileNumberSize& log_file_number_size);
 
+  // Same as MergeBatch() and WriteToWAL(merged_batch, ...), with the writers
+  // of the group copying their batch into the WAL record in parallel instead
+  // of the leader merging them. See DBOptions::enable_parallel_wal_copy.
+  IOStatus WriteToWALWithParallelCopy(
+      WriteThread::WriteGroup& write_group, const WriteOptions& write_options,
+      log::Writer* log_writer, uint64_t* log_used, uint64_t* log_size,
+      LogFileNumberSize& log_file_number_size, SequenceNumber sequence,
+      size_t* write_with_wal, WriteBatch** to_be_cached_state);
+
   IOStatus ConcurrentWriteToWAL(const WriteThread::WriteGroup& write_group,
                                 uint64_t* log_used,
                                 SequenceNumber* last_sequence, size_t seq_inc);
@@ -2507,6 +2548,10 @@ class DBImpl : public DB {
 
   Status CloseHelper();
 
+  // For DBOptions::block_cache_dump_file. Errors are logged.
+  void DumpBlockCache();
+  void LoadBlockCache();
+
   void WaitForBackgroundWork();
 
   // Background threads call this function, which is just a wrapper around
@@ -2880,6 +2925,14 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  // State of WriteToWALWithParallelCopy(), only used by the leader of
+  // write_thread_.
+  std::vector<WriteThread::WalCopy> wal_copies_;
+  std::vector<log::Writer::PieceCrc> wal_piece_crcs_;
+  std::string wal_copy_buffer_;
+  // The writes bypassing write_thread_, if
+  // DBOptions::enable_lock_free_wal_buffer.
+  std::unique_ptr<LockFreeWalBuffer> lock_free_wal_buffer_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
@@ -1118,7 +1118,8 @@ Status DBImpl::CompactRangeInternal(const CompactRangeOptions& options,
   constexpr int kInvalidLevel = -1;
   int final_output_level = kInvalidLevel;
   bool exclusive = options.exclusive_manual_compaction;
-  if (cfd->ioptions().compaction_style == kCompactionStyleUniversal &&
+  if ((cfd->ioptions().compaction_style == kCompactionStyleUniversal ||
+       cfd->ioptions().compaction_style == kCompactionStyleLazyLevel) &&
       cfd->NumberLevels() > 1) {
     // Always compact all files together.
     final_output_level = cfd->NumberLevels() - 1;
@@ -2034,10 +2035,11 @@ Status DBImpl::RunManualCompaction(
   ManualCompactionState manual(
       cfd, input_level, output_level, compact_range_options.target_path_id,
       exclusive, disallow_trivial_move, compact_range_options.canceled);
-  // For universal compaction, we enforce every manual compaction to compact
-  // all files.
+  // For universal and lazy level compactions, we enforce every manual
+  // compaction to compact all files.
   if (begin == nullptr ||
       cfd->ioptions().compaction_style == kCompactionStyleUniversal ||
+      cfd->ioptions().compaction_style == kCompactionStyleLazyLevel ||
       cfd->ioptions().compaction_style == kCompactionStyleFIFO) {
     manual.begin = nullptr;
   } else {
@@ -2046,6 +2048,7 @@ Status DBImpl::RunManualCompaction(
   }
   if (end == nullptr ||
       cfd->ioptions().compaction_style == kCompactionStyleUniversal ||
+      cfd->ioptions().compaction_style == kCompactionStyleLazyLevel ||
       cfd->ioptions().compaction_style == kCompactionStyleFIFO) {
     manual.end = nullptr;
   } else {
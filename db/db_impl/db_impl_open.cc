@@ -272,6 +272,24 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.enable_lock_free_wal_buffer) {
+    if (!db_options.manual_wal_flush) {
+      return Status::InvalidArgument(
+          "enable_lock_free_wal_buffer requires manual_wal_flush");
+    }
+    if (!db_options.allow_concurrent_memtable_write) {
+      return Status::InvalidArgument(
+          "enable_lock_free_wal_buffer is incompatible with "
+          "!allow_concurrent_memtable_write");
+    }
+    if (db_options.enable_pipelined_write || db_options.two_write_queues ||
+        db_options.unordered_write) {
+      return Status::InvalidArgument(
+          "enable_lock_free_wal_buffer is incompatible with "
+          "enable_pipelined_write, two_write_queues and unordered_write");
+    }
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return Status::InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
@@ -2631,6 +2649,17 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     ROCKS_LOG_WARN(impl->immutable_db_options_.info_log,
                    "DB::Open() failed: %s", s.ToString().c_str());
   }
+  if (s.ok() && impl->immutable_db_options_.enable_lock_free_wal_buffer) {
+    DBImpl* db = impl.get();
+    impl->lock_free_wal_buffer_.reset(new LockFreeWalBuffer(
+        LockFreeWalBuffer::kDefaultNumSlots,
+        [db](const Slice& record, SequenceNumber sequence) {
+          return db->WriteLockFreeWalRecord(record, sequence);
+        }));
+  }
+  if (s.ok() && !impl->immutable_db_options_.block_cache_dump_file.empty()) {
+    impl->LoadBlockCache();
+  }
   if (s.ok()) {
     s = impl->StartPeriodicTaskScheduler();
   }
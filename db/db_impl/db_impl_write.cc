@@ -11,12 +11,16 @@
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
 #include "db/event_helpers.h"
+#include "db/negative_lookup_cache.h"
+#include "db/scan_cache.h"
 #include "logging/logging.h"
 #include "memtable/wbwi_memtable.h"
 #include "monitoring/perf_context_imp.h"
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
 
 namespace ROCKSDB_NAMESPACE {
 // Convenience methods
@@ -283,6 +287,13 @@ Status DBImpl::IngestWBWI(std::shared_ptr<WriteBatchWithIndex> wbwi,
       }
       break;
     }
+    // The entries of WBWIMemTables are not added through MemTable::Add()
+    if (cfds[i]->scan_cache_versions() != nullptr) {
+      cfds[i]->scan_cache_versions()->Invalidate();
+    }
+    if (cfds[i]->negative_lookup_cache() != nullptr) {
+      cfds[i]->negative_lookup_cache()->Invalidate();
+    }
   }
   for (size_t i = 0; i < cfds.size(); ++i) {
     if (cfds[i]->UnrefAndTryDelete()) {
@@ -437,6 +448,20 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     }
   }
 
+  // Plain writes to the memtable and the WAL may bypass the write thread.
+  if (lock_free_wal_buffer_ && !write_options.sync &&
+      !write_options.disableWAL && callback == nullptr &&
+      user_write_cb == nullptr && log_used == nullptr && log_ref == 0 &&
+      !disable_memtable && batch_cnt == 0 && pre_release_callback == nullptr &&
+      post_memtable_callback == nullptr && !wbwi &&
+      WriteBatchInternal::Count(my_batch) > 0 && !my_batch->HasMerge() &&
+      my_batch->GetWalTerminationPoint().is_cleared()) {
+    Status s;
+    if (WriteLockFree(write_options, my_batch, seq_used, &s)) {
+      return s;
+    }
+  }
+
   if (two_write_queues_ && disable_memtable) {
     AssignOrder assign_order =
         seq_per_batch_ ? kDoAssignOrder : kDontAssignOrder;
@@ -1128,6 +1153,125 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
   return Status::OK();
 }
 
+bool DBImpl::WriteLockFree(const WriteOptions& write_options,
+                           WriteBatch* my_batch, uint64_t* seq_used,
+                           Status* status) {
+  // Leave to the write thread whatever PreprocessWrite() would have to do.
+  if (UNLIKELY(!flush_scheduler_.Empty() || !trim_history_scheduler_.Empty() ||
+               write_controller_.IsStopped() ||
+               write_controller_.NeedsDelay() ||
+               write_buffer_manager_->ShouldFlush() ||
+               write_buffer_manager_->ShouldStall() ||
+               total_log_size_ > GetMaxTotalWalSize() ||
+               error_handler_.IsDBStopped() ||
+               lock_free_wal_buffer_->HasError())) {
+    return false;
+  }
+  // The WAL record is not checked again before it is written.
+  Status s = my_batch->VerifyChecksum();
+  if (!s.ok()) {
+    *status = s;
+    return true;
+  }
+  uint64_t epoch;
+  if (!write_thread_.TryEnterBypass(&epoch)) {
+    return false;
+  }
+  TEST_SYNC_POINT("DBImpl::WriteLockFree:Enter");
+  PERF_TIMER_GUARD(write_pre_and_post_process_time);
+  StopWatch write_sw(immutable_db_options_.clock, stats_, DB_WRITE);
+
+  WriteThread::Writer w(write_options, my_batch, /*_callback=*/nullptr,
+                        /*_user_write_cb=*/nullptr, /*_log_ref=*/0,
+                        /*_disable_memtable=*/false);
+  const size_t total_count = WriteBatchInternal::Count(my_batch);
+  const size_t total_byte_size = WriteBatchInternal::ByteSize(my_batch);
+  // TODO: this use of operator bool on `tracer_` can avoid unnecessary lock
+  // grabs but does not seem thread-safe.
+  if (tracer_) {
+    // Trace in sequence number order, as the write thread does.
+    InstrumentedMutexLock lock(&trace_mutex_);
+    w.sequence = lock_free_wal_buffer_->Reserve(total_count, epoch,
+                                                versions_->LastSequence());
+    if (tracer_ && tracer_->IsWriteOrderPreserved()) {
+      // TODO: maybe handle the tracing status?
+      tracer_->Write(my_batch).PermitUncheckedError();
+    }
+  } else {
+    w.sequence = lock_free_wal_buffer_->Reserve(total_count, epoch,
+                                                versions_->LastSequence());
+  }
+  lock_free_wal_buffer_->Fill(w.sequence, *my_batch);
+
+  auto stats = default_cf_internal_stats_;
+  stats->AddDBStats(InternalStats::kIntStatsNumKeysWritten, total_count,
+                    /*concurrent=*/true);
+  RecordTick(stats_, NUMBER_KEYS_WRITTEN, total_count);
+  stats->AddDBStats(InternalStats::kIntStatsBytesWritten, total_byte_size,
+                    /*concurrent=*/true);
+  RecordTick(stats_, BYTES_WRITTEN, total_byte_size);
+  stats->AddDBStats(InternalStats::kIntStatsWriteDoneBySelf, 1,
+                    /*concurrent=*/true);
+  RecordTick(stats_, WRITE_DONE_BY_SELF);
+  stats->AddDBStats(InternalStats::kIntStatsWriteWithWal, 1,
+                    /*concurrent=*/true);
+  RecordTick(stats_, WRITE_WITH_WAL);
+  RecordInHistogram(stats_, BYTES_PER_WRITE, total_byte_size);
+
+  PERF_TIMER_STOP(write_pre_and_post_process_time);
+  {
+    PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
+    ColumnFamilyMemTablesImpl column_family_memtables(
+        versions_->GetColumnFamilySet());
+    w.status = WriteBatchInternal::InsertInto(
+        &w, w.sequence, &column_family_memtables, &flush_scheduler_,
+        &trim_history_scheduler_, write_options.ignore_missing_column_families,
+        0 /*log_number*/, this, true /*concurrent_memtable_writes*/,
+        seq_per_batch_, w.batch_cnt, batch_per_txn_,
+        write_options.memtable_insert_hint_per_batch);
+  }
+  PERF_TIMER_START(write_pre_and_post_process_time);
+
+  // The batch is visible once all the previous ones are inserted as well.
+  versions_->AdvanceLastSequence(lock_free_wal_buffer_->Publish(w.sequence));
+  write_thread_.ExitBypass();
+  MemTableInsertStatusCheck(w.status);
+  if (seq_used != nullptr) {
+    *seq_used = w.sequence;
+  }
+  *status = w.FinalStatus();
+  return true;
+}
+
+IOStatus DBImpl::WriteLockFreeWalRecord(const Slice& record,
+                                        SequenceNumber sequence) {
+  log::Writer* log_writer;
+  LogFileNumberSize* log_file_number_size;
+  {
+    InstrumentedMutexLock l(&log_write_mutex_);
+    log_writer = logs_.back().writer;
+    log_file_number_size = std::addressof(alive_log_files_.back());
+  }
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  uint64_t log_size;
+  IOStatus io_s = WriteToWAL(record, /*piece_crcs=*/nullptr, WriteOptions(),
+                             log_writer, /*log_used=*/nullptr, &log_size,
+                             *log_file_number_size, sequence);
+  if (io_s.ok()) {
+    default_cf_internal_stats_->AddDBStats(InternalStats::kIntStatsWalFileBytes,
+                                           log_size, /*concurrent=*/true);
+    RecordTick(stats_, WAL_FILE_BYTES, log_size);
+  }
+  return io_s;
+}
+
+IOStatus DBImpl::DrainLockFreeWalBuffer() {
+  if (lock_free_wal_buffer_ == nullptr) {
+    return IOStatus::OK();
+  }
+  return lock_free_wal_buffer_->Drain();
+}
+
 // The 2nd write queue. If enabled it will be used only for WAL-only writes.
 // This is the only queue that updates LastPublishedSequence which is only
 // applicable in a two-queue setting.
@@ -1406,7 +1550,15 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
   assert(write_context != nullptr && log_context != nullptr);
   Status status;
 
-  if (error_handler_.IsDBStopped()) {
+  // Write the WAL records of the writes that bypassed the write thread first,
+  // to keep the WAL in sequence number order.
+  IOStatus io_s = DrainLockFreeWalBuffer();
+  if (UNLIKELY(!io_s.ok())) {
+    WALIOStatusCheck(io_s);
+    status = io_s;
+  }
+
+  if (status.ok() && error_handler_.IsDBStopped()) {
     InstrumentedMutexLock l(&mutex_);
     status = error_handler_.GetBGError();
   }
@@ -1574,6 +1726,19 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (!s.ok()) {
     return status_to_io_status(std::move(s));
   }
+  return WriteToWAL(log_entry, /*piece_crcs=*/nullptr, write_options,
+                    log_writer, log_used, log_size, log_file_number_size,
+                    sequence);
+}
+
+IOStatus DBImpl::WriteToWAL(const Slice& log_entry,
+                            const std::vector<log::Writer::PieceCrc>* piece_crcs,
+                            const WriteOptions& write_options,
+                            log::Writer* log_writer, uint64_t* log_used,
+                            uint64_t* log_size,
+                            LogFileNumberSize& log_file_number_size,
+                            SequenceNumber sequence) {
+  assert(log_size != nullptr);
   *log_size = log_entry.size();
   // When two_write_queues_ WriteToWAL has to be protected from concurretn calls
   // from the two queues anyway and log_write_mutex_ is already held. Otherwise
@@ -1591,7 +1756,7 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (!io_s.ok()) {
     return io_s;
   }
-  io_s = log_writer->AddRecord(write_options, log_entry, sequence);
+  io_s = log_writer->AddRecord(write_options, log_entry, sequence, piece_crcs);
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
@@ -1606,7 +1771,73 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   return io_s;
 }
 
-IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
+IOStatus DBImpl::WriteToWALWithParallelCopy(
+    WriteThread::WriteGroup& write_group, const WriteOptions& write_options,
+    log::Writer* log_writer, uint64_t* log_used, uint64_t* log_size,
+    LogFileNumberSize& log_file_number_size, SequenceNumber sequence,
+    size_t* write_with_wal, WriteBatch** to_be_cached_state) {
+  // Reserve the place of the records of each batch in the WAL record, like
+  // MergeBatch() would lay them out.
+  wal_copies_.resize(write_group.size);
+  wal_piece_crcs_.clear();
+  size_t size = WriteBatchInternal::kHeader;
+  uint32_t count = 0;
+  size_t num_copies = 0;
+  for (auto writer : write_group) {
+    writer->wal_copy = nullptr;
+    writer->log_used = logfile_number_;
+    if (writer->CallbackFailed()) {
+      continue;
+    }
+    uint32_t writer_count = 0;
+    WriteThread::WalCopy& copy = wal_copies_[num_copies++];
+    copy.src = WriteBatchInternal::WalRecords(writer->batch, &writer_count);
+    size += copy.src.size();
+    count += writer_count;
+    writer->wal_copy = &copy;
+    if (WriteBatchInternal::IsLatestPersistentState(writer->batch)) {
+      // We only need to cache the last of such write batch
+      *to_be_cached_state = writer->batch;
+    }
+    (*write_with_wal)++;
+  }
+  if (wal_copy_buffer_.size() < size) {
+    wal_copy_buffer_.resize(size);
+  }
+  char* dest = &wal_copy_buffer_[0];
+  EncodeFixed64(dest, sequence);
+  EncodeFixed32(dest + 8, count);
+  wal_piece_crcs_.push_back(
+      {WriteBatchInternal::kHeader,
+       crc32c::Value(dest, WriteBatchInternal::kHeader)});
+  dest += WriteBatchInternal::kHeader;
+  for (size_t i = 0; i < num_copies; ++i) {
+    wal_copies_[i].dest = dest;
+    dest += wal_copies_[i].src.size();
+  }
+
+  // Each writer copies its batch and computes its CRC.
+  write_thread_.ParallelCopyWal(&write_group);
+  for (auto writer : write_group) {
+    writer->wal_copy = nullptr;
+  }
+
+  for (size_t i = 0; i < num_copies; ++i) {
+    WriteThread::WalCopy& copy = wal_copies_[i];
+    if (!copy.status.ok()) {
+      return status_to_io_status(std::move(copy.status));
+    }
+    if (!copy.src.empty()) {
+      wal_piece_crcs_.push_back({copy.src.size(), copy.crc});
+    }
+  }
+
+  Slice log_entry(wal_copy_buffer_.data(), size);
+  return WriteToWAL(log_entry, &wal_piece_crcs_, write_options, log_writer,
+                    log_used, log_size, log_file_number_size, sequence);
+}
+
+IOStatus DBImpl::WriteToWAL(WriteThread::WriteGroup& write_group,
                             log::Writer* log_writer, uint64_t* log_used,
                             bool need_log_sync, bool need_log_dir_sync,
                             SequenceNumber sequence,
@@ -1617,31 +1848,38 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   // Same holds for all in the batch group
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
-  WriteBatch* merged_batch;
-  io_s = status_to_io_status(MergeBatch(write_group, &tmp_batch_, &merged_batch,
-                                        &write_with_wal, &to_be_cached_state));
-  if (UNLIKELY(!io_s.ok())) {
-    return io_s;
-  }
-
-  if (merged_batch == write_group.leader->batch) {
-    write_group.leader->log_used = logfile_number_;
-  } else if (write_with_wal > 1) {
-    for (auto writer : write_group) {
-      writer->log_used = logfile_number_;
-    }
-  }
-
-  WriteBatchInternal::SetSequence(merged_batch, sequence);
-
+  WriteBatch* merged_batch = nullptr;
   uint64_t log_size;
 
   // TODO: plumb Env::IOActivity, Env::IOPriority
   WriteOptions write_options;
   write_options.rate_limiter_priority =
       write_group.leader->rate_limiter_priority;
-  io_s = WriteToWAL(*merged_batch, write_options, log_writer, log_used,
-                    &log_size, log_file_number_size, sequence);
+  if (immutable_db_options_.enable_parallel_wal_copy && write_group.size > 1) {
+    io_s = WriteToWALWithParallelCopy(
+        write_group, write_options, log_writer, log_used, &log_size,
+        log_file_number_size, sequence, &write_with_wal, &to_be_cached_state);
+  } else {
+    io_s = status_to_io_status(MergeBatch(write_group, &tmp_batch_,
+                                          &merged_batch, &write_with_wal,
+                                          &to_be_cached_state));
+    if (UNLIKELY(!io_s.ok())) {
+      return io_s;
+    }
+
+    if (merged_batch == write_group.leader->batch) {
+      write_group.leader->log_used = logfile_number_;
+    } else if (write_with_wal > 1) {
+      for (auto writer : write_group) {
+        writer->log_used = logfile_number_;
+      }
+    }
+
+    WriteBatchInternal::SetSequence(merged_batch, sequence);
+
+    io_s = WriteToWAL(*merged_batch, write_options, log_writer, log_used,
+                      &log_size, log_file_number_size, sequence);
+  }
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -3824,6 +3824,162 @@ TEST_F(DBIteratorTest, IteratorsConsistentViewExplicitSnapshot) {
   }
 }
 
+TEST_F(DBIteratorTest, ScanCachePrefixScans) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+  options.scan_cache = NewLRUCache(1 << 20);
+  options.prefix_extractor.reset(NewFixedPrefixTransform(1));
+  DestroyAndReopen(options);
+
+  for (const char* key : {"a1", "a2", "a3", "a4", "a5", "b1", "b2"}) {
+    ASSERT_OK(Put(key, std::string("v") + key));
+  }
+  ASSERT_OK(Flush());
+
+  ReadOptions ro;
+  ro.scan_cache_max_entries = 3;
+  ro.prefix_same_as_start = true;
+  auto scan = [&](const Slice& target) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    std::string result;
+    for (iter->Seek(target); iter->Valid(); iter->Next()) {
+      EXPECT_EQ(iter->value().ToString(), "v" + iter->key().ToString());
+      result += iter->key().ToString() + ",";
+    }
+    EXPECT_OK(iter->status());
+    return result;
+  };
+  auto hits = [&]() { return TestGetTickerCount(options, SCAN_CACHE_HIT); };
+  auto misses = [&]() {
+    return TestGetTickerCount(options, SCAN_CACHE_MISS);
+  };
+
+  ASSERT_EQ(scan("a"), "a1,a2,a3,a4,a5,");
+  ASSERT_EQ(hits(), 0);
+  ASSERT_EQ(misses(), 1);
+  ASSERT_EQ(scan("a"), "a1,a2,a3,a4,a5,");
+  ASSERT_EQ(hits(), 1);
+  ASSERT_EQ(scan("b"), "b1,b2,");
+  ASSERT_EQ(scan("b"), "b1,b2,");
+  ASSERT_EQ(hits(), 2);
+  ASSERT_EQ(misses(), 2);
+
+  // Writes to other prefixes don't invalidate the cached scans
+  ASSERT_OK(Put("b3", "vb3"));
+  ASSERT_EQ(scan("a"), "a1,a2,a3,a4,a5,");
+  ASSERT_EQ(hits(), 3);
+  ASSERT_EQ(scan("b"), "b1,b2,b3,");
+  ASSERT_EQ(misses(), 3);
+
+  // Writes in the range do, including for iterators created before them
+  std::unique_ptr<Iterator> old_iter(db_->NewIterator(ro));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("a0", "va0"));
+  ASSERT_OK(Delete("a2"));
+  old_iter->Seek("a");
+  ASSERT_EQ(misses(), 4);
+  ASSERT_EQ(IterStatus(old_iter.get()), "a1->va1");
+  old_iter->Next();
+  ASSERT_EQ(IterStatus(old_iter.get()), "a2->va2");
+  ASSERT_EQ(scan("a"), "a0,a1,a3,a4,a5,");
+  ASSERT_EQ(misses(), 5);
+  ASSERT_EQ(scan("a"), "a0,a1,a3,a4,a5,");
+  ASSERT_EQ(hits(), 4);
+
+  // Also served at other sequence numbers when not invalidated since
+  ro.snapshot = snapshot;
+  ASSERT_EQ(scan("b"), "b1,b2,b3,");
+  ASSERT_EQ(hits(), 5);
+  ASSERT_EQ(scan("a"), "a1,a2,a3,a4,a5,");
+  ASSERT_EQ(misses(), 6);
+  ro.snapshot = nullptr;
+  db_->ReleaseSnapshot(snapshot);
+
+  // Range deletions invalidate all the prefixes
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "b2",
+                             "b3"));
+  ASSERT_EQ(scan("a"), "a0,a1,a3,a4,a5,");
+  ASSERT_EQ(scan("b"), "b1,b3,");
+  ASSERT_EQ(misses(), 8);
+
+  // And so does file ingestion
+  std::string file = dbname_ + "/ingest.sst";
+  SstFileWriter writer(EnvOptions(), options);
+  ASSERT_OK(writer.Open(file));
+  ASSERT_OK(writer.Put("c1", "vc1"));
+  ASSERT_OK(writer.Finish());
+  ASSERT_OK(db_->IngestExternalFile({file}, IngestExternalFileOptions()));
+  ASSERT_EQ(scan("a"), "a0,a1,a3,a4,a5,");
+  ASSERT_EQ(misses(), 9);
+  ASSERT_EQ(hits(), 5);
+}
+
+TEST_F(DBIteratorTest, ScanCacheIteratorOperations) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+  options.scan_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+
+  for (int i = 1; i <= 5; i++) {
+    ASSERT_OK(Put("k" + std::to_string(i), "v" + std::to_string(i)));
+  }
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(), "x",
+                           WideColumns{{"attr", "value"}}));
+
+  ReadOptions ro;
+  ro.scan_cache_max_entries = 2;
+  for (int round = 0; round < 2; round++) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    // Next() past the cached entries
+    iter->Seek("k2");
+    ASSERT_EQ(IterStatus(iter.get()), "k2->v2");
+    ASSERT_EQ(iter->columns(),
+              (WideColumns{{kDefaultWideColumnName, Slice("v2")}}));
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter.get()), "k3->v3");
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter.get()), "k4->v4");
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter.get()), "k5->v5");
+
+    // Prev() from a cached entry
+    iter->Seek("k3");
+    ASSERT_EQ(IterStatus(iter.get()), "k3->v3");
+    iter->Prev();
+    ASSERT_EQ(IterStatus(iter.get()), "k2->v2");
+    iter->Prev();
+    ASSERT_EQ(IterStatus(iter.get()), "k1->v1");
+
+    iter->SeekToLast();
+    ASSERT_EQ(IterStatus(iter.get()), "x->");
+    iter->SeekForPrev("k9");
+    ASSERT_EQ(IterStatus(iter.get()), "k5->v5");
+    iter->Seek("k9");
+    ASSERT_EQ(IterStatus(iter.get()), "x->");
+    ASSERT_EQ(iter->columns(), (WideColumns{{"attr", "value"}}));
+    iter->Next();
+    ASSERT_EQ(IterStatus(iter.get()), "(invalid)");
+  }
+  // Scans reaching the entity are not cached
+  ASSERT_EQ(TestGetTickerCount(options, SCAN_CACHE_HIT), 2);
+  ASSERT_EQ(TestGetTickerCount(options, SCAN_CACHE_MISS), 4);
+
+  // Any write invalidates scans not confined to a prefix
+  ASSERT_OK(Put("a", "va"));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  iter->Seek("k2");
+  ASSERT_EQ(IterStatus(iter.get()), "k2->v2");
+  ASSERT_EQ(TestGetTickerCount(options, SCAN_CACHE_MISS), 5);
+  std::string prop;
+  ASSERT_OK(iter->GetProperty("rocksdb.iterator.super-version-number", &prop));
+  ASSERT_OK(iter->Refresh());
+  iter->Seek("k2");
+  ASSERT_EQ(IterStatus(iter.get()), "k2->v2");
+  ASSERT_EQ(TestGetTickerCount(options, SCAN_CACHE_HIT), 3);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -23,7 +23,10 @@ class DBMemTableTest : public DBTestBase {
 class MockMemTableRep : public MemTableRep {
  public:
   explicit MockMemTableRep(Allocator* allocator, MemTableRep* rep)
-      : MemTableRep(allocator), rep_(rep), num_insert_with_hint_(0) {}
+      : MemTableRep(allocator),
+        rep_(rep),
+        num_insert_with_hint_(0),
+        num_insert_in_sorted_run_(0) {}
 
   KeyHandle Allocate(const size_t len, char** buf) override {
     return rep_->Allocate(len, buf);
@@ -39,6 +42,11 @@ class MockMemTableRep : public MemTableRep {
     last_hint_out_ = *hint;
   }
 
+  bool InsertKeyInSortedRun(KeyHandle handle) override {
+    num_insert_in_sorted_run_++;
+    return rep_->InsertKeyInSortedRun(handle);
+  }
+
   bool Contains(const char* key) const override { return rep_->Contains(key); }
 
   void Get(const LookupKey& k, void* callback_args,
@@ -57,12 +65,14 @@ class MockMemTableRep : public MemTableRep {
   void* last_hint_in() { return last_hint_in_; }
   void* last_hint_out() { return last_hint_out_; }
   int num_insert_with_hint() { return num_insert_with_hint_; }
+  int num_insert_in_sorted_run() { return num_insert_in_sorted_run_; }
 
  private:
   std::unique_ptr<MemTableRep> rep_;
   void* last_hint_in_;
   void* last_hint_out_;
   int num_insert_with_hint_;
+  int num_insert_in_sorted_run_;
 };
 
 class MockMemTableRepFactory : public MemTableRepFactory {
@@ -277,6 +287,108 @@ TEST_F(DBMemTableTest, ConcurrentMergeWrite) {
   delete mem;
 }
 
+TEST_F(DBMemTableTest, BTreeRepConcurrentInsertAndIterate) {
+  Options options;
+  InternalKeyComparator cmp(BytewiseComparator());
+  options.memtable_factory = std::make_shared<BTreeRepFactory>();
+  options.allow_concurrent_memtable_write = true;
+  ImmutableOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+  std::unique_ptr<MemTable> mem(
+      new MemTable(cmp, ioptions, MutableCFOptions(options), &wb,
+                   kMaxSequenceNumber, 0 /* column_family_id */));
+
+  // Enough keys for several levels of inner node splits.
+  const int kNumThreads = 4;
+  const int kKeysPerThread = 5000;
+  auto key_of = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%08d", i);
+    return std::string(buf);
+  };
+  std::atomic<bool> writers_done{false};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      MemTablePostProcessInfo post_process_info;
+      void* hint = nullptr;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        int k = i * kNumThreads + t;
+        ASSERT_OK(mem->Add(k + 1, kTypeValue, key_of(k), key_of(k),
+                           nullptr /* kv_prot_info */, true,
+                           &post_process_info, (i % 2) ? &hint : nullptr));
+      }
+      delete[] reinterpret_cast<char*>(hint);
+    });
+  }
+  // Iterate while inserts split leaves; keys must stay strictly ordered.
+  threads.emplace_back([&]() {
+    while (!writers_done.load()) {
+      Arena arena;
+      ScopedArenaPtr<InternalIterator> iter(mem->NewIterator(
+          ReadOptions(), /*seqno_to_time_mapping=*/nullptr, &arena,
+          /*prefix_extractor=*/nullptr, /*for_flush=*/false));
+      std::string prev;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        if (!prev.empty()) {
+          ASSERT_LT(cmp.Compare(prev, iter->key()), 0);
+        }
+        prev = iter->key().ToString();
+      }
+    }
+  });
+  for (int t = 0; t < kNumThreads; t++) {
+    threads[t].join();
+  }
+  writers_done.store(true);
+  threads.back().join();
+
+  const int kNumKeys = kNumThreads * kKeysPerThread;
+  // Duplicate <key, seq> is rejected.
+  ASSERT_TRUE(mem->Add(1, kTypeValue, key_of(0), "dup",
+                       nullptr /* kv_prot_info */)
+                  .IsTryAgain());
+
+  ReadOptions ro;
+  Arena arena;
+  ScopedArenaPtr<InternalIterator> iter(mem->NewIterator(
+      ro, /*seqno_to_time_mapping=*/nullptr, &arena,
+      /*prefix_extractor=*/nullptr, /*for_flush=*/false));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(key_of(count), ExtractUserKey(iter->key()).ToString());
+    count++;
+  }
+  ASSERT_EQ(kNumKeys, count);
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    count--;
+    ASSERT_EQ(key_of(count), ExtractUserKey(iter->key()).ToString());
+  }
+  ASSERT_EQ(0, count);
+  iter->Seek(InternalKey(key_of(1234), kMaxSequenceNumber, kValueTypeForSeek)
+                 .Encode());
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(key_of(1234), ExtractUserKey(iter->key()).ToString());
+  iter->SeekForPrev(
+      InternalKey(key_of(1234), kMaxSequenceNumber, kValueTypeForSeek)
+          .Encode());
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(key_of(1233), ExtractUserKey(iter->key()).ToString());
+
+  mem->MarkImmutable();
+  std::string value;
+  Status status;
+  MergeContext merge_context;
+  SequenceNumber max_covering_tombstone_seq = 0;
+  LookupKey lkey(key_of(4321), kMaxSequenceNumber);
+  ASSERT_TRUE(mem->Get(lkey, &value, /*columns=*/nullptr,
+                       /*timestamp=*/nullptr, &status, &merge_context,
+                       &max_covering_tombstone_seq, ro,
+                       true /* immutable_memtable */));
+  ASSERT_OK(status);
+  ASSERT_EQ(key_of(4321), value);
+}
+
 TEST_F(DBMemTableTest, InsertWithHint) {
   Options options;
   options.allow_concurrent_memtable_write = false;
@@ -320,6 +432,59 @@ TEST_F(DBMemTableTest, InsertWithHint) {
   ASSERT_EQ("vvv", Get("NotInPrefixDomain"));
 }
 
+TEST_F(DBMemTableTest, InsertSortedBatch) {
+  Options options;
+  options.allow_concurrent_memtable_write = false;
+  options.create_if_missing = true;
+  options.memtable_factory.reset(new MockMemTableRepFactory());
+  options.env = env_;
+  Reopen(options);
+  MockMemTableRep* rep =
+      static_cast<MockMemTableRepFactory*>(options.memtable_factory.get())
+          ->rep();
+
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Put("k5", "v5"));
+  ASSERT_EQ(0, rep->num_insert_in_sorted_run());
+
+  // Every key of a sorted batch but the first continues the run, including
+  // keys that land in between existing keys. Range deletions go to a
+  // different table and are not part of the run.
+  WriteBatch sorted;
+  ASSERT_OK(sorted.Put("k1", "v1"));
+  ASSERT_OK(sorted.Put("k3", "v3"));
+  ASSERT_OK(sorted.DeleteRange("k0", "k1"));
+  ASSERT_OK(sorted.Delete("k4"));
+  ASSERT_OK(sorted.Put("k6", "v6"));
+  ASSERT_OK(db_->Write(WriteOptions(), &sorted));
+  ASSERT_EQ(3, rep->num_insert_in_sorted_run());
+
+  // Once the order is broken, the rest of the batch is inserted normally.
+  WriteBatch unsorted;
+  ASSERT_OK(unsorted.Put("k8", "v8"));
+  ASSERT_OK(unsorted.Put("k7", "v7"));
+  ASSERT_OK(unsorted.Put("k9", "v9"));
+  ASSERT_OK(db_->Write(WriteOptions(), &unsorted));
+  ASSERT_EQ(3, rep->num_insert_in_sorted_run());
+
+  // A key that repeats within the batch is not after the previous one.
+  WriteBatch repeated;
+  ASSERT_OK(repeated.Put("k3", "v3_1"));
+  ASSERT_OK(repeated.Put("k3", "v3_2"));
+  ASSERT_OK(db_->Write(WriteOptions(), &repeated));
+  ASSERT_EQ(3, rep->num_insert_in_sorted_run());
+
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("v2", Get("k2"));
+  ASSERT_EQ("v3_2", Get("k3"));
+  ASSERT_EQ("NOT_FOUND", Get("k4"));
+  ASSERT_EQ("v5", Get("k5"));
+  ASSERT_EQ("v6", Get("k6"));
+  ASSERT_EQ("v7", Get("k7"));
+  ASSERT_EQ("v8", Get("k8"));
+  ASSERT_EQ("v9", Get("k9"));
+}
+
 TEST_F(DBMemTableTest, ColumnFamilyId) {
   // Verifies MemTableRepFactory is told the right column family id.
   Options options;
@@ -412,6 +412,9 @@ Options DBTestBase::GetOptions(
       options.allow_concurrent_memtable_write = false;
       options.unordered_write = false;
       break;
+    case kBTreeRep:
+      options.memtable_factory.reset(new BTreeRepFactory());
+      break;
     case kHashLinkList:
       options.prefix_extractor.reset(NewFixedPrefixTransform(1));
       options.memtable_factory.reset(
@@ -1051,6 +1051,7 @@ class DBTestBase : public testing::Test {
     kUniversalSubcompactions,
     kUnorderedWrite,
     kBlockBasedTableWithBinarySearchWithFirstKeyIndex,
+    kBTreeRep,
     // This must be the last line
     kEnd,
   };
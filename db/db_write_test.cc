@@ -1000,6 +1000,189 @@ TEST_P(DBWriteTest, RecycleLogToggleTest) {
   ASSERT_EQ(Get(Key(1)), "val2");
 }
 
+TEST_P(DBWriteTest, AsyncIOForWrites) {
+  Options options = GetOptions();
+  options.use_async_io_for_writes = true;
+  options.write_buffer_size = 64 << 10;
+  options.level0_file_num_compaction_trigger = 2;
+  Reopen(options);
+
+  WriteOptions sync_write_options;
+  sync_write_options.sync = true;
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(rnd.RandomString(200));
+    if (i % 7 == 0) {
+      ASSERT_OK(dbfull()->Put(sync_write_options, Key(i), values.back()));
+    } else {
+      ASSERT_OK(Put(Key(i), values.back()));
+    }
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForFlushMemTable());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int i = 1000; i < 1100; ++i) {
+    values.push_back(rnd.RandomString(200));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(db_->FlushWAL(/*sync=*/true));
+
+  Reopen(options);
+  for (int i = 0; i < 1100; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
+TEST_P(DBWriteTest, ParallelWalCopy) {
+  constexpr int kNumThreads = 5;
+  Options options = GetOptions();
+  options.enable_parallel_wal_copy = true;
+  Reopen(options);
+
+  std::atomic<int> ready_count{0};
+  std::atomic<int> copy_count{0};
+  // Wait until all threads linked to write threads, to make sure
+  // all threads join the same batch group.
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::JoinBatchGroup:Wait", [&](void* arg) {
+        ready_count++;
+        auto* w = static_cast<WriteThread::Writer*>(arg);
+        if (w->state == WriteThread::STATE_GROUP_LEADER) {
+          while (ready_count < kNumThreads) {
+            // busy waiting
+          }
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::CompleteParallelWalWriter", [&](void* arg) {
+        if (static_cast<WriteThread::Writer*>(arg)->wal_copy != nullptr) {
+          copy_count++;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumThreads * 3; ++i) {
+    values.push_back(rnd.RandomString(100 + i * 1000));
+  }
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&, i]() {
+      WriteBatch batch;
+      for (int j = i * 3; j < i * 3 + 3; ++j) {
+        ASSERT_OK(batch.Put(Key(j), values[j]));
+      }
+      ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  // Not used with two_write_queues.
+  ASSERT_EQ(options.two_write_queues ? 0 : kNumThreads, copy_count.load());
+
+  // The WAL record is read back on recovery.
+  if (options.manual_wal_flush) {
+    ASSERT_OK(db_->FlushWAL(/*sync=*/false));
+  }
+  Reopen(options);
+  for (int i = 0; i < kNumThreads * 3; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, LockFreeWalBuffer) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrites = 500;
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.enable_lock_free_wal_buffer = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.manual_wal_flush = true;
+  Reopen(options);
+
+  std::atomic<int> lock_free_count{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::WriteLockFree:Enter", [&](void*) { lock_free_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Every third write of the first thread goes through the write thread, and
+  // a flush switches the memtable and the WAL in the middle.
+  std::vector<port::Thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < kNumWrites; ++j) {
+        WriteOptions write_options;
+        write_options.sync = i == 0 && j % 3 == 0;
+        WriteBatch batch;
+        ASSERT_OK(batch.Put(Key(i * kNumWrites + j), "v" + std::to_string(j)));
+        ASSERT_OK(batch.Put("last" + std::to_string(i), std::to_string(j)));
+        ASSERT_OK(dbfull()->Write(write_options, &batch));
+        if (i == 1 && j == kNumWrites / 2) {
+          ASSERT_OK(Flush());
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_GT(lock_free_count.load(), 0);
+  ASSERT_EQ(kNumThreads * kNumWrites * 2,
+            static_cast<int>(dbfull()->GetLatestSequenceNumber()));
+
+  ASSERT_OK(db_->FlushWAL(/*sync=*/false));
+  Reopen(options);
+  ASSERT_EQ(kNumThreads * kNumWrites * 2,
+            static_cast<int>(dbfull()->GetLatestSequenceNumber()));
+  for (int i = 0; i < kNumThreads; i++) {
+    for (int j = 0; j < kNumWrites; ++j) {
+      ASSERT_EQ("v" + std::to_string(j), Get(Key(i * kNumWrites + j)));
+    }
+    ASSERT_EQ(std::to_string(kNumWrites - 1), Get("last" + std::to_string(i)));
+  }
+}
+
+TEST_F(DBWriteTestUnparameterized, LockFreeWalBufferOrder) {
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.manual_wal_flush = true;
+  options.enable_lock_free_wal_buffer = true;
+  Reopen(options);
+
+  // The WAL records buffered are written before the one of a write through
+  // the write thread, and recovered in sequence number order.
+  WriteOptions sync_write_options;
+  sync_write_options.sync = true;
+  ASSERT_OK(Put("key", "v1"));
+  ASSERT_OK(Put("key", "v2", sync_write_options));
+  ASSERT_OK(Put("key", "v3"));
+  ASSERT_OK(Put("other", "v1"));
+  ASSERT_OK(Delete("other"));
+  const SequenceNumber seq = dbfull()->GetLatestSequenceNumber();
+  ASSERT_EQ(5U, seq);
+  // Closing writes the buffered WAL records as well.
+  Reopen(options);
+  ASSERT_EQ(seq, dbfull()->GetLatestSequenceNumber());
+  ASSERT_EQ("v3", Get("key"));
+  ASSERT_EQ("NOT_FOUND", Get("other"));
+
+  // Writes go on after the sequence numbers used by the write thread.
+  ASSERT_OK(Put("key", "v4", sync_write_options));
+  ASSERT_OK(Put("key", "v5"));
+  ASSERT_EQ(seq + 2, dbfull()->GetLatestSequenceNumber());
+  ASSERT_OK(db_->FlushWAL(/*sync=*/false));
+  Reopen(options);
+  ASSERT_EQ("v5", Get("key"));
+  ASSERT_EQ(seq + 2, dbfull()->GetLatestSequenceNumber());
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
@@ -22,6 +22,7 @@
 
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_entry_stats.h"
+#include "cache/quota_cache.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
 #include "db/write_stall_stats.h"
@@ -255,6 +256,7 @@ static const std::string levelstats = "levelstats";
 static const std::string block_cache_entry_stats = "block-cache-entry-stats";
 static const std::string fast_block_cache_entry_stats =
     "fast-block-cache-entry-stats";
+static const std::string block_cache_quota = "block-cache-quota";
 static const std::string num_immutable_mem_table = "num-immutable-mem-table";
 static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
@@ -343,6 +345,8 @@ const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
     rocksdb_prefix + fast_block_cache_entry_stats;
+const std::string DB::Properties::kBlockCacheQuota =
+    rocksdb_prefix + block_cache_quota;
 const std::string DB::Properties::kNumImmutableMemTable =
     rocksdb_prefix + num_immutable_mem_table;
 const std::string DB::Properties::kNumImmutableMemTableFlushed =
@@ -483,6 +487,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kFastBlockCacheEntryStats,
          {true, &InternalStats::HandleFastBlockCacheEntryStats, nullptr,
           &InternalStats::HandleFastBlockCacheEntryStatsMap, nullptr}},
+        {DB::Properties::kBlockCacheQuota,
+         {true, &InternalStats::HandleBlockCacheQuota, nullptr,
+          &InternalStats::HandleBlockCacheQuotaMap, nullptr}},
         {DB::Properties::kSSTables,
          {false, &InternalStats::HandleSsTables, nullptr, nullptr, nullptr}},
         {DB::Properties::kAggregatedTableProperties,
@@ -824,6 +831,32 @@ bool InternalStats::HandleFastBlockCacheEntryStatsMap(
   return HandleBlockCacheEntryStatsMapInternal(values, true /* fast */);
 }
 
+bool InternalStats::HandleBlockCacheQuota(std::string* value,
+                                          Slice /*suffix*/) {
+  std::map<std::string, std::string> values;
+  if (!HandleBlockCacheQuotaMap(&values, Slice())) {
+    return false;
+  }
+  std::ostringstream str;
+  for (const auto& kv : values) {
+    str << kv.first << ": " << kv.second << "\n";
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheQuotaMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  Cache* block_cache = GetBlockCacheForStats();
+  QuotaCache* quota_cache =
+      block_cache ? block_cache->CheckedCast<QuotaCache>() : nullptr;
+  if (quota_cache == nullptr) {
+    return false;
+  }
+  quota_cache->GetQuotaStats(values);
+  return true;
+}
+
 bool InternalStats::HandleLiveSstFilesSizeAtTemperature(std::string* value,
                                                         Slice suffix) {
   uint64_t temperature;
@@ -918,6 +918,9 @@ class InternalStats {
   bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix);
   bool HandleFastBlockCacheEntryStatsMap(
       std::map<std::string, std::string>* values, Slice suffix);
+  bool HandleBlockCacheQuota(std::string* value, Slice suffix);
+  bool HandleBlockCacheQuotaMap(std::map<std::string, std::string>* values,
+                                Slice suffix);
   bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
   bool HandleNumBlobFiles(uint64_t* value, DBImpl* db, Version* version);
   bool HandleBlobStats(std::string* value, Slice suffix);
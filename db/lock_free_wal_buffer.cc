@@ -0,0 +1,213 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/lock_free_wal_buffer.h"
+
+#include <thread>
+
+#include "db/write_batch_internal.h"
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+LockFreeWalBuffer::LockFreeWalBuffer(size_t num_slots, WriteFn write_fn)
+    : num_slots_(num_slots),
+      slots_(new Slot[num_slots]),
+      write_fn_(std::move(write_fn)),
+      cv_(&mu_) {
+  assert(num_slots_ > 0);
+  flush_thread_.reset(
+      new port::Thread(&LockFreeWalBuffer::BackgroundFlush, this));
+}
+
+LockFreeWalBuffer::~LockFreeWalBuffer() {
+  if (flush_thread_) {
+    {
+      MutexLock l(&mu_);
+      closing_ = true;
+      cv_.SignalAll();
+    }
+    flush_thread_->join();
+  }
+  error_.PermitUncheckedError();
+}
+
+SequenceNumber LockFreeWalBuffer::Reserve(uint64_t count, uint64_t epoch,
+                                          SequenceNumber last_sequence) {
+  assert(count > 0);
+  if (epoch != epoch_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    if (epoch != epoch_.load(std::memory_order_relaxed)) {
+      // The writers of the previous epoch are done, so their batches are all
+      // published, and normally flushed by Drain() already.
+      while (error_.ok() && FlushFilled()) {
+      }
+      assert(last_published_.load(std::memory_order_relaxed) ==
+             LastReserved());
+      assert(last_sequence >= LastReserved());
+      last_reserved_.store(last_sequence, std::memory_order_relaxed);
+      last_published_.store(last_sequence, std::memory_order_relaxed);
+      last_flushed_.store(last_sequence, std::memory_order_relaxed);
+      epoch_.store(epoch, std::memory_order_release);
+    }
+  }
+  const SequenceNumber sequence =
+      last_reserved_.fetch_add(count, std::memory_order_acq_rel) + 1;
+  // The slot was last used for a batch at least num_slots_ before, which must
+  // be out of both the memtable insertions and the WAL writes in progress.
+  if (sequence > num_slots_) {
+    const SequenceNumber previous = sequence - num_slots_;
+    while (last_flushed_.load(std::memory_order_acquire) < previous ||
+           last_published_.load(std::memory_order_acquire) < previous) {
+      TEST_SYNC_POINT("LockFreeWalBuffer::Reserve:WaitForSlot");
+      RequestFlush();
+      std::this_thread::yield();
+    }
+  }
+  if (sequence + count - last_flushed_.load(std::memory_order_relaxed) >
+      num_slots_ / 2) {
+    RequestFlush();
+  }
+  return sequence;
+}
+
+void LockFreeWalBuffer::Fill(SequenceNumber sequence, const WriteBatch& batch) {
+  Slot& slot = GetSlot(sequence);
+  assert(slot.filled.load(std::memory_order_relaxed) != sequence);
+  const Slice contents = WriteBatchInternal::Contents(&batch);
+  slot.count.store(WriteBatchInternal::Count(&batch),
+                   std::memory_order_relaxed);
+  slot.rep.assign(contents.data(), contents.size());
+  EncodeFixed64(&slot.rep[0], sequence);
+  slot.filled.store(sequence, std::memory_order_release);
+}
+
+SequenceNumber LockFreeWalBuffer::Publish(SequenceNumber sequence) {
+  GetSlot(sequence).inserted.store(sequence, std::memory_order_release);
+  // Advance over all the batches inserted in sequence. Whoever inserts the
+  // batch right after the last published one publishes the ones that were
+  // waiting for it.
+  SequenceNumber published = last_published_.load(std::memory_order_acquire);
+  for (;;) {
+    Slot& slot = GetSlot(published + 1);
+    if (slot.inserted.load(std::memory_order_acquire) != published + 1) {
+      break;
+    }
+    // If the slot was published and reused meanwhile, `count` may be another
+    // batch's, but then the exchange fails.
+    const SequenceNumber next =
+        published + slot.count.load(std::memory_order_relaxed);
+    if (last_published_.compare_exchange_weak(published, next,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+      published = next;
+    }
+  }
+  return published;
+}
+
+IOStatus LockFreeWalBuffer::Flush(SequenceNumber sequence) {
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  while (error_.ok() &&
+         last_flushed_.load(std::memory_order_relaxed) < sequence) {
+    if (!FlushFilled()) {
+      // Wait for a writer to fill its slot.
+      std::this_thread::yield();
+    }
+  }
+  return error_;
+}
+
+IOStatus LockFreeWalBuffer::Drain() {
+  IOStatus s = Flush(LastReserved());
+  assert(!s.ok() ||
+         last_published_.load(std::memory_order_relaxed) == LastReserved());
+  if (!s.ok()) {
+    // Drop the batches not written, like a failed write group.
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    last_flushed_.store(LastReserved(), std::memory_order_relaxed);
+    error_ = IOStatus::OK();
+    has_error_.store(false, std::memory_order_relaxed);
+  }
+  return s;
+}
+
+IOStatus LockFreeWalBuffer::Close() {
+  if (flush_thread_) {
+    {
+      MutexLock l(&mu_);
+      closing_ = true;
+      cv_.SignalAll();
+    }
+    flush_thread_->join();
+    flush_thread_.reset();
+  }
+  return Drain();
+}
+
+void LockFreeWalBuffer::RequestFlush() {
+  if (!flush_requested_.load(std::memory_order_relaxed) &&
+      !flush_requested_.exchange(true, std::memory_order_acq_rel)) {
+    MutexLock l(&mu_);
+    cv_.Signal();
+  }
+}
+
+void LockFreeWalBuffer::BackgroundFlush() {
+  for (;;) {
+    {
+      MutexLock l(&mu_);
+      while (!closing_ && !flush_requested_.load(std::memory_order_relaxed)) {
+        cv_.Wait();
+      }
+      if (closing_) {
+        return;
+      }
+    }
+    flush_requested_.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(flush_mutex_);
+    while (error_.ok() && FlushFilled()) {
+    }
+  }
+}
+
+bool LockFreeWalBuffer::FlushFilled() {
+  const SequenceNumber first =
+      last_flushed_.load(std::memory_order_relaxed) + 1;
+  SequenceNumber next = first;
+  uint64_t count = 0;
+  record_.clear();
+  for (;;) {
+    Slot& slot = GetSlot(next);
+    if (slot.filled.load(std::memory_order_acquire) != next) {
+      break;
+    }
+    if (record_.empty()) {
+      record_.assign(slot.rep);
+    } else {
+      record_.append(slot.rep.data() + WriteBatchInternal::kHeader,
+                     slot.rep.size() - WriteBatchInternal::kHeader);
+    }
+    const uint64_t slot_count = slot.count.load(std::memory_order_relaxed);
+    count += slot_count;
+    next += slot_count;
+  }
+  if (count == 0) {
+    return false;
+  }
+  // The slots can be reused once copied.
+  last_flushed_.store(next - 1, std::memory_order_release);
+  EncodeFixed32(&record_[8], static_cast<uint32_t>(count));
+  IOStatus s = write_fn_(record_, first);
+  if (!s.ok()) {
+    error_ = s;
+    has_error_.store(true, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,139 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/io_status.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class WriteBatch;
+
+// LockFreeWalBuffer lets writers reserve sequence numbers and a place in the
+// WAL with an atomic fetch-add instead of going through the WriteThread (see
+// DBOptions::enable_lock_free_wal_buffer). Each writer copies its batch in the
+// slot of its first sequence number, inserts it into the memtable
+// concurrently with the other writers, and then publishes its sequence
+// numbers once all the previous ones are inserted as well. A background
+// thread writes the filled slots to the WAL in sequence number order, merged
+// into a single record like the batches of a write group.
+//
+// The writers must not run concurrently with the WriteThread: they only go
+// through while it is idle (see WriteThread::TryEnterBypass()), and whoever
+// then gets hold of the WriteThread writes their batches to the WAL with
+// Drain() before writing anything else.
+class LockFreeWalBuffer {
+ public:
+  // Writes the given record, a merged WriteBatch starting at the given
+  // sequence number, to the WAL.
+  using WriteFn =
+      std::function<IOStatus(const Slice& record, SequenceNumber sequence)>;
+
+  // A batch takes the slot of its first sequence number, so the writers wait
+  // for the WAL writes once their sequence numbers are this far ahead.
+  static constexpr size_t kDefaultNumSlots = 8192;
+
+  LockFreeWalBuffer(size_t num_slots, WriteFn write_fn);
+  // Stops the background thread, dropping the batches not written to the WAL
+  // unless Close() was called.
+  ~LockFreeWalBuffer();
+
+  // No copying allowed
+  LockFreeWalBuffer(const LockFreeWalBuffer&) = delete;
+  void operator=(const LockFreeWalBuffer&) = delete;
+
+  // Reserves `count` consecutive sequence numbers, and returns the first one.
+  // Waits until the slot of the first sequence number is available.
+  // `epoch` is the WriteThread epoch the writer went through in. The first
+  // reservation of an epoch starts after `last_sequence`, the last sequence
+  // number of the DB, as the WriteThread may have used sequence numbers since
+  // the previous one.
+  SequenceNumber Reserve(uint64_t count, uint64_t epoch,
+                         SequenceNumber last_sequence);
+
+  // Copies `batch`, with its sequence number set to `sequence`, to the slot
+  // reserved for it, to be written to the WAL.
+  void Fill(SequenceNumber sequence, const WriteBatch& batch);
+
+  // Marks the batch at `sequence` as inserted into the memtable, and returns
+  // the last sequence number up to which all the batches are inserted.
+  SequenceNumber Publish(SequenceNumber sequence);
+
+  // Writes the batches to the WAL, up to the one at `sequence` at least.
+  // Waits for the batches in between to be filled.
+  IOStatus Flush(SequenceNumber sequence);
+
+  // Writes all the batches reserved to the WAL, and returns the first error
+  // writing to the WAL since the last call, for the caller to handle it.
+  // REQUIRES: no writer in flight
+  IOStatus Drain();
+
+  // Stops the background thread and drains the buffer.
+  IOStatus Close();
+
+  SequenceNumber LastReserved() const {
+    return last_reserved_.load(std::memory_order_acquire);
+  }
+
+  // Whether writing to the WAL failed. The writers should go through the
+  // WriteThread to have the error handled.
+  bool HasError() const { return has_error_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Slot {
+    // The sequence number of the batch copied in the slot, and of the batch
+    // last inserted into the memtable.
+    std::atomic<SequenceNumber> filled{0};
+    std::atomic<SequenceNumber> inserted{0};
+    std::atomic<uint64_t> count{0};
+    std::string rep;
+  };
+
+  Slot& GetSlot(SequenceNumber sequence) {
+    return slots_[sequence % num_slots_];
+  }
+
+  void RequestFlush();
+  void BackgroundFlush();
+  // Writes the batches filled in sequence, if any. Returns whether it wrote
+  // some. REQUIRES: flush_mutex_ held
+  bool FlushFilled();
+
+  const size_t num_slots_;
+  std::unique_ptr<Slot[]> slots_;
+  const WriteFn write_fn_;
+
+  // The WriteThread epoch of the reservations.
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<SequenceNumber> last_reserved_{0};
+  std::atomic<SequenceNumber> last_published_{0};
+  // Written under flush_mutex_.
+  std::atomic<SequenceNumber> last_flushed_{0};
+  std::atomic<bool> has_error_{false};
+
+  // Serializes the writes to the WAL.
+  std::mutex flush_mutex_;
+  IOStatus error_;
+  std::string record_;
+
+  // For the background thread.
+  std::atomic<bool> flush_requested_{false};
+  port::Mutex mu_;
+  port::CondVar cv_;
+  bool closing_ = false;
+  std::unique_ptr<port::Thread> flush_thread_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -350,6 +350,31 @@ TEST_P(LogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, PieceCrcs) {
+  // Records made of pieces with precomputed CRCs, spanning several
+  // fragments, so that some pieces are split between fragments.
+  Random rnd(301);
+  std::vector<std::string> records;
+  for (size_t num_pieces : {1, 2, 3, 50}) {
+    std::string record;
+    std::vector<Writer::PieceCrc> piece_crcs;
+    for (size_t i = 0; i < num_pieces; ++i) {
+      const size_t size = i == 0 ? 12 : rnd.Uniform(3 * kBlockSize) + 1;
+      std::string piece = rnd.RandomString(static_cast<int>(size));
+      piece_crcs.push_back({size, crc32c::Value(piece.data(), size)});
+      record.append(piece);
+    }
+    ASSERT_OK(writer_->AddRecord(WriteOptions(), Slice(record),
+                                 /*seqno=*/0, &piece_crcs));
+    records.push_back(record);
+  }
+  for (const auto& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ(0U, DroppedBytes());
+}
+
 TEST_P(LogTest, MarginalTrailer) {
   // Make a trailer that is exactly the same length as an empty record.
   int header_size =
@@ -9,6 +9,7 @@
 
 #include "db/log_writer.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "file/writable_file_writer.h"
@@ -87,7 +88,8 @@ bool Writer::PublishIfClosed() {
 }
 
 IOStatus Writer::AddRecord(const WriteOptions& write_options,
-                           const Slice& slice, const SequenceNumber& seqno) {
+                           const Slice& slice, const SequenceNumber& seqno,
+                           const std::vector<PieceCrc>* piece_crcs) {
   IOStatus s = MaybeHandleSeenFileWriterError();
   if (!s.ok()) {
     return s;
@@ -104,7 +106,13 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
   if (compress_) {
     compress_->Reset();
     compress_start = true;
+    // The CRCs are for the uncompressed data.
+    piece_crcs = nullptr;
   }
+  assert(piece_crcs == nullptr || !piece_crcs->empty());
+  // Position in `piece_crcs`.
+  size_t piece = 0;
+  size_t piece_offset = 0;
 
   IOOptions opts;
   s = WritableFileWriter::PrepareIOOptions(write_options, opts);
@@ -171,7 +179,32 @@ IOStatus Writer::AddRecord(const WriteOptions& write_options,
         type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
       }
 
-      s = EmitPhysicalRecord(write_options, type, ptr, fragment_length);
+      if (piece_crcs != nullptr) {
+        // Combine the CRCs of the pieces of the fragment, computing those
+        // of partial pieces.
+        uint32_t payload_crc = 0;
+        size_t remaining = fragment_length;
+        while (remaining > 0) {
+          assert(piece < piece_crcs->size());
+          const PieceCrc& p = (*piece_crcs)[piece];
+          const size_t n = std::min(remaining, p.size - piece_offset);
+          const uint32_t crc =
+              (piece_offset == 0 && n == p.size)
+                  ? p.crc
+                  : crc32c::Value(ptr + (fragment_length - remaining), n);
+          payload_crc = crc32c::Crc32cCombine(payload_crc, crc, n);
+          remaining -= n;
+          piece_offset += n;
+          if (piece_offset == p.size) {
+            ++piece;
+            piece_offset = 0;
+          }
+        }
+        s = EmitPhysicalRecord(write_options, type, ptr, fragment_length,
+                               &payload_crc);
+      } else {
+        s = EmitPhysicalRecord(write_options, type, ptr, fragment_length);
+      }
       ptr += fragment_length;
       left -= fragment_length;
       begin = false;
@@ -309,7 +342,8 @@ IOStatus Writer::MaybeAddUserDefinedTimestampSizeRecord(
 bool Writer::BufferIsEmpty() { return dest_->BufferIsEmpty(); }
 
 IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
-                                    RecordType t, const char* ptr, size_t n) {
+                                    RecordType t, const char* ptr, size_t n,
+                                    const uint32_t* payload_crc) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
   size_t header_size;
@@ -341,8 +375,10 @@ IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
   }
 
   // Compute the crc of the record type and the payload.
-  uint32_t payload_crc = crc32c::Value(ptr, n);
-  crc = crc32c::Crc32cCombine(crc, payload_crc, n);
+  const uint32_t data_crc =
+      payload_crc != nullptr ? *payload_crc : crc32c::Value(ptr, n);
+  assert(data_crc == crc32c::Value(ptr, n));
+  crc = crc32c::Crc32cCombine(crc, data_crc, n);
   crc = crc32c::Mask(crc);  // Adjust for storage
   TEST_SYNC_POINT_CALLBACK("LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum",
                            &crc);
@@ -355,7 +391,7 @@ IOStatus Writer::EmitPhysicalRecord(const WriteOptions& write_options,
     s = dest_->Append(opts, Slice(buf, header_size), 0 /* crc32c_checksum */);
   }
   if (s.ok()) {
-    s = dest_->Append(opts, Slice(ptr, n), payload_crc);
+    s = dest_->Append(opts, Slice(ptr, n), data_crc);
   }
   block_offset_ += header_size + n;
   return s;
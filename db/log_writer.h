@@ -90,8 +90,18 @@ class Writer {
 
   ~Writer();
 
+  // The size and CRC32C of a piece of a record, see AddRecord().
+  struct PieceCrc {
+    size_t size;
+    uint32_t crc;
+  };
+
+  // If not null, `piece_crcs` holds the CRC32C of consecutive pieces making
+  // up `slice`, so that only the pieces spanning several physical records
+  // have their CRC computed again.
   IOStatus AddRecord(const WriteOptions& write_options, const Slice& slice,
-                     const SequenceNumber& seqno = 0);
+                     const SequenceNumber& seqno = 0,
+                     const std::vector<PieceCrc>* piece_crcs = nullptr);
   IOStatus AddCompressionTypeRecord(const WriteOptions& write_options);
   IOStatus MaybeAddPredecessorWALInfo(const WriteOptions& write_options,
                                       const PredecessorWALInfo& info);
@@ -137,8 +147,10 @@ class Writer {
   // record type stored in the header.
   uint32_t type_crc_[kMaxRecordType + 1];
 
+  // `payload_crc`, if not null, is the CRC32C of the payload.
   IOStatus EmitPhysicalRecord(const WriteOptions& write_options,
-                              RecordType type, const char* ptr, size_t length);
+                              RecordType type, const char* ptr, size_t length,
+                              const uint32_t* payload_crc = nullptr);
 
   IOStatus MaybeHandleSeenFileWriterError();
 
@@ -19,9 +19,11 @@
 #include "db/kv_checksum.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
+#include "db/negative_lookup_cache.h"
 #include "db/pinned_iterators_manager.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/read_callback.h"
+#include "db/scan_cache.h"
 #include "db/wide/wide_column_serialization.h"
 #include "logging/logging.h"
 #include "memory/arena.h"
@@ -342,6 +344,15 @@ Slice MemTableRep::UserKey(const char* key) const {
   return Slice(slice.data(), slice.size() - 8);
 }
 
+void MemTableRep::MultiGet(size_t num_keys, const LookupKey* const* keys,
+                           void* const* callback_args,
+                           bool (*callback_func)(void* arg,
+                                                 const char* entry)) {
+  for (size_t i = 0; i < num_keys; ++i) {
+    Get(*keys[i], callback_args[i], callback_func);
+  }
+}
+
 KeyHandle MemTableRep::Allocate(const size_t len, char** buf) {
   *buf = allocator_->Allocate(len);
   return static_cast<KeyHandle>(*buf);
@@ -911,7 +922,8 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
                      const Slice& value,
                      const ProtectionInfoKVOS64* kv_prot_info,
                      bool allow_concurrent,
-                     MemTablePostProcessInfo* post_process_info, void** hint) {
+                     MemTablePostProcessInfo* post_process_info, void** hint,
+                     bool in_sorted_run) {
   // Format of an entry is concatenation of:
   //  key_size     : varint32 of internal_key.size()
   //  key bytes    : char[internal_key.size()]
@@ -965,7 +977,9 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
         return Status::TryAgain("key+seq exists");
       }
     } else {
-      bool res = table->InsertKey(handle);
+      bool res = (in_sorted_run && table == table_)
+                     ? table->InsertKeyInSortedRun(handle)
+                     : table->InsertKey(handle);
       if (UNLIKELY(!res)) {
         return Status::TryAgain("key+seq exists");
       }
@@ -1076,6 +1090,16 @@ Status MemTable::Add(SequenceNumber s, ValueType type,
     is_range_del_table_empty_.store(false, std::memory_order_relaxed);
   }
   UpdateOldestKeyTime();
+  if (scan_cache_versions_ != nullptr) {
+    scan_cache_versions_->OnWrite(key_without_ts, type, s);
+  }
+  if (negative_lookup_cache_ != nullptr) {
+    if (type == kTypeRangeDeletion) {
+      negative_lookup_cache_->OnRangeDeletion(s);
+    } else {
+      negative_lookup_cache_->OnWrite(key_without_ts, s);
+    }
+  }
 
   TEST_SYNC_POINT_CALLBACK("MemTable::Add:BeforeReturn:Encoded", &encoded);
   return Status::OK();
@@ -1115,6 +1139,36 @@ struct Saver {
     return true;
   }
 };
+
+void InitSaver(Saver* saver, MemTable* mem,
+               const ImmutableMemTableOptions& moptions, SystemClock* clock,
+               const LookupKey& key, SequenceNumber max_covering_tombstone_seq,
+               bool do_merge, ReadCallback* callback, bool* is_blob_index,
+               std::string* value, PinnableWideColumns* columns,
+               std::string* timestamp, Status* s, MergeContext* merge_context,
+               bool* found_final_value, bool* merge_in_progress) {
+  saver->status = s;
+  saver->found_final_value = found_final_value;
+  saver->merge_in_progress = merge_in_progress;
+  saver->key = &key;
+  saver->value = value;
+  saver->columns = columns;
+  saver->timestamp = timestamp;
+  saver->seq = kMaxSequenceNumber;
+  saver->mem = mem;
+  saver->merge_context = merge_context;
+  saver->max_covering_tombstone_seq = max_covering_tombstone_seq;
+  saver->merge_operator = moptions.merge_operator;
+  saver->logger = moptions.info_log;
+  saver->inplace_update_support = moptions.inplace_update_support;
+  saver->statistics = moptions.statistics;
+  saver->clock = clock;
+  saver->callback_ = callback;
+  saver->is_blob_index = is_blob_index;
+  saver->do_merge = do_merge;
+  saver->allow_data_in_errors = moptions.allow_data_in_errors;
+  saver->protection_bytes_per_key = moptions.protection_bytes_per_key;
+}
 }  // anonymous namespace
 
 static bool SaveValue(void* arg, const char* entry) {
@@ -1442,27 +1496,9 @@ void MemTable::GetFromTable(const LookupKey& key,
                             MergeContext* merge_context, SequenceNumber* seq,
                             bool* found_final_value, bool* merge_in_progress) {
   Saver saver;
-  saver.status = s;
-  saver.found_final_value = found_final_value;
-  saver.merge_in_progress = merge_in_progress;
-  saver.key = &key;
-  saver.value = value;
-  saver.columns = columns;
-  saver.timestamp = timestamp;
-  saver.seq = kMaxSequenceNumber;
-  saver.mem = this;
-  saver.merge_context = merge_context;
-  saver.max_covering_tombstone_seq = max_covering_tombstone_seq;
-  saver.merge_operator = moptions_.merge_operator;
-  saver.logger = moptions_.info_log;
-  saver.inplace_update_support = moptions_.inplace_update_support;
-  saver.statistics = moptions_.statistics;
-  saver.clock = clock_;
-  saver.callback_ = callback;
-  saver.is_blob_index = is_blob_index;
-  saver.do_merge = do_merge;
-  saver.allow_data_in_errors = moptions_.allow_data_in_errors;
-  saver.protection_bytes_per_key = moptions_.protection_bytes_per_key;
+  InitSaver(&saver, this, moptions_, clock_, key, max_covering_tombstone_seq,
+            do_merge, callback, is_blob_index, value, columns, timestamp, s,
+            merge_context, found_final_value, merge_in_progress);
 
   if (!moptions_.paranoid_memory_checks) {
     table_->Get(key, &saver, SaveValue);
@@ -1521,9 +1557,18 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
       }
     }
   }
+  // Set up a Saver per key first, so that all point lookups can be handed to
+  // the memtable rep as one batch and their searches interleaved.
+  std::array<Saver, MultiGetContext::MAX_BATCH_SIZE> savers;
+  std::array<void*, MultiGetContext::MAX_BATCH_SIZE> saver_args;
+  std::array<const LookupKey*, MultiGetContext::MAX_BATCH_SIZE> lookup_keys;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> found_final_values;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> merges_in_progress;
+  size_t num_lookups = 0;
   for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
-    bool found_final_value{false};
-    bool merge_in_progress = iter->s->IsMergeInProgress();
+    const size_t i = num_lookups++;
+    found_final_values[i] = false;
+    merges_in_progress[i] = iter->s->IsMergeInProgress();
     if (!no_range_del) {
       std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
           NewRangeTombstoneIteratorInternal(
@@ -1541,13 +1586,38 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
         }
       }
     }
-    SequenceNumber dummy_seq;
-    GetFromTable(*(iter->lkey), iter->max_covering_tombstone_seq, true,
-                 callback, &iter->is_blob_index,
-                 iter->value ? iter->value->GetSelf() : nullptr, iter->columns,
-                 iter->timestamp, iter->s, &(iter->merge_context), &dummy_seq,
-                 &found_final_value, &merge_in_progress);
+    InitSaver(&savers[i], this, moptions_, clock_, *(iter->lkey),
+              iter->max_covering_tombstone_seq, true /* do_merge */, callback,
+              &iter->is_blob_index,
+              iter->value ? iter->value->GetSelf() : nullptr, iter->columns,
+              iter->timestamp, iter->s, &(iter->merge_context),
+              &found_final_values[i], &merges_in_progress[i]);
+    saver_args[i] = &savers[i];
+    lookup_keys[i] = iter->lkey;
+  }
+
+  if (!moptions_.paranoid_memory_checks) {
+    table_->MultiGet(num_lookups, lookup_keys.data(), saver_args.data(),
+                     SaveValue);
+  } else {
+    for (size_t i = 0; i < num_lookups; ++i) {
+      Status check_s = table_->GetAndValidate(
+          *lookup_keys[i], &savers[i], SaveValue,
+          moptions_.allow_data_in_errors);
+      if (check_s.IsCorruption()) {
+        *(savers[i].status) = check_s;
+        // Should stop searching the LSM.
+        found_final_values[i] = true;
+      }
+    }
+  }
 
+  size_t lookup_idx = 0;
+  for (auto iter = temp_range.begin(); iter != temp_range.end(); ++iter) {
+    const size_t i = lookup_idx++;
+    bool found_final_value = found_final_values[i];
+    bool merge_in_progress = merges_in_progress[i];
+    assert(iter->s->ok() || iter->s->IsMergeInProgress() || found_final_value);
     if (!found_final_value && merge_in_progress) {
       if (iter->s->ok()) {
         *(iter->s) = Status::MergeInProgress();
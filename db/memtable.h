@@ -41,6 +41,8 @@ struct FlushJobInfo;
 class Mutex;
 class MemTableIterator;
 class MergeContext;
+class NegativeLookupCache;
+class ScanCacheVersions;
 class SystemClock;
 
 struct ImmutableMemTableOptions {
@@ -620,6 +622,11 @@ class MemTable final : public ReadOnlyMemTable {
   // REQUIRES: if allow_concurrent = false, external synchronization to prevent
   // simultaneous operations on the same MemTable.
   //
+  // `in_sorted_run` tells the memtable that `key` follows the previously added
+  // point key in sort order (e.g. both come from the same sorted WriteBatch),
+  // so the insert can start from the previous insert position. Only used when
+  // allow_concurrent = false.
+  //
   // Returns `Status::TryAgain` if the `seq`, `key` combination already exists
   // in the memtable and `MemTableRepFactory::CanHandleDuplicatedKey()` is true.
   // The next attempt should try a larger value for `seq`.
@@ -627,7 +634,7 @@ class MemTable final : public ReadOnlyMemTable {
              const Slice& value, const ProtectionInfoKVOS64* kv_prot_info,
              bool allow_concurrent = false,
              MemTablePostProcessInfo* post_process_info = nullptr,
-             void** hint = nullptr);
+             void** hint = nullptr, bool in_sorted_run = false);
 
   using ReadOnlyMemTable::Get;
   bool Get(const LookupKey& key, std::string* value,
@@ -727,6 +734,18 @@ class MemTable final : public ReadOnlyMemTable {
     }
   }
 
+  // Every entry added is reported to `scan_cache_versions`, if not nullptr.
+  // REQUIRES: called before the memtable is written to
+  void SetScanCacheVersions(ScanCacheVersions* scan_cache_versions) {
+    scan_cache_versions_ = scan_cache_versions;
+  }
+
+  // Every entry added is reported to `negative_lookup_cache`, if not nullptr.
+  // REQUIRES: called before the memtable is written to
+  void SetNegativeLookupCache(NegativeLookupCache* negative_lookup_cache) {
+    negative_lookup_cache_ = negative_lookup_cache;
+  }
+
   bool IsEmpty() const override { return first_seqno_ == 0; }
 
   SequenceNumber GetFirstSequenceNumber() override {
@@ -879,6 +898,9 @@ class MemTable final : public ReadOnlyMemTable {
   // Insert hints for each prefix.
   UnorderedMapH<Slice, void*, SliceHasher32> insert_hints_;
 
+  ScanCacheVersions* scan_cache_versions_ = nullptr;
+  NegativeLookupCache* negative_lookup_cache_ = nullptr;
+
   // Timestamp of oldest key
   std::atomic<uint64_t> oldest_key_time_;
 
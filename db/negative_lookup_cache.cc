@@ -0,0 +1,108 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/negative_lookup_cache.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+NegativeLookupCache::NegativeLookupCache(size_t capacity)
+    : num_buckets_(std::max(capacity / sizeof(Bucket), size_t{1})),
+      buckets_(new Bucket[num_buckets_]) {}
+
+NegativeLookupCache::Bucket& NegativeLookupCache::GetBucket(
+    const Slice& user_key, uint64_t* fingerprint) const {
+  uint64_t hi;
+  uint64_t lo;
+  Hash2x64(user_key.data(), user_key.size(), &hi, &lo);
+  // 0 marks empty slots
+  *fingerprint = lo | 1;
+  return buckets_[FastRange64(hi, num_buckets_)];
+}
+
+bool NegativeLookupCache::Lookup(const Slice& user_key,
+                                 SequenceNumber sequence) {
+  uint64_t fingerprint;
+  Bucket& bucket = GetBucket(user_key, &fingerprint);
+  const uint32_t epoch = static_cast<uint32_t>(GetEpoch());
+  std::lock_guard<SpinMutex> l(bucket.mutex);
+  if (bucket.epoch != epoch) {
+    return false;
+  }
+  // Loaded under the lock, so that it covers the range deletions before the
+  // insertion of the entry
+  const SequenceNumber min_sequence =
+      last_range_del_seq_.load(std::memory_order_acquire);
+  for (const Slot& slot : bucket.slots) {
+    if (slot.fingerprint == fingerprint) {
+      return std::max(bucket.last_write_seq, min_sequence) <=
+             std::min(slot.sequence, sequence);
+    }
+  }
+  return false;
+}
+
+void NegativeLookupCache::Insert(const Slice& user_key,
+                                 SequenceNumber sequence, uint64_t epoch) {
+  uint64_t fingerprint;
+  Bucket& bucket = GetBucket(user_key, &fingerprint);
+  std::lock_guard<SpinMutex> l(bucket.mutex);
+  if (epoch != GetEpoch()) {
+    // Invalidated since the lookup started
+    return;
+  }
+  if (bucket.epoch != static_cast<uint32_t>(epoch)) {
+    bucket.epoch = static_cast<uint32_t>(epoch);
+    for (Slot& slot : bucket.slots) {
+      slot = Slot();
+    }
+  }
+  if (bucket.last_write_seq > sequence ||
+      last_range_del_seq_.load(std::memory_order_acquire) > sequence) {
+    // Would never be used
+    return;
+  }
+  // Replace the same key, an empty slot, or the one looked up the longest
+  // ago, in that order
+  Slot* victim = &bucket.slots[0];
+  for (Slot& slot : bucket.slots) {
+    if (slot.fingerprint == fingerprint) {
+      slot.sequence = std::max(slot.sequence, sequence);
+      return;
+    }
+    if (victim->fingerprint != 0 &&
+        (slot.fingerprint == 0 || slot.sequence < victim->sequence)) {
+      victim = &slot;
+    }
+  }
+  victim->fingerprint = fingerprint;
+  victim->sequence = sequence;
+}
+
+void NegativeLookupCache::OnWrite(const Slice& user_key, SequenceNumber seq) {
+  uint64_t fingerprint;
+  Bucket& bucket = GetBucket(user_key, &fingerprint);
+  std::lock_guard<SpinMutex> l(bucket.mutex);
+  bucket.last_write_seq = std::max(bucket.last_write_seq, seq);
+  for (Slot& slot : bucket.slots) {
+    if (slot.fingerprint == fingerprint) {
+      slot = Slot();
+    }
+  }
+}
+
+void NegativeLookupCache::OnRangeDeletion(SequenceNumber seq) {
+  SequenceNumber last = last_range_del_seq_.load(std::memory_order_relaxed);
+  while (last < seq && !last_range_del_seq_.compare_exchange_weak(
+                           last, seq, std::memory_order_acq_rel)) {
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,87 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "db/dbformat.h"
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Remembers recent point lookups of a column family that found no entry for
+// their key, so that repeated lookups of missing keys can return NotFound
+// without searching the memtables and every level of the LSM tree. See
+// AdvancedColumnFamilyOptions::negative_lookup_cache_size.
+//
+// The memory is a fixed array of cache line sized buckets, each holding the
+// fingerprints of a few missing keys along with the sequence number they
+// were looked up at. Each bucket also records the largest sequence number of
+// the writes to keys hashing to it. Writes are recorded when inserted into
+// the memtable, which happens before their sequence number is published, so
+// an entry can serve a lookup at sequence number R iff no write to the bucket
+// has a sequence number larger than min(R, entry sequence number).
+//
+// Changes not going through the memtable (file ingestion, ...) call
+// Invalidate(), which drops all the entries.
+class NegativeLookupCache {
+ public:
+  // Uses about `capacity` bytes
+  explicit NegativeLookupCache(size_t capacity);
+
+  // Whether `user_key` (without timestamp) is known not to exist at
+  // `sequence`
+  bool Lookup(const Slice& user_key, SequenceNumber sequence);
+
+  // Records that `user_key` was not found at `sequence`. `epoch` is the
+  // result of GetEpoch() from before the lookup started, so that lookups
+  // racing with Invalidate() don't insert stale entries.
+  void Insert(const Slice& user_key, SequenceNumber sequence, uint64_t epoch);
+
+  // Called for each entry inserted into a memtable of the column family.
+  // Deletions count too, as lookups at older snapshots can find the deleted
+  // entries.
+  void OnWrite(const Slice& user_key, SequenceNumber seq);
+
+  // Range deletions can hide entries of any bucket
+  void OnRangeDeletion(SequenceNumber seq);
+
+  void Invalidate() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+  uint64_t GetEpoch() const { return epoch_.load(std::memory_order_acquire); }
+
+  size_t GetNumBuckets() const { return num_buckets_; }
+
+ private:
+  static constexpr size_t kSlotsPerBucket = 3;
+
+  struct Slot {
+    // 0 for an empty slot
+    uint64_t fingerprint = 0;
+    SequenceNumber sequence = 0;
+  };
+
+  struct ALIGN_AS(CACHE_LINE_SIZE) Bucket {
+    SpinMutex mutex;
+    // Epoch of the slots; they are stale when it differs from epoch_
+    uint32_t epoch = 0;
+    SequenceNumber last_write_seq = 0;
+    Slot slots[kSlotsPerBucket];
+  };
+
+  Bucket& GetBucket(const Slice& user_key, uint64_t* fingerprint) const;
+
+  const size_t num_buckets_;
+  std::unique_ptr<Bucket[]> buckets_;
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<SequenceNumber> last_range_del_seq_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,422 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/scan_cache.h"
+
+#include <algorithm>
+
+#include "db/arena_wrapped_db_iter.h"
+#include "db/column_family.h"
+#include "db/db_impl/db_impl.h"
+#include "monitoring/statistics_impl.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+ScanCacheVersions::ScanCacheVersions(
+    Cache* scan_cache, std::shared_ptr<const SliceTransform> prefix_extractor)
+    : prefix_extractor_(std::move(prefix_extractor)) {
+  PutVarint64(&cache_key_prefix_, scan_cache->NewId());
+  if (prefix_extractor_ != nullptr) {
+    stripes_.reset(new std::atomic<SequenceNumber>[kNumStripes]);
+    for (size_t i = 0; i < kNumStripes; i++) {
+      stripes_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ScanCacheVersions::UpdateMax(std::atomic<SequenceNumber>* last,
+                                  SequenceNumber seq) {
+  SequenceNumber cur = last->load(std::memory_order_relaxed);
+  while (cur < seq && !last->compare_exchange_weak(
+                          cur, seq, std::memory_order_relaxed)) {
+  }
+}
+
+size_t ScanCacheVersions::GetStripe(const Slice& user_key) const {
+  return static_cast<size_t>(
+      GetSliceNPHash64(prefix_extractor_->Transform(user_key)) % kNumStripes);
+}
+
+void ScanCacheVersions::OnWrite(const Slice& user_key, ValueType type,
+                                SequenceNumber seq) {
+  // These are ordered before the sequence number is published (with release
+  // semantics), and so before the reads of a reader at that sequence number.
+  UpdateMax(&last_write_seq_, seq);
+  if (prefix_extractor_ == nullptr) {
+    return;
+  }
+  if (type == kTypeRangeDeletion || !prefix_extractor_->InDomain(user_key)) {
+    // Might be part of any prefix scan
+    UpdateMax(&last_range_del_seq_, seq);
+  } else {
+    UpdateMax(&stripes_[GetStripe(user_key)], seq);
+  }
+}
+
+SequenceNumber ScanCacheVersions::GetLastWriteSequence(
+    const SliceTransform* prefix_extractor, const Slice& target) const {
+  if (prefix_extractor != nullptr &&
+      prefix_extractor == prefix_extractor_.get() &&
+      prefix_extractor->InDomain(target)) {
+    return std::max(
+        last_range_del_seq_.load(std::memory_order_relaxed),
+        stripes_[GetStripe(target)].load(std::memory_order_relaxed));
+  }
+  return last_write_seq_.load(std::memory_order_relaxed);
+}
+
+ScanCacheIterator::ScanCacheIterator(DBImpl* db,
+                                     const ReadOptions& read_options,
+                                     ColumnFamilyHandleImpl* cfh,
+                                     SuperVersion* sv, SequenceNumber sequence)
+    : db_(db),
+      read_options_(read_options),
+      cfh_(cfh),
+      versions_(cfh->cfd()->scan_cache_versions()),
+      cache_(cfh->cfd()->ioptions().scan_cache.get()),
+      sv_(sv),
+      sv_number_(sv->version_number),
+      prefix_extractor_(sv->mutable_cf_options.prefix_extractor.get()),
+      sequence_(sequence) {
+  assert(versions_ != nullptr);
+}
+
+ScanCacheIterator::~ScanCacheIterator() {
+  ReleaseCachedEntry();
+  db_iter_.reset();
+  if (sv_ != nullptr) {
+    db_->CleanupSuperVersion(sv_);
+  }
+}
+
+bool ScanCacheIterator::IsSupported(const ReadOptions& read_options,
+                                    const ColumnFamilyData* cfd,
+                                    const SuperVersion* sv) {
+  const ScanCacheVersions* versions = cfd->scan_cache_versions();
+  // The options changing which entries are returned either are part of the
+  // cache key or make the scans uncacheable
+  return versions != nullptr && read_options.scan_cache_max_entries > 0 &&
+         !read_options.tailing && read_options.timestamp == nullptr &&
+         read_options.iter_start_ts == nullptr &&
+         read_options.read_tier == kReadAllTier &&
+         !read_options.ignore_range_deletions && !read_options.table_filter &&
+         read_options.weight == 0 && !read_options.property_bag.has_value() &&
+         sv->mutable_cf_options.prefix_extractor.get() ==
+             versions->GetPrefixExtractor();
+}
+
+Iterator* ScanCacheIterator::GetDBIter() {
+  if (db_iter_ == nullptr) {
+    db_iter_.reset(db_->NewIteratorImpl(read_options_, cfh_, sv_, sequence_,
+                                        nullptr /* read_callback */));
+    // Now owned by db_iter_
+    sv_ = nullptr;
+  }
+  return db_iter_.get();
+}
+
+void ScanCacheIterator::ReleaseCachedEntry() {
+  entries_.clear();
+  pos_ = 0;
+  if (handle_ != nullptr) {
+    cache_.Release(handle_);
+    handle_ = nullptr;
+  }
+  owned_entry_.reset();
+}
+
+void ScanCacheIterator::BuildCacheKey(const Slice& target,
+                                      std::string* cache_key) const {
+  *cache_key = versions_->GetCacheKeyPrefix();
+  PutVarint64(cache_key, versions_->GetEpoch());
+  PutVarint64(cache_key, read_options_.scan_cache_max_entries);
+  uint32_t flags = (read_options_.total_order_seek ? 1 : 0) |
+                   (read_options_.auto_prefix_mode ? 2 : 0) |
+                   (read_options_.prefix_same_as_start ? 4 : 0) |
+                   (read_options_.iterate_lower_bound != nullptr ? 8 : 0) |
+                   (read_options_.iterate_upper_bound != nullptr ? 16 : 0);
+  PutVarint32(cache_key, flags);
+  if (read_options_.iterate_lower_bound != nullptr) {
+    PutLengthPrefixedSlice(cache_key, *read_options_.iterate_lower_bound);
+  }
+  if (read_options_.iterate_upper_bound != nullptr) {
+    PutLengthPrefixedSlice(cache_key, *read_options_.iterate_upper_bound);
+  }
+  cache_key->append(target.data(), target.size());
+}
+
+const SliceTransform* ScanCacheIterator::GetScanPrefixExtractor() const {
+  if (read_options_.prefix_same_as_start && !read_options_.total_order_seek) {
+    return prefix_extractor_;
+  }
+  return nullptr;
+}
+
+bool ScanCacheIterator::ParseEntry(const std::string& entry) {
+  Slice input(entry);
+  if (input.size() < 9) {
+    return false;
+  }
+  complete_ = input[8] != 0;
+  input.remove_prefix(9);
+  while (!input.empty()) {
+    Slice key;
+    Slice value;
+    if (!GetLengthPrefixedSlice(&input, &key) ||
+        !GetLengthPrefixedSlice(&input, &value)) {
+      entries_.clear();
+      return false;
+    }
+    entries_.emplace_back(key, value);
+  }
+  return true;
+}
+
+bool ScanCacheIterator::LookupCachedEntry(const Slice& target,
+                                          const Slice& cache_key) {
+  auto handle = cache_.Lookup(cache_key);
+  if (handle == nullptr) {
+    return false;
+  }
+  const std::string& entry = *cache_.Value(handle);
+  assert(entry.size() >= 9);
+  // The entry has the same results as a scan at our sequence number if no
+  // write in the range came after both
+  const SequenceNumber last_write =
+      versions_->GetLastWriteSequence(GetScanPrefixExtractor(), target);
+  if (last_write > std::min(DecodeFixed64(entry.data()), sequence_)) {
+    cache_.Release(handle);
+    return false;
+  }
+  handle_ = handle;
+  if (!ParseEntry(entry)) {
+    assert(false);
+    ReleaseCachedEntry();
+    return false;
+  }
+  return true;
+}
+
+void ScanCacheIterator::ReadAndInsertEntry(const Slice& target,
+                                           const Slice& cache_key) {
+  Iterator* iter = GetDBIter();
+  iter->Seek(target);
+
+  std::unique_ptr<std::string> entry(new std::string());
+  PutFixed64(entry.get(), sequence_);
+  entry->push_back(0);
+  size_t num_entries = 0;
+  for (; num_entries < read_options_.scan_cache_max_entries && iter->Valid();
+       num_entries++) {
+    if (!iter->PrepareValue()) {
+      break;
+    }
+    const WideColumns& columns = iter->columns();
+    if (columns.size() != 1 || columns[0].name() != kDefaultWideColumnName) {
+      // Only plain values are cached. Go back to the start of the scan.
+      iter->Seek(target);
+      return;
+    }
+    PutLengthPrefixedSlice(entry.get(), iter->key());
+    PutLengthPrefixedSlice(entry.get(), iter->value());
+    iter->Next();
+  }
+  if (!iter->status().ok()) {
+    // Let the DB iterator return the error when the reader gets there
+    iter->Seek(target);
+    return;
+  }
+  (*entry)[8] = iter->Valid() ? 0 : 1;
+
+  // Serve the rest of the scan from the entries we just read, with the DB
+  // iterator positioned after them
+  size_t charge = entry->capacity() + sizeof(std::string);
+  ScanCacheInterface::TypedHandle* handle = nullptr;
+  Status s = cache_.Insert(cache_key, entry.get(), charge, &handle);
+  if (s.ok()) {
+    entry.release();
+    handle_ = handle;
+    ParseEntry(*cache_.Value(handle));
+  } else {
+    owned_entry_ = std::move(entry);
+    ParseEntry(*owned_entry_);
+  }
+  use_cached_ = true;
+  db_iter_after_entries_ = true;
+}
+
+void ScanCacheIterator::SwitchToDBIter() {
+  assert(use_cached_);
+  Iterator* iter = GetDBIter();
+  if (pos_ < entries_.size()) {
+    iter->Seek(entries_[pos_].first);
+  } else if (!db_iter_after_entries_) {
+    assert(!entries_.empty());
+    const Slice& last = entries_.back().first;
+    iter->Seek(last);
+    if (iter->Valid() &&
+        cfh_->cfd()->user_comparator()->Equal(iter->key(), last)) {
+      iter->Next();
+    }
+  }
+  use_cached_ = false;
+  db_iter_after_entries_ = false;
+  ReleaseCachedEntry();
+}
+
+bool ScanCacheIterator::Valid() const {
+  if (use_cached_) {
+    return pos_ < entries_.size();
+  }
+  return db_iter_ != nullptr && db_iter_->Valid();
+}
+
+void ScanCacheIterator::SeekToFirst() {
+  ReleaseCachedEntry();
+  use_cached_ = false;
+  GetDBIter()->SeekToFirst();
+}
+
+void ScanCacheIterator::SeekToLast() {
+  ReleaseCachedEntry();
+  use_cached_ = false;
+  GetDBIter()->SeekToLast();
+}
+
+void ScanCacheIterator::Seek(const Slice& target) {
+  ReleaseCachedEntry();
+  use_cached_ = false;
+  db_iter_after_entries_ = false;
+  if (read_options_.scan_cache_max_entries == 0) {
+    GetDBIter()->Seek(target);
+    return;
+  }
+
+  std::string cache_key;
+  BuildCacheKey(target, &cache_key);
+  Statistics* stats = cfh_->cfd()->ioptions().stats;
+  if (LookupCachedEntry(target, cache_key)) {
+    RecordTick(stats, SCAN_CACHE_HIT);
+    use_cached_ = true;
+    return;
+  }
+  RecordTick(stats, SCAN_CACHE_MISS);
+  ReadAndInsertEntry(target, cache_key);
+}
+
+void ScanCacheIterator::SeekForPrev(const Slice& target) {
+  ReleaseCachedEntry();
+  use_cached_ = false;
+  GetDBIter()->SeekForPrev(target);
+}
+
+void ScanCacheIterator::Next() {
+  assert(Valid());
+  if (!use_cached_) {
+    db_iter_->Next();
+    return;
+  }
+  pos_++;
+  if (pos_ == entries_.size() && !complete_) {
+    SwitchToDBIter();
+  }
+}
+
+void ScanCacheIterator::Prev() {
+  assert(Valid());
+  if (use_cached_) {
+    SwitchToDBIter();
+  }
+  db_iter_->Prev();
+}
+
+bool ScanCacheIterator::PrepareValue() {
+  assert(Valid());
+  if (use_cached_) {
+    return true;
+  }
+  return db_iter_->PrepareValue();
+}
+
+Slice ScanCacheIterator::key() const {
+  assert(Valid());
+  if (use_cached_) {
+    return entries_[pos_].first;
+  }
+  return db_iter_->key();
+}
+
+Slice ScanCacheIterator::value() const {
+  assert(Valid());
+  if (use_cached_) {
+    return entries_[pos_].second;
+  }
+  return db_iter_->value();
+}
+
+const WideColumns& ScanCacheIterator::columns() const {
+  assert(Valid());
+  if (use_cached_) {
+    columns_ = WideColumns{{kDefaultWideColumnName, entries_[pos_].second}};
+    return columns_;
+  }
+  return db_iter_->columns();
+}
+
+Status ScanCacheIterator::status() const {
+  if (use_cached_ || db_iter_ == nullptr) {
+    return Status::OK();
+  }
+  return db_iter_->status();
+}
+
+Status ScanCacheIterator::GetProperty(std::string prop_name,
+                                      std::string* prop) {
+  if (!use_cached_ && db_iter_ != nullptr) {
+    return db_iter_->GetProperty(std::move(prop_name), prop);
+  }
+  if (prop == nullptr) {
+    return Status::InvalidArgument("prop is nullptr");
+  }
+  if (prop_name == "rocksdb.iterator.super-version-number") {
+    *prop = std::to_string(sv_number_);
+    return Status::OK();
+  } else if (prop_name == "rocksdb.iterator.is-key-pinned" ||
+             prop_name == "rocksdb.iterator.is-value-pinned") {
+    // Only until the next Seek()
+    *prop = "0";
+    return Status::OK();
+  } else if (prop_name == "rocksdb.iterator.internal-key" && Valid()) {
+    *prop = key().ToString();
+    return Status::OK();
+  }
+  return Iterator::GetProperty(std::move(prop_name), prop);
+}
+
+Status ScanCacheIterator::Refresh(const Snapshot* snapshot) {
+  ReleaseCachedEntry();
+  use_cached_ = false;
+  db_iter_after_entries_ = false;
+  db_iter_.reset();
+  if (sv_ != nullptr) {
+    db_->CleanupSuperVersion(sv_);
+  }
+  ColumnFamilyData* cfd = cfh_->cfd();
+  read_options_.snapshot = snapshot;
+  sv_ = cfd->GetReferencedSuperVersion(db_);
+  sv_number_ = sv_->version_number;
+  prefix_extractor_ = sv_->mutable_cf_options.prefix_extractor.get();
+  sequence_ = snapshot != nullptr ? snapshot->GetSequenceNumber()
+                                  : db_->GetLastPublishedSequence();
+  if (prefix_extractor_ != versions_->GetPrefixExtractor()) {
+    // The options changed since the iterator was created
+    read_options_.scan_cache_max_entries = 0;
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,168 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cache/typed_cache.h"
+#include "db/dbformat.h"
+#include "rocksdb/iterator.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice_transform.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class ColumnFamilyData;
+class ColumnFamilyHandleImpl;
+class DBImpl;
+struct SuperVersion;
+
+// Tracks the writes to a column family that can change the results of the
+// scans in DBOptions::scan_cache.
+//
+// A cached scan records the sequence number it was read at. It can serve a
+// reader at another sequence number as long as no write with a larger
+// sequence number than either of them can affect the scanned range. Writes
+// are hashed into stripes by prefix, so that scans confined to a prefix
+// (ReadOptions::prefix_same_as_start) are only invalidated by writes to keys
+// of the same stripe, while other scans are invalidated by any write.
+//
+// Writes are recorded when inserted into the memtable, which happens before
+// their sequence number is published. Changes not going through the memtable
+// (file ingestion, compaction filters, ...) call Invalidate(), which changes
+// the epoch that is part of the cache keys.
+class ScanCacheVersions {
+ public:
+  ScanCacheVersions(Cache* scan_cache,
+                    std::shared_ptr<const SliceTransform> prefix_extractor);
+
+  // Called for each entry inserted into a memtable of the column family.
+  // `user_key` is without timestamp.
+  void OnWrite(const Slice& user_key, ValueType type, SequenceNumber seq);
+
+  // Makes all the cached scans of the column family unreachable
+  void Invalidate() { epoch_.fetch_add(1, std::memory_order_relaxed); }
+
+  uint64_t GetEpoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+  // The largest sequence number of a write that might have changed a scan
+  // starting at `target`. If `prefix_extractor` is non-null, the scan is
+  // confined to the prefix of `target` under that extractor.
+  SequenceNumber GetLastWriteSequence(const SliceTransform* prefix_extractor,
+                                      const Slice& target) const;
+
+  // Unique to the column family (and DB) among the users of the cache
+  const std::string& GetCacheKeyPrefix() const { return cache_key_prefix_; }
+
+  const SliceTransform* GetPrefixExtractor() const {
+    return prefix_extractor_.get();
+  }
+
+ private:
+  static constexpr size_t kNumStripes = 1024;
+
+  static void UpdateMax(std::atomic<SequenceNumber>* last, SequenceNumber seq);
+  size_t GetStripe(const Slice& user_key) const;
+
+  std::string cache_key_prefix_;
+  // The prefix extractor of the column family when it was opened. Scans with
+  // a different one (after SetOptions()) can't use the stripes.
+  const std::shared_ptr<const SliceTransform> prefix_extractor_;
+  std::atomic<uint64_t> epoch_{0};
+  // Any write, and range deletions, which can affect any scan
+  std::atomic<SequenceNumber> last_write_seq_{0};
+  std::atomic<SequenceNumber> last_range_del_seq_{0};
+  std::unique_ptr<std::atomic<SequenceNumber>[]> stripes_;
+};
+
+// An Iterator serving Seek() and the following Next() calls from the results
+// of an earlier identical scan, stored in DBOptions::scan_cache. On a miss,
+// the first ReadOptions::scan_cache_max_entries entries are read from a
+// regular DB iterator and inserted into the cache. The DB iterator is only
+// created when needed: on a miss, when moving past the cached entries, and
+// for any other positioning operation.
+class ScanCacheIterator : public Iterator {
+ public:
+  // Takes ownership of the reference to `sv`. `sequence` is the sequence
+  // number to read at, either of the snapshot or the last published one.
+  ScanCacheIterator(DBImpl* db, const ReadOptions& read_options,
+                    ColumnFamilyHandleImpl* cfh, SuperVersion* sv,
+                    SequenceNumber sequence);
+  ~ScanCacheIterator() override;
+
+  // Whether a DB iterator with these options can be served from the cache
+  static bool IsSupported(const ReadOptions& read_options,
+                          const ColumnFamilyData* cfd, const SuperVersion* sv);
+
+  bool Valid() const override;
+  void SeekToFirst() override;
+  void SeekToLast() override;
+  void Seek(const Slice& target) override;
+  void SeekForPrev(const Slice& target) override;
+  void Next() override;
+  void Prev() override;
+  bool PrepareValue() override;
+  Slice key() const override;
+  Slice value() const override;
+  const WideColumns& columns() const override;
+  Status status() const override;
+  Status GetProperty(std::string prop_name, std::string* prop) override;
+  Status Refresh() override { return Refresh(nullptr); }
+  Status Refresh(const Snapshot* snapshot) override;
+
+ private:
+  using ScanCacheInterface =
+      BasicTypedCacheInterface<std::string, CacheEntryRole::kMisc>;
+
+  // Continues with the DB iterator, creating it if needed, from the current
+  // cached entry (or after the last one)
+  void SwitchToDBIter();
+  Iterator* GetDBIter();
+  void ReleaseCachedEntry();
+  // Returns false on a miss or if the cached scan is outdated
+  bool LookupCachedEntry(const Slice& target, const Slice& cache_key);
+  // Reads the first entries of the scan, to insert them into the cache and
+  // serve them from there
+  void ReadAndInsertEntry(const Slice& target, const Slice& cache_key);
+  bool ParseEntry(const std::string& entry);
+  // Cached scans are only valid for the same options and start key
+  void BuildCacheKey(const Slice& target, std::string* cache_key) const;
+  // The prefix extractor if scans are confined to the prefix of the target
+  const SliceTransform* GetScanPrefixExtractor() const;
+
+  DBImpl* const db_;
+  ReadOptions read_options_;
+  ColumnFamilyHandleImpl* const cfh_;
+  ScanCacheVersions* const versions_;
+  ScanCacheInterface cache_;
+  // Owned until the DB iterator is created
+  SuperVersion* sv_;
+  uint64_t sv_number_;
+  const SliceTransform* prefix_extractor_;
+  SequenceNumber sequence_;
+  std::unique_ptr<Iterator> db_iter_;
+  // Whether positioned on the cached entries, or using db_iter_
+  bool use_cached_ = false;
+  // Whether db_iter_ is positioned right after the cached entries
+  bool db_iter_after_entries_ = false;
+
+  // Cached entry format: fixed64 sequence number, one byte for whether the
+  // scan is complete, and the length prefixed keys and values
+  ScanCacheInterface::TypedHandle* handle_ = nullptr;
+  // When the cache rejected the entry
+  std::unique_ptr<std::string> owned_entry_;
+  std::vector<std::pair<Slice, Slice>> entries_;
+  // Whether the entries are all of the scan, or just the first ones
+  bool complete_ = false;
+  size_t pos_ = 0;
+  mutable WideColumns columns_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -206,6 +206,12 @@ class TableCache {
                                const MutableCFOptions& mutable_cf_options,
                                std::vector<TableReader::Anchor>& anchors);
 
+  // See TableReader::GetCachedKeyRanges()
+  Status GetCachedKeyRanges(
+      const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+      const FileMetaData& file_meta, const MutableCFOptions& mutable_cf_options,
+      std::vector<std::pair<std::string, std::string>>* ranges);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
@@ -26,6 +26,7 @@
 #include "db/blob/blob_log_format.h"
 #include "db/blob/blob_source.h"
 #include "db/compaction/compaction.h"
+#include "db/compaction/compaction_picker_lazy_level.h"
 #include "db/compaction/file_pri.h"
 #include "db/dbformat.h"
 #include "db/internal_stats.h"
@@ -1098,6 +1099,9 @@ class LevelIterator final : public InternalIterator {
     read_seq_ = read_seq;
   }
 
+  bool GetRawDataBlock(RawDataBlock* block) override;
+  void SkipRawDataBlock() override;
+
  private:
   // Return true if at least one invalid file is seen and skipped.
   bool SkipEmptyFileForward();
@@ -1446,6 +1450,27 @@ bool LevelIterator::NextAndGetResult(IterateResult* result) {
   return is_valid;
 }
 
+bool LevelIterator::GetRawDataBlock(RawDataBlock* block) {
+  assert(Valid());
+  if (to_return_sentinel_ || !file_iter_.GetRawDataBlock(block)) {
+    return false;
+  }
+  // The next file can start with the last user key of this one
+  return file_index_ + 1 >= flevel_->num_files ||
+         user_comparator_.Compare(
+             ExtractUserKey(file_smallest_key(file_index_ + 1)),
+             ExtractUserKey(block->last_key)) > 0;
+}
+
+void LevelIterator::SkipRawDataBlock() {
+  assert(Valid());
+  file_iter_.SkipRawDataBlock();
+  if (range_tombstone_iter_) {
+    TrySetDeleteRangeSentinel(file_largest_key(file_index_));
+  }
+  SkipEmptyFileForward();
+}
+
 void LevelIterator::Prev() {
   assert(Valid());
   if (to_return_sentinel_) {
@@ -3474,7 +3499,11 @@ void VersionStorageInfo::ComputeCompactionScore(
         }
       }
 
-      if (compaction_style_ == kCompactionStyleFIFO) {
+      if (compaction_style_ == kCompactionStyleLazyLevel) {
+        // The whole DB is scored on level 0, as with universal compaction
+        score = LazyLevelCompactionPicker::ComputeScore(
+            *this, mutable_cf_options, max_output_level);
+      } else if (compaction_style_ == kCompactionStyleFIFO) {
         score = static_cast<double>(total_size) /
                 mutable_cf_options.compaction_options_fifo.max_table_files_size;
         if (score < 1 &&
@@ -3936,15 +3965,33 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
+// Sort `temp` based on ratio of overlapping size over file size. With
+// `use_read_heat`, the ratio is divided by (1 + the read heat of the file),
+// see kReadHeatAndOverlappingRatio.
 void SortFileByOverlappingRatio(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
-    int level, int num_non_empty_levels, uint64_t ttl,
+    int level, int num_non_empty_levels, uint64_t ttl, bool use_read_heat,
     std::vector<Fsize>* temp) {
   std::unordered_map<uint64_t, uint64_t> file_to_order;
   auto next_level_it = next_level_files.begin();
 
+  // The read heat of a file is its density of sampled reads relative to the
+  // one of the level
+  double level_read_density = 0;
+  if (use_read_heat) {
+    uint64_t level_reads = 0;
+    uint64_t level_size = 0;
+    for (auto& file : files) {
+      level_reads +=
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      level_size += file->compensated_file_size;
+    }
+    if (level_size > 0) {
+      level_read_density = static_cast<double>(level_reads) / level_size;
+    }
+  }
+
   int64_t curr_time;
   Status status = clock->GetCurrentTime(&curr_time);
   if (!status.ok()) {
@@ -3977,9 +4024,17 @@ void SortFileByOverlappingRatio(
     uint64_t ttl_boost_score = (ttl > 0) ? ttl_booster.GetBoostScore(file) : 1;
     assert(ttl_boost_score > 0);
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] = overlapping_bytes * 1024U /
-                                          file->compensated_file_size /
-                                          ttl_boost_score;
+    uint64_t order = overlapping_bytes * 1024U / file->compensated_file_size /
+                     ttl_boost_score;
+    if (level_read_density > 0) {
+      const double read_heat =
+          static_cast<double>(
+              file->stats.num_reads_sampled.load(std::memory_order_relaxed)) /
+          file->compensated_file_size / level_read_density;
+      order = static_cast<uint64_t>(static_cast<double>(order) /
+                                    (1.0 + read_heat));
+    }
+    file_to_order[file->fd.GetNumber()] = order;
   }
 
   size_t num_to_sort = temp->size() > VersionStorageInfo::kNumberFilesToSort
@@ -4067,7 +4122,8 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
     const ImmutableOptions& ioptions, const MutableCFOptions& options) {
   if (compaction_style_ == kCompactionStyleNone ||
       compaction_style_ == kCompactionStyleFIFO ||
-      compaction_style_ == kCompactionStyleUniversal) {
+      compaction_style_ == kCompactionStyleUniversal ||
+      compaction_style_ == kCompactionStyleLazyLevel) {
     // don't need this
     return;
   }
@@ -4109,9 +4165,11 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
                   });
         break;
       case kMinOverlappingRatio:
-        SortFileByOverlappingRatio(*internal_comparator_, files_[level],
-                                   files_[level + 1], ioptions.clock, level,
-                                   num_non_empty_levels_, options.ttl, &temp);
+      case kReadHeatAndOverlappingRatio:
+        SortFileByOverlappingRatio(
+            *internal_comparator_, files_[level], files_[level + 1],
+            ioptions.clock, level, num_non_empty_levels_, options.ttl,
+            ioptions.compaction_pri == kReadHeatAndOverlappingRatio, &temp);
         break;
       case kRoundRobin:
         SortFileByRoundRobin(*internal_comparator_, &compact_cursor_,
@@ -1381,6 +1381,16 @@ class VersionSet {
     last_sequence_.store(s, std::memory_order_release);
   }
 
+  // Sets the last sequence number to `s` unless it is already further, for
+  // writers publishing their sequence numbers concurrently.
+  void AdvanceLastSequence(uint64_t s) {
+    uint64_t last = last_sequence_.load(std::memory_order_relaxed);
+    while (last < s && !last_sequence_.compare_exchange_weak(
+                           last, s, std::memory_order_release,
+                           std::memory_order_relaxed)) {
+    }
+  }
+
   // Note: memory_order_release must be sufficient
   void SetLastPublishedSequence(uint64_t s) {
     assert(s >= last_published_sequence_);
@@ -2025,6 +2025,13 @@ class MemTableInserter : public WriteBatch::Handler {
   using HintMapType = aligned_storage<HintMap>::type;
   HintMapType hint_;
 
+  // Point keys of the current batch inserted so far into `sorted_run_mem_`
+  // have been in ascending order, the last one being `sorted_run_last_key_`.
+  // Only tracked for non-concurrent memtable writes.
+  MemTable* sorted_run_mem_;
+  Slice sorted_run_last_key_;
+  bool sorted_run_broken_;
+
   HintMap& GetHintMap() {
     assert(hint_per_batch_);
     if (!hint_created_) {
@@ -2034,6 +2041,30 @@ class MemTableInserter : public WriteBatch::Handler {
     return *reinterpret_cast<HintMap*>(&hint_);
   }
 
+  // Returns true if `key` continues the ascending run of point keys that the
+  // current batch has inserted into `mem`, in which case the memtable can
+  // insert it starting from the previous insert position. Once the batch
+  // breaks the order we stop comparing, so unsorted batches pay at most one
+  // extra key comparison.
+  bool InSortedRun(MemTable* mem, ValueType type, const Slice& key) {
+    if (concurrent_memtable_writes_ || sorted_run_broken_ ||
+        type == kTypeRangeDeletion) {
+      return false;
+    }
+    bool in_run = false;
+    if (mem == sorted_run_mem_) {
+      in_run = mem->GetInternalKeyComparator().user_comparator()->Compare(
+                   key, sorted_run_last_key_) > 0;
+      if (!in_run) {
+        sorted_run_broken_ = true;
+        return false;
+      }
+    }
+    sorted_run_mem_ = mem;
+    sorted_run_last_key_ = key;
+    return in_run;
+  }
+
   MemPostInfoMap& GetPostMap() {
     assert(concurrent_memtable_writes_);
     if (!post_info_created_) {
@@ -2123,7 +2154,9 @@ class MemTableInserter : public WriteBatch::Handler {
         duplicate_detector_(),
         dup_dectector_on_(false),
         hint_per_batch_(hint_per_batch),
-        hint_created_(false) {
+        hint_created_(false),
+        sorted_run_mem_(nullptr),
+        sorted_run_broken_(false) {
     assert(cf_mems_);
   }
 
@@ -2164,6 +2197,11 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
+  // Starts sorted run detection over for the next batch of a write group.
+  void ResetSortedRun() {
+    sorted_run_mem_ = nullptr;
+    sorted_run_broken_ = false;
+  }
   void set_prot_info(const WriteBatch::ProtectionInfo* prot_info) {
     prot_info_ = prot_info;
     prot_info_idx_ = 0;
@@ -2268,7 +2306,8 @@ class MemTableInserter : public WriteBatch::Handler {
       ret_status =
           mem->Add(sequence_, value_type, key, value, kv_prot_info,
                    concurrent_memtable_writes_, get_post_process_info(mem),
-                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr,
+                   InSortedRun(mem, value_type, key));
     } else if (moptions->inplace_callback == nullptr ||
                value_type != kTypeValue) {
       assert(!concurrent_memtable_writes_);
@@ -2488,7 +2527,8 @@ class MemTableInserter : public WriteBatch::Handler {
     ret_status =
         mem->Add(sequence_, delete_type, key, value, kv_prot_info,
                  concurrent_memtable_writes_, get_post_process_info(mem),
-                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr,
+                 InSortedRun(mem, delete_type, key));
     if (UNLIKELY(ret_status.IsTryAgain())) {
       assert(seq_per_batch_);
       const bool kBatchBoundary = true;
@@ -3233,6 +3273,7 @@ Status WriteBatchInternal::InsertInto(
     SetSequence(w->batch, inserter.sequence());
     inserter.set_log_number_ref(w->log_ref);
     inserter.set_prot_info(w->batch->prot_info_.get());
+    inserter.ResetSortedRun();
     w->status = w->batch->Iterate(&inserter);
     if (!w->status.ok()) {
       return w->status;
@@ -3404,6 +3445,21 @@ Status WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   return Status::OK();
 }
 
+Slice WriteBatchInternal::WalRecords(const WriteBatch* batch,
+                                     uint32_t* count) {
+  assert(batch->rep_.size() >= WriteBatchInternal::kHeader);
+  const SavePoint& batch_end = batch->GetWalTerminationPoint();
+  size_t size;
+  if (!batch_end.is_cleared()) {
+    size = batch_end.size - WriteBatchInternal::kHeader;
+    *count = batch_end.count;
+  } else {
+    size = batch->rep_.size() - WriteBatchInternal::kHeader;
+    *count = Count(batch);
+  }
+  return Slice(batch->rep_.data() + WriteBatchInternal::kHeader, size);
+}
+
 Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
                                   const bool wal_only) {
   assert(dst->Count() == 0 ||
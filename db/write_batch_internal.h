@@ -224,6 +224,11 @@ class WriteBatchInternal {
   static Status Append(WriteBatch* dst, const WriteBatch* src,
                        const bool WAL_only = false);
 
+  // Returns the records that Append() with WAL_only copies from batch, i.e.
+  // the records up to its WAL termination point if any, and sets *count to
+  // their number.
+  static Slice WalRecords(const WriteBatch* batch, uint32_t* count);
+
   // Returns the byte size of appending a WriteBatch with ByteSize
   // leftByteSize and a WriteBatch with ByteSize rightByteSize
   static size_t AppendedByteSize(size_t leftByteSize, size_t rightByteSize);
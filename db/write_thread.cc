@@ -12,6 +12,7 @@
 #include "monitoring/perf_context_imp.h"
 #include "port/port.h"
 #include "test_util/sync_point.h"
+#include "util/crc32c.h"
 #include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -407,6 +408,7 @@ void WriteThread::JoinBatchGroup(Writer* w) {
   w->CheckWriteEnqueuedCallback();
 
   if (linked_as_leader) {
+    WaitForBypassWriters();
     SetState(w, STATE_GROUP_LEADER);
   }
 
@@ -428,11 +430,18 @@ void WriteThread::JoinBatchGroup(Writer* w) {
      *      writes in parallel.
      */
     TEST_SYNC_POINT_CALLBACK("WriteThread::JoinBatchGroup:BeganWaiting", w);
-    AwaitState(w,
-               STATE_GROUP_LEADER | STATE_MEMTABLE_WRITER_LEADER |
-                   STATE_PARALLEL_MEMTABLE_CALLER |
-                   STATE_PARALLEL_MEMTABLE_WRITER | STATE_COMPLETED,
-               &jbg_ctx);
+    const uint8_t goal_mask =
+        STATE_GROUP_LEADER | STATE_MEMTABLE_WRITER_LEADER |
+        STATE_PARALLEL_MEMTABLE_CALLER | STATE_PARALLEL_MEMTABLE_WRITER |
+        STATE_COMPLETED;
+    uint8_t state =
+        AwaitState(w, goal_mask | STATE_PARALLEL_WAL_WRITER, &jbg_ctx);
+    if (state == STATE_PARALLEL_WAL_WRITER) {
+      // 4) An existing leader pick us as its follower and tell us to copy
+      // our batch to the WAL record in parallel, then 2) or 3).
+      CompleteParallelWalWriter(w);
+      AwaitState(w, goal_mask, &jbg_ctx);
+    }
     TEST_SYNC_POINT_CALLBACK("WriteThread::JoinBatchGroup:DoneWaiting", w);
   }
 }
@@ -714,6 +723,45 @@ void WriteThread::LaunchParallelMemTableWriters(WriteGroup* write_group) {
   SetMemWritersEachStride(w);
 }
 
+static WriteThread::AdaptationContext pcw_ctx("ParallelCopyWal");
+void WriteThread::ParallelCopyWal(WriteGroup* write_group) {
+  assert(write_group != nullptr);
+  Writer* leader = write_group->leader;
+  assert(leader->state == STATE_GROUP_LEADER);
+  size_t running = 1;
+  for (auto w : *write_group) {
+    if (w != leader && w->wal_copy != nullptr) {
+      ++running;
+    }
+  }
+  write_group->running.store(running);
+  SetState(leader, STATE_PARALLEL_WAL_WRITER);
+  for (auto w : *write_group) {
+    if (w != leader && w->wal_copy != nullptr) {
+      SetState(w, STATE_PARALLEL_WAL_WRITER);
+    }
+  }
+  CompleteParallelWalWriter(leader);
+  AwaitState(leader, STATE_GROUP_LEADER, &pcw_ctx);
+}
+
+void WriteThread::CompleteParallelWalWriter(Writer* w) {
+  WalCopy* copy = w->wal_copy;
+  TEST_SYNC_POINT_CALLBACK("WriteThread::CompleteParallelWalWriter", w);
+  if (copy != nullptr) {
+    copy->status = w->batch->VerifyChecksum();
+    if (copy->status.ok()) {
+      memcpy(copy->dest, copy->src.data(), copy->src.size());
+      copy->crc = crc32c::Value(copy->dest, copy->src.size());
+    }
+  }
+  WriteGroup* write_group = w->write_group;
+  if (write_group->running-- == 1) {
+    // The last copy is done.
+    SetState(write_group->leader, STATE_GROUP_LEADER);
+  }
+}
+
 static WriteThread::AdaptationContext cpmtw_ctx(
     "CompleteParallelMemTableWriter");
 // This method is called by both the leader and parallel followers
@@ -898,6 +946,8 @@ void WriteThread::EnterUnbatched(Writer* w, InstrumentedMutex* mu) {
     TEST_SYNC_POINT("WriteThread::EnterUnbatched:Wait");
     // Last leader will not pick us as a follower since our batch is nullptr
     AwaitState(w, STATE_GROUP_LEADER, &eu_ctx);
+  } else {
+    WaitForBypassWriters();
   }
   if (enable_pipelined_write_) {
     WaitForMemTableWriters();
@@ -917,6 +967,30 @@ void WriteThread::ExitUnbatched(Writer* w) {
   }
 }
 
+bool WriteThread::TryEnterBypass(uint64_t* epoch) {
+  // Pairs with LinkOne() and WaitForBypassWriters(): either the next writer
+  // entering the queue sees this write, or this write sees it in the queue.
+  bypass_writers_.fetch_add(1, std::memory_order_seq_cst);
+  *epoch = bypass_epoch_.load(std::memory_order_seq_cst);
+  if (newest_writer_.load(std::memory_order_seq_cst) != nullptr) {
+    ExitBypass();
+    return false;
+  }
+  return true;
+}
+
+void WriteThread::ExitBypass() {
+  bypass_writers_.fetch_sub(1, std::memory_order_release);
+}
+
+void WriteThread::WaitForBypassWriters() {
+  bypass_epoch_.fetch_add(1, std::memory_order_seq_cst);
+  while (bypass_writers_.load(std::memory_order_seq_cst) != 0) {
+    TEST_SYNC_POINT("WriteThread::WaitForBypassWriters:Wait");
+    std::this_thread::yield();
+  }
+}
+
 static WriteThread::AdaptationContext wfmw_ctx("WaitForMemTableWriters");
 void WriteThread::WaitForMemTableWriters() {
   assert(enable_pipelined_write_);
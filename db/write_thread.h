@@ -79,10 +79,28 @@ class WriteThread {
     // by calling SetMemWritersEachStride. After doing
     // this, it will also write to memtable.
     STATE_PARALLEL_MEMTABLE_CALLER = 64,
+
+    // The state used to inform a waiting follower that it should copy its
+    // batch into the WAL record of its group, at the place reserved in
+    // Writer::wal_copy, and then keep waiting as in STATE_INIT. The leader is
+    // in this state until all the copies are done.
+    STATE_PARALLEL_WAL_WRITER = 128,
   };
 
   struct Writer;
 
+  // Where a writer copies the records of its batch to be written to the WAL,
+  // when its group leader has them copied in parallel.
+  struct WalCopy {
+    Slice src;
+    char* dest = nullptr;
+    // CRC32C of the copy
+    uint32_t crc = 0;
+    Status status;
+
+    ~WalCopy() { status.PermitUncheckedError(); }
+  };
+
   struct WriteGroup {
     Writer* leader = nullptr;
     Writer* last_writer = nullptr;
@@ -139,6 +157,7 @@ class WriteThread {
     bool made_waitable;          // records lazy construction of mutex and cv
     std::atomic<uint8_t> state;  // write under StateMutex() or pre-link
     WriteGroup* write_group;
+    WalCopy* wal_copy;  // set by the leader for STATE_PARALLEL_WAL_WRITER
     SequenceNumber sequence;  // the sequence number to use for the first key
     Status status;
     Status callback_status;  // status returned by callback->Callback()
@@ -168,6 +187,7 @@ class WriteThread {
           made_waitable(false),
           state(STATE_INIT),
           write_group(nullptr),
+          wal_copy(nullptr),
           sequence(kMaxSequenceNumber),
           link_older(nullptr),
           link_newer(nullptr) {}
@@ -197,6 +217,7 @@ class WriteThread {
           made_waitable(false),
           state(STATE_INIT),
           write_group(nullptr),
+          wal_copy(nullptr),
           sequence(kMaxSequenceNumber),
           link_older(nullptr),
           link_newer(nullptr),
@@ -363,6 +384,14 @@ class WriteThread {
   // write_group, and all of these MemTableWriters will write to memtable.
   void SetMemWritersEachStride(Writer* w);
 
+  // Has the members of this write batch group with Writer::wal_copy set copy
+  // their batch into the WAL record in parallel (see
+  // STATE_PARALLEL_WAL_WRITER), copies the leader's own batch, and waits for
+  // all the copies to be done.
+  //
+  // WriteGroup* write_group: Extra state used to coordinate the parallel copy
+  void ParallelCopyWal(WriteGroup* write_group);
+
   // Reports the completion of w's batch to the parallel group leader, and
   // waits for the rest of the parallel batch to complete.  Returns true
   // if this thread is the last to complete, and hence should advance
@@ -386,6 +415,15 @@ class WriteThread {
   // write is enabled.
   void WaitForMemTableWriters();
 
+  // Registers a write that bypasses the queue of writers, which is only
+  // allowed while the queue is empty (see LockFreeWalBuffer). Returns false
+  // if it is not, and the write must go through the queue instead. Otherwise
+  // sets *epoch to the number of times the queue was entered from empty, and
+  // ExitBypass() must be called once the write is done. The next writer
+  // entering the queue waits for the writes in progress.
+  bool TryEnterBypass(uint64_t* epoch);
+  void ExitBypass();
+
   SequenceNumber UpdateLastSequence(SequenceNumber sequence) {
     if (sequence > last_sequence_) {
       last_sequence_ = sequence;
@@ -436,6 +474,11 @@ class WriteThread {
   // write is enabled.
   std::atomic<Writer*> newest_memtable_writer_;
 
+  // The writes in progress bypassing the queue, and the number of times the
+  // queue was entered from empty. See TryEnterBypass().
+  std::atomic<uint64_t> bypass_writers_{0};
+  std::atomic<uint64_t> bypass_epoch_{0};
+
   // The last sequence that have been consumed by a writer. The sequence
   // is not necessary visible to reads because the writer can be ongoing.
   SequenceNumber last_sequence_;
@@ -476,6 +519,14 @@ class WriteThread {
   // Set writer state and wake the writer up if it is waiting.
   void SetState(Writer* w, uint8_t new_state);
 
+  // Copies the batch of w as requested by ParallelCopyWal(), and moves the
+  // leader out of STATE_PARALLEL_WAL_WRITER if this is the last copy.
+  void CompleteParallelWalWriter(Writer* w);
+
+  // Bumps the bypass epoch and waits for the writes bypassing the queue,
+  // after a writer entered it from empty.
+  void WaitForBypassWriters();
+
   // Links w into the newest_writer list. Return true if w was linked directly
   // into the leader position.  Safe to call from multiple threads without
   // external locking.
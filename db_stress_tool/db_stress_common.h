@@ -96,7 +96,10 @@ DECLARE_int32(threads);
 DECLARE_int32(ttl);
 DECLARE_int32(value_size_mult);
 DECLARE_int32(compaction_readahead_size);
+DECLARE_uint64(compaction_pipeline_buffer_size);
+DECLARE_bool(compaction_copy_data_blocks);
 DECLARE_bool(enable_pipelined_write);
+DECLARE_bool(enable_lock_free_wal_buffer);
 DECLARE_bool(verify_before_write);
 DECLARE_bool(histogram);
 DECLARE_bool(destroy_db_initially);
@@ -135,6 +138,8 @@ DECLARE_int32(universal_min_merge_width);
 DECLARE_int32(universal_max_merge_width);
 DECLARE_int32(universal_max_size_amplification_percent);
 DECLARE_int32(universal_max_read_amp);
+DECLARE_uint32(lazy_level_size_ratio);
+DECLARE_int32(lazy_level_max_sorted_runs);
 DECLARE_int32(clear_column_family_one_in);
 DECLARE_int32(get_live_files_apis_one_in);
 DECLARE_int32(get_all_column_family_metadata_one_in);
@@ -126,8 +126,22 @@ DEFINE_int32(value_size_mult, 8,
 
 DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
+DEFINE_uint64(compaction_pipeline_buffer_size,
+              ROCKSDB_NAMESPACE::Options().compaction_pipeline_buffer_size,
+              "Options.compaction_pipeline_buffer_size");
+
+DEFINE_bool(compaction_copy_data_blocks,
+            ROCKSDB_NAMESPACE::Options().compaction_copy_data_blocks,
+            "Options.compaction_copy_data_blocks");
+
 DEFINE_bool(enable_pipelined_write, false, "Pipeline WAL/memtable writes");
 
+DEFINE_bool(enable_lock_free_wal_buffer,
+            ROCKSDB_NAMESPACE::Options().enable_lock_free_wal_buffer,
+            "Let unsynced writes bypass the write thread and buffer their WAL "
+            "records lock-free. Requires `manual_wal_flush_one_in` > 0 and "
+            "`allow_concurrent_memtable_write`.");
+
 DEFINE_bool(verify_before_write, false, "Verify before write");
 
 DEFINE_bool(histogram, false, "Print histogram of operation timings");
@@ -309,6 +323,16 @@ DEFINE_int32(universal_max_size_amplification_percent, 0,
 DEFINE_int32(universal_max_read_amp, -1,
              "The limit on the number of sorted runs");
 
+DEFINE_uint32(
+    lazy_level_size_ratio,
+    ROCKSDB_NAMESPACE::CompactionOptionsLazyLevel().size_ratio,
+    "The size ratio between the logical levels in lazy level compaction");
+
+DEFINE_int32(lazy_level_max_sorted_runs,
+             ROCKSDB_NAMESPACE::CompactionOptionsLazyLevel().max_sorted_runs,
+             "The max number of sorted runs per logical level in lazy level "
+             "compaction");
+
 DEFINE_int32(clear_column_family_one_in, 1000000,
              "With a chance of 1/N, delete a column family and then recreate "
              "it again. If N == 0, never drop/create column families. "
@@ -3344,6 +3344,9 @@ void StressTest::PrintEnv() const {
     case kRoundRobin:
       compaction_pri = "kRoundRobin";
       break;
+    case kReadHeatAndOverlappingRatio:
+      compaction_pri = "kReadHeatAndOverlappingRatio";
+      break;
   }
   fprintf(stdout, "Compaction Pri            : %s\n", compaction_pri);
   fprintf(stdout, "Background Purge          : %d\n",
@@ -4087,6 +4090,9 @@ void InitializeOptionsFromFlags(
   options.env = db_stress_env;
   options.use_fsync = FLAGS_use_fsync;
   options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+  options.compaction_pipeline_buffer_size =
+      static_cast<size_t>(FLAGS_compaction_pipeline_buffer_size);
+  options.compaction_copy_data_blocks = FLAGS_compaction_copy_data_blocks;
   options.allow_mmap_reads = FLAGS_mmap_read;
   options.allow_mmap_writes = FLAGS_mmap_write;
   options.use_direct_reads = FLAGS_use_direct_reads;
@@ -4136,6 +4142,7 @@ void InitializeOptionsFromFlags(
       static_cast<unsigned int>(FLAGS_stats_dump_period_sec);
   options.ttl = FLAGS_compaction_ttl;
   options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+  options.enable_lock_free_wal_buffer = FLAGS_enable_lock_free_wal_buffer;
   options.enable_write_thread_adaptive_yield =
       FLAGS_enable_write_thread_adaptive_yield;
   options.compaction_options_universal.size_ratio = FLAGS_universal_size_ratio;
@@ -4147,6 +4154,10 @@ void InitializeOptionsFromFlags(
       FLAGS_universal_max_size_amplification_percent;
   options.compaction_options_universal.max_read_amp =
       FLAGS_universal_max_read_amp;
+  options.compaction_options_lazy_level.size_ratio =
+      FLAGS_lazy_level_size_ratio;
+  options.compaction_options_lazy_level.max_sorted_runs =
+      FLAGS_lazy_level_max_sorted_runs;
   options.atomic_flush = FLAGS_atomic_flush;
   options.manual_wal_flush = FLAGS_manual_wal_flush_one_in > 0 ? true : false;
   options.avoid_unnecessary_blocking_io = FLAGS_avoid_unnecessary_blocking_io;
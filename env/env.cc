@@ -1138,6 +1138,7 @@ EnvOptions Env::OptimizeForLogWrite(const EnvOptions& env_options,
   optimized_env_options.bytes_per_sync = db_options.wal_bytes_per_sync;
   optimized_env_options.writable_file_max_buffer_size =
       db_options.writable_file_max_buffer_size;
+  optimized_env_options.use_async_writes = db_options.use_async_io_for_writes;
   return optimized_env_options;
 }
 
@@ -1162,6 +1163,7 @@ EnvOptions Env::OptimizeForCompactionTableWrite(
   EnvOptions optimized_env_options(env_options);
   optimized_env_options.use_direct_writes =
       db_options.use_direct_io_for_flush_and_compaction;
+  optimized_env_options.use_async_writes = db_options.use_async_io_for_writes;
   return optimized_env_options;
 }
 
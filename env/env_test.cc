@@ -1140,6 +1140,46 @@ TEST_F(EnvPosixTest, PositionedAppend) {
   ASSERT_EQ('b', result[kBlockSize]);
 }
 
+TEST_F(EnvPosixTest, AsyncWrites) {
+  // Writes are queued on io_uring when supported, and done synchronously
+  // otherwise; the result must be the same.
+  EnvOptions options;
+  options.use_mmap_writes = false;
+  options.use_async_writes = true;
+  std::string fname = test::PerThreadDBPath(env_, "async_writes");
+  std::unique_ptr<WritableFile> writable_file;
+  ASSERT_OK(env_->NewWritableFile(fname, &writable_file, options));
+
+  Random rnd(301);
+  std::string expected;
+  // The caller may reuse the buffer as soon as Append() returns.
+  std::string buf;
+  for (int i = 0; i < 200; ++i) {
+    buf = rnd.RandomString(1 + rnd.Uniform(100 << 10));
+    ASSERT_OK(writable_file->Append(buf));
+    expected += buf;
+    buf.assign(buf.size(), 'x');
+    if (i % 10 == 0) {
+      ASSERT_OK(writable_file->Flush());
+    }
+    if (i % 50 == 0) {
+      ASSERT_OK(writable_file->Sync());
+    }
+    ASSERT_EQ(expected.size(), writable_file->GetFileSize());
+  }
+  ASSERT_OK(writable_file->RangeSync(0, expected.size() / 2));
+  expected.resize(expected.size() - 1000);
+  ASSERT_OK(writable_file->Truncate(expected.size()));
+  ASSERT_OK(writable_file->Fsync());
+  ASSERT_OK(writable_file->Close());
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_TRUE(expected == actual);
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 // `GetUniqueId()` temporarily returns zero on Windows. `BlockBasedTable` can
 // handle a return value of zero but this test case cannot.
 #ifndef OS_WIN
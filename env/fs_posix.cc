@@ -348,11 +348,7 @@ class PosixFileSystem : public FileSystem {
       // disable mmap writes
       EnvOptions no_mmap_writes_options = options;
       no_mmap_writes_options.use_mmap_writes = false;
-      result->reset(
-          new PosixWritableFile(fname, fd,
-                                GetLogicalBlockSizeForWriteIfNeeded(
-                                    no_mmap_writes_options, fname, fd),
-                                no_mmap_writes_options));
+      NewBufferedWritableFile(fname, fd, no_mmap_writes_options, result);
     }
     return s;
   }
@@ -443,11 +439,7 @@ class PosixFileSystem : public FileSystem {
       // disable mmap writes
       FileOptions no_mmap_writes_options = options;
       no_mmap_writes_options.use_mmap_writes = false;
-      result->reset(
-          new PosixWritableFile(fname, fd,
-                                GetLogicalBlockSizeForWriteIfNeeded(
-                                    no_mmap_writes_options, fname, fd),
-                                no_mmap_writes_options));
+      NewBufferedWritableFile(fname, fd, no_mmap_writes_options, result);
     }
     return s;
   }
@@ -920,6 +912,7 @@ class PosixFileSystem : public FileSystem {
     optimized.fallocate_with_keep_size = true;
     optimized.writable_file_max_buffer_size =
         db_options.writable_file_max_buffer_size;
+    optimized.use_async_writes = db_options.use_async_io_for_writes;
     return optimized;
   }
 
@@ -1041,6 +1034,27 @@ class PosixFileSystem : public FileSystem {
         fd);
   }
 
+  // Creates the writable file for a file opened without O_DIRECT or mmap,
+  // queueing its writes on io_uring if requested and supported.
+  void NewBufferedWritableFile(const std::string& fname, int fd,
+                               const EnvOptions& options,
+                               std::unique_ptr<FSWritableFile>* result) {
+    const size_t logical_block_size =
+        GetLogicalBlockSizeForWriteIfNeeded(options, fname, fd);
+#if defined(ROCKSDB_IOURING_PRESENT)
+    if (options.use_async_writes && IsIOUringEnabled()) {
+      struct io_uring* iu = CreateIOUring();
+      if (iu != nullptr) {
+        result->reset(new PosixAsyncWritableFile(fname, fd, logical_block_size,
+                                                 options, iu));
+        return;
+      }
+    }
+#endif
+    result->reset(
+        new PosixWritableFile(fname, fd, logical_block_size, options));
+  }
+
 #ifdef ROCKSDB_IOURING_PRESENT
   bool IsIOUringEnabled() {
     if (RocksDbIOUringEnable && RocksDbIOUringEnable()) {
@@ -1579,6 +1579,253 @@ size_t PosixWritableFile::GetUniqueId(char* id, size_t max_size) const {
 }
 #endif
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+/*
+ * PosixAsyncWritableFile
+ *
+ * Use io_uring to write data to a file in the background.
+ */
+PosixAsyncWritableFile::PosixAsyncWritableFile(const std::string& fname,
+                                               int fd,
+                                               size_t logical_block_size,
+                                               const EnvOptions& options,
+                                               struct io_uring* iu)
+    : PosixWritableFile(fname, fd, logical_block_size, options), iu_(iu) {
+  assert(!options.use_direct_writes);
+  assert(iu_ != nullptr);
+}
+
+PosixAsyncWritableFile::~PosixAsyncWritableFile() {
+  if (fd_ >= 0) {
+    IOStatus s = PosixAsyncWritableFile::Close(IOOptions(), nullptr);
+    s.PermitUncheckedError();
+  }
+  io_uring_queue_exit(iu_);
+  delete iu_;
+  error_.PermitUncheckedError();
+}
+
+IOStatus PosixAsyncWritableFile::Submit(std::unique_ptr<Request>&& req) {
+  mu_.AssertHeld();
+  struct io_uring_sqe* sqe = io_uring_get_sqe(iu_);
+  while (sqe == nullptr) {
+    // The submission queue is full.
+    IOStatus s = WaitForOldest();
+    if (!s.ok()) {
+      return s;
+    }
+    sqe = io_uring_get_sqe(iu_);
+  }
+  if (req->data.empty()) {
+    io_uring_prep_fsync(sqe, fd_, req->datasync ? IORING_FSYNC_DATASYNC : 0);
+  } else {
+    io_uring_prep_write(sqe, fd_, req->data.data(),
+                        static_cast<unsigned>(req->data.size()), req->offset);
+  }
+  // Start only once all the previous requests completed, so that writes
+  // land in order and an fsync covers all of them.
+  io_uring_sqe_set_flags(sqe, IOSQE_IO_DRAIN);
+  io_uring_sqe_set_data(sqe, req.get());
+  ssize_t ret;
+  do {
+    ret = io_uring_submit(iu_);
+  } while (ret == -EINTR || ret == -EAGAIN);
+  if (ret < 0) {
+    // The request stays in the submission queue, so keep it alive until the
+    // ring is torn down, and fail all further calls.
+    error_ = IOError("While io_uring_submit() for writing", filename_,
+                     static_cast<int>(-ret));
+    unsubmitted_ = std::move(req);
+    return error_;
+  }
+  queued_bytes_ += req->data.size();
+  queued_.push_back(std::move(req));
+  return IOStatus::OK();
+}
+
+void PosixAsyncWritableFile::Complete(struct io_uring_cqe* cqe) {
+  mu_.AssertHeld();
+  assert(!queued_.empty());
+  Request* req = queued_.front().get();
+  assert(io_uring_cqe_get_data(cqe) == req);
+  (void)req;
+  const int res = cqe->res;
+  io_uring_cqe_seen(iu_, cqe);
+
+  if (req->data.empty()) {
+    if (res < 0 && error_.ok()) {
+      error_ = IOError(req->datasync ? "While fdatasync" : "While fsync",
+                       filename_, -res);
+    }
+  } else if (res < 0) {
+    if (error_.ok()) {
+      error_ = IOError("While appending to file", filename_, -res);
+    }
+  } else if (static_cast<size_t>(res) < req->data.size()) {
+    // Short write, finish it in place.
+    const size_t done = static_cast<size_t>(res);
+    if (!PosixPositionedWrite(fd_, req->data.data() + done,
+                              req->data.size() - done,
+                              static_cast<off_t>(req->offset + done)) &&
+        error_.ok()) {
+      error_ = IOError("While appending to file", filename_, errno);
+    }
+  }
+  queued_bytes_ -= req->data.size();
+  queued_.pop_front();
+}
+
+void PosixAsyncWritableFile::ReapCompleted() {
+  mu_.AssertHeld();
+  struct io_uring_cqe* cqe = nullptr;
+  while (!queued_.empty() && io_uring_peek_cqe(iu_, &cqe) == 0) {
+    Complete(cqe);
+  }
+}
+
+IOStatus PosixAsyncWritableFile::WaitForOldest() {
+  mu_.AssertHeld();
+  assert(!queued_.empty());
+  struct io_uring_cqe* cqe = nullptr;
+  int ret;
+  do {
+    ret = io_uring_wait_cqe(iu_, &cqe);
+  } while (ret == -EINTR || ret == -EAGAIN);
+  if (ret < 0) {
+    return IOError("While io_uring_wait_cqe() for writing", filename_, -ret);
+  }
+  Complete(cqe);
+  return IOStatus::OK();
+}
+
+IOStatus PosixAsyncWritableFile::WaitForAll() {
+  mu_.AssertHeld();
+  while (!queued_.empty()) {
+    IOStatus s = WaitForOldest();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  return error_;
+}
+
+IOStatus PosixAsyncWritableFile::Append(const Slice& data,
+                                        const IOOptions& /*opts*/,
+                                        IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  ReapCompleted();
+  if (!error_.ok()) {
+    return error_;
+  }
+  if (data.empty()) {
+    return IOStatus::OK();
+  }
+  while (!queued_.empty() && (queued_.size() >= kMaxQueuedRequests ||
+                              queued_bytes_ + data.size() > kMaxQueuedBytes)) {
+    IOStatus s = WaitForOldest();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  // The caller reuses its buffer right away.
+  std::unique_ptr<Request> req(new Request());
+  req->data.assign(data.data(), data.size());
+  req->offset = filesize_;
+  IOStatus s = Submit(std::move(req));
+  if (s.ok()) {
+    filesize_ += data.size();
+  }
+  return s;
+}
+
+IOStatus PosixAsyncWritableFile::PositionedAppend(const Slice& data,
+                                                  uint64_t offset,
+                                                  const IOOptions& opts,
+                                                  IODebugContext* dbg) {
+  MutexLock lock(&mu_);
+  IOStatus s = WaitForAll();
+  if (!s.ok()) {
+    return s;
+  }
+  return PosixWritableFile::PositionedAppend(data, offset, opts, dbg);
+}
+
+IOStatus PosixAsyncWritableFile::Truncate(uint64_t size, const IOOptions& opts,
+                                          IODebugContext* dbg) {
+  MutexLock lock(&mu_);
+  IOStatus s = WaitForAll();
+  if (!s.ok()) {
+    return s;
+  }
+  return PosixWritableFile::Truncate(size, opts, dbg);
+}
+
+IOStatus PosixAsyncWritableFile::Close(const IOOptions& opts,
+                                       IODebugContext* dbg) {
+  MutexLock lock(&mu_);
+  IOStatus s = WaitForAll();
+  IOStatus close_status = PosixWritableFile::Close(opts, dbg);
+  if (s.ok()) {
+    s = close_status;
+  } else {
+    close_status.PermitUncheckedError();
+  }
+  return s;
+}
+
+IOStatus PosixAsyncWritableFile::Flush(const IOOptions& /*opts*/,
+                                       IODebugContext* /*dbg*/) {
+  MutexLock lock(&mu_);
+  ReapCompleted();
+  return error_;
+}
+
+IOStatus PosixAsyncWritableFile::SyncInternal(bool datasync) {
+  MutexLock lock(&mu_);
+  ReapCompleted();
+  if (!error_.ok()) {
+    return error_;
+  }
+  std::unique_ptr<Request> req(new Request());
+  req->datasync = datasync;
+  IOStatus s = Submit(std::move(req));
+  if (!s.ok()) {
+    return s;
+  }
+  return WaitForAll();
+}
+
+IOStatus PosixAsyncWritableFile::Sync(const IOOptions& /*opts*/,
+                                      IODebugContext* /*dbg*/) {
+  return SyncInternal(/*datasync=*/true);
+}
+
+IOStatus PosixAsyncWritableFile::Fsync(const IOOptions& /*opts*/,
+                                       IODebugContext* /*dbg*/) {
+  return SyncInternal(/*datasync=*/false);
+}
+
+IOStatus PosixAsyncWritableFile::RangeSync(uint64_t offset, uint64_t nbytes,
+                                           const IOOptions& opts,
+                                           IODebugContext* dbg) {
+  {
+    // Only start writeback once the range has been written.
+    MutexLock lock(&mu_);
+    while (!queued_.empty() && queued_.front()->offset < offset + nbytes) {
+      IOStatus s = WaitForOldest();
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    if (!error_.ok()) {
+      return error_;
+    }
+  }
+  return PosixWritableFile::RangeSync(offset, nbytes, opts, dbg);
+}
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 /*
  * PosixRandomRWFile
  */
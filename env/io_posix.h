@@ -15,8 +15,10 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 
 #include "port/port.h"
@@ -420,6 +422,80 @@ class PosixWritableFile : public FSWritableFile {
 #endif
 };
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+// PosixWritableFile that queues appends on its own io_uring instead of
+// writing them in the calling thread, so that e.g. a compaction can build the
+// next block while the previous one is being written. Each request is drained
+// behind the previous ones, so the file always holds a prefix of the appended
+// data, and Sync()/Fsync() queue an fsync behind the writes and wait for it.
+// Errors of queued writes are returned by the following calls.
+class PosixAsyncWritableFile : public PosixWritableFile {
+ public:
+  // Takes ownership of `iu`.
+  PosixAsyncWritableFile(const std::string& fname, int fd,
+                         size_t logical_block_size, const EnvOptions& options,
+                         struct io_uring* iu);
+  ~PosixAsyncWritableFile() override;
+
+  IOStatus Truncate(uint64_t size, const IOOptions& opts,
+                    IODebugContext* dbg) override;
+  IOStatus Close(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Append(const Slice& data, const IOOptions& opts,
+                  IODebugContext* dbg) override;
+  IOStatus Append(const Slice& data, const IOOptions& opts,
+                  const DataVerificationInfo& /* verification_info */,
+                  IODebugContext* dbg) override {
+    return Append(data, opts, dbg);
+  }
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& opts,
+                            IODebugContext* dbg) override;
+  IOStatus PositionedAppend(const Slice& data, uint64_t offset,
+                            const IOOptions& opts,
+                            const DataVerificationInfo& /* verification_info */,
+                            IODebugContext* dbg) override {
+    return PositionedAppend(data, offset, opts, dbg);
+  }
+  IOStatus Flush(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Sync(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus Fsync(const IOOptions& opts, IODebugContext* dbg) override;
+  IOStatus RangeSync(uint64_t offset, uint64_t nbytes, const IOOptions& opts,
+                     IODebugContext* dbg) override;
+
+ private:
+  // A queued write, or an fsync if `data` is empty.
+  struct Request {
+    std::string data;
+    uint64_t offset = 0;
+    bool datasync = false;
+  };
+
+  // Maximum number of requests and of bytes queued at once, beyond which
+  // Append() waits for the oldest writes.
+  static constexpr size_t kMaxQueuedRequests = kIoUringDepth / 4;
+  static constexpr size_t kMaxQueuedBytes = 16 << 20;
+
+  IOStatus Submit(std::unique_ptr<Request>&& req);
+  // Handles the completions already available without waiting.
+  void ReapCompleted();
+  // Waits for the oldest queued request to complete.
+  IOStatus WaitForOldest();
+  IOStatus WaitForAll();
+  void Complete(struct io_uring_cqe* cqe);
+  IOStatus SyncInternal(bool datasync);
+
+  port::Mutex mu_;
+  struct io_uring* iu_;
+  // In submission order, which is also the completion order.
+  std::deque<std::unique_ptr<Request>> queued_;
+  size_t queued_bytes_ = 0;
+  // Request left in the submission queue by a failed submit.
+  std::unique_ptr<Request> unsubmitted_;
+  // First error of a queued request.
+  IOStatus error_;
+};
+#endif  // defined(ROCKSDB_IOURING_PRESENT)
+
 // mmap() based random-access
 class PosixMmapReadableFile : public FSRandomAccessFile {
  private:
@@ -33,6 +33,15 @@ enum CompactionStyle : char {
   // Disable background compaction. Compaction jobs are submitted
   // via CompactFiles().
   kCompactionStyleNone = 0x3,
+  // EXPERIMENTAL
+  // Lazy leveling compaction style: a hybrid of tiered (universal) and
+  // leveled compaction. Like universal compaction, the L0 files and each
+  // non-empty level other than the last are sorted runs, from the newest to
+  // the oldest. Up to a configured number of sorted runs of similar sizes are
+  // kept before they are merged (tiering), while the last level holds most of
+  // the data and is compacted file by file, as with leveled compaction. See
+  // CompactionOptionsLazyLevel.
+  kCompactionStyleLazyLevel = 0x4,
 };
 
 // In Level-based compaction, it Determines which file from a level to be
@@ -59,6 +68,17 @@ enum CompactionPri : char {
   // level. The file picking process will cycle through all the files in a
   // round-robin manner.
   kRoundRobin = 0x4,
+  // EXPERIMENTAL
+  // Like kMinOverlappingRatio, but the overlapping ratio of a file is divided
+  // by (1 + its read heat), the density of its sampled reads
+  // (FileMetaData::stats.num_reads_sampled per byte) relative to the average
+  // of its level. Files which are read more than the rest of their level are
+  // compacted first, as every point lookup going through them also has to
+  // check the overlapping files of the lower levels, while cold key ranges
+  // are left for later, which saves write amplification where read
+  // amplification costs little. Without any sampled read in a level, the
+  // files are ordered as with kMinOverlappingRatio.
+  kReadHeatAndOverlappingRatio = 0x5,
 };
 
 struct FileTemperatureAge {
@@ -125,6 +145,36 @@ struct CompactionOptionsFIFO {
 #endif
 };
 
+// EXPERIMENTAL
+// The options of kCompactionStyleLazyLevel. The sorted runs other than the
+// last level are grouped in logical levels by size: a sorted run is in
+// logical level i when its size is at most write_buffer_size * size_ratio^i.
+// When a logical level has more than its maximum number of sorted runs, they
+// are merged into a single sorted run, of a larger logical level. Data is
+// moved, file by file, from the oldest sorted run into the last level when
+// the last level is less than size_ratio times the size of the rest of the
+// data, which bounds the space amplification to about 1 + 1 / size_ratio.
+struct CompactionOptionsLazyLevel {
+  // Size ratio between consecutive logical levels, and between the last
+  // level and the rest of the data. Must be at least 2.
+  // Default: 10
+  unsigned int size_ratio = 10;
+
+  // Maximum number of sorted runs of each logical level which does not have
+  // an entry in max_sorted_runs_per_level. Must be at least 1.
+  // Default: 4
+  int max_sorted_runs = 4;
+
+  // Maximum number of sorted runs of each logical level, starting from
+  // logical level 0 (the memtable sized sorted runs). Must be at least 1.
+  // Default: empty
+  std::vector<int> max_sorted_runs_per_level;
+
+#if __cplusplus >= 202002L
+  bool operator==(const CompactionOptionsLazyLevel& rhs) const = default;
+#endif
+};
+
 // The control option of how the cache tiers will be used. Currently rocksdb
 // support block cache (volatile tier), secondary cache (non-volatile tier).
 // In the future, we may add more caching layers.
@@ -616,6 +666,14 @@ struct AdvancedColumnFamilyOptions {
   // SetOptions("compaction_options_fifo", "{max_table_files_size=100;}")
   CompactionOptionsFIFO compaction_options_fifo;
 
+  // EXPERIMENTAL
+  // The options for the lazy leveling compaction style
+  //
+  // Dynamically changeable through SetOptions() API
+  // Dynamic change example:
+  // SetOptions("compaction_options_lazy_level", "{max_sorted_runs=8;}")
+  CompactionOptionsLazyLevel compaction_options_lazy_level;
+
   // An iteration->Next() sequentially skips over keys with the same
   // user-key unless this option is set. This number specifies the number
   // of keys (with the same userkey) that will be sequentially
@@ -1105,6 +1163,60 @@ struct AdvancedColumnFamilyOptions {
   // additional key comparison during memtable lookup.
   bool paranoid_memory_checks = false;
 
+  // EXPERIMENTAL
+  // If non-zero, about this many bytes are used to remember recent point
+  // lookups (Get()) that found no entry for their key, so that repeated
+  // lookups of the same missing keys return NotFound without searching the
+  // memtables, nor probing the filters of every L0 file and level. The
+  // remembered misses are dropped on any write to their keys, on range
+  // deletions, and on file ingestion.
+  //
+  // Not used with user-defined timestamps, inplace_update_support,
+  // unordered_write, nor with two_write_queues or WritePrepared/
+  // WriteUnprepared transactions. Lookups with a read callback, or not
+  // reading all tiers, bypass it.
+  //
+  // Default: 0 (disabled)
+  // Not dynamically changeable, change it requires db restart.
+  size_t negative_lookup_cache_size = 0;
+
+  // EXPERIMENTAL
+  // If non-zero, each (sub)compaction reads its input on a separate thread,
+  // which does the reading, decompression and merging of the input files
+  // ahead of the compaction thread, through a queue of copied entries of
+  // about this many bytes. The compaction thread only runs the compaction
+  // filter, merges and output file building. This helps when a compaction
+  // is CPU bound, and can't be split further with max_subcompactions. For
+  // the compression of the output, see CompressionOptions::parallel_threads.
+  //
+  // The time each thread spends waiting for the other is reported in
+  // CompactionJobStats.
+  //
+  // Default: 0 (disabled)
+  // Not dynamically changeable, change it requires db restart.
+  size_t compaction_pipeline_buffer_size = 0;
+
+  // EXPERIMENTAL
+  // If true, compactions copy the input data blocks which would be output
+  // unchanged to the output files as is, instead of decoding their entries and
+  // encoding and compressing them again. That is, blocks of block-based
+  // tables with only values (no deletions, merge operands, etc.), of user
+  // keys not in any other input, while no range deletion applies, when the
+  // compression type of the block is the one of the output level. This makes
+  // the compactions of non-overlapping data, e.g. data written in key order,
+  // mostly I/O bound. The numbers of copied and rewritten blocks are reported
+  // in CompactionJobStats.
+  //
+  // Not used with a compaction filter, user-defined timestamps, blob files,
+  // compression dictionaries, parallel compression, an SST partitioner,
+  // compaction_pipeline_buffer_size, or when the output files can be cut for
+  // TTL or round-robin compaction priority. Copied blocks keep their sequence
+  // numbers, which are not zeroed out in the last level.
+  //
+  // Default: false
+  // Not dynamically changeable, change it requires db restart.
+  bool compaction_copy_data_blocks = false;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -1084,6 +1084,7 @@ extern ROCKSDB_LIBRARY_API void rocksdb_block_based_options_set_index_type(
 enum {
   rocksdb_block_based_table_data_block_index_type_binary_search = 0,
   rocksdb_block_based_table_data_block_index_type_binary_search_and_hash = 1,
+  rocksdb_block_based_table_data_block_index_type_interpolation_search = 2,
 };
 extern ROCKSDB_LIBRARY_API void
 rocksdb_block_based_options_set_data_block_index_type(
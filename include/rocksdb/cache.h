@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -24,7 +25,9 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
+class Statistics;
 
 // These definitions begin source compatibility for a future change in which
 // a specific class for block cache is split away from general caches, so that
@@ -189,6 +192,28 @@ struct ShardedCacheOptions {
   //   repeatable behavior on a host, for diagnostic purposes.
   int32_t hash_seed = kHostHashSeed;
 
+  // EXPERIMENTAL: If true and RocksDB is built with NUMA support (WITH_NUMA),
+  // the shards are divided among the NUMA nodes of the host, and the memory
+  // of each shard is allocated on its node. With LRUCache, entries are also
+  // inserted in the shards of the node of the inserting thread, which usually
+  // allocated their memory, and lookups check the shards of the local node
+  // before those of the other nodes. This saves cross-node memory traffic
+  // when entries are mostly used on the node that loaded them, at the cost of
+  // a lookup per node on a miss, an erase per node on Insert(), and of the
+  // threads of a node only using that node's share of the capacity.
+  // HyperClockCache only places its shards on the nodes, because it derives
+  // the key of an entry from its hash.
+  bool numa_aware = false;
+
+  // EXPERIMENTAL: With numa_aware, an entry found in the shard of another
+  // node is copied to the local node after about this many such lookups from
+  // the local node, so that every node can have its own copy of the hottest
+  // entries. Only entries that can be saved and re-created through their
+  // CacheItemHelper (see IsSecondaryCacheCompatible()) are replicated, by
+  // lookups passing such a helper, like those of the block cache. 0 means no
+  // replication.
+  uint32_t numa_replication_threshold = 0;
+
   ShardedCacheOptions() {}
   ShardedCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -243,6 +268,19 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // EXPERIMENTAL
+  // If true, cache hits don't take the shard mutex to move entries in the LRU
+  // list. Lookups instead hold the shard lock in shared mode, and record hits
+  // in per-core buffers, which are applied to the LRU list in batches under
+  // the exclusive lock, when one is full or before entries are evicted or
+  // erased. Referenced entries also stay in the LRU list, and eviction skips
+  // them. This reduces the contention on the shard locks with many threads,
+  // while keeping the priority pools above (unlike HyperClockCache), at the
+  // cost of a slightly less precise LRU order, as hits arriving while a
+  // buffer is full are dropped. GetPinnedUsage() also becomes linear in the
+  // number of entries.
+  bool batched_promotion = false;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -371,6 +409,38 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// EXPERIMENTAL
+// Options structure for configuring a SecondaryCache instance on local
+// flash, typically as the TieredCacheOptions::nvm_sec_cache. The entries are
+// appended to large segment files, and only an index of them, a few tens of
+// bytes per entry, is kept in memory. Space is reclaimed a whole segment at a
+// time, oldest first. Lookups with wait=false read asynchronously when the
+// file system supports it (FSSupportedOps::kAsyncIO), as the posix one does
+// with io_uring.
+//
+// The cache is not persistent: its segment files are deleted on startup and
+// when it is destroyed.
+struct FlashSecondaryCacheOptions {
+  // The directory of the segment files, created if missing.
+  std::string path;
+
+  // The total size of the segment files. Must be at least twice
+  // segment_size.
+  size_t capacity = 0;
+
+  // The size of the segment files, at most 4GB.
+  size_t segment_size = 64 << 20;
+
+  // The entries are written to the current segment in chunks of this size.
+  size_t write_buffer_size = 1 << 20;
+
+  // The file system of `path`. FileSystem::Default() if not set.
+  std::shared_ptr<FileSystem> fs;
+};
+
+Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                              std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
@@ -478,6 +548,19 @@ struct HyperClockCacheOptions : public ShardedCacheOptions {
   // keep operations very fast.
   int eviction_effort_cap = 30;
 
+  // EXPERIMENTAL: When true, each cache shard keeps a small count-min sketch
+  // of how often keys are looked up or inserted (TinyLFU), and a new entry
+  // is only inserted in place of an eviction victim when the new entry is
+  // estimated to be more popular than that victim. Otherwise the insertion
+  // is rejected, as if the entry was inserted and immediately evicted (or,
+  // when a handle is requested, the entry is returned as a "standalone"
+  // handle not kept in the cache). This protects the working set from being
+  // flushed out by scans, e.g. a large compaction or iteration with
+  // fill_cache=true. Counters are halved as the clock sweeps the table, so
+  // that only recent popularity counts. The sketch takes about 2 bytes of
+  // memory per table slot, and it is ignored with strict_capacity_limit=true.
+  bool frequency_admission = false;
+
   HyperClockCacheOptions(
       size_t _capacity, size_t _estimated_entry_charge,
       int _num_shard_bits = -1, bool _strict_capacity_limit = false,
@@ -563,6 +646,40 @@ struct TieredCacheOptions {
 
 std::shared_ptr<Cache> NewTieredCache(const TieredCacheOptions& cache_opts);
 
+// EXPERIMENTAL
+// Limits on the total charge of a set of cache entries. 0 means no limit.
+struct CacheQuota {
+  // Above this, entries are only admitted while the cache has unused
+  // capacity (borrowed from the other users of the cache), with the lowest
+  // priority so that they are the first evicted once the capacity is needed.
+  size_t soft_limit = 0;
+  // Above this, entries are never admitted. Insertions are then handled as if
+  // the entry was inserted and immediately evicted (or returned as a
+  // standalone handle, see Cache::CreateStandalone).
+  size_t hard_limit = 0;
+};
+
+// EXPERIMENTAL
+// Options for a view of a shared cache enforcing quotas on the entries
+// inserted through it, for example to keep the block cache usage of a noisy
+// column family from evicting the index and filter blocks of others. Set the
+// BlockBasedTableOptions::block_cache of each column family to its own
+// QuotaCache over the same cache. The quota usage of a column family is
+// reported by the DB property "rocksdb.block-cache-quota".
+struct QuotaCacheOptions {
+  // The shared cache. Required.
+  std::shared_ptr<Cache> cache;
+  // Quota on the entries of all roles
+  CacheQuota total;
+  // Quotas on the entries of specific roles, in addition to `total`
+  std::map<CacheEntryRole, CacheQuota> role_quotas;
+  // If set, receives BLOCK_CACHE_QUOTA_* tickers
+  std::shared_ptr<Statistics> statistics;
+};
+
+// Returns nullptr if opts.cache is not set
+std::shared_ptr<Cache> NewQuotaCache(const QuotaCacheOptions& opts);
+
 // EXPERIMENTAL
 // Dynamically update some of the parameters of a TieredCache. The input
 // cache shared_ptr should have been allocated using NewTieredVolatileCache.
@@ -118,6 +118,27 @@ struct CompactionJobStats {
   // number of single-deletes which meet something other than a put
   uint64_t num_single_del_mismatch = 0;
 
+  // Following counters are only populated with
+  // compaction_pipeline_buffer_size > 0, summed over the subcompactions.
+  // Together with elapsed_micros, they give the utilization of each stage.
+
+  // Time the input threads spent reading, decompressing and merging the
+  // input files.
+  uint64_t pipeline_input_busy_micros = 0;
+
+  // Time the input threads waited for the compaction threads to consume
+  // their output.
+  uint64_t pipeline_input_stall_micros = 0;
+
+  // Time the compaction threads waited for the input threads.
+  uint64_t pipeline_merge_stall_micros = 0;
+
+  // With compaction_copy_data_blocks, the number of output data blocks copied
+  // as is from the input files, and the number of the ones built from
+  // individual entries.
+  uint64_t num_data_blocks_copied = 0;
+  uint64_t num_data_blocks_rewritten = 0;
+
   // TODO: Add output_to_penultimate_level output information
 };
 }  // namespace ROCKSDB_NAMESPACE
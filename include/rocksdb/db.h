@@ -1201,6 +1201,12 @@ class DB {
     //      stale values more frequently to reduce overhead and latency.
     static const std::string kFastBlockCacheEntryStats;
 
+    //  "rocksdb.block-cache-quota" - returns a multi-line string or map with
+    //      the usage and limits of the QuotaCache (see NewQuotaCache()) used
+    //      as the block cache of the column family, in total and per
+    //      CacheEntryRole. Not available for other block caches.
+    static const std::string kBlockCacheQuota;
+
     //  "rocksdb.num-immutable-mem-table" - returns number of immutable
     //      memtables that have not yet been flushed.
     static const std::string kNumImmutableMemTable;
@@ -93,6 +93,9 @@ struct EnvOptions {
   // If true, then use O_DIRECT for writing data
   bool use_direct_writes = false;
 
+  // If true, queue writes to be done asynchronously when supported
+  bool use_async_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -6,12 +6,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "rocksdb/customizable.h"
 #include "rocksdb/status.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+class Statistics;
+
 // MemoryAllocator is an interface that a client can implement to supply custom
 // memory allocation and deallocation methods. See rocksdb/cache.h for more
 // information.
@@ -84,4 +87,39 @@ Status NewJemallocNodumpAllocator(
     const JemallocAllocatorOptions& options,
     std::shared_ptr<MemoryAllocator>* memory_allocator);
 
+// EXPERIMENTAL
+struct HugePageSlabAllocatorOptions {
+  static const char* kName() { return "HugePageSlabAllocatorOptions"; }
+  // Memory reserved up front for the slabs, backed by huge pages (explicit
+  // huge pages if enough are reserved in the system, otherwise transparent
+  // huge pages if enabled) as it gets used. Allocations not fitting in it
+  // fall back to the heap. When used by a block cache, it should be a bit
+  // larger than the cache capacity, as the last slab of each size class is
+  // usually partly empty.
+  size_t capacity = size_t{1} << 30;
+
+  // Size of a slab, holding allocations of a single size class. Must be a
+  // power of two, normally the huge page size.
+  size_t slab_size = size_t{2} << 20;
+
+  // Allocations are rounded up to the smallest of these sizes. Larger ones
+  // fall back to the heap. Must be increasing. If empty, four classes per
+  // power of two from 256 bytes to 64KB, fitting uncompressed blocks from
+  // the usual block sizes with at most 20% waste.
+  std::vector<size_t> size_classes;
+
+  // If set, receives the SLAB_ALLOCATOR_* tickers
+  std::shared_ptr<Statistics> statistics;
+};
+
+// EXPERIMENTAL
+// Creates a slab allocator backed by huge pages, to use as the
+// memory_allocator of a block cache (LRUCacheOptions, HyperClockCacheOptions).
+// The block cache entries, and the buffers BlockFetcher allocates for
+// uncompressed blocks, then fill huge pages, reducing TLB misses compared to
+// separate heap allocations.
+Status NewHugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator);
+
 }  // namespace ROCKSDB_NAMESPACE
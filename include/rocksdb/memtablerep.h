@@ -17,9 +17,11 @@
 // The factory will be passed an MemTableAllocator object when a new MemTableRep
 // is requested.
 //
-// Users can implement their own memtable representations. We include three
+// Users can implement their own memtable representations. We include these
 // types built in:
 //  - SkipListRep: This is the default; it is backed by a skip list.
+//  - BTreeRep: Backed by a B+tree with cache-line packed nodes, for
+//  write-heavy workloads where skip list search misses dominate.
 //  - HashSkipListRep: The memtable rep that is best used for keys that are
 //  structured like "prefix:suffix" where iteration within a prefix is
 //  common and iteration across different prefixes is rare. It is backed by
@@ -125,6 +127,19 @@ class MemTableRep {
     return true;
   }
 
+  // Same as ::InsertKey, but the caller knows that the key follows the key of
+  // the previous InsertKey()/InsertKeyInSortedRun() call in sort order, e.g.
+  // because both come from the same sorted WriteBatch. Implementations can
+  // use this to start the search from the previous insert position instead of
+  // from the top. It is only a hint: the key still has to be inserted
+  // correctly if it does not hold.
+  //
+  // Currently only skip-list based memtable implement the interface. Other
+  // implementations will fallback to InsertKey() by default.
+  virtual bool InsertKeyInSortedRun(KeyHandle handle) {
+    return InsertKey(handle);
+  }
+
   // Same as ::InsertWithHint, but allow concurrent write
   //
   // If hint points to nullptr, a new hint will be allocated on heap, otherwise
@@ -194,6 +209,18 @@ class MemTableRep {
   virtual void Get(const LookupKey& k, void* callback_args,
                    bool (*callback_func)(void* arg, const char* entry));
 
+  // Batched form of Get(): equivalent to calling
+  // Get(*keys[i], callback_args[i], callback_func) for every i in
+  // [0, num_keys), but allows the implementation to interleave the searches
+  // so that their cache misses overlap. Keys are typically sorted, as they
+  // come from a MultiGet batch.
+  //
+  // Default:
+  // Calls Get() for each key in turn.
+  virtual void MultiGet(size_t num_keys, const LookupKey* const* keys,
+                        void* const* callback_args,
+                        bool (*callback_func)(void* arg, const char* entry));
+
   // Same as Get() but performs data integrity validation.
   virtual Status GetAndValidate(const LookupKey& /* k */,
                                 void* /* callback_args */,
@@ -393,6 +420,33 @@ class SkipListFactory : public MemTableRepFactory {
   size_t lookahead_;
 };
 
+// This uses a B+tree whose nodes each pack many key pointers together, so a
+// lookup visits O(log_F N) contiguous nodes instead of the O(log N) randomly
+// placed nodes of a skip list, trading fewer cache misses for serialized
+// inserts. Inserts, including concurrent inserts, are serialized by a
+// reader-writer latch on the tree while lookups and iterators share it. The
+// latch is bypassed once the memtable becomes immutable.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  BTreeRepFactory();
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "BTreeRepFactory"; }
+  static const char* kNickName() { return "btree"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using MemTableRepFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
 // rare and writes are generally not issued after reads begin.
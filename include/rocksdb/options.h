@@ -746,6 +746,20 @@ struct DBOptions {
   // Default: 16
   int max_file_opening_threads = 16;
 
+  // EXPERIMENTAL
+  // If not empty, a file to keep the contents of the block cache across a
+  // restart of the DB. On close, the data and filter blocks of the live table
+  // files of this DB found in the block caches of its column families are
+  // written to this file, along with the cache keys (which are stable across
+  // DB::Open() when the files have unique ids). On the next DB::Open(), the
+  // blocks of the files still live are loaded back into the block caches,
+  // using up to max_file_opening_threads threads, until the caches are full.
+  // Blocks cached with CacheTier::kVolatileTier as lowest_used_cache_tier are
+  // not saved. Errors with the file are logged and otherwise ignored.
+  //
+  // Default: empty (disabled)
+  std::string block_cache_dump_file = "";
+
   // Once write-ahead logs exceed this size, we will start forcing the flush of
   // column families whose memtables are backed by the oldest live WAL file
   // (i.e. the ones that are causing all the space amplification). If set to 0
@@ -984,6 +998,18 @@ struct DBOptions {
   // Default: false
   bool use_direct_io_for_flush_and_compaction = false;
 
+  // If true, WAL writes and the output of flushes and compactions are queued
+  // on io_uring and written in the background, instead of being written in
+  // the calling thread. Appends return once queued, so that e.g. a compaction
+  // can build the next block while the previous one is being written, and
+  // syncs wait for all the queued writes. Only effective for buffered (non
+  // direct, non mmap) writes with the default posix FileSystem when io_uring
+  // is available; otherwise writes are synchronous as usual.
+  // Writes not yet synced may be lost on process crash, as with
+  // manual_wal_flush, but files always hold a prefix of the data appended.
+  // Default: false
+  bool use_async_io_for_writes = false;
+
   // If false, fallocate() calls are bypassed, which disables file
   // preallocation. The file space preallocation is used to increase the file
   // write/append performance. By default, RocksDB preallocates space for WAL,
@@ -1186,6 +1212,38 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // If true, the write batch group leader no longer merges the batches of its
+  // group into a single WAL record itself. It reserves the place of each
+  // batch in the record, and each writer of the group copies and checksums
+  // its own batch in parallel, before the leader writes the record. This
+  // reduces the time spent by the leader when many threads write large
+  // batches concurrently, at the cost of waking up the followers one more
+  // time. Not used with two_write_queues (or unordered_write).
+  //
+  // Default: false
+  bool enable_parallel_wal_copy = false;
+
+  // If true, writes with WriteOptions::sync == false that only need to be
+  // inserted into the memtable skip the write thread while no other write is
+  // queued. Each such write reserves its sequence numbers and its place in an
+  // in-memory WAL buffer with an atomic fetch-add, inserts its batch into the
+  // memtable concurrently with the others, and a background thread writes the
+  // buffered batches to the WAL, merged like a write group. The writes that
+  // do not qualify (sync, merges, callbacks, or while writes are slowed down
+  // or a flush is scheduled) go through the write thread, which first writes
+  // the buffered batches to the WAL.
+  //
+  // This avoids waiting for and handing off to a write group leader, at the
+  // cost of the WAL records being written in the background. So it requires
+  // manual_wal_flush, with the same guarantees: the writes are only
+  // guaranteed to be in the WAL after FlushWAL(), or after a later write goes
+  // through the write thread. It also requires
+  // allow_concurrent_memtable_write, and is not supported with
+  // enable_pipelined_write, two_write_queues or unordered_write.
+  //
+  // Default: false
+  bool enable_lock_free_wal_buffer = false;
+
   // Setting unordered_write to true trades higher write throughput with
   // relaxing the immutability guarantee of snapshots. This violates the
   // repeatability one expects from ::Get from a snapshot, as well as
@@ -1288,6 +1346,22 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<RowCache> row_cache = nullptr;
 
+  // EXPERIMENTAL
+  // A global cache for the results of short range scans. Iterators created by
+  // DB::NewIterator() with ReadOptions::scan_cache_max_entries > 0 store the
+  // first entries from each Seek() and serve later identical Seek() calls
+  // from them, without building the iterators over the memtables and files.
+  // A cached scan is used as long as no write since it can change its
+  // results: with ReadOptions::prefix_same_as_start, writes to keys with the
+  // same prefix (or to a few others sharing a hash), otherwise any write to
+  // the column family. Range deletions, file ingestion, and compactions of
+  // column families with a compaction filter or FIFO compaction invalidate
+  // all cached scans of the column family.
+  // Not used for column families with user-defined timestamps or
+  // inplace_update_support, nor with unordered_write.
+  // Default: nullptr (disabled)
+  std::shared_ptr<RowCache> scan_cache = nullptr;
+
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
   // records, ignoring a particular record or skipping replay.
@@ -1969,6 +2043,19 @@ struct ReadOptions {
   // Default: false
   bool auto_refresh_iterator_with_snapshot = false;
 
+  // EXPERIMENTAL
+  //
+  // When DBOptions::scan_cache is set and this is not 0, Seek() is served
+  // from a cached identical scan if possible. Otherwise the first
+  // `scan_cache_max_entries` entries from the seek key are read right away
+  // and inserted in the cache. Next() past those entries, and other
+  // positioning operations, go through a regular DB iterator. Meant for
+  // short, repeated scans such as the latest entries under a prefix. Scans
+  // reaching wide-column entities are not cached.
+  //
+  // Default: 0 (scan cache not used)
+  size_t scan_cache_max_entries = 0;
+
   // *** END options only relevant to iterators or scans ***
 
   // *** BEGIN options for RocksDB internal use only ***
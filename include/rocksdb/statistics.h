@@ -534,6 +534,29 @@ enum Tickers : uint32_t {
   FILE_READ_CORRUPTION_RETRY_COUNT,
   FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
 
+  // Insertions through a QuotaCache (see NewQuotaCache()) admitted above the
+  // soft limit, and not admitted because of a quota
+  BLOCK_CACHE_QUOTA_BORROWED,
+  BLOCK_CACHE_QUOTA_REJECTED,
+
+  // HugePageSlabAllocator (see NewHugePageSlabAllocator()): slabs taken into
+  // use, allocations served by the heap instead of a slab, and bytes lost to
+  // rounding up allocations to a size class
+  SLAB_ALLOCATOR_SLABS_ALLOCATED,
+  SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS,
+  SLAB_ALLOCATOR_WASTED_BYTES,
+
+  // Seeks of iterators using DBOptions::scan_cache served from the cache, or
+  // not (including when the cached scan was outdated)
+  SCAN_CACHE_HIT,
+  SCAN_CACHE_MISS,
+
+  // Point lookups answered NotFound by the negative lookup cache
+  // (negative_lookup_cache_size), and lookups not found there which then
+  // found no entry
+  NEGATIVE_LOOKUP_CACHE_HIT,
+  NEGATIVE_LOOKUP_CACHE_MISS,
+
   TICKER_ENUM_MAX
 };
 
@@ -250,6 +250,19 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but data blocks are located with a learned model
+    // (piecewise linear segments) of the last key of each block rather than a
+    // binary search on the index block. The model is much smaller than the
+    // index block and is kept in table reader memory, outside of the block
+    // cache. It is only used for tables whose block separators have the same
+    // size and, apart from a common prefix, fit in 8 bytes, such as fixed
+    // width big-endian encoded integer keys, under BytewiseComparator; other
+    // tables fall back to kBinarySearch. Lookups return the same blocks as
+    // kBinarySearch, so this is only a speed and memory optimization.
+    // Tables written with this index type cannot be read by RocksDB versions
+    // that do not support it.
+    kLearnedIndexSearch = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -258,6 +271,16 @@ struct BlockBasedTableOptions {
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
     kDataBlockBinaryAndHash = 1,  // additional hash index
+    // Additional interpolation model that predicts the restart interval of a
+    // key from the key itself, so that Seek() only binary searches the few
+    // restart intervals around the prediction. Meant for blocks with many
+    // restart intervals (large block_size and/or small
+    // block_restart_interval) whose keys are fixed width and roughly
+    // uniformly distributed under a bytewise comparator, such as big-endian
+    // integers. Blocks where the model would not narrow the search are
+    // written as kDataBlockBinarySearch. Files written with this option can
+    // not be read by RocksDB versions that predate it.
+    kDataBlockInterpolationSearch = 2,
   };
 
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
@@ -639,6 +662,12 @@ struct BlockBasedTableOptions {
     kDisable,
     // Prepopulate blocks during flush only.
     kFlushOnly,
+    // Prepopulate blocks during flush, and the data blocks written by
+    // compactions whose keys were in input data blocks found in the block
+    // cache when the compaction started. This keeps the hot parts of the
+    // data in cache across compactions, rather than having reads miss
+    // until the new files are warmed up again.
+    kFlushAndHotCompaction,
   };
 
   PrepopulateBlockCache prepopulate_block_cache =
@@ -4761,6 +4761,8 @@ class CompactionPriorityJni {
         return 0x3;
       case ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin:
         return 0x4;
+      case ROCKSDB_NAMESPACE::CompactionPri::kReadHeatAndOverlappingRatio:
+        return 0x5;
       default:
         return 0x0;  // undefined
     }
@@ -4781,6 +4783,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
       case 0x4:
         return ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin;
+      case 0x5:
+        return ROCKSDB_NAMESPACE::CompactionPri::kReadHeatAndOverlappingRatio;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -5273,6 +5277,24 @@ class TickerTypeJni {
         return -0x56;
       case ROCKSDB_NAMESPACE::Tickers::FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT:
         return -0x57;
+      case ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_QUOTA_BORROWED:
+        return -0x58;
+      case ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_QUOTA_REJECTED:
+        return -0x59;
+      case ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_SLABS_ALLOCATED:
+        return -0x5A;
+      case ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS:
+        return -0x5B;
+      case ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_WASTED_BYTES:
+        return -0x5C;
+      case ROCKSDB_NAMESPACE::Tickers::SCAN_CACHE_HIT:
+        return -0x5D;
+      case ROCKSDB_NAMESPACE::Tickers::SCAN_CACHE_MISS:
+        return -0x5E;
+      case ROCKSDB_NAMESPACE::Tickers::NEGATIVE_LOOKUP_CACHE_HIT:
+        return -0x5F;
+      case ROCKSDB_NAMESPACE::Tickers::NEGATIVE_LOOKUP_CACHE_MISS:
+        return -0x60;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -5735,6 +5757,24 @@ class TickerTypeJni {
       case -0x57:
         return ROCKSDB_NAMESPACE::Tickers::
             FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT;
+      case -0x58:
+        return ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_QUOTA_BORROWED;
+      case -0x59:
+        return ROCKSDB_NAMESPACE::Tickers::BLOCK_CACHE_QUOTA_REJECTED;
+      case -0x5A:
+        return ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_SLABS_ALLOCATED;
+      case -0x5B:
+        return ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS;
+      case -0x5C:
+        return ROCKSDB_NAMESPACE::Tickers::SLAB_ALLOCATOR_WASTED_BYTES;
+      case -0x5D:
+        return ROCKSDB_NAMESPACE::Tickers::SCAN_CACHE_HIT;
+      case -0x5E:
+        return ROCKSDB_NAMESPACE::Tickers::SCAN_CACHE_MISS;
+      case -0x5F:
+        return ROCKSDB_NAMESPACE::Tickers::NEGATIVE_LOOKUP_CACHE_HIT;
+      case -0x60:
+        return ROCKSDB_NAMESPACE::Tickers::NEGATIVE_LOOKUP_CACHE_MISS;
       case -0x54:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -6864,6 +6904,9 @@ class IndexTypeJni {
       case ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
           kBinarySearchWithFirstKey:
         return 0x3;
+      case ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
+          kLearnedIndexSearch:
+        return 0x4;
       default:
         return 0x7F;  // undefined
     }
@@ -6886,6 +6929,9 @@ class IndexTypeJni {
       case 0x3:
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
             kBinarySearchWithFirstKey;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
+            kLearnedIndexSearch;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::
@@ -6909,6 +6955,9 @@ class DataBlockIndexTypeJni {
       case ROCKSDB_NAMESPACE::BlockBasedTableOptions::DataBlockIndexType::
           kDataBlockBinaryAndHash:
         return 0x1;
+      case ROCKSDB_NAMESPACE::BlockBasedTableOptions::DataBlockIndexType::
+          kDataBlockInterpolationSearch:
+        return 0x2;
       default:
         return 0x7F;  // undefined
     }
@@ -6925,6 +6974,9 @@ class DataBlockIndexTypeJni {
       case 0x1:
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::DataBlockIndexType::
             kDataBlockBinaryAndHash;
+      case 0x2:
+        return ROCKSDB_NAMESPACE::BlockBasedTableOptions::DataBlockIndexType::
+            kDataBlockInterpolationSearch;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::BlockBasedTableOptions::DataBlockIndexType::
@@ -7388,6 +7440,8 @@ class CompactionStyleJni {
         return 0x2;
       case ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleNone:
         return 0x3;
+      case ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleLazyLevel:
+        return 0x4;
       default:
         return 0x7F;  // undefined
     }
@@ -7406,6 +7460,8 @@ class CompactionStyleJni {
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleFIFO;
       case 0x3:
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleNone;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleLazyLevel;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionStyle::kCompactionStyleLevel;
@@ -41,7 +41,13 @@ public enum CompactionPriority {
    * level. The file picking process will cycle through all the files in a
    * round-robin manner.
    */
-  RoundRobin((byte)0x4);
+  RoundRobin((byte)0x4),
+
+  /**
+   * Like {@link #MinOverlappingRatio}, but files read more than the rest of
+   * their level, according to the sampled file reads, are compacted first.
+   */
+  ReadHeatAndOverlappingRatio((byte)0x5);
 
 
   private final byte value;
@@ -25,6 +25,9 @@ package org.rocksdb;
  *   Compaction jobs are submitted
  *   {@link RocksDB#compactFiles(CompactionOptions, ColumnFamilyHandle, java.util.List, int, int,
  * CompactionJobInfo)} ()}.</li>
+ *   <li><strong>LAZY_LEVEL</strong> - (EXPERIMENTAL) Lazy leveling
+ *   compaction style, a hybrid of tiered compaction for the recent data and
+ *   leveled compaction for the last level.</li>
  * </ol>
  *
  * @see <a
@@ -38,7 +41,8 @@ public enum CompactionStyle {
   LEVEL((byte) 0x0),
   UNIVERSAL((byte) 0x1),
   FIFO((byte) 0x2),
-  NONE((byte) 0x3);
+  NONE((byte) 0x3),
+  LAZY_LEVEL((byte) 0x4);
 
   private final byte value;
 
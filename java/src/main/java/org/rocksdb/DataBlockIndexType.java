@@ -18,7 +18,12 @@ public enum DataBlockIndexType {
   /**
    * additional hash index
    */
-  kDataBlockBinaryAndHash((byte)0x1);
+  kDataBlockBinaryAndHash((byte)0x1),
+
+  /**
+   * additional interpolation search model
+   */
+  kDataBlockInterpolationSearch((byte)0x2);
 
   private final byte value;
 
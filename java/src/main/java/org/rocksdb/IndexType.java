@@ -36,7 +36,14 @@ public enum IndexType {
    * Makes the index significantly bigger (2x or more), especially when keys
    * are long.
    */
-  kBinarySearchWithFirstKey((byte) 3);
+  kBinarySearchWithFirstKey((byte) 3),
+  /**
+   * Like {@link #kBinarySearch}, but data blocks are located with a learned
+   * model of the last key of each block. Only used for tables with fixed width
+   * keys (such as big-endian encoded integers) under the bytewise comparator;
+   * other tables fall back to {@link #kBinarySearch}.
+   */
+  kLearnedIndexSearch((byte) 4);
 
   /**
    * Returns the byte value of the enumerations value
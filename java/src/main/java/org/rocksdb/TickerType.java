@@ -882,6 +882,24 @@ public enum TickerType {
 
     FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT((byte) -0x57),
 
+    BLOCK_CACHE_QUOTA_BORROWED((byte) -0x58),
+
+    BLOCK_CACHE_QUOTA_REJECTED((byte) -0x59),
+
+    SLAB_ALLOCATOR_SLABS_ALLOCATED((byte) -0x5A),
+
+    SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS((byte) -0x5B),
+
+    SLAB_ALLOCATOR_WASTED_BYTES((byte) -0x5C),
+
+    SCAN_CACHE_HIT((byte) -0x5D),
+
+    SCAN_CACHE_MISS((byte) -0x5E),
+
+    NEGATIVE_LOOKUP_CACHE_HIT((byte) -0x5F),
+
+    NEGATIVE_LOOKUP_CACHE_MISS((byte) -0x60),
+
     TICKER_ENUM_MAX((byte) -0x54);
 
     private final byte value;
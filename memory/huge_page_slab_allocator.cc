@@ -0,0 +1,314 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/huge_page_slab_allocator.h"
+
+#include <algorithm>
+
+#include "monitoring/statistics_impl.h"
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/options_type.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+static std::unordered_map<std::string, OptionTypeInfo>
+    huge_page_slab_type_info = {
+        {"capacity",
+         {offsetof(struct HugePageSlabAllocatorOptions, capacity),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"slab_size",
+         {offsetof(struct HugePageSlabAllocatorOptions, slab_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"size_classes",
+         OptionTypeInfo::Vector<size_t>(
+             offsetof(struct HugePageSlabAllocatorOptions, size_classes),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kSizeT})},
+};
+
+// Four size classes per power of two, so that no more than a fifth of an
+// object is lost to rounding up its size, from 256B to 64KB. Uncompressed
+// blocks are usually a bit larger than the configured block_size.
+std::vector<size_t> DefaultSizeClasses() {
+  std::vector<size_t> size_classes;
+  for (size_t pow2 = 256; pow2 < 64 * 1024; pow2 *= 2) {
+    for (size_t quarters = 4; quarters < 8; quarters++) {
+      size_classes.push_back(pow2 * quarters / 4);
+    }
+  }
+  size_classes.push_back(64 * 1024);
+  return size_classes;
+}
+}  // namespace
+
+HugePageSlabAllocator::HugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& options)
+    : options_(options), mapping_(MemMapping::AllocateLazyZeroed(0)) {
+  RegisterOptions(&options_, &huge_page_slab_type_info);
+}
+
+HugePageSlabAllocator::~HugePageSlabAllocator() = default;
+
+Status HugePageSlabAllocator::PrepareOptions(
+    const ConfigOptions& config_options) {
+  if (base_ != nullptr) {
+    // Already prepared
+    return Status::OK();
+  }
+  if (options_.slab_size < 4096 ||
+      (options_.slab_size & (options_.slab_size - 1)) != 0) {
+    return Status::InvalidArgument(
+        "slab_size must be a power of two of at least 4KB");
+  }
+  if (options_.capacity < options_.slab_size) {
+    return Status::InvalidArgument("capacity must be at least slab_size");
+  }
+  std::vector<size_t> sizes = options_.size_classes.empty()
+                                  ? DefaultSizeClasses()
+                                  : options_.size_classes;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (sizes[i] < sizeof(void*) || sizes[i] > options_.slab_size ||
+        (i > 0 && sizes[i] <= sizes[i - 1])) {
+      return Status::InvalidArgument(
+          "size_classes must be increasing, between the size of a pointer "
+          "and slab_size");
+    }
+  }
+  Status s = MemoryAllocator::PrepareOptions(config_options);
+  if (!s.ok()) {
+    return s;
+  }
+
+  slab_size_ = options_.slab_size;
+  num_slabs_ = static_cast<uint32_t>(
+      std::min(options_.capacity / slab_size_, size_t{kNone - 1}));
+  // Extra room to align the slabs to slab_size, so that (when slab_size is
+  // the huge page size) each slab is one page
+  size_t length = (size_t{num_slabs_} + 1) * slab_size_;
+  mapping_ = MemMapping::AllocateHuge(length);
+  explicit_huge_pages_ = mapping_.Get() != nullptr;
+  if (!explicit_huge_pages_) {
+    // No huge pages reserved (or not supported). Lazily mapped, with
+    // transparent huge pages where available.
+    mapping_ = MemMapping::AllocateLazyZeroed(length);
+    if (mapping_.Get() == nullptr) {
+      return Status::MemoryLimit("Failed to map HugePageSlabAllocator memory");
+    }
+  }
+  uintptr_t addr = reinterpret_cast<uintptr_t>(mapping_.Get());
+  uintptr_t aligned = (addr + slab_size_ - 1) & ~uintptr_t{slab_size_ - 1};
+  base_ = reinterpret_cast<char*>(aligned);
+#if defined(MADV_HUGEPAGE) && !defined(OS_WIN)
+  if (!explicit_huge_pages_) {
+    madvise(base_, size_t{num_slabs_} * slab_size_, MADV_HUGEPAGE);
+  }
+#endif
+
+  slabs_.reset(new SlabMeta[num_slabs_]);
+  num_size_classes_ = sizes.size();
+  size_classes_.reset(new SizeClass[num_size_classes_]);
+  for (size_t i = 0; i < num_size_classes_; i++) {
+    size_classes_[i].size = sizes[i];
+  }
+  return Status::OK();
+}
+
+size_t HugePageSlabAllocator::GetSizeClass(size_t size) const {
+  for (size_t i = 0; i < num_size_classes_; i++) {
+    if (size_classes_[i].size >= size) {
+      return size_classes_[i].size;
+    }
+  }
+  return 0;
+}
+
+void* HugePageSlabAllocator::FallbackAllocate(size_t size) {
+  RecordTick(options_.statistics.get(), SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS);
+  return new char[size];
+}
+
+void* HugePageSlabAllocator::Allocate(size_t size) {
+  assert(base_ != nullptr);
+  // Binary search for the size class
+  size_t lo = 0;
+  size_t hi = num_size_classes_;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (size_classes_[mid].size < size) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == num_size_classes_) {
+    return FallbackAllocate(size);
+  }
+  const uint32_t class_index = static_cast<uint32_t>(lo);
+  SizeClass& size_class = size_classes_[class_index];
+
+  void* result = nullptr;
+  {
+    MutexLock l(&size_class.mutex);
+    uint32_t slab = size_class.partial_slabs;
+    if (slab == kNone) {
+      slab = NewSlab();
+      if (slab == kNone) {
+        return FallbackAllocate(size);
+      }
+      SlabMeta& meta = slabs_[slab];
+      meta.size_class = class_index;
+      LinkPartial(size_class, slab);
+      size_class.num_slabs++;
+      RecordTick(options_.statistics.get(), SLAB_ALLOCATOR_SLABS_ALLOCATED);
+    }
+    SlabMeta& meta = slabs_[slab];
+    if (meta.free_list != nullptr) {
+      result = meta.free_list;
+      meta.free_list = *static_cast<void**>(result);
+    } else {
+      result = SlabAddress(slab) + meta.used_bytes;
+      meta.used_bytes += static_cast<uint32_t>(size_class.size);
+    }
+    meta.num_objects++;
+    size_class.num_objects++;
+    if (meta.free_list == nullptr &&
+        meta.used_bytes + size_class.size > slab_size_) {
+      // Full
+      UnlinkPartial(size_class, slab);
+    }
+  }
+  RecordTick(options_.statistics.get(), SLAB_ALLOCATOR_WASTED_BYTES,
+             size_class.size - size);
+  return result;
+}
+
+void HugePageSlabAllocator::Deallocate(void* p) {
+  uint32_t slab = SlabOf(p);
+  if (slab == kNone) {
+    delete[] static_cast<char*>(p);
+    return;
+  }
+  SlabMeta& meta = slabs_[slab];
+  SizeClass& size_class = size_classes_[meta.size_class];
+  bool free_slab = false;
+  {
+    MutexLock l(&size_class.mutex);
+    bool was_full = meta.free_list == nullptr &&
+                    meta.used_bytes + size_class.size > slab_size_;
+    *static_cast<void**>(p) = meta.free_list;
+    meta.free_list = p;
+    meta.num_objects--;
+    size_class.num_objects--;
+    if (meta.num_objects == 0) {
+      if (!was_full) {
+        UnlinkPartial(size_class, slab);
+      }
+      size_class.num_slabs--;
+      meta = SlabMeta();
+      free_slab = true;
+    } else if (was_full) {
+      LinkPartial(size_class, slab);
+    }
+  }
+  if (free_slab) {
+    FreeSlab(slab);
+  }
+}
+
+size_t HugePageSlabAllocator::UsableSize(void* p,
+                                         size_t allocation_size) const {
+  uint32_t slab = SlabOf(p);
+  if (slab == kNone) {
+    return allocation_size;
+  }
+  return size_classes_[slabs_[slab].size_class].size;
+}
+
+uint32_t HugePageSlabAllocator::SlabOf(const void* p) const {
+  const char* addr = static_cast<const char*>(p);
+  if (addr < base_ || addr >= base_ + size_t{num_slabs_} * slab_size_) {
+    return kNone;
+  }
+  return static_cast<uint32_t>(static_cast<size_t>(addr - base_) /
+                               slab_size_);
+}
+
+uint32_t HugePageSlabAllocator::NewSlab() {
+  MutexLock l(&free_slabs_mutex_);
+  if (!free_slabs_.empty()) {
+    uint32_t slab = free_slabs_.back();
+    free_slabs_.pop_back();
+    return slab;
+  }
+  if (next_new_slab_ < num_slabs_) {
+    return next_new_slab_++;
+  }
+  return kNone;
+}
+
+void HugePageSlabAllocator::FreeSlab(uint32_t slab) {
+  // The memory stays mapped, for reuse by any size class
+  MutexLock l(&free_slabs_mutex_);
+  free_slabs_.push_back(slab);
+}
+
+void HugePageSlabAllocator::LinkPartial(SizeClass& size_class, uint32_t slab) {
+  SlabMeta& meta = slabs_[slab];
+  meta.prev = kNone;
+  meta.next = size_class.partial_slabs;
+  if (meta.next != kNone) {
+    slabs_[meta.next].prev = slab;
+  }
+  size_class.partial_slabs = slab;
+}
+
+void HugePageSlabAllocator::UnlinkPartial(SizeClass& size_class,
+                                          uint32_t slab) {
+  SlabMeta& meta = slabs_[slab];
+  if (meta.prev != kNone) {
+    slabs_[meta.prev].next = meta.next;
+  } else {
+    assert(size_class.partial_slabs == slab);
+    size_class.partial_slabs = meta.next;
+  }
+  if (meta.next != kNone) {
+    slabs_[meta.next].prev = meta.prev;
+  }
+  meta.prev = kNone;
+  meta.next = kNone;
+}
+
+HugePageSlabAllocator::Stats HugePageSlabAllocator::GetStats() const {
+  Stats stats;
+  stats.explicit_huge_pages = explicit_huge_pages_;
+  for (size_t i = 0; i < num_size_classes_; i++) {
+    SizeClass& size_class = size_classes_[i];
+    MutexLock l(&size_class.mutex);
+    stats.slabs_in_use += size_class.num_slabs;
+    stats.object_bytes += size_class.num_objects * size_class.size;
+  }
+  return stats;
+}
+
+Status NewHugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  std::unique_ptr<MemoryAllocator> allocator(
+      new HugePageSlabAllocator(options));
+  Status s = allocator->PrepareOptions(ConfigOptions());
+  if (s.ok()) {
+    memory_allocator->reset(allocator.release());
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,109 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "port/mmap.h"
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+#include "utilities/memory_allocators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A slab allocator for the similarly sized buffers of the block cache. See
+// HugePageSlabAllocatorOptions.
+//
+// The whole `capacity` is mapped once (with explicit huge pages if available,
+// otherwise asking for transparent huge pages) and divided into slabs of
+// `slab_size` bytes. Each slab in use holds objects of a single size class,
+// handed out from a free list, or from the never used tail of the slab. A
+// slab left without objects goes back to a shared list of free slabs, for use
+// by any size class. Allocations larger than the largest size class, or not
+// fitting in the mapping, fall back to the heap.
+class HugePageSlabAllocator : public BaseMemoryAllocator {
+ public:
+  explicit HugePageSlabAllocator(const HugePageSlabAllocatorOptions& options);
+  ~HugePageSlabAllocator() override;
+
+  static const char* kClassName() { return "HugePageSlabAllocator"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  struct Stats {
+    // Slabs currently holding at least one object
+    size_t slabs_in_use = 0;
+    // Total size of the objects in those slabs, by size class. The rest of
+    // their memory (slabs_in_use * slab_size - object_bytes) is free but only
+    // usable by objects of the same size class.
+    size_t object_bytes = 0;
+    // Whether the mapping uses explicit huge pages (MAP_HUGETLB), as opposed
+    // to transparent huge pages when the kernel can provide them
+    bool explicit_huge_pages = false;
+  };
+  Stats GetStats() const;
+
+  // The smallest size class of at least `size`, or 0 if there is none
+  size_t GetSizeClass(size_t size) const;
+
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  struct SlabMeta {
+    uint32_t size_class = kNone;
+    uint32_t num_objects = 0;
+    // Bytes of the slab ever used by objects; free space beyond
+    uint32_t used_bytes = 0;
+    // List of freed objects, linked through their first bytes
+    void* free_list = nullptr;
+    // Links in the list of slabs of a size class with room for more objects
+    uint32_t prev = kNone;
+    uint32_t next = kNone;
+  };
+
+  struct ALIGN_AS(CACHE_LINE_SIZE) SizeClass {
+    size_t size = 0;
+    port::Mutex mutex;
+    // Head of the list of slabs with room for more objects
+    uint32_t partial_slabs = kNone;
+    size_t num_slabs = 0;
+    size_t num_objects = 0;
+  };
+
+  // Returns kNone if the mapping is full
+  uint32_t NewSlab();
+  void FreeSlab(uint32_t slab);
+  void LinkPartial(SizeClass& size_class, uint32_t slab);
+  void UnlinkPartial(SizeClass& size_class, uint32_t slab);
+  char* SlabAddress(uint32_t slab) const { return base_ + slab * slab_size_; }
+  // Slab of an address in the mapping, or kNone
+  uint32_t SlabOf(const void* p) const;
+  void* FallbackAllocate(size_t size);
+
+  HugePageSlabAllocatorOptions options_;
+  size_t slab_size_ = 0;
+  MemMapping mapping_;
+  bool explicit_huge_pages_ = false;
+  char* base_ = nullptr;
+  uint32_t num_slabs_ = 0;
+  std::unique_ptr<SlabMeta[]> slabs_;
+  std::unique_ptr<SizeClass[]> size_classes_;
+  size_t num_size_classes_ = 0;
+
+  // Slabs never used or freed, guarded by free_slabs_mutex_
+  port::Mutex free_slabs_mutex_;
+  std::vector<uint32_t> free_slabs_;
+  uint32_t next_new_slab_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
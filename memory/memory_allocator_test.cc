@@ -6,12 +6,14 @@
 
 #include <cstdio>
 
+#include "memory/huge_page_slab_allocator.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
+#include "rocksdb/statistics.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "test_util/testharness.h"
 #include "utilities/memory_allocators.h"
@@ -209,9 +211,109 @@ TEST_F(CreateMemoryAllocatorTest, NewJemallocNodumpAllocator) {
   ASSERT_EQ(opts->limit_tcache_size, jopts.limit_tcache_size);
 }
 
+TEST_F(CreateMemoryAllocatorTest, NewHugePageSlabAllocator) {
+  HugePageSlabAllocatorOptions hopts;
+  std::shared_ptr<MemoryAllocator> allocator;
+
+  hopts.capacity = 4 * 64 * 1024;
+  hopts.slab_size = 64 * 1024;
+  hopts.size_classes = {1024, 4096, 8192};
+  hopts.statistics = CreateDBStatistics();
+
+  ASSERT_NOK(NewHugePageSlabAllocator(hopts, nullptr));
+  // Invalid options
+  hopts.slab_size = 3 * 1024 * 1024;
+  ASSERT_NOK(NewHugePageSlabAllocator(hopts, &allocator));
+  hopts.slab_size = 64 * 1024;
+  hopts.size_classes = {4096, 1024};
+  ASSERT_NOK(NewHugePageSlabAllocator(hopts, &allocator));
+  hopts.size_classes = {1024, 128 * 1024};
+  ASSERT_NOK(NewHugePageSlabAllocator(hopts, &allocator));
+  ASSERT_EQ(allocator, nullptr);
+
+  hopts.size_classes = {1024, 4096, 8192};
+  ASSERT_OK(NewHugePageSlabAllocator(hopts, &allocator));
+  ASSERT_NE(allocator, nullptr);
+  auto opts = allocator->GetOptions<HugePageSlabAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->capacity, hopts.capacity);
+  ASSERT_EQ(opts->slab_size, hopts.slab_size);
+  ASSERT_EQ(opts->size_classes, hopts.size_classes);
+
+  auto slab = static_cast<HugePageSlabAllocator*>(allocator.get());
+  ASSERT_EQ(slab->GetSizeClass(1), 1024U);
+  ASSERT_EQ(slab->GetSizeClass(1025), 4096U);
+  ASSERT_EQ(slab->GetSizeClass(8192), 8192U);
+  ASSERT_EQ(slab->GetSizeClass(8193), 0U);
+
+  // Rounded up to the size class, wasting the rest
+  void* p = allocator->Allocate(3000);
+  ASSERT_EQ(allocator->UsableSize(p, 3000), 4096U);
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 1U);
+  ASSERT_EQ(slab->GetStats().object_bytes, 4096U);
+  ASSERT_EQ(hopts.statistics->getTickerCount(SLAB_ALLOCATOR_WASTED_BYTES),
+            4096U - 3000U);
+
+  // Objects of a size class are packed in the same slab, and freed objects
+  // reused
+  std::vector<void*> objects;
+  for (int i = 0; i < 16; i++) {
+    objects.push_back(allocator->Allocate(4096));
+  }
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 2U);
+  allocator->Deallocate(objects[0]);
+  ASSERT_EQ(allocator->Allocate(4000), objects[0]);
+  ASSERT_EQ(
+      hopts.statistics->getTickerCount(SLAB_ALLOCATOR_SLABS_ALLOCATED), 2U);
+
+  // Too large for any size class
+  void* large = allocator->Allocate(10000);
+  ASSERT_NE(large, nullptr);
+  ASSERT_EQ(allocator->UsableSize(large, 10000), 10000U);
+  ASSERT_EQ(hopts.statistics->getTickerCount(
+                SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS),
+            1U);
+  allocator->Deallocate(large);
+
+  // No slab left once all are in use
+  std::vector<void*> others = {allocator->Allocate(100)};
+  for (int i = 0; i < 8; i++) {
+    others.push_back(allocator->Allocate(8000));
+  }
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 4U);
+  void* fallback = allocator->Allocate(8000);
+  ASSERT_EQ(allocator->UsableSize(fallback, 8000), 8000U);
+  ASSERT_EQ(hopts.statistics->getTickerCount(
+                SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS),
+            2U);
+  allocator->Deallocate(fallback);
+
+  // Empty slabs are available to other size classes
+  allocator->Deallocate(p);
+  for (void* o : objects) {
+    allocator->Deallocate(o);
+  }
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 2U);
+  for (void* o : others) {
+    allocator->Deallocate(o);
+  }
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 0U);
+  ASSERT_EQ(slab->GetStats().object_bytes, 0U);
+  for (int i = 0; i < 4; i++) {
+    objects[i] = allocator->Allocate(8192);
+  }
+  ASSERT_EQ(slab->GetStats().slabs_in_use, 1U);
+  for (int i = 0; i < 4; i++) {
+    allocator->Deallocate(objects[i]);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(DefaultMemoryAllocator, MemoryAllocatorTest,
                         ::testing::Values(std::make_tuple(
                             DefaultMemoryAllocator::kClassName(), true)));
+INSTANTIATE_TEST_CASE_P(HugePageSlabAllocator, MemoryAllocatorTest,
+                        ::testing::Values(std::make_tuple(
+                            HugePageSlabAllocator::kClassName(), true)));
 #ifdef MEMKIND
 INSTANTIATE_TEST_CASE_P(
     MemkindkMemAllocator, MemoryAllocatorTest,
@@ -0,0 +1,544 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// BTreeRep is a MemTableRep backed by a B+tree whose nodes pack up to
+// kNodeSlots key pointers into a contiguous array. Compared to a skip list,
+// a lookup visits O(log_F N) nodes instead of O(log N) randomly allocated
+// nodes, so the number of dependent cache misses on the way down is much
+// smaller.
+//
+// Concurrency: all structural modifications are made while holding the
+// tree latch in exclusive mode, readers hold it in shared mode. Nodes are
+// allocated from the memtable allocator and are never freed or moved, and a
+// split always keeps the left half in the original node, so the head leaf
+// is stable. Iterators remember the leaf they are positioned in together
+// with the leaf version observed at that time; an insert into a leaf bumps
+// its version, which makes iterators relocate their (immutable) current
+// key before stepping. Once the rep is marked read-only there can be no
+// more writers and readers skip the latch entirely.
+
+#include <atomic>
+
+#include "db/memtable.h"
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/memtablerep.h"
+#include "util/mutexlock.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+class BTreeRep : public MemTableRep {
+ public:
+  // Number of keys per node. 32 key pointers make a leaf span four cache
+  // lines, which keeps the in-node binary search short while still giving
+  // a fanout high enough for a tree of height 4 to hold millions of keys.
+  static constexpr int kNodeSlots = 32;
+  // Enough for kNodeSlots^kMaxHeight keys, far beyond any memtable size.
+  static constexpr int kMaxHeight = 16;
+
+  struct Node {
+    bool is_leaf;
+    int num_keys;
+  };
+
+  struct LeafNode : public Node {
+    // Incremented whenever keys changes, see Iterator::Resync().
+    uint64_t version;
+    LeafNode* prev;
+    LeafNode* next;
+    const char* keys[kNodeSlots];
+  };
+
+  // keys[i] is the smallest key of the subtree rooted at children[i + 1].
+  struct InnerNode : public Node {
+    const char* keys[kNodeSlots];
+    Node* children[kNodeSlots + 1];
+  };
+
+  BTreeRep(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+      : MemTableRep(allocator), cmp_(compare), immutable_(false) {
+    head_ = NewLeaf();
+    tail_ = head_;
+    root_ = head_;
+  }
+
+  void Insert(KeyHandle handle) override {
+    bool ok = InsertKey(handle);
+    (void)ok;
+    assert(ok);
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    WriteLock l(&mu_);
+    LeafNode* unused;
+    return InsertLocked(static_cast<const char*>(handle), &unused);
+  }
+
+  void InsertWithHint(KeyHandle handle, void** hint) override {
+    bool ok = InsertKeyWithHint(handle, hint);
+    (void)ok;
+    assert(ok);
+  }
+
+  // The hint is the leaf that received the previous insert. It is allocated
+  // from the memtable allocator and therefore owned by the rep.
+  bool InsertKeyWithHint(KeyHandle handle, void** hint) override {
+    assert(hint != nullptr);
+    WriteLock l(&mu_);
+    LeafNode* leaf = static_cast<LeafNode*>(*hint);
+    bool res = InsertHintedLocked(static_cast<const char*>(handle), &leaf);
+    *hint = leaf;
+    return res;
+  }
+
+  void InsertWithHintConcurrently(KeyHandle handle, void** hint) override {
+    bool ok = InsertKeyWithHintConcurrently(handle, hint);
+    (void)ok;
+    assert(ok);
+  }
+
+  // Same as InsertKeyWithHint(), but the hint is a heap allocated slot
+  // holding the leaf pointer, since concurrent hints are released by the
+  // caller with delete[].
+  bool InsertKeyWithHintConcurrently(KeyHandle handle, void** hint) override {
+    assert(hint != nullptr);
+    if (*hint == nullptr) {
+      char* raw = new char[sizeof(LeafNode*)];
+      memset(raw, 0, sizeof(LeafNode*));
+      *hint = raw;
+    }
+    LeafNode** slot = reinterpret_cast<LeafNode**>(*hint);
+    WriteLock l(&mu_);
+    return InsertHintedLocked(static_cast<const char*>(handle), slot);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    bool ok = InsertKeyConcurrently(handle);
+    (void)ok;
+    assert(ok);
+  }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    return InsertKey(handle);
+  }
+
+  bool Contains(const char* key) const override {
+    ReadGuard g(this);
+    LeafNode* leaf = FindLeaf(key);
+    int i = LowerBound(leaf, key);
+    return i < leaf->num_keys && cmp_(leaf->keys[i], key) == 0;
+  }
+
+  void MarkReadOnly() override {
+    // Wait for any in-flight reader or writer that still uses the latch.
+    WriteLock l(&mu_);
+    immutable_.store(true, std::memory_order_release);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    Iterator iter(this);
+    Slice dummy_slice;
+    for (iter.Seek(dummy_slice, k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  void UniqueRandomSample(const uint64_t num_entries,
+                          const uint64_t target_sample_size,
+                          std::unordered_set<const char*>* entries) override {
+    entries->clear();
+    assert(target_sample_size > 0);
+    assert(num_entries > 0);
+    // Selection sampling over one ordered pass: entry i is picked with
+    // probability (samples left) / (entries left).
+    Random* rnd = Random::GetTLSInstance();
+    Iterator iter(this);
+    uint64_t counter = 0, num_samples_left = target_sample_size;
+    for (iter.SeekToFirst(); iter.Valid() && num_samples_left > 0 &&
+                             counter < num_entries;
+         iter.Next(), counter++) {
+      if (rnd->Next() % (num_entries - counter) < num_samples_left) {
+        entries->insert(iter.key());
+        num_samples_left--;
+      }
+    }
+  }
+
+  ~BTreeRep() override = default;
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const BTreeRep* rep)
+        : rep_(rep), leaf_(nullptr), idx_(0), version_(0), key_(nullptr) {}
+
+    ~Iterator() override = default;
+
+    bool Valid() const override { return key_ != nullptr; }
+
+    const char* key() const override {
+      assert(Valid());
+      return key_;
+    }
+
+    void Next() override {
+      assert(Valid());
+      ReadGuard g(rep_);
+      Resync();
+      SetPosition(leaf_, idx_ + 1);
+    }
+
+    void Prev() override {
+      assert(Valid());
+      ReadGuard g(rep_);
+      Resync();
+      if (idx_ > 0) {
+        SetPosition(leaf_, idx_ - 1);
+      } else {
+        LeafNode* prev = leaf_->prev;
+        SetPosition(prev, prev == nullptr ? 0 : prev->num_keys - 1);
+      }
+    }
+
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* target = memtable_key != nullptr
+                               ? memtable_key
+                               : EncodeKey(&tmp_, user_key);
+      ReadGuard g(rep_);
+      LeafNode* leaf = rep_->FindLeaf(target);
+      SetPosition(leaf, rep_->LowerBound(leaf, target));
+    }
+
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      const char* target = memtable_key != nullptr
+                               ? memtable_key
+                               : EncodeKey(&tmp_, user_key);
+      ReadGuard g(rep_);
+      LeafNode* leaf = rep_->FindLeaf(target);
+      int i = rep_->UpperBound(leaf->keys, leaf->num_keys, target);
+      if (i > 0) {
+        SetPosition(leaf, i - 1);
+      } else {
+        LeafNode* prev = leaf->prev;
+        SetPosition(prev, prev == nullptr ? 0 : prev->num_keys - 1);
+      }
+    }
+
+    void SeekToFirst() override {
+      ReadGuard g(rep_);
+      SetPosition(rep_->head_, 0);
+    }
+
+    void SeekToLast() override {
+      ReadGuard g(rep_);
+      LeafNode* tail = rep_->tail_;
+      SetPosition(tail, tail->num_keys - 1);
+    }
+
+   private:
+    // Positions the iterator at leaf->keys[idx], moving on to the next leaf
+    // when idx is one past the end. A null leaf or an empty tree makes the
+    // iterator invalid.
+    // REQUIRES: tree latch held in shared mode (or rep immutable)
+    void SetPosition(LeafNode* leaf, int idx) {
+      if (leaf != nullptr && idx >= leaf->num_keys) {
+        leaf = leaf->next;
+        idx = 0;
+      }
+      if (leaf == nullptr || idx < 0 || leaf->num_keys == 0) {
+        leaf_ = nullptr;
+        key_ = nullptr;
+        return;
+      }
+      leaf_ = leaf;
+      idx_ = idx;
+      version_ = leaf->version;
+      key_ = leaf->keys[idx];
+    }
+
+    // Re-establishes leaf_/idx_ for key_ if the leaf was modified since the
+    // iterator was positioned. Keys only ever move to a newly split right
+    // sibling, so if key_ is no longer in leaf_ it is found from the root.
+    // REQUIRES: tree latch held in shared mode (or rep immutable)
+    void Resync() {
+      if (leaf_->version == version_) {
+        return;
+      }
+      LeafNode* leaf = leaf_;
+      int i = rep_->LowerBound(leaf, key_);
+      if (i >= leaf->num_keys || rep_->cmp_(leaf->keys[i], key_) != 0) {
+        leaf = rep_->FindLeaf(key_);
+        i = rep_->LowerBound(leaf, key_);
+      }
+      assert(i < leaf->num_keys && leaf->keys[i] == key_);
+      leaf_ = leaf;
+      idx_ = i;
+      version_ = leaf->version;
+    }
+
+    const BTreeRep* rep_;
+    LeafNode* leaf_;
+    int idx_;
+    uint64_t version_;
+    const char* key_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(BTreeRep::Iterator))
+                      : operator new(sizeof(BTreeRep::Iterator));
+    return new (mem) BTreeRep::Iterator(this);
+  }
+
+ private:
+  // Takes the tree latch in shared mode unless the rep is immutable.
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const BTreeRep* rep)
+        : mu_(rep->immutable_.load(std::memory_order_acquire) ? nullptr
+                                                              : &rep->mu_) {
+      if (mu_ != nullptr) {
+        mu_->ReadLock();
+      }
+    }
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+    ~ReadGuard() {
+      if (mu_ != nullptr) {
+        mu_->ReadUnlock();
+      }
+    }
+
+   private:
+    port::RWMutex* const mu_;
+  };
+
+  LeafNode* NewLeaf() {
+    char* mem = allocator_->AllocateAligned(sizeof(LeafNode));
+    LeafNode* leaf = new (mem) LeafNode();
+    leaf->is_leaf = true;
+    leaf->num_keys = 0;
+    leaf->version = 0;
+    leaf->prev = nullptr;
+    leaf->next = nullptr;
+    return leaf;
+  }
+
+  InnerNode* NewInner() {
+    char* mem = allocator_->AllocateAligned(sizeof(InnerNode));
+    InnerNode* inner = new (mem) InnerNode();
+    inner->is_leaf = false;
+    inner->num_keys = 0;
+    return inner;
+  }
+
+  // Returns the first index i in keys[0, n) with keys[i] >= key.
+  int LowerBound(const LeafNode* leaf, const char* key) const {
+    int lo = 0, hi = leaf->num_keys;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cmp_(leaf->keys[mid], key) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Returns the first index i in keys[0, n) with keys[i] > key.
+  int UpperBound(const char* const* keys, int n, const char* key) const {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cmp_(keys[mid], key) <= 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  // Returns the leaf whose key range contains key. If path is not null, the
+  // inner nodes visited and the child slot taken in each are recorded, and
+  // *depth is set to the number of inner levels.
+  // REQUIRES: tree latch held (or rep immutable)
+  LeafNode* FindLeaf(const char* key, InnerNode** path = nullptr,
+                     int* slots = nullptr, int* depth = nullptr) const {
+    Node* node = root_;
+    int d = 0;
+    while (!node->is_leaf) {
+      InnerNode* inner = static_cast<InnerNode*>(node);
+      int i = UpperBound(inner->keys, inner->num_keys, key);
+      if (path != nullptr) {
+        assert(d < kMaxHeight);
+        path[d] = inner;
+        slots[d] = i;
+      }
+      d++;
+      node = inner->children[i];
+      PREFETCH(node, 0, 1);
+    }
+    if (depth != nullptr) {
+      *depth = d;
+    }
+    return static_cast<LeafNode*>(node);
+  }
+
+  // Tries to insert into the hinted leaf without a root-to-leaf descent,
+  // which is valid when key falls in the leaf's key range and the leaf has
+  // room. Otherwise falls back to InsertLocked(). Updates *leaf_hint with
+  // the leaf that received the key.
+  // REQUIRES: tree latch held in exclusive mode
+  bool InsertHintedLocked(const char* key, LeafNode** leaf_hint) {
+    LeafNode* leaf = *leaf_hint;
+    if (leaf != nullptr && leaf->num_keys > 0 && leaf->num_keys < kNodeSlots &&
+        (leaf->prev == nullptr || cmp_(leaf->keys[0], key) <= 0) &&
+        (leaf->next == nullptr || cmp_(key, leaf->next->keys[0]) < 0)) {
+      int i = LowerBound(leaf, key);
+      if (i < leaf->num_keys && cmp_(leaf->keys[i], key) == 0) {
+        return false;
+      }
+      InsertIntoLeaf(leaf, i, key);
+      return true;
+    }
+    return InsertLocked(key, leaf_hint);
+  }
+
+  // Returns false without modifying the tree if an equal key already exists.
+  // REQUIRES: tree latch held in exclusive mode
+  bool InsertLocked(const char* key, LeafNode** inserted_leaf) {
+    InnerNode* path[kMaxHeight];
+    int slots[kMaxHeight];
+    int depth = 0;
+    LeafNode* leaf = FindLeaf(key, path, slots, &depth);
+    int i = LowerBound(leaf, key);
+    if (i < leaf->num_keys && cmp_(leaf->keys[i], key) == 0) {
+      *inserted_leaf = leaf;
+      return false;
+    }
+    if (leaf->num_keys < kNodeSlots) {
+      InsertIntoLeaf(leaf, i, key);
+      *inserted_leaf = leaf;
+      return true;
+    }
+
+    // Split the leaf, keeping the lower half in place.
+    LeafNode* right = NewLeaf();
+    const int keep = kNodeSlots / 2;
+    right->num_keys = kNodeSlots - keep;
+    memcpy(right->keys, leaf->keys + keep, right->num_keys * sizeof(char*));
+    leaf->num_keys = keep;
+    leaf->version++;
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (leaf->next != nullptr) {
+      leaf->next->prev = right;
+    } else {
+      tail_ = right;
+    }
+    leaf->next = right;
+    if (i <= keep) {
+      InsertIntoLeaf(leaf, i, key);
+      *inserted_leaf = leaf;
+    } else {
+      InsertIntoLeaf(right, i - keep, key);
+      *inserted_leaf = right;
+    }
+
+    // Propagate the new separator upwards, splitting inner nodes as needed.
+    const char* sep = right->keys[0];
+    Node* new_child = right;
+    for (int d = depth - 1; d >= 0; d--) {
+      InnerNode* parent = path[d];
+      int slot = slots[d];
+      if (parent->num_keys < kNodeSlots) {
+        InsertIntoInner(parent, slot, sep, new_child);
+        return true;
+      }
+      // Split a full inner node around its middle separator, which moves up
+      // to the next level rather than being copied.
+      const char* keys[kNodeSlots + 1];
+      Node* children[kNodeSlots + 2];
+      memcpy(keys, parent->keys, slot * sizeof(char*));
+      keys[slot] = sep;
+      memcpy(keys + slot + 1, parent->keys + slot,
+             (kNodeSlots - slot) * sizeof(char*));
+      memcpy(children, parent->children, (slot + 1) * sizeof(Node*));
+      children[slot + 1] = new_child;
+      memcpy(children + slot + 2, parent->children + slot + 1,
+             (kNodeSlots - slot) * sizeof(Node*));
+      const int mid = (kNodeSlots + 1) / 2;
+      InnerNode* sibling = NewInner();
+      parent->num_keys = mid;
+      memcpy(parent->keys, keys, mid * sizeof(char*));
+      memcpy(parent->children, children, (mid + 1) * sizeof(Node*));
+      sibling->num_keys = kNodeSlots - mid;
+      memcpy(sibling->keys, keys + mid + 1, sibling->num_keys * sizeof(char*));
+      memcpy(sibling->children, children + mid + 1,
+             (sibling->num_keys + 1) * sizeof(Node*));
+      sep = keys[mid];
+      new_child = sibling;
+    }
+
+    // The root itself was split.
+    InnerNode* new_root = NewInner();
+    new_root->num_keys = 1;
+    new_root->keys[0] = sep;
+    new_root->children[0] = root_;
+    new_root->children[1] = new_child;
+    root_ = new_root;
+    return true;
+  }
+
+  void InsertIntoLeaf(LeafNode* leaf, int i, const char* key) {
+    assert(leaf->num_keys < kNodeSlots);
+    memmove(leaf->keys + i + 1, leaf->keys + i,
+            (leaf->num_keys - i) * sizeof(char*));
+    leaf->keys[i] = key;
+    leaf->num_keys++;
+    leaf->version++;
+  }
+
+  void InsertIntoInner(InnerNode* inner, int slot, const char* sep,
+                       Node* child) {
+    assert(inner->num_keys < kNodeSlots);
+    memmove(inner->keys + slot + 1, inner->keys + slot,
+            (inner->num_keys - slot) * sizeof(char*));
+    memmove(inner->children + slot + 2, inner->children + slot + 1,
+            (inner->num_keys - slot) * sizeof(Node*));
+    inner->keys[slot] = sep;
+    inner->children[slot + 1] = child;
+    inner->num_keys++;
+  }
+
+  const MemTableRep::KeyComparator& cmp_;
+  mutable port::RWMutex mu_;
+  std::atomic<bool> immutable_;
+  Node* root_;
+  LeafNode* head_;
+  LeafNode* tail_;
+};
+
+}  // namespace
+
+BTreeRepFactory::BTreeRepFactory() = default;
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BTreeRep(compare, allocator);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
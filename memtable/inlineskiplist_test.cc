@@ -9,8 +9,10 @@
 
 #include "memtable/inlineskiplist.h"
 
+#include <algorithm>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 #include "memory/concurrent_arena.h"
 #include "rocksdb/env.h"
@@ -78,6 +80,14 @@ class InlineSkipTest : public testing::Test {
     return res;
   }
 
+  bool InsertInSortedRun(TestInlineSkipList* list, Key key) {
+    char* buf = list->AllocateKey(sizeof(Key));
+    memcpy(buf, &key, sizeof(Key));
+    bool res = list->InsertInSortedRun(buf);
+    keys_.insert(key);
+    return res;
+  }
+
   void Validate(TestInlineSkipList* list) {
     // Check keys exist.
     for (Key key : keys_) {
@@ -212,6 +222,49 @@ TEST_F(InlineSkipTest, InsertAndLookup) {
   }
 }
 
+TEST_F(InlineSkipTest, SeekBatch) {
+  const int N = 2000;
+  const int R = 5000;
+  Random rnd(301);
+  ConcurrentArena arena;
+  TestComparator cmp;
+  InlineSkipList<TestComparator> list(cmp, &arena);
+  std::set<Key> keys;
+  for (int i = 0; i < N; i++) {
+    Key key = rnd.Next() % R;
+    if (keys.insert(key).second) {
+      char* buf = list.AllocateKey(sizeof(Key));
+      memcpy(buf, &key, sizeof(Key));
+      list.Insert(buf);
+    }
+  }
+
+  // Batch sizes both below and above the number of searches kept in flight,
+  // with targets past the last key included.
+  for (size_t batch_size : {1, 7, 16, 33, 100}) {
+    std::vector<Key> targets(batch_size);
+    std::vector<const char*> encoded(batch_size);
+    std::vector<InlineSkipList<TestComparator>::Iterator> iters(
+        batch_size, InlineSkipList<TestComparator>::Iterator(&list));
+    std::vector<InlineSkipList<TestComparator>::Iterator*> iter_ptrs;
+    for (size_t i = 0; i < batch_size; i++) {
+      targets[i] = rnd.Next() % (R + 10);
+      encoded[i] = Encode(&targets[i]);
+      iter_ptrs.push_back(&iters[i]);
+    }
+    list.SeekBatch(batch_size, encoded.data(), iter_ptrs.data());
+    for (size_t i = 0; i < batch_size; i++) {
+      auto expected = keys.lower_bound(targets[i]);
+      if (expected == keys.end()) {
+        ASSERT_FALSE(iters[i].Valid());
+      } else {
+        ASSERT_TRUE(iters[i].Valid());
+        ASSERT_EQ(*expected, Decode(iters[i].key()));
+      }
+    }
+  }
+}
+
 TEST_F(InlineSkipTest, InsertWithHint_Sequential) {
   const int N = 100000;
   Arena arena;
@@ -309,6 +362,45 @@ TEST_F(InlineSkipTest, InsertWithHint_CompatibleWithInsertWithoutHint) {
   Validate(&list);
 }
 
+TEST_F(InlineSkipTest, InsertInSortedRun) {
+  const int N = 1000;
+  const size_t kBatchSize = 100;
+  Random rnd(534);
+  Arena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  std::unordered_set<Key> used;
+  void* hint = nullptr;
+  for (int i = 0; i < N; i++) {
+    // Sorted batches of random keys, interleaved with unsorted inserts and
+    // inserts through an unrelated hint that leave the splice stale.
+    std::vector<Key> batch;
+    while (batch.size() < kBatchSize) {
+      Key key = rnd.Next();
+      if (used.insert(key).second) {
+        batch.push_back(key);
+      }
+    }
+    std::sort(batch.begin(), batch.end());
+    for (size_t j = 0; j < batch.size(); j++) {
+      if (j == 0) {
+        Insert(&list, batch[j]);
+      } else {
+        ASSERT_TRUE(InsertInSortedRun(&list, batch[j]));
+      }
+    }
+    Key key = (Key{1} << 32) + i;
+    if (used.insert(key).second) {
+      if (i % 2 == 0) {
+        Insert(&list, key);
+      } else {
+        InsertWithHint(&list, key, &hint);
+      }
+    }
+  }
+  Validate(&list);
+}
+
 #if !defined(ROCKSDB_VALGRIND_RUN) || defined(ROCKSDB_FULL_VALGRIND_RUN)
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
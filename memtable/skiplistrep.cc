@@ -3,6 +3,7 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 //
+#include <array>
 #include <random>
 
 #include "db/memtable.h"
@@ -10,6 +11,7 @@
 #include "memtable/inlineskiplist.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/utilities/options_type.h"
+#include "util/autovector.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -47,6 +49,10 @@ class SkipListRep : public MemTableRep {
     return skip_list_.Insert(static_cast<char*>(handle));
   }
 
+  bool InsertKeyInSortedRun(KeyHandle handle) override {
+    return skip_list_.InsertInSortedRun(static_cast<char*>(handle));
+  }
+
   void InsertWithHint(KeyHandle handle, void** hint) override {
     skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
   }
@@ -92,6 +98,36 @@ class SkipListRep : public MemTableRep {
     }
   }
 
+  void MultiGet(size_t num_keys, const LookupKey* const* keys,
+                void* const* callback_args,
+                bool (*callback_func)(void* arg, const char* entry)) override {
+    using ListIterator =
+        InlineSkipList<const MemTableRep::KeyComparator&>::Iterator;
+    constexpr size_t kBatchSize = 32;
+    autovector<ListIterator, kBatchSize> iters;
+    std::array<ListIterator*, kBatchSize> iter_ptrs;
+    std::array<const char*, kBatchSize> targets;
+    for (size_t base = 0; base < num_keys; base += kBatchSize) {
+      const size_t n = std::min(kBatchSize, num_keys - base);
+      iters.clear();
+      for (size_t i = 0; i < n; ++i) {
+        iters.emplace_back(&skip_list_);
+        targets[i] = keys[base + i]->memtable_key().data();
+      }
+      for (size_t i = 0; i < n; ++i) {
+        iter_ptrs[i] = &iters[i];
+      }
+      skip_list_.SeekBatch(n, targets.data(), iter_ptrs.data());
+      for (size_t i = 0; i < n; ++i) {
+        ListIterator& iter = iters[i];
+        for (; iter.Valid() &&
+               callback_func(callback_args[base + i], iter.key());
+             iter.Next()) {
+        }
+      }
+    }
+  }
+
   Status GetAndValidate(const LookupKey& k, void* callback_args,
                         bool (*callback_func)(void* arg, const char* entry),
                         bool allow_data_in_errors) override {
@@ -704,6 +704,94 @@ static const uint64_t DBGetNum = 10000l;
 BENCHMARK(DBGet)->Threads(1)->Iterations(DBGetNum)->Apply(DBGetArguments);
 BENCHMARK(DBGet)->Threads(8)->Iterations(DBGetNum / 8)->Apply(DBGetArguments);
 
+static void DBMultiGetInMemtable(benchmark::State& state) {
+  const uint64_t kDataLen = 64 << 20;  // 64MB
+  const uint64_t kValueLen = 64;
+  const uint64_t kNumKeys = kDataLen / kValueLen;
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  bool negative_query = state.range(1);
+
+  // setup DB
+  static std::unique_ptr<DB> db;
+
+  Options options;
+  // Make memtable large enough that automatic flush will not be triggered,
+  // so that every lookup is served by the memtable.
+  options.write_buffer_size = 2 * kDataLen;
+
+  auto rnd = Random(301 + state.thread_index());
+
+  if (state.thread_index() == 0) {
+    KeyGenerator kg_seq(kNumKeys);
+    SetupDB(state, options, &db, "DBMultiGetInMemtable");
+
+    // load db
+    auto write_opts = WriteOptions();
+    write_opts.disableWAL = true;
+    for (uint64_t i = 0; i < kNumKeys; i++) {
+      Status s = db->Put(write_opts, kg_seq.Next(),
+                         rnd.RandomString(static_cast<int>(kValueLen)));
+      if (!s.ok()) {
+        state.SkipWithError(s.ToString().c_str());
+      }
+    }
+  }
+
+  KeyGenerator kg_rnd(&rnd, kNumKeys);
+  std::vector<std::string> key_bufs(batch_size);
+  std::vector<Slice> keys(batch_size);
+  std::vector<PinnableSlice> values(batch_size);
+  std::vector<Status> statuses(batch_size);
+  size_t not_found = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < batch_size; i++) {
+      key_bufs[i] = (negative_query ? kg_rnd.NextNonExist() : kg_rnd.Next())
+                        .ToString();
+      keys[i] = key_bufs[i];
+      values[i].Reset();
+    }
+    db->MultiGet(ReadOptions(), db->DefaultColumnFamily(), batch_size,
+                 keys.data(), values.data(), statuses.data());
+    for (size_t i = 0; i < batch_size; i++) {
+      if (statuses[i].IsNotFound()) {
+        not_found++;
+      } else if (!statuses[i].ok()) {
+        state.SkipWithError(statuses[i].ToString().c_str());
+      }
+    }
+  }
+
+  state.counters["neg_qu_pct"] = benchmark::Counter(
+      static_cast<double>(not_found * 100) / batch_size,
+      benchmark::Counter::kAvgIterations);
+  state.counters["keys_per_second"] =
+      benchmark::Counter(static_cast<double>(batch_size),
+                         benchmark::Counter::kIsIterationInvariantRate);
+
+  if (state.thread_index() == 0) {
+    TeardownDB(state, db, options, kg_rnd);
+  }
+}
+
+static void DBMultiGetInMemtableArguments(benchmark::internal::Benchmark* b) {
+  for (int batch_size : {1, 8, 32, 64}) {
+    for (bool negative_query : {false, true}) {
+      b->Args({batch_size, negative_query});
+    }
+  }
+  b->ArgNames({"batch_size", "negative_query"});
+}
+
+static const uint64_t DBMultiGetInMemtableNum = 10000l;
+BENCHMARK(DBMultiGetInMemtable)
+    ->Threads(1)
+    ->Iterations(DBMultiGetInMemtableNum)
+    ->Apply(DBMultiGetInMemtableArguments);
+BENCHMARK(DBMultiGetInMemtable)
+    ->Threads(8)
+    ->Iterations(DBMultiGetInMemtableNum / 8)
+    ->Apply(DBMultiGetInMemtableArguments);
+
 static void SimpleGetWithPerfContext(benchmark::State& state) {
   // setup DB
   static std::unique_ptr<DB> db;
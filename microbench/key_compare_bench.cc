@@ -0,0 +1,120 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Micro-benchmark of the key comparison kernels in util/key_compare.h against
+// the memcmp() based Slice::compare() and Slice::difference_offset(), over
+// different key length distributions.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/slice.h"
+#include "util/key_compare.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Pairs of keys sharing a random prefix, like neighboring keys met during a
+// binary search or a merge, so that comparisons have to look past it.
+class KeyPairs {
+ public:
+  // Key lengths are uniform in [min_len, max_len].
+  KeyPairs(size_t min_len, size_t max_len) {
+    Random rnd(301);
+    for (size_t i = 0; i < kNumPairs; ++i) {
+      size_t len =
+          min_len + rnd.Uniform(static_cast<int>(max_len - min_len + 1));
+      std::string a = rnd.RandomBinaryString(static_cast<int>(len));
+      std::string b = a;
+      if (len > 0) {
+        // Mostly differ near the end, some are equal.
+        size_t pos = len - 1 - rnd.Uniform(static_cast<int>(len / 4 + 1));
+        if (!rnd.OneIn(8)) {
+          b[pos] = static_cast<char>(b[pos] + 1 + rnd.Uniform(255));
+        }
+      }
+      keys_.push_back(std::move(a));
+      keys_.push_back(std::move(b));
+    }
+  }
+
+  Slice first(size_t i) const { return keys_[2 * (i % kNumPairs)]; }
+  Slice second(size_t i) const { return keys_[2 * (i % kNumPairs) + 1]; }
+
+ private:
+  static constexpr size_t kNumPairs = 4096;
+  std::vector<std::string> keys_;
+};
+
+// benchmark arguments:
+// 0. min key length
+// 1. max key length
+static void KeyLengthArguments(benchmark::internal::Benchmark* b) {
+  for (const auto& lens : std::vector<std::pair<int64_t, int64_t>>{
+           {8, 8}, {16, 16}, {24, 24}, {40, 40}, {100, 100}, {8, 64}}) {
+    b->Args({lens.first, lens.second});
+  }
+  b->ArgNames({"min_len", "max_len"});
+}
+
+static void SliceCompare(benchmark::State& state) {
+  KeyPairs pairs(state.range(0), state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pairs.first(i).compare(pairs.second(i)));
+    ++i;
+  }
+}
+BENCHMARK(SliceCompare)->Apply(KeyLengthArguments);
+
+static void KernelCompare(benchmark::State& state) {
+  KeyPairs pairs(state.range(0), state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BytewiseCompare(pairs.first(i), pairs.second(i)));
+    ++i;
+  }
+}
+BENCHMARK(KernelCompare)->Apply(KeyLengthArguments);
+
+static void BytewiseComparatorCompare(benchmark::State& state) {
+  KeyPairs pairs(state.range(0), state.range(1));
+  const Comparator* cmp = BytewiseComparator();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cmp->Compare(pairs.first(i), pairs.second(i)));
+    ++i;
+  }
+}
+BENCHMARK(BytewiseComparatorCompare)->Apply(KeyLengthArguments);
+
+static void SliceDifferenceOffset(benchmark::State& state) {
+  KeyPairs pairs(state.range(0), state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        pairs.first(i).difference_offset(pairs.second(i)));
+    ++i;
+  }
+}
+BENCHMARK(SliceDifferenceOffset)->Apply(KeyLengthArguments);
+
+static void KernelSharedPrefixLength(benchmark::State& state) {
+  KeyPairs pairs(state.range(0), state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        SharedPrefixLength(pairs.first(i), pairs.second(i)));
+    ++i;
+  }
+}
+BENCHMARK(KernelSharedPrefixLength)->Apply(KeyLengthArguments);
+
+}  // namespace ROCKSDB_NAMESPACE
+
+BENCHMARK_MAIN();
@@ -270,6 +270,16 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.file.read.corruption.retry.count"},
     {FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
      "rocksdb.file.read.corruption.retry.success.count"},
+    {BLOCK_CACHE_QUOTA_BORROWED, "rocksdb.block.cache.quota.borrowed"},
+    {BLOCK_CACHE_QUOTA_REJECTED, "rocksdb.block.cache.quota.rejected"},
+    {SLAB_ALLOCATOR_SLABS_ALLOCATED, "rocksdb.slab.allocator.slabs.allocated"},
+    {SLAB_ALLOCATOR_FALLBACK_ALLOCATIONS,
+     "rocksdb.slab.allocator.fallback.allocations"},
+    {SLAB_ALLOCATOR_WASTED_BYTES, "rocksdb.slab.allocator.wasted.bytes"},
+    {SCAN_CACHE_HIT, "rocksdb.scan.cache.hit"},
+    {SCAN_CACHE_MISS, "rocksdb.scan.cache.miss"},
+    {NEGATIVE_LOOKUP_CACHE_HIT, "rocksdb.negative.lookup.cache.hit"},
+    {NEGATIVE_LOOKUP_CACHE_MISS, "rocksdb.negative.lookup.cache.miss"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -343,6 +343,23 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}}};
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    lazy_level_compaction_options_type_info = {
+        {"size_ratio",
+         {offsetof(struct CompactionOptionsLazyLevel, size_ratio),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_sorted_runs",
+         {offsetof(struct CompactionOptionsLazyLevel, max_sorted_runs),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_sorted_runs_per_level",
+         OptionTypeInfo::Vector<int>(
+             offsetof(struct CompactionOptionsLazyLevel,
+                      max_sorted_runs_per_level),
+             OptionVerificationType::kNormal, OptionTypeFlags::kMutable,
+             {0, OptionType::kInt})}};
+
 static std::unordered_map<std::string, OptionTypeInfo>
     cf_mutable_options_type_info = {
         {"report_bg_io_stats",
@@ -545,6 +562,12 @@ static std::unordered_map<std::string, OptionTypeInfo>
              &universal_compaction_options_type_info,
              offsetof(struct MutableCFOptions, compaction_options_universal),
              OptionVerificationType::kNormal, OptionTypeFlags::kMutable)},
+        {"compaction_options_lazy_level",
+         OptionTypeInfo::Struct(
+             "compaction_options_lazy_level",
+             &lazy_level_compaction_options_type_info,
+             offsetof(struct MutableCFOptions, compaction_options_lazy_level),
+             OptionVerificationType::kNormal, OptionTypeFlags::kMutable)},
         {"ttl",
          {offsetof(struct MutableCFOptions, ttl), OptionType::kUInt64T,
           OptionVerificationType::kNormal, OptionTypeFlags::kMutable}},
@@ -870,6 +893,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableCFOptions, persist_user_defined_timestamps),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kCompareLoose}},
+        {"negative_lookup_cache_size",
+         {offsetof(struct ImmutableCFOptions, negative_lookup_cache_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_pipeline_buffer_size",
+         {offsetof(struct ImmutableCFOptions, compaction_pipeline_buffer_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_copy_data_blocks",
+         {offsetof(struct ImmutableCFOptions, compaction_copy_data_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kCFOptionsName = "ColumnFamilyOptions";
@@ -1011,7 +1046,11 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       sst_partitioner_factory(cf_options.sst_partitioner_factory),
       blob_cache(cf_options.blob_cache),
       persist_user_defined_timestamps(
-          cf_options.persist_user_defined_timestamps) {}
+          cf_options.persist_user_defined_timestamps),
+      negative_lookup_cache_size(cf_options.negative_lookup_cache_size),
+      compaction_pipeline_buffer_size(
+          cf_options.compaction_pipeline_buffer_size),
+      compaction_copy_data_blocks(cf_options.compaction_copy_data_blocks) {}
 
 ImmutableOptions::ImmutableOptions() : ImmutableOptions(Options()) {}
 
@@ -1079,7 +1118,8 @@ void MutableCFOptions::RefreshDerivedOptions(int num_levels,
                                              CompactionStyle compaction_style) {
   max_file_size.resize(num_levels);
   for (int i = 0; i < num_levels; ++i) {
-    if (i == 0 && compaction_style == kCompactionStyleUniversal) {
+    if (i == 0 && (compaction_style == kCompactionStyleUniversal ||
+                   compaction_style == kCompactionStyleLazyLevel)) {
       max_file_size[i] = ULLONG_MAX;
     } else if (i > 1) {
       max_file_size[i] = MultiplyCheckOverflow(max_file_size[i - 1],
@@ -1210,6 +1250,23 @@ void MutableCFOptions::Dump(Logger* log) const {
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
 
+  // Lazy Level Compaction Options
+  ROCKS_LOG_INFO(log, "compaction_options_lazy_level.size_ratio : %u",
+                 compaction_options_lazy_level.size_ratio);
+  ROCKS_LOG_INFO(log, "compaction_options_lazy_level.max_sorted_runs : %d",
+                 compaction_options_lazy_level.max_sorted_runs);
+  result = "";
+  for (const auto m : compaction_options_lazy_level.max_sorted_runs_per_level) {
+    snprintf(buf, sizeof(buf), "%d, ", m);
+    result += buf;
+  }
+  if (result.size() >= 2) {
+    result.resize(result.size() - 2);
+  }
+  ROCKS_LOG_INFO(log,
+                 "compaction_options_lazy_level.max_sorted_runs_per_level : %s",
+                 result.c_str());
+
   // Blob file related options
   ROCKS_LOG_INFO(log, "                        enable_blob_files: %s",
                  enable_blob_files ? "true" : "false");
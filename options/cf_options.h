@@ -84,6 +84,12 @@ struct ImmutableCFOptions {
   std::shared_ptr<Cache> blob_cache;
 
   bool persist_user_defined_timestamps;
+
+  size_t negative_lookup_cache_size;
+
+  size_t compaction_pipeline_buffer_size;
+
+  bool compaction_copy_data_blocks;
 };
 
 struct ImmutableOptions : public ImmutableDBOptions, public ImmutableCFOptions {
@@ -140,6 +146,7 @@ struct MutableCFOptions {
             options.max_bytes_for_level_multiplier_additional),
         compaction_options_fifo(options.compaction_options_fifo),
         compaction_options_universal(options.compaction_options_universal),
+        compaction_options_lazy_level(options.compaction_options_lazy_level),
         preclude_last_level_data_seconds(
             options.preclude_last_level_data_seconds),
         preserve_internal_time_seconds(options.preserve_internal_time_seconds),
@@ -304,6 +311,7 @@ struct MutableCFOptions {
   std::vector<int> max_bytes_for_level_multiplier_additional;
   CompactionOptionsFIFO compaction_options_fifo;
   CompactionOptionsUniversal compaction_options_universal;
+  CompactionOptionsLazyLevel compaction_options_lazy_level;
   uint64_t preclude_last_level_data_seconds;
   uint64_t preserve_internal_time_seconds;
 
@@ -79,6 +79,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       compaction_pri(options.compaction_pri),
       compaction_options_universal(options.compaction_options_universal),
       compaction_options_fifo(options.compaction_options_fifo),
+      compaction_options_lazy_level(options.compaction_options_lazy_level),
       max_sequential_skip_in_iterations(
           options.max_sequential_skip_in_iterations),
       memtable_factory(options.memtable_factory),
@@ -113,7 +114,10 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
       prepopulate_blob_cache(options.prepopulate_blob_cache),
-      persist_user_defined_timestamps(options.persist_user_defined_timestamps) {
+      persist_user_defined_timestamps(options.persist_user_defined_timestamps),
+      negative_lookup_cache_size(options.negative_lookup_cache_size),
+      compaction_pipeline_buffer_size(options.compaction_pipeline_buffer_size),
+      compaction_copy_data_blocks(options.compaction_copy_data_blocks) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -358,6 +362,20 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_HEADER(log, "Options.compaction_options_fifo.allow_compaction: %d",
                    compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_HEADER(log,
+                   "Options.compaction_options_lazy_level.size_ratio: %u",
+                   compaction_options_lazy_level.size_ratio);
+  ROCKS_LOG_HEADER(log,
+                   "Options.compaction_options_lazy_level.max_sorted_runs: %d",
+                   compaction_options_lazy_level.max_sorted_runs);
+  const auto& max_sorted_runs_per_level =
+      compaction_options_lazy_level.max_sorted_runs_per_level;
+  for (size_t i = 0; i < max_sorted_runs_per_level.size(); i++) {
+    ROCKS_LOG_HEADER(log,
+                     "Options.compaction_options_lazy_level"
+                     ".max_sorted_runs_per_level[%" ROCKSDB_PRIszt "]: %d",
+                     i, max_sorted_runs_per_level[i]);
+  }
   std::ostringstream collector_info;
   for (const auto& collector_factory : table_properties_collector_factories) {
     collector_info << collector_factory->ToString() << ';';
@@ -382,6 +400,14 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    memtable_huge_page_size);
   ROCKS_LOG_HEADER(log, "                          Options.bloom_locality: %d",
                    bloom_locality);
+  ROCKS_LOG_HEADER(
+      log, "              Options.negative_lookup_cache_size: %" ROCKSDB_PRIszt,
+      negative_lookup_cache_size);
+  ROCKS_LOG_HEADER(
+      log, "         Options.compaction_pipeline_buffer_size: %" ROCKSDB_PRIszt,
+      compaction_pipeline_buffer_size);
+  ROCKS_LOG_HEADER(log, "             Options.compaction_copy_data_blocks: %d",
+                   compaction_copy_data_blocks);
 
   ROCKS_LOG_HEADER(
       log, "                   Options.max_successive_merges: %" ROCKSDB_PRIszt,
@@ -323,6 +323,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
       {offsetof(struct DBOptions, sst_file_manager),
        sizeof(std::shared_ptr<SstFileManager>)},
       {offsetof(struct DBOptions, info_log), sizeof(std::shared_ptr<Logger>)},
+      {offsetof(struct DBOptions, block_cache_dump_file), sizeof(std::string)},
       {offsetof(struct DBOptions, statistics),
        sizeof(std::shared_ptr<Statistics>)},
       {offsetof(struct DBOptions, db_paths), sizeof(std::vector<DbPath>)},
@@ -333,6 +334,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
       {offsetof(struct DBOptions, listeners),
        sizeof(std::vector<std::shared_ptr<EventListener>>)},
       {offsetof(struct DBOptions, row_cache), sizeof(std::shared_ptr<Cache>)},
+      {offsetof(struct DBOptions, scan_cache), sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct DBOptions, wal_filter), sizeof(const WalFilter*)},
       {offsetof(struct DBOptions, file_checksum_gen_factory),
        sizeof(std::shared_ptr<FileChecksumGenFactory>)},
@@ -390,6 +392,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "table_cache_numshardbits=28;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
+                             "block_cache_dump_file=path/to/dump;"
                              "max_background_jobs=8;"
                              "max_background_compactions=33;"
                              "use_fsync=true;"
@@ -429,10 +432,13 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "allow_mmap_reads=false;"
                              "use_direct_reads=false;"
                              "use_direct_io_for_flush_and_compaction=false;"
+                             "use_async_io_for_writes=false;"
                              "max_log_file_size=4607;"
                              "advise_random_on_open=true;"
                              "fail_if_options_file_error=false;"
                              "enable_pipelined_write=false;"
+                             "enable_parallel_wal_copy=false;"
+                             "enable_lock_free_wal_buffer=false;"
                              "unordered_write=false;"
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
@@ -511,6 +517,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::vector<int>)},
       {offsetof(struct ColumnFamilyOptions, compaction_options_fifo),
        sizeof(struct CompactionOptionsFIFO)},
+      {offsetof(struct ColumnFamilyOptions, compaction_options_lazy_level),
+       sizeof(struct CompactionOptionsLazyLevel)},
       {offsetof(struct ColumnFamilyOptions, memtable_factory),
        sizeof(std::shared_ptr<MemTableRepFactory>)},
       {offsetof(struct ColumnFamilyOptions,
@@ -667,6 +675,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "compaction_options_fifo={max_table_files_size=3;allow_"
       "compaction=true;age_for_warm=0;file_temperature_age_thresholds={{"
       "temperature=kCold;age=12345}};};"
+      "compaction_options_lazy_level={size_ratio=8;max_sorted_runs=3;"
+      "max_sorted_runs_per_level=2:5};"
       "blob_cache=1M;"
       "memtable_protection_bytes_per_key=2;"
       "persist_user_defined_timestamps=true;"
@@ -674,7 +684,10 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "memtable_max_range_deletions=999999;"
       "bottommost_file_compaction_delay=7200;"
       "uncache_aggressiveness=1234;"
-      "paranoid_memory_checks=1;",
+      "paranoid_memory_checks=1;"
+      "negative_lookup_cache_size=65536;"
+      "compaction_pipeline_buffer_size=1048576;"
+      "compaction_copy_data_blocks=true;",
       new_options));
 
   ASSERT_NE(new_options->blob_cache.get(), nullptr);
@@ -698,6 +711,11 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       new_options->compaction_options_fifo.file_temperature_age_thresholds[0]
           .age,
       12345);
+  ASSERT_EQ(new_options->compaction_options_lazy_level.size_ratio, 8);
+  ASSERT_EQ(new_options->compaction_options_lazy_level.max_sorted_runs, 3);
+  ASSERT_EQ(
+      new_options->compaction_options_lazy_level.max_sorted_runs_per_level,
+      std::vector<int>({2, 5}));
 
   ColumnFamilyOptions rnd_filled_options = *new_options;
 
@@ -717,6 +735,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::vector<int>)},
       {offsetof(struct MutableCFOptions, compaction_options_fifo),
        sizeof(struct CompactionOptionsFIFO)},
+      {offsetof(struct MutableCFOptions, compaction_options_lazy_level),
+       sizeof(struct CompactionOptionsLazyLevel)},
       {offsetof(struct MutableCFOptions, compression_per_level),
        sizeof(std::vector<CompressionType>)},
       {offsetof(struct MutableCFOptions, max_file_size),
@@ -24,9 +24,41 @@
 #include "table/block_based/data_block_footer.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+// Helper routine: decodes the three varint32 of an entry header from the 8
+// bytes at "p" at once, finding the last byte of each varint from the high
+// bits of the word instead of testing the bytes one by one. Returns the size
+// of the header, or 0 if it does not fit in the 8 bytes.
+inline size_t DecodeEntryHeader(const char* p, uint32_t* shared,
+                                uint32_t* non_shared, uint32_t* value_length) {
+  const uint64_t word = DecodeFixed64(p);
+  // The last byte of a varint has its high bit clear
+  uint64_t ends = ~word & 0x8080808080808080;
+  size_t start = 0;
+  for (uint32_t* v : {shared, non_shared, value_length}) {
+    if (ends == 0) {
+      return 0;
+    }
+    const size_t end = static_cast<size_t>(CountTrailingZeroBits(ends)) / 8;
+    ends &= ends - 1;
+    const size_t len = end + 1 - start;
+    if (len > 5) {
+      return 0;
+    }
+    const uint64_t bytes =
+        (word >> (8 * start)) & ((uint64_t{1} << (8 * len)) - 1);
+    // Pack the 7-bit groups, dropping the high bits.
+    *v = static_cast<uint32_t>(
+        (bytes & 0x7f) | ((bytes >> 1) & 0x3f80) | ((bytes >> 2) & 0x1fc000) |
+        ((bytes >> 3) & 0xfe00000) | ((bytes >> 4) & 0xf0000000));
+    start = end + 1;
+  }
+  return start;
+}
+
 // Helper routine: decode the next block entry starting at "p",
 // storing the number of shared key bytes, non_shared key bytes,
 // and the length of the value in "*shared", "*non_shared", and
@@ -45,9 +77,14 @@ struct DecodeEntry {
     *shared = reinterpret_cast<const unsigned char*>(p)[0];
     *non_shared = reinterpret_cast<const unsigned char*>(p)[1];
     *value_length = reinterpret_cast<const unsigned char*>(p)[2];
+    size_t header_size;
     if ((*shared | *non_shared | *value_length) < 128) {
       // Fast path: all three values are encoded in one byte each
       p += 3;
+    } else if (limit - p >= 8 &&
+               (header_size = DecodeEntryHeader(p, shared, non_shared,
+                                                value_length)) != 0) {
+      p += header_size;
     } else {
       if ((p = GetVarint32Ptr(p, limit, shared)) == nullptr) {
         return nullptr;
@@ -82,9 +119,14 @@ struct CheckAndDecodeEntry {
     *shared = reinterpret_cast<const unsigned char*>(p)[0];
     *non_shared = reinterpret_cast<const unsigned char*>(p)[1];
     *value_length = reinterpret_cast<const unsigned char*>(p)[2];
+    size_t header_size;
     if ((*shared | *non_shared | *value_length) < 128) {
       // Fast path: all three values are encoded in one byte each
       p += 3;
+    } else if (limit - p >= 8 &&
+               (header_size = DecodeEntryHeader(p, shared, non_shared,
+                                                value_length)) != 0) {
+      p += header_size;
     } else {
       if ((p = GetVarint32Ptr(p, limit, shared)) == nullptr) {
         return nullptr;
@@ -158,11 +200,47 @@ void DataBlockIter::NextImpl() {
     return;
   }
 #endif
+  // A scan reaching the next restart interval is likely to go through it, so
+  // decode the entry headers of the interval at once.
+  if (next_decoded_entry_ == num_decoded_entries_ &&
+      restart_index_ + 1 < num_restarts_ &&
+      NextEntryOffset() == GetRestartPoint(restart_index_ + 1)) {
+    DecodeInterval();
+  }
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
   ++cur_entry_idx_;
 }
 
+void DataBlockIter::DecodeInterval() {
+  const uint32_t start = NextEntryOffset();
+  uint32_t limit = restarts_;
+  for (uint32_t i = restart_index_ + 1; i < num_restarts_; ++i) {
+    const uint32_t restart_point = GetRestartPoint(i);
+    if (restart_point > start) {
+      limit = restart_point;
+      break;
+    }
+  }
+  num_decoded_entries_ = 0;
+  next_decoded_entry_ = 0;
+  uint32_t offset = start;
+  while (offset < limit && num_decoded_entries_ < kMaxDecodedEntries) {
+    DecodedEntry& entry = decoded_entries_[num_decoded_entries_];
+    const char* p = CheckAndDecodeEntry()(data_ + offset, data_ + limit,
+                                          &entry.shared, &entry.non_shared,
+                                          &entry.value_length);
+    if (p == nullptr) {
+      // Left to ParseNextDataKey() to report
+      break;
+    }
+    entry.offset = offset;
+    entry.key_offset = static_cast<uint32_t>(p - data_);
+    offset = entry.key_offset + entry.non_shared + entry.value_length;
+    ++num_decoded_entries_;
+  }
+}
+
 void MetaBlockIter::NextImpl() {
   bool is_shared = false;
   ParseNextKey<CheckAndDecodeEntry>(&is_shared);
@@ -307,7 +385,8 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan,
+                                  data_block_interpolation_index_);
 
   if (!ok) {
     return;
@@ -514,7 +593,8 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan,
+                                  data_block_interpolation_index_);
 
   if (!ok) {
     return;
@@ -563,6 +643,8 @@ void DataBlockIter::SeekToFirstImpl() {
     return;
   }
   SeekToRestartPoint(0);
+  // Most likely a scan of the block, see NextImpl().
+  DecodeInterval();
   bool is_shared = false;
   ParseNextDataKey(&is_shared);
   cur_entry_idx_ = 0;
@@ -650,6 +732,14 @@ bool BlockIter<TValue>::ParseNextKey(bool* is_shared) {
   // Decode next entry
   uint32_t shared, non_shared, value_length;
   p = DecodeEntryFunc()(p, limit, &shared, &non_shared, &value_length);
+  return ParseDecodedKey(p, shared, non_shared, value_length, is_shared);
+}
+
+template <class TValue>
+bool BlockIter<TValue>::ParseDecodedKey(const char* p, uint32_t shared,
+                                        uint32_t non_shared,
+                                        uint32_t value_length,
+                                        bool* is_shared) {
   if (p == nullptr || raw_key_.Size() < shared) {
     CorruptionError();
     return false;
@@ -687,7 +777,20 @@ bool BlockIter<TValue>::ParseNextKey(bool* is_shared) {
 }
 
 bool DataBlockIter::ParseNextDataKey(bool* is_shared) {
-  if (ParseNextKey<DecodeEntry>(is_shared)) {
+  bool ok;
+  if (next_decoded_entry_ < num_decoded_entries_ &&
+      decoded_entries_[next_decoded_entry_].offset == NextEntryOffset()) {
+    const DecodedEntry& entry = decoded_entries_[next_decoded_entry_++];
+    current_ = entry.offset;
+    ok = ParseDecodedKey(data_ + entry.key_offset, entry.shared,
+                         entry.non_shared, entry.value_length, is_shared);
+  } else {
+    // Positioned elsewhere since the interval was decoded
+    num_decoded_entries_ = 0;
+    next_decoded_entry_ = 0;
+    ok = ParseNextKey<DecodeEntry>(is_shared);
+  }
+  if (ok) {
 #ifndef NDEBUG
     if (global_seqno_ != kDisableGlobalSequenceNumber) {
       // If we are reading a file with a global sequence number we should
@@ -824,10 +927,15 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 // key). Furthermore, `*skip_linear_scan` is set to indicate whether the
 // `*index`th restart key is the final result so that key does not need to be
 // compared again later.
+//
+// With an `interpolation_index`, the restart keys at the ends of its
+// predicted range are compared first, which shrinks the search to that range
+// when the prediction holds.
 template <class TValue>
 template <typename DecodeKeyFunc>
-bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
-                                   bool* skip_linear_scan) {
+bool BlockIter<TValue>::BinarySeek(
+    const Slice& target, uint32_t* index, bool* skip_linear_scan,
+    const DataBlockInterpolationIndex* interpolation_index) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
     // that have no keys while also having `num_restarts_ == 1`. This would
@@ -846,10 +954,9 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
   int64_t left = -1, right = num_restarts_ - 1;
-  while (left != right) {
-    // The `mid` is computed by rounding up so it lands in (`left`, `right`].
-    int64_t mid = left + (right - left + 1) / 2;
-    uint32_t region_offset = GetRestartPoint(static_cast<uint32_t>(mid));
+  // Compares the restart key at index `i` to the target into `*cmp`.
+  auto compare_restart_key = [&](int64_t i, int* cmp) {
+    uint32_t region_offset = GetRestartPoint(static_cast<uint32_t>(i));
     uint32_t shared, non_shared;
     const char* key_ptr = DecodeKeyFunc()(
         data_ + region_offset, data_ + restarts_, &shared, &non_shared);
@@ -857,9 +964,49 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
-    UpdateRawKeyAndMaybePadMinTimestamp(mid_key);
-    int cmp = CompareCurrentKey(target);
+    Slice restart_key(key_ptr, non_shared);
+    UpdateRawKeyAndMaybePadMinTimestamp(restart_key);
+    *cmp = CompareCurrentKey(target);
+    return true;
+  };
+  if (interpolation_index != nullptr) {
+    int64_t lo, hi;
+    interpolation_index->PredictRange(ExtractUserKey(target), &lo, &hi);
+    int cmp;
+    if (lo > left) {
+      if (!compare_restart_key(lo, &cmp)) {
+        return false;
+      }
+      if (cmp < 0) {
+        left = lo;
+      } else if (cmp > 0) {
+        right = lo - 1;
+      } else {
+        *skip_linear_scan = true;
+        left = right = lo;
+      }
+    }
+    if (left != right && hi < right && hi >= left) {
+      if (!compare_restart_key(hi + 1, &cmp)) {
+        return false;
+      }
+      if (cmp > 0) {
+        right = hi;
+      } else if (cmp < 0) {
+        left = hi + 1;
+      } else {
+        *skip_linear_scan = true;
+        left = right = hi + 1;
+      }
+    }
+  }
+  while (left != right) {
+    // The `mid` is computed by rounding up so it lands in (`left`, `right`].
+    int64_t mid = left + (right - left + 1) / 2;
+    int cmp;
+    if (!compare_restart_key(mid, &cmp)) {
+      return false;
+    }
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
       // blocks before "mid" are uninteresting.
@@ -1030,7 +1177,13 @@ uint32_t Block::NumRestarts() const {
     // Such check is for backward compatibility. We can ensure legacy block
     // with a vary large num_restarts i.e. >= 0x80000000 can be interpreted
     // correctly as no HashIndex even if the MSB of num_restarts is set.
-    return num_restarts;
+    //
+    // The interpolation index flag (bit 30) is not limited by block size, and
+    // a legacy block cannot have that many restarts (4GiB of restart array)
+    // unless the MSB is set as well.
+    if (IndexType() != BlockBasedTableOptions::kDataBlockInterpolationSearch) {
+      return num_restarts;
+    }
   }
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
@@ -1039,14 +1192,15 @@ uint32_t Block::NumRestarts() const {
 
 BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
   assert(size_ >= 2 * sizeof(uint32_t));
-  if (size_ > kMaxBlockSizeSupportedByHashIndex) {
-    // The check is for the same reason as that in NumRestarts()
-    return BlockBasedTableOptions::kDataBlockBinarySearch;
-  }
   uint32_t block_footer = DecodeFixed32(data_ + size_ - sizeof(uint32_t));
   uint32_t num_restarts = block_footer;
   BlockBasedTableOptions::DataBlockIndexType index_type;
   UnPackIndexTypeAndNumRestarts(block_footer, &index_type, &num_restarts);
+  if (size_ > kMaxBlockSizeSupportedByHashIndex &&
+      index_type != BlockBasedTableOptions::kDataBlockInterpolationSearch) {
+    // The check is for the same reason as that in NumRestarts()
+    return BlockBasedTableOptions::kDataBlockBinarySearch;
+  }
   return index_type;
 }
 
@@ -1102,6 +1256,25 @@ Block::Block(BlockContents&& contents, size_t read_amp_bytes_per_bit,
           break;
         }
         break;
+      case BlockBasedTableOptions::kDataBlockInterpolationSearch: {
+        if (size_ < sizeof(uint32_t) /* block footer */ +
+                        DataBlockInterpolationIndex::kSize) {
+          size_ = 0;
+          break;
+        }
+        const uint32_t model_offset = static_cast<uint32_t>(
+            size_ - sizeof(uint32_t) - DataBlockInterpolationIndex::kSize);
+        restart_offset_ = model_offset - num_restarts_ * sizeof(uint32_t);
+        if (restart_offset_ > model_offset) {
+          // model_offset is too small for NumRestarts() and therefore
+          // restart_offset_ wrapped around.
+          size_ = 0;
+          break;
+        }
+        data_block_interpolation_index_.Initialize(data_ + model_offset,
+                                                   num_restarts_);
+        break;
+      }
       default:
         size_ = 0;  // Error marker
     }
@@ -1279,6 +1452,9 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
+        data_block_interpolation_index_.Valid()
+            ? &data_block_interpolation_index_
+            : nullptr,
         protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
@@ -24,6 +24,7 @@
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_hash_index.h"
+#include "table/block_based/data_block_interpolation_index.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
 #include "test_util/sync_point.h"
@@ -288,6 +289,7 @@ class Block {
   uint32_t block_restart_interval_{0};
   uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  DataBlockInterpolationIndex data_block_interpolation_index_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -340,6 +342,9 @@ class BlockIter : public InternalIteratorBase<TValue> {
     return current_ < restarts_;
   }
 
+  // Whether the iterator is at the first entry of the block
+  bool IsAtFirstEntry() const { return current_ == 0 && Valid(); }
+
   void SeekToFirst() override final {
 #ifndef NDEBUG
     if (TEST_Corrupt_Callback("BlockIter::SeekToFirst")) return;
@@ -519,6 +524,12 @@ class BlockIter : public InternalIteratorBase<TValue> {
   template <typename DecodeEntryFunc>
   inline bool ParseNextKey(bool* is_shared);
 
+  // Same as ParseNextKey() with the entry header at current_ already decoded,
+  // `p` pointing to the key delta (nullptr if the header is corrupted).
+  inline bool ParseDecodedKey(const char* p, uint32_t shared,
+                              uint32_t non_shared, uint32_t value_length,
+                              bool* is_shared);
+
   // protection_bytes_per_key, kv_checksum, and block_restart_interval
   // are needed only for per kv checksum verification.
   void InitializeBase(const Comparator* raw_ucmp, const char* data,
@@ -665,9 +676,12 @@ class BlockIter : public InternalIteratorBase<TValue> {
   }
 
  protected:
+  // If `interpolation_index` is not null, its predicted range of restart
+  // intervals is searched first.
   template <typename DecodeKeyFunc>
-  inline bool BinarySeek(const Slice& target, uint32_t* index,
-                         bool* is_index_key_result);
+  inline bool BinarySeek(
+      const Slice& target, uint32_t* index, bool* is_index_key_result,
+      const DataBlockInterpolationIndex* interpolation_index = nullptr);
 
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
@@ -693,6 +707,7 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
+                  const DataBlockInterpolationIndex* data_block_interpolation_index,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
                   uint32_t block_restart_interval) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
@@ -703,6 +718,9 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    data_block_interpolation_index_ = data_block_interpolation_index;
+    num_decoded_entries_ = 0;
+    next_decoded_entry_ = 0;
   }
 
   Slice value() const override {
@@ -737,6 +755,8 @@ class DataBlockIter final : public BlockIter<Slice> {
     prev_entries_keys_buff_.clear();
     prev_entries_.clear();
     prev_entries_idx_ = -1;
+    num_decoded_entries_ = 0;
+    next_decoded_entry_ = 0;
   }
 
  protected:
@@ -778,7 +798,28 @@ class DataBlockIter final : public BlockIter<Slice> {
   std::vector<CachedPrevEntry> prev_entries_;
   int32_t prev_entries_idx_ = -1;
 
+  // The entry headers of the restart interval being scanned forward, decoded
+  // at once by DecodeInterval() and consumed by ParseNextDataKey().
+  struct DecodedEntry {
+    // offset of entry in block
+    uint32_t offset;
+    // offset of the key delta in block
+    uint32_t key_offset;
+    uint32_t shared;
+    uint32_t non_shared;
+    uint32_t value_length;
+  };
+  static constexpr uint32_t kMaxDecodedEntries = 32;
+  DecodedEntry decoded_entries_[kMaxDecodedEntries];
+  uint32_t num_decoded_entries_ = 0;
+  uint32_t next_decoded_entry_ = 0;
+
+  // Decodes the headers of the entries from NextEntryOffset() to the end of
+  // its restart interval, up to kMaxDecodedEntries.
+  void DecodeInterval();
+
   DataBlockHashIndex* data_block_hash_index_;
+  const DataBlockInterpolationIndex* data_block_interpolation_index_;
 
   bool SeekForGetImpl(const Slice& target);
 };
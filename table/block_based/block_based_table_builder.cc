@@ -47,6 +47,7 @@
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/format.h"
+#include "table/internal_iterator.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
 #include "util/coding.h"
@@ -357,8 +358,13 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<FilterBlockBuilder> filter_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
+  // See TableBuilderOptions::hot_key_ranges
+  const std::vector<std::pair<std::string, std::string>>* hot_key_ranges;
 
   BlockHandle pending_handle;  // Handle to add to index block
+  // Whether the index entry of the last data block, added by
+  // AddRawDataBlock(), is yet to be added, with the next key
+  bool raw_block_index_pending = false;
 
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
@@ -497,6 +503,7 @@ struct BlockBasedTableBuilder::Rep {
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
                                             !table_opt.block_align),
         reason(tbo.reason),
+        hot_key_ranges(tbo.hot_key_ranges),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
                 table_options, data_block)),
@@ -1030,6 +1037,12 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
     }
 #endif  // !NDEBUG
 
+    if (r->raw_block_index_pending) {
+      r->raw_block_index_pending = false;
+      r->index_builder->AddIndexEntry(r->last_ikey, &ikey, r->pending_handle,
+                                      &r->index_separator_scratch);
+    }
+
     auto should_flush = r->flush_block_policy->Update(ikey, value);
     if (should_flush) {
       assert(!r->data_block.empty());
@@ -1147,6 +1160,83 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
   }
 }
 
+bool BlockBasedTableBuilder::AddRawDataBlock(const RawDataBlock& block) {
+  Rep* r = rep_;
+  assert(rep_->state != Rep::State::kClosed);
+  if (!ok() || r->state != Rep::State::kUnbuffered ||
+      r->IsParallelCompressionEnabled() || r->ts_sz > 0 ||
+      block.compression_type != r->compression_type ||
+      (block.compression_type != kNoCompression &&
+       GetCompressFormatForVersion(block.format_version) !=
+           GetCompressFormatForVersion(r->table_options.format_version))) {
+    return false;
+  }
+#ifndef NDEBUG
+  if (r->props.num_entries > r->props.num_range_deletions) {
+    assert(r->internal_comparator.Compare(block.first_key,
+                                          Slice(r->last_ikey)) > 0);
+  }
+#endif  // !NDEBUG
+
+  // The index entry of the previous block can be added now that the first
+  // key of the next one is known
+  bool add_index_entry = r->raw_block_index_pending;
+  if (!r->data_block.empty()) {
+    r->first_key_in_next_block = &block.first_key;
+    Flush();
+    add_index_entry = true;
+  }
+  if (ok() && add_index_entry) {
+    r->index_builder->AddIndexEntry(r->last_ikey, &block.first_key,
+                                    r->pending_handle,
+                                    &r->index_separator_scratch);
+  }
+  r->raw_block_index_pending = false;
+
+  // The entries are still needed by the filter, the index and the property
+  // collectors
+  InternalIterator* entries = block.entries;
+  for (; ok() && entries->Valid(); entries->Next()) {
+    const Slice ikey = entries->key();
+    const Slice value = entries->value();
+    ValueType value_type;
+    SequenceNumber seq;
+    UnPackSequenceAndType(ExtractInternalKeyFooter(ikey), &seq, &value_type);
+    r->props.key_largest_seqno = std::max(r->props.key_largest_seqno, seq);
+    if (r->filter_builder != nullptr) {
+      r->filter_builder->AddWithPrevKey(
+          ExtractUserKeyAndStripTimestamp(ikey, r->ts_sz),
+          r->last_ikey.empty()
+              ? Slice{}
+              : ExtractUserKeyAndStripTimestamp(r->last_ikey, r->ts_sz));
+    }
+    r->last_ikey.assign(ikey.data(), ikey.size());
+    r->index_builder->OnKeyAdded(ikey);
+    NotifyCollectTableCollectorsOnAdd(ikey, value, r->get_offset(),
+                                      r->table_properties_collectors,
+                                      r->ioptions.logger);
+  }
+  if (!entries->status().ok()) {
+    r->SetStatus(entries->status());
+  }
+  if (!ok()) {
+    return true;
+  }
+
+  WriteMaybeCompressedBlock(block.contents, block.compression_type,
+                            &r->pending_handle, BlockType::kData);
+  if (!ok()) {
+    return true;
+  }
+  r->raw_block_index_pending = true;
+  r->props.data_size = r->get_offset();
+  ++r->props.num_data_blocks;
+  r->props.num_entries += block.num_entries;
+  r->props.raw_key_size += block.raw_key_size;
+  r->props.raw_value_size += block.raw_value_size;
+  return true;
+}
+
 void BlockBasedTableBuilder::Flush() {
   Rep* r = rep_;
   assert(rep_->state != Rep::State::kClosed);
@@ -1395,9 +1485,10 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
   handle->set_size(block_contents.size());
   assert(status().ok());
   assert(io_status().ok());
-  if (uncompressed_block_data == nullptr) {
+  // Unknown for compressed blocks copied by AddRawDataBlock(), which are not
+  // added to the block cache
+  if (uncompressed_block_data == nullptr && comp_type == kNoCompression) {
     uncompressed_block_data = &block_contents;
-    assert(comp_type == kNoCompression);
   }
 
   {
@@ -1441,6 +1532,16 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
       case BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly:
         warm_cache = (r->reason == TableFileCreationReason::kFlush);
         break;
+      case BlockBasedTableOptions::PrepopulateBlockCache::
+          kFlushAndHotCompaction:
+        // The metadata blocks of compaction outputs are cached as usual
+        // when the new files are opened
+        warm_cache =
+            (r->reason == TableFileCreationReason::kFlush) ||
+            (r->reason == TableFileCreationReason::kCompaction &&
+             is_data_block && uncompressed_block_data != nullptr &&
+             IsHotDataBlock(*uncompressed_block_data));
+        break;
       case BlockBasedTableOptions::PrepopulateBlockCache::kDisable:
         warm_cache = false;
         break;
@@ -1449,7 +1550,7 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
         assert(false);
         warm_cache = false;
     }
-    if (warm_cache) {
+    if (warm_cache && uncompressed_block_data != nullptr) {
       Status s = InsertBlockInCacheHelper(*uncompressed_block_data, handle,
                                           block_type);
       if (!s.ok()) {
@@ -1577,6 +1678,36 @@ IOStatus BlockBasedTableBuilder::io_status() const {
   return rep_->GetIOStatus();
 }
 
+bool BlockBasedTableBuilder::IsHotDataBlock(
+    const Slice& uncompressed_block_data) const {
+  const Rep* r = rep_;
+  if (r->hot_key_ranges == nullptr || r->hot_key_ranges->empty()) {
+    return false;
+  }
+  const Comparator* ucmp = r->internal_comparator.user_comparator();
+  Block reader{BlockContents{uncompressed_block_data}};
+  std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+      ucmp, kDisableGlobalSequenceNumber, nullptr /* iter */,
+      nullptr /* stats */, false /* block_contents_pinned */,
+      r->persist_user_defined_timestamps));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    return false;
+  }
+  const std::string first = ExtractUserKey(iter->key()).ToString();
+  iter->SeekToLast();
+  assert(iter->Valid());
+  const Slice last = ExtractUserKey(iter->key());
+  // The first range ending at or after the first key of the block
+  auto it = std::lower_bound(
+      r->hot_key_ranges->begin(), r->hot_key_ranges->end(), first,
+      [ucmp](const std::pair<std::string, std::string>& range,
+             const std::string& key) {
+        return ucmp->Compare(range.second, key) < 0;
+      });
+  return it != r->hot_key_ranges->end() && ucmp->Compare(it->first, last) <= 0;
+}
+
 Status BlockBasedTableBuilder::InsertBlockInCacheHelper(
     const Slice& block_contents, const BlockHandle* handle,
     BlockType block_type) {
@@ -2083,7 +2214,7 @@ Status BlockBasedTableBuilder::Finish() {
   } else {
     // To make sure properties block is able to keep the accurate size of index
     // block, we will finish writing all index entries first.
-    if (ok() && !empty_data_block) {
+    if (ok() && (!empty_data_block || r->raw_block_index_pending)) {
       r->index_builder->AddIndexEntry(
           r->last_ikey, nullptr /* no next data block */, r->pending_handle,
           &r->index_separator_scratch);
@@ -60,6 +60,11 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Add(const Slice& key, const Slice& value) override;
 
+  // Only for blocks of the same compression type, with the same compression
+  // format. Not supported with a compression dictionary, parallel
+  // compression or user-defined timestamps.
+  bool AddRawDataBlock(const RawDataBlock& block) override;
+
   // Return non-ok iff some error has been detected.
   Status status() const override;
 
@@ -142,6 +147,10 @@ class BlockBasedTableBuilder : public TableBuilder {
                                   const BlockHandle* handle,
                                   BlockType block_type);
 
+  // Whether the keys of the data block overlap
+  // TableBuilderOptions::hot_key_ranges
+  bool IsHotDataBlock(const Slice& uncompressed_block_data) const;
+
   Status InsertBlockInCompressedCache(const Slice& block_contents,
                                       const CompressionType type,
                                       const BlockHandle* handle);
@@ -8,6 +8,8 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/block_based_table_iterator.h"
 
+#include "table/block_fetcher.h"
+
 namespace ROCKSDB_NAMESPACE {
 
 void BlockBasedTableIterator::SeekToFirst() { SeekImpl(nullptr, false); }
@@ -298,6 +300,99 @@ bool BlockBasedTableIterator::NextAndGetResult(IterateResult* result) {
   return is_valid;
 }
 
+bool BlockBasedTableIterator::GetRawDataBlock(RawDataBlock* block) {
+  assert(Valid());
+  const BlockBasedTable::Rep* rep = table_->get_rep();
+  if (is_at_first_key_from_index_ || !block_iter_points_to_real_block_ ||
+      !IsIndexAtCurr() || DoesContainBlockHandles() ||
+      !block_iter_.IsAtFirstEntry() ||
+      rep->global_seqno != kDisableGlobalSequenceNumber ||
+      !rep->compression_dict_handle.IsNull() ||
+      !rep->user_defined_timestamps_persisted) {
+    return false;
+  }
+
+  // The block must only have values, of distinct user keys
+  uint64_t num_entries = 0;
+  uint64_t raw_key_size = 0;
+  uint64_t raw_value_size = 0;
+  bool copyable = true;
+  ParsedInternalKey pikey;
+  raw_block_first_key_.assign(block_iter_.key().data(),
+                              block_iter_.key().size());
+  for (; block_iter_.Valid(); block_iter_.Next()) {
+    const Slice key = block_iter_.key();
+    if (!ParseInternalKey(key, &pikey, /*log_err_key=*/false).ok() ||
+        pikey.type != kTypeValue ||
+        (num_entries > 0 &&
+         user_comparator_.Compare(ExtractUserKey(raw_block_last_key_),
+                                  pikey.user_key) >= 0)) {
+      copyable = false;
+      break;
+    }
+    ++num_entries;
+    raw_key_size += key.size();
+    raw_value_size += block_iter_.value().size();
+    raw_block_last_key_.assign(key.data(), key.size());
+  }
+  if (!block_iter_.status().ok()) {
+    // The rest of the block is corrupted, which leaves this iterator invalid
+    return false;
+  }
+  block_iter_.SeekToFirst();
+  if (!copyable) {
+    return false;
+  }
+
+  // The next block must start with another user key, which is implied by the
+  // index separator when it is a user key
+  const Slice last_user_key = ExtractUserKey(raw_block_last_key_);
+  if (rep->index_key_includes_seq &&
+      user_comparator_.Compare(index_iter_->user_key(), last_user_key) <= 0) {
+    return false;
+  }
+  if (read_options_.iterate_upper_bound != nullptr &&
+      user_comparator_.CompareWithoutTimestamp(
+          last_user_key, /*a_has_ts=*/true, *read_options_.iterate_upper_bound,
+          /*b_has_ts=*/false) >= 0) {
+    return false;
+  }
+
+  // Read the block again as stored, usually from the prefetch buffer
+  raw_block_contents_ = BlockContents();
+  BlockFetcher block_fetcher(
+      rep->file.get(), block_prefetcher_.prefetch_buffer(), rep->footer,
+      read_options_, index_iter_->value().handle, &raw_block_contents_,
+      rep->ioptions, /*do_uncompress=*/false, rep->blocks_maybe_compressed,
+      BlockType::kData, UncompressionDict::GetEmptyDict(),
+      rep->persistent_cache_options, /*memory_allocator=*/nullptr,
+      /*memory_allocator_compressed=*/nullptr, /*for_compaction=*/true);
+  if (!block_fetcher.ReadBlockContents().ok()) {
+    return false;
+  }
+
+  block->contents = raw_block_contents_.data;
+  block->compression_type = block_fetcher.get_compression_type();
+  block->format_version = rep->footer.format_version();
+  block->entries = &block_iter_;
+  block->first_key = raw_block_first_key_;
+  block->last_key = raw_block_last_key_;
+  block->num_entries = num_entries;
+  block->raw_key_size = raw_key_size;
+  block->raw_value_size = raw_value_size;
+  return true;
+}
+
+void BlockBasedTableIterator::SkipRawDataBlock() {
+  assert(block_iter_points_to_real_block_);
+  raw_block_contents_ = BlockContents();
+  // Past the last entry, wherever the entries were left
+  block_iter_.SeekToLast();
+  block_iter_.Next();
+  FindKeyForward();
+  CheckOutOfBound();
+}
+
 void BlockBasedTableIterator::Prev() {
   if (readahead_cache_lookup_ && !IsIndexAtCurr()) {
     // In case of readahead_cache_lookup_, index_iter_ has moved forward. So we
@@ -56,6 +56,8 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   void Next() final override;
   bool NextAndGetResult(IterateResult* result) override;
   void Prev() override;
+  bool GetRawDataBlock(RawDataBlock* block) override;
+  void SkipRawDataBlock() override;
   bool Valid() const override {
     return !is_out_of_bound_ &&
            (is_at_first_key_from_index_ ||
@@ -341,6 +343,11 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // `block_handles_` is lazily constructed to save CPU when it is unused
   std::unique_ptr<std::deque<BlockHandleInfo>> block_handles_;
 
+  // The block of the last successful GetRawDataBlock()
+  BlockContents raw_block_contents_;
+  std::string raw_block_first_key_;
+  std::string raw_block_last_key_;
+
   // During cache lookup to find readahead size, index_iter_ is iterated and it
   // can point to a different block. is_index_at_curr_block_ keeps track of
   // that.
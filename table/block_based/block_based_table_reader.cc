@@ -56,6 +56,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -134,6 +135,7 @@ namespace ROCKSDB_NAMESPACE {
 extern const uint64_t kBlockBasedTableMagicNumber;
 extern const std::string kHashIndexPrefixesBlock;
 extern const std::string kHashIndexPrefixesMetadataBlock;
+extern const std::string kLearnedIndexBlock;
 
 BlockBasedTable::~BlockBasedTable() {
   auto ua = rep_->uncache_aggressiveness.LoadRelaxed();
@@ -2603,6 +2605,10 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kHashIndexMetadata;
   }
 
+  if (meta_block_name == kLearnedIndexBlock) {
+    return BlockType::kLearnedIndex;
+  }
+
   if (meta_block_name == kIndexBlockName) {
     return BlockType::kIndex;
   }
@@ -2680,6 +2686,44 @@ bool BlockBasedTable::EraseFromCache(const BlockHandle& handle) const {
   return cache->Release(cache_handle, /*erase_if_last_ref=*/true);
 }
 
+Status BlockBasedTable::GetCachedKeyRanges(
+    const ReadOptions& read_options, const Slice& smallest_user_key,
+    std::vector<std::pair<std::string, std::string>>* ranges) {
+  Cache* const cache = rep_->table_options.block_cache.get();
+  if (cache == nullptr) {
+    return Status::OK();
+  }
+
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(
+      read_options, /*disable_prefix_seek=*/false, &iiter_on_stack,
+      /*get_context=*/nullptr, /*lookup_context=*/nullptr);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(iiter);
+  }
+
+  // The keys of a data block are after the index key of the block before
+  std::string prev_key = smallest_user_key.ToString();
+  bool prev_cached = false;
+  for (iiter->SeekToFirst(); iiter->Valid(); iiter->Next()) {
+    CacheKey key = GetCacheKey(rep_->base_cache_key, iiter->value().handle);
+    Cache::Handle* const cache_handle = cache->Lookup(key.AsSlice());
+    const bool cached = cache_handle != nullptr;
+    if (cached) {
+      cache->Release(cache_handle);
+      if (prev_cached) {
+        ranges->back().second = iiter->user_key().ToString();
+      } else {
+        ranges->emplace_back(prev_key, iiter->user_key().ToString());
+      }
+    }
+    prev_cached = cached;
+    prev_key = iiter->user_key().ToString();
+  }
+  return iiter->status();
+}
+
 bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
@@ -2770,6 +2814,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndexSearch: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
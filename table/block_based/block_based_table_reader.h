@@ -184,6 +184,10 @@ class BlockBasedTable : public TableReader {
   Status ApproximateKeyAnchors(const ReadOptions& read_options,
                                std::vector<Anchor>& anchors) override;
 
+  Status GetCachedKeyRanges(
+      const ReadOptions& read_options, const Slice& smallest_user_key,
+      std::vector<std::pair<std::string, std::string>>* ranges) override;
+
   bool EraseFromCache(const BlockHandle& handle) const;
 
   bool TEST_BlockInCache(const BlockHandle& handle) const;
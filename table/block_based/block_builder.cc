@@ -40,6 +40,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/data_block_footer.h"
 #include "util/coding.h"
+#include "util/key_compare.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -64,6 +65,9 @@ BlockBuilder::BlockBuilder(
       data_block_hash_index_builder_.Initialize(
           data_block_hash_table_util_ratio);
       break;
+    case BlockBasedTableOptions::kDataBlockInterpolationSearch:
+      data_block_interpolation_index_builder_.Initialize();
+      break;
     default:
       assert(0);
   }
@@ -82,6 +86,9 @@ void BlockBuilder::Reset() {
   if (data_block_hash_index_builder_.Valid()) {
     data_block_hash_index_builder_.Reset();
   }
+  if (data_block_interpolation_index_builder_.Valid()) {
+    data_block_interpolation_index_builder_.Reset();
+  }
 #ifndef NDEBUG
   add_with_last_key_called_ = false;
 #endif
@@ -136,6 +143,9 @@ Slice BlockBuilder::Finish() {
       CurrentSizeEstimate() <= kMaxBlockSizeSupportedByHashIndex) {
     data_block_hash_index_builder_.Finish(buffer_);
     index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  } else if (data_block_interpolation_index_builder_.Valid() &&
+             data_block_interpolation_index_builder_.Finish(buffer_)) {
+    index_type = BlockBasedTableOptions::kDataBlockInterpolationSearch;
   }
 
   // footer is a packed format of data_block_index_type and num_restarts
@@ -209,7 +219,7 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     counter_ = 0;
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
-    shared = key_to_persist.difference_offset(last_key_persisted);
+    shared = SharedPrefixLength(key_to_persist, last_key_persisted);
   }
 
   const size_t non_shared = key_to_persist.size() - shared;
@@ -245,6 +255,13 @@ inline void BlockBuilder::AddWithLastKeyImpl(const Slice& key,
     data_block_hash_index_builder_.Add(ExtractUserKey(key),
                                        restarts_.size() - 1);
   }
+  if (data_block_interpolation_index_builder_.Valid() && counter_ == 0) {
+    // Like above, only data blocks should be using
+    // `kDataBlockInterpolationSearch`.
+    assert(!is_user_key_);
+    data_block_interpolation_index_builder_.AddRestartKey(
+        ExtractUserKey(key_to_persist));
+  }
 
   counter_++;
   estimate_ += buffer_.size() - buffer_size;
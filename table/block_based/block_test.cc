@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <limits>
 #include <set>
 #include <string>
 #include <unordered_set>
@@ -298,8 +299,9 @@ INSTANTIATE_TEST_CASE_P(
         ::testing::Bool(), ::testing::ValuesIn(test::GetUDTTestModes()),
         ::testing::Values(
             BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash,
             BlockBasedTableOptions::DataBlockIndexType::
-                kDataBlockBinaryAndHash)));
+                kDataBlockInterpolationSearch)));
 
 // A slow and accurate version of BlockReadAmpBitmap that simply store
 // all the marked ranges in a set.
@@ -576,6 +578,137 @@ TEST_F(BlockTest, ReadAmpBitmapPow2) {
   ASSERT_EQ(BlockReadAmpBitmap(100, 35, stats.get()).GetBytesPerBit(), 32u);
 }
 
+TEST_F(BlockTest, InterpolationSearch) {
+  auto big_endian_key = [](uint64_t v) {
+    std::string k;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      k.push_back(static_cast<char>((v >> shift) & 0xff));
+    }
+    AppendInternalKeyFooter(&k, 0 /* seqno */, kTypeValue);
+    return k;
+  };
+
+  for (bool skewed : {false, true}) {
+    // Evenly spaced keys fit the model. With a few keys far away from the
+    // others it is not worth it, and the block falls back to binary search.
+    const uint64_t kNumRecords = 10000;
+    std::vector<uint64_t> user_keys;
+    for (uint64_t i = 0; i < kNumRecords; ++i) {
+      user_keys.push_back(skewed && i >= kNumRecords - 8 ? (i << 40) : i * 10);
+    }
+    // Larger than kMaxBlockSizeSupportedByHashIndex to also cover the footer
+    // of big blocks.
+    BlockBuilder builder(4 /* restart interval */, true /* use_delta_encoding */,
+                         false /* use_value_delta_encoding */,
+                         BlockBasedTableOptions::kDataBlockInterpolationSearch);
+    for (uint64_t k : user_keys) {
+      builder.Add(big_endian_key(k), "value" + std::to_string(k));
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    ASSERT_GT(contents.data.size(), kMaxBlockSizeSupportedByHashIndex);
+    Block reader(std::move(contents));
+    ASSERT_EQ(reader.IndexType(),
+              skewed ? BlockBasedTableOptions::kDataBlockBinarySearch
+                     : BlockBasedTableOptions::kDataBlockInterpolationSearch);
+    ASSERT_EQ(reader.NumRestarts(), kNumRecords / 4);
+
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        Options().comparator, kDisableGlobalSequenceNumber));
+    for (size_t i = 0; i < user_keys.size(); ++i) {
+      const uint64_t k = user_keys[i];
+      iter->Seek(big_endian_key(k));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->value().ToString(), "value" + std::to_string(k));
+
+      // Between two keys.
+      iter->Seek(big_endian_key(k + 1));
+      if (i + 1 < user_keys.size()) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), big_endian_key(user_keys[i + 1]));
+      } else {
+        ASSERT_FALSE(iter->Valid());
+      }
+      iter->SeekForPrev(big_endian_key(k + 1));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), big_endian_key(k));
+    }
+    iter->Seek(big_endian_key(0));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(iter->key(), big_endian_key(user_keys[0]));
+    iter->Seek(big_endian_key(std::numeric_limits<uint64_t>::max()));
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+  }
+}
+
+TEST_F(BlockTest, ScanWithMultiByteHeaders) {
+  // Keys and values long enough for the entry headers to take up to 3 bytes
+  // per varint, to cover the decoding of restart intervals at once.
+  Random rnd(301);
+  const int kNumRecords = 2000;
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumRecords; ++i) {
+    const size_t suffix_len = rnd.OneIn(10) ? 200 : 8;
+    std::string key = rnd.RandomString(static_cast<int>(suffix_len));
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%08d", i);
+    keys.push_back(std::string(rnd.OneIn(3) ? 150 : 1, 'k') + buf + key);
+    const int value_len = rnd.OneIn(4) ? 0 : (rnd.OneIn(3) ? 20000 : 130);
+    values.push_back(rnd.RandomString(value_len));
+  }
+  std::sort(keys.begin(), keys.end());
+  for (auto& key : keys) {
+    AppendInternalKeyFooter(&key, 0 /* seqno */, kTypeValue);
+  }
+
+  for (int restart_interval : {1, 3, 16, 50}) {
+    BlockBuilder builder(restart_interval);
+    for (int i = 0; i < kNumRecords; ++i) {
+      builder.Add(keys[i], values[i]);
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents));
+    std::unique_ptr<DataBlockIter> iter(reader.NewDataIterator(
+        Options().comparator, kDisableGlobalSequenceNumber));
+
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, kNumRecords);
+
+    // Mixed with seeks and moving backward.
+    for (int j = 0; j < 200; ++j) {
+      i = static_cast<int>(rnd.Uniform(kNumRecords));
+      iter->Seek(keys[i]);
+      for (int k = 0; k < 40 && i < kNumRecords; ++k) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(iter->key(), keys[i]);
+        ASSERT_EQ(iter->value(), values[i]);
+        if (k % 7 == 6 && i > 0) {
+          iter->Prev();
+          --i;
+        } else {
+          iter->Next();
+          ++i;
+        }
+      }
+      ASSERT_OK(iter->status());
+    }
+    i = kNumRecords - 1;
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), --i) {
+      ASSERT_EQ(iter->key(), keys[i]);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, -1);
+  }
+}
+
 class IndexBlockTest
     : public testing::Test,
       public testing::WithParamInterface<
@@ -1030,9 +1163,16 @@ TEST_F(BlockPerKVChecksumTest, ApproximateMemory) {
 
 std::string GetDataBlockIndexTypeStr(
     BlockBasedTableOptions::DataBlockIndexType t) {
-  return t == BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch
-             ? "BinarySearch"
-             : "BinaryAndHash";
+  switch (t) {
+    case BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch:
+      return "BinarySearch";
+    case BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash:
+      return "BinaryAndHash";
+    case BlockBasedTableOptions::DataBlockIndexType::
+        kDataBlockInterpolationSearch:
+      return "InterpolationSearch";
+  }
+  return "Unknown";
 }
 
 class DataBlockKVChecksumTest
@@ -1084,8 +1224,9 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(
         ::testing::Values(
             BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash,
             BlockBasedTableOptions::DataBlockIndexType::
-                kDataBlockBinaryAndHash),
+                kDataBlockInterpolationSearch),
         ::testing::Values(0, 1, 2, 4, 8) /* protection_bytes_per_key */,
         ::testing::Values(1, 2, 3, 8, 16) /* restart_interval */,
         ::testing::Values(false, true)) /* delta_encoding */,
@@ -1489,8 +1630,9 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(
         ::testing::Values(
             BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch,
+            BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash,
             BlockBasedTableOptions::DataBlockIndexType::
-                kDataBlockBinaryAndHash),
+                kDataBlockInterpolationSearch),
         ::testing::Values(4, 8) /* block_protection_bytes_per_key */,
         ::testing::Values(1, 3, 8, 16) /* restart_interval */,
         ::testing::Values(false, true)),
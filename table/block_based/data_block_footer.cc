@@ -15,11 +15,15 @@ namespace ROCKSDB_NAMESPACE {
 
 const int kDataBlockIndexTypeBitShift = 31;
 
-// 0x7FFFFFFF
-const uint32_t kMaxNumRestarts = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// Flag for kDataBlockInterpolationSearch. A restart array with this many
+// entries would not fit in a block, so legacy blocks never have it set.
+const int kDataBlockInterpolationBitShift = 30;
 
-// 0x7FFFFFFF
-const uint32_t kNumRestartsMask = (1u << kDataBlockIndexTypeBitShift) - 1u;
+// 0x3FFFFFFF
+const uint32_t kMaxNumRestarts = (1u << kDataBlockInterpolationBitShift) - 1u;
+
+// 0x3FFFFFFF
+const uint32_t kNumRestartsMask = (1u << kDataBlockInterpolationBitShift) - 1u;
 
 uint32_t PackIndexTypeAndNumRestarts(
     BlockBasedTableOptions::DataBlockIndexType index_type,
@@ -31,6 +35,9 @@ uint32_t PackIndexTypeAndNumRestarts(
   uint32_t block_footer = num_restarts;
   if (index_type == BlockBasedTableOptions::kDataBlockBinaryAndHash) {
     block_footer |= 1u << kDataBlockIndexTypeBitShift;
+  } else if (index_type ==
+             BlockBasedTableOptions::kDataBlockInterpolationSearch) {
+    block_footer |= 1u << kDataBlockInterpolationBitShift;
   } else if (index_type != BlockBasedTableOptions::kDataBlockBinarySearch) {
     assert(0);
   }
@@ -45,6 +52,8 @@ void UnPackIndexTypeAndNumRestarts(
   if (index_type) {
     if (block_footer & 1u << kDataBlockIndexTypeBitShift) {
       *index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    } else if (block_footer & 1u << kDataBlockInterpolationBitShift) {
+      *index_type = BlockBasedTableOptions::kDataBlockInterpolationSearch;
     } else {
       *index_type = BlockBasedTableOptions::kDataBlockBinarySearch;
     }
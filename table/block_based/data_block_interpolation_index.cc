@@ -0,0 +1,122 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/data_block_interpolation_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "util/coding.h"
+#include "util/key_compare.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+uint64_t DataBlockInterpolationIndex::KeyToInt(const Slice& user_key,
+                                               uint32_t prefix_len) {
+  uint64_t v = 0;
+  for (size_t i = prefix_len; i < size_t{prefix_len} + 8; ++i) {
+    v <<= 8;
+    if (i < user_key.size()) {
+      v |= static_cast<unsigned char>(user_key[i]);
+    }
+  }
+  return v;
+}
+
+int64_t DataBlockInterpolationIndex::Predict(uint64_t key, uint64_t min_key,
+                                             uint64_t max_key,
+                                             uint32_t num_restarts) {
+  assert(min_key < max_key);
+  assert(num_restarts > 0);
+  if (key <= min_key) {
+    return 0;
+  }
+  if (key >= max_key) {
+    return num_restarts - 1;
+  }
+  const double pos = static_cast<double>(key - min_key) /
+                     static_cast<double>(max_key - min_key) *
+                     static_cast<double>(num_restarts - 1);
+  return std::min(static_cast<int64_t>(pos), int64_t{num_restarts} - 1);
+}
+
+void DataBlockInterpolationIndex::Initialize(const char* data,
+                                             uint32_t num_restarts) {
+  prefix_len_ = DecodeFixed32(data);
+  max_error_ = DecodeFixed32(data + sizeof(uint32_t));
+  min_key_ = DecodeFixed64(data + 2 * sizeof(uint32_t));
+  max_key_ = DecodeFixed64(data + 2 * sizeof(uint32_t) + sizeof(uint64_t));
+  if (min_key_ >= max_key_) {
+    // Never written by the builder; do not use the model.
+    num_restarts_ = 0;
+    return;
+  }
+  num_restarts_ = num_restarts;
+}
+
+void DataBlockInterpolationIndex::PredictRange(const Slice& user_key,
+                                               int64_t* left,
+                                               int64_t* right) const {
+  assert(Valid());
+  const int64_t pos = Predict(KeyToInt(user_key, prefix_len_), min_key_,
+                              max_key_, num_restarts_);
+  *left = std::max(pos - int64_t{max_error_} - 1, int64_t{-1});
+  *right = std::min(pos + int64_t{max_error_}, int64_t{num_restarts_} - 1);
+}
+
+void DataBlockInterpolationIndexBuilder::AddRestartKey(const Slice& user_key) {
+  restart_keys_.append(user_key.data(), user_key.size());
+  restart_key_ends_.push_back(static_cast<uint32_t>(restart_keys_.size()));
+}
+
+bool DataBlockInterpolationIndexBuilder::Finish(std::string& buffer) {
+  const uint32_t num_restarts =
+      static_cast<uint32_t>(restart_key_ends_.size());
+  // With few restart intervals a binary search is as good.
+  if (num_restarts < 8) {
+    return false;
+  }
+  auto restart_key = [&](uint32_t i) {
+    const uint32_t begin = i == 0 ? 0 : restart_key_ends_[i - 1];
+    return Slice(restart_keys_.data() + begin, restart_key_ends_[i] - begin);
+  };
+  const Slice first = restart_key(0);
+  const Slice last = restart_key(num_restarts - 1);
+  // Restart keys are sorted, so the prefix shared by the first and the last
+  // one is shared by all of them.
+  const uint32_t prefix_len =
+      static_cast<uint32_t>(SharedPrefixLength(first, last));
+  const uint64_t min_key =
+      DataBlockInterpolationIndex::KeyToInt(first, prefix_len);
+  const uint64_t max_key =
+      DataBlockInterpolationIndex::KeyToInt(last, prefix_len);
+  if (min_key >= max_key) {
+    return false;
+  }
+  int64_t max_error = 0;
+  for (uint32_t i = 0; i < num_restarts; ++i) {
+    const int64_t pos = DataBlockInterpolationIndex::Predict(
+        DataBlockInterpolationIndex::KeyToInt(restart_key(i), prefix_len),
+        min_key, max_key, num_restarts);
+    max_error = std::max(max_error, std::abs(pos - int64_t{i}));
+  }
+  // The predicted range spans 2 * max_error + 2 restart intervals.
+  if (2 * max_error + 2 > num_restarts / 2) {
+    return false;
+  }
+  PutFixed32(&buffer, prefix_len);
+  PutFixed32(&buffer, static_cast<uint32_t>(max_error));
+  PutFixed64(&buffer, min_key);
+  PutFixed64(&buffer, max_key);
+  return true;
+}
+
+void DataBlockInterpolationIndexBuilder::Reset() {
+  restart_keys_.clear();
+  restart_key_ends_.clear();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,113 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+// An optional per data block search model, aimed at blocks with many restart
+// intervals (large blocks and/or small block_restart_interval) whose keys are
+// fixed width and roughly uniformly distributed, such as big-endian encoded
+// integers. Instead of binary searching the whole restart array, a Seek()
+// predicts the restart interval from the target key by linear interpolation
+// between the first and last restart keys, then binary searches only the
+// few restart intervals that the error bound of the model allows.
+//
+// The model is appended to the data-block after the restart array:
+//
+// DATA_BLOCK: [RI RI RI ... RI RI_IDX MODEL FOOTER]
+//
+// RI:       Restart Interval (the same as the default data-block format)
+// RI_IDX:   Restart Interval index (the same as the default data-block format)
+// MODEL:    [PREFIX_LEN MAX_ERROR MIN_KEY MAX_KEY], fixed32, fixed32, fixed64
+//           and fixed64.
+// FOOTER:   A 32bit block footer, which is NUM_RESTARTS with bit 30 as the
+//           flag indicating that the model is in use (see data_block_footer).
+//
+// Keys are mapped to a 64 bit integer by taking the 8 bytes of the user key
+// following the PREFIX_LEN bytes shared by all restart keys (zero padded), in
+// big-endian order. The predicted restart index of a key K is
+//   (K - MIN_KEY) / (MAX_KEY - MIN_KEY) * (NUM_RESTARTS - 1)
+// rounded down, and MAX_ERROR is the largest distance between the predicted
+// and actual index of any restart key. As the prediction is monotonic in the
+// key, the last restart key <= target is then within
+//   [prediction - MAX_ERROR - 1, prediction + MAX_ERROR].
+//
+// The bound is only trusted after checking the restart keys at both of its
+// ends, so a key outside of the modeled range, or a comparator that does not
+// order keys bytewise, only makes the search slower, never incorrect.
+//
+// The model is only appended when it narrows the search to less than half of
+// the restart intervals; otherwise the block is written as
+// kDataBlockBinarySearch.
+
+class DataBlockInterpolationIndex {
+ public:
+  // Size of the serialized model.
+  static constexpr size_t kSize =
+      2 * sizeof(uint32_t) /* PREFIX_LEN, MAX_ERROR */ +
+      2 * sizeof(uint64_t) /* MIN_KEY, MAX_KEY */;
+
+  DataBlockInterpolationIndex() : num_restarts_(0) {}
+
+  // `data` points to the kSize bytes of the serialized model.
+  void Initialize(const char* data, uint32_t num_restarts);
+
+  inline bool Valid() const { return num_restarts_ != 0; }
+
+  // Sets `*left` and `*right` to the range of restart indexes the last
+  // restart key <= `user_key` is predicted to be in, where -1 stands for "all
+  // restart keys are greater".
+  void PredictRange(const Slice& user_key, int64_t* left,
+                    int64_t* right) const;
+
+  // The mapping and prediction functions shared by the builder and the
+  // reader.
+  static uint64_t KeyToInt(const Slice& user_key, uint32_t prefix_len);
+  static int64_t Predict(uint64_t key, uint64_t min_key, uint64_t max_key,
+                         uint32_t num_restarts);
+
+ private:
+  uint32_t num_restarts_;
+  uint32_t prefix_len_;
+  uint32_t max_error_;
+  uint64_t min_key_;
+  uint64_t max_key_;
+};
+
+class DataBlockInterpolationIndexBuilder {
+ public:
+  DataBlockInterpolationIndexBuilder() : valid_(false) {}
+
+  void Initialize() { valid_ = true; }
+
+  inline bool Valid() const { return valid_; }
+
+  // Adds the user key of the next restart interval.
+  void AddRestartKey(const Slice& user_key);
+
+  // Appends the model to `buffer` and returns true if it is worth it for a
+  // block with the restart keys added since the last Reset().
+  bool Finish(std::string& buffer);
+
+  void Reset();
+
+  inline size_t EstimateSize() const {
+    return DataBlockInterpolationIndex::kSize;
+  }
+
+ private:
+  bool valid_;
+  // Restart keys, concatenated.
+  std::string restart_keys_;
+  std::vector<uint32_t> restart_key_ends_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
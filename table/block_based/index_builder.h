@@ -18,6 +18,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_block_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -436,6 +437,64 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder contains a binary-searchable primary index and, when
+// the data blocks are separated by fixed width user keys under a bytewise
+// comparator, a LearnedBlockIndex of them in a metablock. Readers use the
+// latter instead of the primary index when it is present.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  LearnedIndexBuilder(const InternalKeyComparator* comparator,
+                      int index_block_restart_interval, int format_version,
+                      bool use_value_delta_encoding,
+                      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+                      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps) {}
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* first_key_in_next_block,
+                      const BlockHandle& block_handle,
+                      std::string* separator_scratch) override {
+    // The learned index uses the last key of each block rather than a
+    // shortened separator, so that all the keys have the same width.
+    learned_index_builder_.Add(ExtractUserKey(last_key_in_current_block),
+                               block_handle);
+    return primary_index_builder_.AddIndexEntry(
+        last_key_in_current_block, first_key_in_next_block, block_handle,
+        separator_scratch);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    // The learned index only has user keys, and relies on their byte order.
+    if (s.ok() && !primary_index_builder_.seperator_is_key_plus_seq() &&
+        ts_sz_ == 0 && comparator_->user_comparator() == BytewiseComparator() &&
+        learned_index_builder_.Finish(&learned_index_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexBlock.c_str(), learned_index_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + learned_index_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  LearnedBlockIndexBuilder learned_index_builder_;
+  std::string learned_index_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
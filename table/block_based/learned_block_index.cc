@@ -0,0 +1,478 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_block_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "db/dbformat.h"
+#include "table/block_based/block_based_table_reader.h"
+#include "util/coding.h"
+#include "util/key_compare.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint64_t kBlockTrailerSize = BlockBasedTable::kBlockTrailerSize;
+// Approximate size of the serialized fields of a segment, in bits.
+constexpr uint64_t kSegmentHeaderBits = 24 * 8;
+
+uint32_t BitsNeeded(uint64_t v) {
+  return v == 0 ? 0 : static_cast<uint32_t>(FloorLog2(v)) + 1;
+}
+
+// Largest key of `key_width` bytes.
+uint64_t MaxKey(uint32_t key_width) {
+  return key_width >= 8 ? ~uint64_t{0} : (uint64_t{1} << (8 * key_width)) - 1;
+}
+
+// ORs the `bits` low bits of `value` into `buffer` at `bit_offset`.
+void WriteBits(std::string* buffer, uint64_t bit_offset, uint32_t bits,
+               uint64_t value) {
+  assert(bits <= LearnedBlockIndex::kMaxFieldBits);
+  if (bits == 0) {
+    return;
+  }
+  const size_t byte_offset = static_cast<size_t>(bit_offset / 8);
+  if (buffer->size() < byte_offset + sizeof(uint64_t)) {
+    buffer->resize(byte_offset + sizeof(uint64_t));
+  }
+  char* p = &(*buffer)[byte_offset];
+  EncodeFixed64(p, DecodeFixed64(p) | (value << (bit_offset % 8)));
+}
+
+// Line through the first and last of `n` increasing values, and the range of
+// the residuals of the values in between.
+struct LinearFit {
+  uint64_t base = 0;
+  uint64_t slope = 0;
+  int64_t min_residual = 0;
+  uint32_t bits = 0;
+
+  int64_t Residual(const uint64_t* values, uint32_t j) const {
+    // Both terms are <= values[n - 1] - base, which fits int64.
+    return static_cast<int64_t>(values[j] - base) -
+           static_cast<int64_t>(slope * j);
+  }
+};
+
+// Returns false if the residuals do not fit kMaxFieldBits.
+bool Fit(const uint64_t* values, uint32_t n, LinearFit* fit) {
+  assert(n > 0);
+  const uint64_t range = values[n - 1] - values[0];
+  if (range > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+    return false;
+  }
+  fit->base = values[0];
+  fit->slope = n > 1 ? range / (n - 1) : 0;
+  int64_t min_residual = 0;
+  int64_t max_residual = 0;
+  for (uint32_t j = 0; j < n; ++j) {
+    const int64_t residual = fit->Residual(values, j);
+    min_residual = std::min(min_residual, residual);
+    max_residual = std::max(max_residual, residual);
+  }
+  fit->min_residual = min_residual;
+  fit->bits = BitsNeeded(static_cast<uint64_t>(max_residual) -
+                         static_cast<uint64_t>(min_residual));
+  return fit->bits <= LearnedBlockIndex::kMaxFieldBits;
+}
+
+void PutFit(std::string* dst, const LinearFit& fit) {
+  PutVarint64(dst, fit.base);
+  PutVarint64(dst, fit.slope);
+  PutVarsignedint64(dst, fit.min_residual);
+  dst->push_back(static_cast<char>(fit.bits));
+}
+
+void WriteResiduals(std::string* packed_fields, uint64_t* bit_offset,
+                    const uint64_t* values, uint32_t n, const LinearFit& fit) {
+  for (uint32_t j = 0; j < n; ++j) {
+    WriteBits(packed_fields, *bit_offset, fit.bits,
+              static_cast<uint64_t>(fit.Residual(values, j) -
+                                    fit.min_residual));
+    *bit_offset += fit.bits;
+  }
+}
+
+bool GetModel(Slice* input, uint64_t* base, uint64_t* slope,
+              uint64_t* min_residual, uint8_t* bits) {
+  int64_t residual = 0;
+  if (!GetVarint64(input, base) || !GetVarint64(input, slope) ||
+      !GetVarsignedint64(input, &residual) || input->empty()) {
+    return false;
+  }
+  *min_residual = static_cast<uint64_t>(residual);
+  *bits = static_cast<uint8_t>((*input)[0]);
+  input->remove_prefix(1);
+  return *bits <= LearnedBlockIndex::kMaxFieldBits;
+}
+}  // namespace
+
+uint64_t LearnedBlockIndex::KeyToInt(const Slice& suffix, uint32_t key_width) {
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < key_width; ++i) {
+    v <<= 8;
+    if (i < suffix.size()) {
+      v |= static_cast<unsigned char>(suffix[i]);
+    }
+  }
+  return v;
+}
+
+uint32_t LearnedBlockIndex::Predict(uint64_t key, uint64_t base_key,
+                                    uint64_t slope, uint32_t num_entries) {
+  assert(num_entries > 0);
+  if (slope == 0 || key <= base_key) {
+    return 0;
+  }
+  return static_cast<uint32_t>(
+      std::min<uint64_t>((key - base_key) / slope, num_entries - 1));
+}
+
+Status LearnedBlockIndex::Create(BlockContents&& contents,
+                                 std::unique_ptr<LearnedBlockIndex>* index) {
+  std::unique_ptr<LearnedBlockIndex> result(new LearnedBlockIndex());
+  result->contents_ = std::move(contents);
+  Slice input = result->contents_.data;
+
+  uint32_t num_segments = 0;
+  if (!GetLengthPrefixedSlice(&input, &result->prefix_) ||
+      !GetVarint32(&input, &result->key_width_) ||
+      !GetVarint32(&input, &num_segments) || result->key_width_ == 0 ||
+      result->key_width_ > sizeof(uint64_t)) {
+    return Status::Corruption("Bad learned index header");
+  }
+  result->segments_.reserve(num_segments);
+  uint64_t bit_offset = 0;
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment seg;
+    Model& key = seg.key;
+    Model& offset = seg.offset;
+    if (!GetVarint32(&input, &seg.num_entries) ||
+        !GetModel(&input, &key.base, &key.slope, &key.min_residual,
+                  &key.bits) ||
+        !GetVarint32(&input, &seg.max_error) ||
+        !GetModel(&input, &offset.base, &offset.slope, &offset.min_residual,
+                  &offset.bits) ||
+        !GetVarint64(&input, &seg.last_size) || seg.num_entries == 0 ||
+        seg.num_entries > kMaxSegmentSize) {
+      return Status::Corruption("Bad learned index segment");
+    }
+    key.bit_offset = bit_offset;
+    bit_offset += uint64_t{seg.num_entries} * key.bits;
+    offset.bit_offset = bit_offset;
+    bit_offset += uint64_t{seg.num_entries} * offset.bits;
+    result->segments_.push_back(seg);
+  }
+  if (input.size() < (bit_offset + 7) / 8 + kPaddingSize) {
+    return Status::Corruption("Truncated learned index");
+  }
+  result->packed_fields_ = input.data();
+  uint64_t prev_last_key = 0;
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment& seg = result->segments_[i];
+    seg.last_key = result->KeyAt(seg, seg.num_entries - 1);
+    if (i > 0 && seg.key.base <= prev_last_key) {
+      return Status::Corruption("Unsorted learned index");
+    }
+    prev_last_key = seg.last_key;
+  }
+  *index = std::move(result);
+  return Status::OK();
+}
+
+uint64_t LearnedBlockIndex::ReadBits(uint64_t bit_offset, uint32_t bits) const {
+  if (bits == 0) {
+    return 0;
+  }
+  const uint64_t word =
+      DecodeFixed64(packed_fields_ + static_cast<size_t>(bit_offset / 8));
+  return (word >> (bit_offset % 8)) & ((uint64_t{1} << bits) - 1);
+}
+
+uint64_t LearnedBlockIndex::ValueAt(const Model& model, uint32_t entry) const {
+  return model.base + model.slope * entry + model.min_residual +
+         ReadBits(model.bit_offset + uint64_t{entry} * model.bits, model.bits);
+}
+
+BlockHandle LearnedBlockIndex::GetBlockHandle(Position pos) const {
+  const Segment& segment = segments_[pos.segment];
+  const uint64_t offset = ValueAt(segment.offset, pos.entry);
+  if (pos.entry + 1 == segment.num_entries) {
+    return BlockHandle(offset, segment.last_size);
+  }
+  return BlockHandle(offset, ValueAt(segment.offset, pos.entry + 1) - offset -
+                                 kBlockTrailerSize);
+}
+
+// Returns the index of the first entry of `segment` that is >= `key`.
+// REQUIRES: key <= segment.last_key
+uint32_t LearnedBlockIndex::LowerBound(const Segment& segment,
+                                       uint64_t key) const {
+  assert(key <= segment.last_key);
+  // The result is within [left, right].
+  uint32_t left = 0;
+  uint32_t right = segment.num_entries - 1;
+  // Check the bounds of the predicted range first. They hold for the keys the
+  // model was built from, and are close for the others.
+  const uint32_t pos =
+      Predict(key, segment.key.base, segment.key.slope, segment.num_entries);
+  const uint32_t lo = pos > segment.max_error ? pos - segment.max_error : 0;
+  const uint32_t hi = std::min(pos + segment.max_error, right);
+  if (lo > 0) {
+    if (KeyAt(segment, lo - 1) < key) {
+      left = lo;
+    } else {
+      right = lo - 1;
+    }
+  }
+  if (left < right && hi < right) {
+    if (KeyAt(segment, hi) >= key) {
+      right = std::max(hi, left);
+    } else {
+      left = hi + 1;
+    }
+  }
+  while (left < right) {
+    const uint32_t mid = left + (right - left) / 2;
+    if (KeyAt(segment, mid) >= key) {
+      right = mid;
+    } else {
+      left = mid + 1;
+    }
+  }
+  return left;
+}
+
+LearnedBlockIndex::Position LearnedBlockIndex::Seek(
+    const Slice& user_key) const {
+  const Position kBegin{0, 0};
+  const Position kEnd{NumSegments(), 0};
+  const size_t prefix_cmp_len = std::min(user_key.size(), prefix_.size());
+  const int cmp = memcmp(user_key.data(), prefix_.data(), prefix_cmp_len);
+  if (cmp < 0 || (cmp == 0 && user_key.size() < prefix_.size())) {
+    return kBegin;
+  } else if (cmp > 0) {
+    return kEnd;
+  }
+  Slice suffix = user_key;
+  suffix.remove_prefix(prefix_.size());
+  uint64_t key = KeyToInt(suffix, key_width_);
+  if (suffix.size() > key_width_) {
+    // Greater than every key mapped to `key`.
+    if (key == MaxKey(key_width_)) {
+      return kEnd;
+    }
+    ++key;
+  }
+  auto it = std::lower_bound(
+      segments_.begin(), segments_.end(), key,
+      [](const Segment& s, uint64_t k) { return s.last_key < k; });
+  if (it == segments_.end()) {
+    return kEnd;
+  }
+  return Position{static_cast<uint32_t>(it - segments_.begin()),
+                  LowerBound(*it, key)};
+}
+
+void LearnedBlockIndex::AppendKey(Position pos, std::string* key) const {
+  const uint64_t v = KeyAt(segments_[pos.segment], pos.entry);
+  key->append(prefix_.data(), prefix_.size());
+  for (uint32_t i = key_width_; i > 0; --i) {
+    key->push_back(static_cast<char>((v >> (8 * (i - 1))) & 0xff));
+  }
+}
+
+size_t LearnedBlockIndex::ApproximateMemoryUsage() const {
+  size_t usage = sizeof(LearnedBlockIndex) +
+                 segments_.capacity() * sizeof(Segment) +
+                 contents_.ApproximateMemoryUsage();
+  return usage;
+}
+
+void LearnedBlockIndexBuilder::Add(const Slice& last_user_key,
+                                   const BlockHandle& block_handle) {
+  keys_.append(last_user_key.data(), last_user_key.size());
+  key_ends_.push_back(keys_.size());
+  block_handles_.push_back(block_handle);
+}
+
+bool LearnedBlockIndexBuilder::Finish(std::string* buffer) const {
+  const size_t num_blocks = block_handles_.size();
+  if (num_blocks == 0) {
+    return false;
+  }
+  auto key_at = [&](size_t i) {
+    const size_t begin = i == 0 ? 0 : key_ends_[i - 1];
+    return Slice(keys_.data() + begin, key_ends_[i] - begin);
+  };
+  // Keys are sorted, so the prefix shared by the first and the last one is
+  // shared by all of them.
+  const Slice first = key_at(0);
+  const size_t key_size = first.size();
+  size_t prefix_len = SharedPrefixLength(first, key_at(num_blocks - 1));
+  if (prefix_len == key_size) {
+    // A single key; keep a non-empty suffix anyway.
+    if (key_size == 0) {
+      return false;
+    }
+    prefix_len = key_size - 1;
+  }
+  const uint32_t key_width = static_cast<uint32_t>(key_size - prefix_len);
+  if (key_width > sizeof(uint64_t)) {
+    return false;
+  }
+  std::vector<uint64_t> keys(num_blocks);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    Slice key = key_at(i);
+    if (key.size() != key_size) {
+      return false;
+    }
+    key.remove_prefix(prefix_len);
+    keys[i] = LearnedBlockIndex::KeyToInt(key, key_width);
+    if (i > 0 && keys[i] <= keys[i - 1]) {
+      return false;
+    }
+  }
+
+  std::string header;
+  std::string packed_fields;
+  PutLengthPrefixedSlice(&header, Slice(first.data(), prefix_len));
+  PutVarint32(&header, key_width);
+  std::string segments;
+  std::vector<uint64_t> offsets;
+  uint32_t num_segments = 0;
+  uint64_t bit_offset = 0;
+  size_t begin = 0;
+  while (begin < num_blocks) {
+    // Blocks of a segment are back to back in the file.
+    size_t max_end = begin + 1;
+    while (max_end < num_blocks &&
+           max_end - begin < LearnedBlockIndex::kMaxSegmentSize &&
+           block_handles_[max_end].offset() ==
+               block_handles_[max_end - 1].offset() +
+                   block_handles_[max_end - 1].size() + kBlockTrailerSize) {
+      ++max_end;
+    }
+    offsets.clear();
+    for (size_t i = begin; i < max_end; ++i) {
+      offsets.push_back(block_handles_[i].offset());
+    }
+    // Pick the segment length with the fewest bits per block, so that e.g. a
+    // jump in the keys starts a new segment rather than widening the
+    // residuals of all the blocks of the segment.
+    uint32_t n = 0;
+    LinearFit key_fit;
+    LinearFit offset_fit;
+    uint64_t best_cost = 0;
+    for (uint32_t len = static_cast<uint32_t>(max_end - begin); len > 0;
+         --len) {
+      LinearFit len_key_fit;
+      LinearFit len_offset_fit;
+      if (!Fit(&keys[begin], len, &len_key_fit) ||
+          !Fit(offsets.data(), len, &len_offset_fit)) {
+        continue;
+      }
+      // Bits per block, times the longest segment length to compare
+      // without rounding.
+      const uint64_t cost =
+          (kSegmentHeaderBits +
+           uint64_t{len} * (len_key_fit.bits + len_offset_fit.bits)) *
+          LearnedBlockIndex::kMaxSegmentSize / len;
+      if (n == 0 || cost < best_cost) {
+        n = len;
+        key_fit = len_key_fit;
+        offset_fit = len_offset_fit;
+        best_cost = cost;
+      }
+    }
+    if (n == 0) {
+      return false;
+    }
+    const size_t end = begin + n;
+    uint32_t max_error = 0;
+    for (uint32_t j = 0; j < n; ++j) {
+      const uint32_t pos = LearnedBlockIndex::Predict(
+          keys[begin + j], key_fit.base, key_fit.slope, n);
+      max_error = std::max(max_error, pos > j ? pos - j : j - pos);
+    }
+
+    PutVarint32(&segments, n);
+    PutFit(&segments, key_fit);
+    PutVarint32(&segments, max_error);
+    PutFit(&segments, offset_fit);
+    PutVarint64(&segments, block_handles_[end - 1].size());
+    WriteResiduals(&packed_fields, &bit_offset, &keys[begin], n, key_fit);
+    WriteResiduals(&packed_fields, &bit_offset, offsets.data(), n, offset_fit);
+    ++num_segments;
+    begin = end;
+  }
+  packed_fields.resize(static_cast<size_t>((bit_offset + 7) / 8) +
+                       LearnedBlockIndex::kPaddingSize);
+
+  buffer->append(header);
+  PutVarint32(buffer, num_segments);
+  buffer->append(segments);
+  buffer->append(packed_fields);
+  return true;
+}
+
+void LearnedBlockIndexIterator::Update() {
+  key_.clear();
+  if (Valid()) {
+    index_->AppendKey(pos_, &key_);
+    handle_ = index_->GetBlockHandle(pos_);
+  }
+}
+
+void LearnedBlockIndexIterator::SeekToFirst() {
+  status_ = Status::OK();
+  pos_ = {0, 0};
+  Update();
+}
+
+void LearnedBlockIndexIterator::SeekToLast() {
+  status_ = Status::OK();
+  const uint32_t num_segments = index_->NumSegments();
+  if (num_segments == 0) {
+    pos_ = {0, 0};
+  } else {
+    pos_ = {num_segments - 1, index_->NumEntries(num_segments - 1) - 1};
+  }
+  Update();
+}
+
+void LearnedBlockIndexIterator::Seek(const Slice& target) {
+  status_ = Status::OK();
+  pos_ = index_->Seek(ExtractUserKey(target));
+  Update();
+}
+
+void LearnedBlockIndexIterator::Next() {
+  assert(Valid());
+  if (++pos_.entry == index_->NumEntries(pos_.segment)) {
+    pos_ = {pos_.segment + 1, 0};
+  }
+  Update();
+}
+
+void LearnedBlockIndexIterator::Prev() {
+  assert(Valid());
+  if (pos_.entry > 0) {
+    --pos_.entry;
+  } else if (pos_.segment > 0) {
+    --pos_.segment;
+    pos_.entry = index_->NumEntries(pos_.segment) - 1;
+  } else {
+    pos_ = {index_->NumSegments(), 0};
+  }
+  Update();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,192 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+// A compact, learned replacement of the binary search index block for tables
+// whose data blocks are separated by fixed width keys, such as big-endian
+// encoded integers under a bytewise comparator (see
+// BlockBasedTableOptions::kLearnedIndexSearch).
+//
+// The last user key of every data block is mapped to an integer made of the
+// (at most 8) bytes following the prefix shared by all of them. The blocks are
+// grouped into segments of up to kMaxSegmentSize blocks stored back to back in
+// the file. In each segment, the key and the offset of the j-th block are
+// modeled as
+//   BASE_KEY + KEY_SLOPE * j  and  BASE_OFFSET + OFFSET_SLOPE * j
+// and only the (usually small) residuals of these linear models are stored,
+// bit-packed. The size of a block follows from the offset of the next one, or
+// LAST_SIZE for the last block of a segment. As keys are reconstructed
+// exactly, lookups compare against the actual keys, and the model only
+// predicts where to look: MAX_ERROR bounds the distance between the predicted
+// and the actual index of every block key of a segment.
+//
+// The model is stored in a meta block next to the regular index block, which
+// remains in the file for readers that cannot use the model:
+//
+// [PREFIX_LEN PREFIX KEY_WIDTH NUM_SEGMENTS SEGMENT... PACKED_FIELDS PADDING]
+//
+// PREFIX_LEN, KEY_WIDTH, NUM_SEGMENTS: varint32
+// SEGMENT:       [NUM_ENTRIES BASE_KEY KEY_SLOPE MIN_KEY_RESIDUAL KEY_BITS
+//                  MAX_ERROR BASE_OFFSET OFFSET_SLOPE MIN_OFFSET_RESIDUAL
+//                  OFFSET_BITS LAST_SIZE], where KEY_BITS and OFFSET_BITS are
+//                 one byte, the residuals zigzag varint64s and the others
+//                 varints.
+// PACKED_FIELDS: for each segment, NUM_ENTRIES key residuals (minus
+//                MIN_KEY_RESIDUAL) of KEY_BITS bits, followed by NUM_ENTRIES
+//                offset residuals (minus MIN_OFFSET_RESIDUAL) of OFFSET_BITS
+//                bits, in little-endian bit order.
+// PADDING:       8 zero bytes, so that any field can be read with one fixed64
+//                load.
+class LearnedBlockIndex {
+ public:
+  // Maximum number of data blocks in a segment.
+  static constexpr uint32_t kMaxSegmentSize = 64;
+  // Maximum width of a packed field, so that it spans at most 8 bytes.
+  static constexpr uint32_t kMaxFieldBits = 56;
+  static constexpr size_t kPaddingSize = 8;
+
+  // Position of a data block, segment index then index in the segment.
+  struct Position {
+    uint32_t segment;
+    uint32_t entry;
+  };
+
+  // Parses the serialized model in `contents`, which must remain valid (if
+  // not owned) for the lifetime of the index.
+  static Status Create(BlockContents&& contents,
+                       std::unique_ptr<LearnedBlockIndex>* index);
+
+  uint32_t NumSegments() const {
+    return static_cast<uint32_t>(segments_.size());
+  }
+  uint32_t NumEntries(uint32_t segment) const {
+    return segments_[segment].num_entries;
+  }
+
+  // Returns the position of the first data block whose last user key is >=
+  // `user_key`, or {NumSegments(), 0} if there is no such block.
+  Position Seek(const Slice& user_key) const;
+
+  // Appends the user key that the block at `pos` is indexed with to `*key`.
+  void AppendKey(Position pos, std::string* key) const;
+
+  BlockHandle GetBlockHandle(Position pos) const;
+
+  size_t ApproximateMemoryUsage() const;
+
+  // The mapping and model functions shared by the builder and the reader.
+  static uint64_t KeyToInt(const Slice& suffix, uint32_t key_width);
+  static uint32_t Predict(uint64_t key, uint64_t base_key, uint64_t slope,
+                          uint32_t num_entries);
+
+ private:
+  // Value of a linear model with bit-packed residuals.
+  struct Model {
+    uint64_t base;
+    uint64_t slope;
+    uint64_t min_residual;  // two's complement
+    // Bit offset of the first residual in the packed fields.
+    uint64_t bit_offset;
+    uint8_t bits;
+  };
+
+  struct Segment {
+    Model key;
+    Model offset;
+    uint64_t last_key;
+    uint64_t last_size;
+    uint32_t num_entries;
+    uint32_t max_error;
+  };
+
+  LearnedBlockIndex() = default;
+
+  uint64_t ReadBits(uint64_t bit_offset, uint32_t bits) const;
+  uint64_t ValueAt(const Model& model, uint32_t entry) const;
+  uint64_t KeyAt(const Segment& segment, uint32_t entry) const {
+    return ValueAt(segment.key, entry);
+  }
+  uint32_t LowerBound(const Segment& segment, uint64_t key) const;
+
+  BlockContents contents_;
+  Slice prefix_;
+  uint32_t key_width_ = 0;
+  std::vector<Segment> segments_;
+  const char* packed_fields_ = nullptr;
+};
+
+// Collects the last user key and handle of each data block and serializes
+// the model, if the keys fit it.
+class LearnedBlockIndexBuilder {
+ public:
+  void Add(const Slice& last_user_key, const BlockHandle& block_handle);
+
+  // Appends the serialized model to `buffer` and returns true if all the keys
+  // added could be mapped to integers. `buffer` is unchanged otherwise.
+  bool Finish(std::string* buffer) const;
+
+ private:
+  // Keys, concatenated.
+  std::string keys_;
+  std::vector<size_t> key_ends_;
+  std::vector<BlockHandle> block_handles_;
+};
+
+// Iterates over the data blocks of a LearnedBlockIndex, with the same
+// interface as an IndexBlockIter over user keys.
+class LearnedBlockIndexIterator : public InternalIteratorBase<IndexValue> {
+ public:
+  explicit LearnedBlockIndexIterator(const LearnedBlockIndex* index)
+      : index_(index), pos_{index->NumSegments(), 0} {}
+
+  bool Valid() const override { return pos_.segment < index_->NumSegments(); }
+  void SeekToFirst() override;
+  void SeekToLast() override;
+  void Seek(const Slice& target) override;
+  void SeekForPrev(const Slice& /*target*/) override {
+    assert(false);
+    pos_ = {index_->NumSegments(), 0};
+    status_ = Status::InvalidArgument(
+        "RocksDB internal error: should never call SeekForPrev() on index "
+        "blocks");
+  }
+  void Next() override;
+  void Prev() override;
+
+  Slice key() const override {
+    assert(Valid());
+    return key_;
+  }
+  Slice user_key() const override { return key(); }
+  IndexValue value() const override {
+    assert(Valid());
+    return IndexValue(handle_, Slice());
+  }
+  Status status() const override { return status_; }
+
+ private:
+  // Updates the key and value from pos_.
+  void Update();
+
+  const LearnedBlockIndex* index_;
+  LearnedBlockIndex::Position pos_;
+  std::string key_;
+  BlockHandle handle_;
+  Status status_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
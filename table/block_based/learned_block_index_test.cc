@@ -0,0 +1,216 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_block_index.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "table/block_based/block_based_table_reader.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class LearnedBlockIndexTest : public testing::Test {
+ protected:
+  // Adds a block with the given last key right after the previous one, or
+  // `gap` bytes further.
+  void AddBlock(const std::string& key, uint64_t size, uint64_t gap = 0) {
+    const uint64_t offset =
+        handles_.empty() ? 0
+                         : handles_.back().offset() + handles_.back().size() +
+                               BlockBasedTable::kBlockTrailerSize + gap;
+    keys_.push_back(key);
+    handles_.emplace_back(offset, size);
+    builder_.Add(key, handles_.back());
+  }
+
+  void Finish() {
+    ASSERT_TRUE(builder_.Finish(&contents_));
+    ASSERT_OK(LearnedBlockIndex::Create(BlockContents(contents_), &index_));
+  }
+
+  // Checks the result of a Seek() against a binary search on the keys.
+  void CheckSeek(const std::string& target) {
+    LearnedBlockIndexIterator iter(index_.get());
+    iter.Seek(InternalKey(target, kMaxSequenceNumber, kValueTypeForSeek)
+                  .Encode());
+    ASSERT_OK(iter.status());
+    const size_t i =
+        std::lower_bound(keys_.begin(), keys_.end(), target) - keys_.begin();
+    if (i == keys_.size()) {
+      ASSERT_FALSE(iter.Valid()) << target;
+      return;
+    }
+    ASSERT_TRUE(iter.Valid()) << target;
+    ASSERT_EQ(iter.key().ToString(), keys_[i]);
+    ASSERT_EQ(iter.value().handle.offset(), handles_[i].offset());
+    ASSERT_EQ(iter.value().handle.size(), handles_[i].size());
+  }
+
+  void CheckIteration() {
+    LearnedBlockIndexIterator iter(index_.get());
+    size_t i = 0;
+    for (iter.SeekToFirst(); iter.Valid(); iter.Next(), ++i) {
+      ASSERT_LT(i, keys_.size());
+      ASSERT_EQ(iter.key().ToString(), keys_[i]);
+      ASSERT_EQ(iter.value().handle.offset(), handles_[i].offset());
+      ASSERT_EQ(iter.value().handle.size(), handles_[i].size());
+    }
+    ASSERT_EQ(i, keys_.size());
+    for (iter.SeekToLast(); iter.Valid(); iter.Prev()) {
+      --i;
+      ASSERT_EQ(iter.key().ToString(), keys_[i]);
+      ASSERT_EQ(iter.value().handle.offset(), handles_[i].offset());
+    }
+    ASSERT_EQ(i, 0U);
+  }
+
+  static std::string EncodeKey(const std::string& prefix, uint64_t v) {
+    std::string key = prefix;
+    PutFixed64(&key, 0);
+    EncodeFixed64BE(&key[prefix.size()], v);
+    return key;
+  }
+
+  static void EncodeFixed64BE(char* dst, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+      dst[i] = static_cast<char>(v & 0xff);
+      v >>= 8;
+    }
+  }
+
+  std::vector<std::string> keys_;
+  std::vector<BlockHandle> handles_;
+  LearnedBlockIndexBuilder builder_;
+  std::string contents_;
+  std::unique_ptr<LearnedBlockIndex> index_;
+};
+
+TEST_F(LearnedBlockIndexTest, Basic) {
+  Random rnd(301);
+  uint64_t v = 1000;
+  for (int i = 0; i < 1000; ++i) {
+    v += 1 + rnd.Uniform(100);
+    AddBlock(EncodeKey("prefix", v), 4000 + rnd.Uniform(200),
+             /* gap */ rnd.OneIn(100) ? 7 : 0);
+  }
+  Finish();
+  // Much smaller than the (uncompressed) key and handle of each block.
+  ASSERT_LT(contents_.size(), keys_.size() * 4);
+  CheckIteration();
+
+  for (const auto& key : keys_) {
+    CheckSeek(key);
+    // Right before and after the key.
+    std::string before = key;
+    before.pop_back();
+    CheckSeek(before);
+    CheckSeek(key + "x");
+  }
+  CheckSeek("");
+  CheckSeek("prefiw");
+  CheckSeek("prefix");
+  CheckSeek("prefiy");
+  CheckSeek(EncodeKey("prefix", 0));
+  CheckSeek(EncodeKey("prefix", ~uint64_t{0}));
+  CheckSeek(EncodeKey("prefix", ~uint64_t{0}) + "x");
+  for (int i = 0; i < 1000; ++i) {
+    CheckSeek(EncodeKey("prefix", rnd.Uniform(static_cast<int>(v + 100))));
+  }
+}
+
+TEST_F(LearnedBlockIndexTest, DecimalKeys) {
+  // Keys far from linear once mapped to integers.
+  char buf[16];
+  for (int i = 0; i < 300; ++i) {
+    snprintf(buf, sizeof(buf), "%08d", i * 37);
+    AddBlock(buf, 100 + i);
+  }
+  Finish();
+  CheckIteration();
+  for (int i = 0; i < 300 * 37; i += 5) {
+    snprintf(buf, sizeof(buf), "%08d", i);
+    CheckSeek(buf);
+  }
+}
+
+TEST_F(LearnedBlockIndexTest, KeyJumps) {
+  // Dense runs of keys separated by large jumps, which should start new
+  // segments instead of widening the residuals.
+  for (uint64_t i = 0; i < 16; ++i) {
+    for (uint64_t j = 0; j < 40; ++j) {
+      AddBlock(EncodeKey("", (i << 40) | (j * 100)), 4096);
+    }
+  }
+  Finish();
+  ASSERT_LT(contents_.size(), keys_.size());
+  CheckIteration();
+  for (const auto& key : keys_) {
+    CheckSeek(key);
+    CheckSeek(key + "x");
+  }
+}
+
+TEST_F(LearnedBlockIndexTest, SingleBlock) {
+  AddBlock("key", 10);
+  Finish();
+  CheckIteration();
+  CheckSeek("");
+  CheckSeek("ke");
+  CheckSeek("key");
+  CheckSeek("kez");
+  CheckSeek("key0");
+}
+
+TEST_F(LearnedBlockIndexTest, UnsupportedKeys) {
+  std::string contents;
+  {
+    // Keys of different sizes.
+    LearnedBlockIndexBuilder builder;
+    builder.Add("a", BlockHandle(0, 10));
+    builder.Add("bb", BlockHandle(15, 10));
+    ASSERT_FALSE(builder.Finish(&contents));
+  }
+  {
+    // More than 8 bytes after the common prefix.
+    LearnedBlockIndexBuilder builder;
+    builder.Add("000000000", BlockHandle(0, 10));
+    builder.Add("100000000", BlockHandle(15, 10));
+    ASSERT_FALSE(builder.Finish(&contents));
+  }
+  {
+    LearnedBlockIndexBuilder builder;
+    ASSERT_FALSE(builder.Finish(&contents));
+  }
+  ASSERT_TRUE(contents.empty());
+}
+
+TEST_F(LearnedBlockIndexTest, Corruption) {
+  for (uint64_t i = 0; i < 100; ++i) {
+    AddBlock(EncodeKey("", i * 1000), 100);
+  }
+  Finish();
+  for (size_t size = 0; size < contents_.size(); ++size) {
+    std::unique_ptr<LearnedBlockIndex> index;
+    ASSERT_TRUE(
+        LearnedBlockIndex::Create(BlockContents(Slice(contents_.data(), size)),
+                                  &index)
+            .IsCorruption());
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,109 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#include "table/block_based/learned_index_reader.h"
+
+#include "logging/logging.h"
+#include "table/block_fetcher.h"
+#include "table/meta_blocks.h"
+
+namespace ROCKSDB_NAMESPACE {
+Status LearnedIndexReader::Create(const BlockBasedTable* table,
+                                  const ReadOptions& ro,
+                                  FilePrefetchBuffer* prefetch_buffer,
+                                  InternalIterator* meta_index_iter,
+                                  bool use_cache, bool prefetch, bool pin,
+                                  BlockCacheLookupContext* lookup_context,
+                                  std::unique_ptr<IndexReader>* index_reader) {
+  assert(table != nullptr);
+  assert(index_reader != nullptr);
+  assert(!pin || prefetch);
+
+  const BlockBasedTable::Rep* rep = table->get_rep();
+  assert(rep != nullptr);
+
+  // Note, the model is optional: the builder does not write it when the keys
+  // do not fit, and failure to read it is not a hard error either, as the
+  // index block can still be used.
+  std::unique_ptr<LearnedBlockIndex> learned_index;
+  BlockHandle learned_index_handle;
+  Status s =
+      FindMetaBlock(meta_index_iter, kLearnedIndexBlock, &learned_index_handle);
+  if (s.ok() && !rep->index_key_includes_seq) {
+    BlockContents contents;
+    BlockFetcher block_fetcher(
+        rep->file.get(), prefetch_buffer, rep->footer, ro, learned_index_handle,
+        &contents, rep->ioptions, true /*decompress*/,
+        true /*maybe_compressed*/, BlockType::kLearnedIndex,
+        UncompressionDict::GetEmptyDict(), rep->persistent_cache_options,
+        GetMemoryAllocator(rep->table_options));
+    s = block_fetcher.ReadBlockContents();
+    if (s.ok()) {
+      s = LearnedBlockIndex::Create(std::move(contents), &learned_index);
+    }
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(rep->ioptions.logger,
+                     "Failed to read learned index of %s: %s. Fall back to "
+                     "binary search index.",
+                     rep->file->file_name().c_str(),
+                     s.ToString().c_str());
+      learned_index.reset();
+    }
+  }
+
+  CachableEntry<Block> index_block;
+  if (!learned_index && (prefetch || !use_cache)) {
+    s = ReadIndexBlock(table, prefetch_buffer, ro, use_cache,
+                       /*get_context=*/nullptr, lookup_context, &index_block);
+    if (!s.ok()) {
+      return s;
+    }
+
+    if (use_cache && !pin) {
+      index_block.Reset();
+    }
+  }
+
+  index_reader->reset(new LearnedIndexReader(table, std::move(index_block),
+                                             std::move(learned_index)));
+
+  return Status::OK();
+}
+
+InternalIteratorBase<IndexValue>* LearnedIndexReader::NewIterator(
+    const ReadOptions& read_options, bool /* disable_prefix_seek */,
+    IndexBlockIter* iter, GetContext* get_context,
+    BlockCacheLookupContext* lookup_context) {
+  if (learned_index_) {
+    return new LearnedBlockIndexIterator(learned_index_.get());
+  }
+
+  const BlockBasedTable::Rep* rep = table()->get_rep();
+  CachableEntry<Block> index_block;
+  const Status s = GetOrReadIndexBlock(get_context, lookup_context,
+                                       &index_block, read_options);
+  if (!s.ok()) {
+    if (iter != nullptr) {
+      iter->Invalidate(s);
+      return iter;
+    }
+
+    return NewErrorInternalIterator<IndexValue>(s);
+  }
+
+  Statistics* kNullStats = nullptr;
+  // We don't return pinned data from index blocks, so no need
+  // to set `block_contents_pinned`.
+  auto it = index_block.GetValue()->NewIndexIterator(
+      internal_comparator()->user_comparator(),
+      rep->get_global_seqno(BlockType::kIndex), iter, kNullStats, true,
+      index_has_first_key(), index_key_includes_seq(), index_value_is_full(),
+      false /* block_contents_pinned */, user_defined_timestamps_persisted());
+
+  assert(it != nullptr);
+  index_block.TransferTo(it);
+
+  return it;
+}
+}  // namespace ROCKSDB_NAMESPACE
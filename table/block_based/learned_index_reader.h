@@ -0,0 +1,52 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include "table/block_based/index_reader_common.h"
+#include "table/block_based/learned_block_index.h"
+
+namespace ROCKSDB_NAMESPACE {
+// Index that locates data blocks with the learned model stored in the
+// kLearnedIndexBlock meta block (see LearnedBlockIndex). The model is held by
+// the reader, so the index block is not read nor cached when the model is
+// usable. Otherwise, e.g. when the keys of the table did not fit the model,
+// falls back to a binary search on the index block.
+class LearnedIndexReader : public BlockBasedTable::IndexReaderCommon {
+ public:
+  static Status Create(const BlockBasedTable* table, const ReadOptions& ro,
+                       FilePrefetchBuffer* prefetch_buffer,
+                       InternalIterator* meta_index_iter, bool use_cache,
+                       bool prefetch, bool pin,
+                       BlockCacheLookupContext* lookup_context,
+                       std::unique_ptr<IndexReader>* index_reader);
+
+  InternalIteratorBase<IndexValue>* NewIterator(
+      const ReadOptions& read_options, bool /* disable_prefix_seek */,
+      IndexBlockIter* iter, GetContext* get_context,
+      BlockCacheLookupContext* lookup_context) override;
+
+  size_t ApproximateMemoryUsage() const override {
+    size_t usage = ApproximateIndexBlockMemoryUsage();
+    if (learned_index_) {
+      usage += learned_index_->ApproximateMemoryUsage();
+    }
+#ifdef ROCKSDB_MALLOC_USABLE_SIZE
+    usage += malloc_usable_size(const_cast<LearnedIndexReader*>(this));
+#else
+    usage += sizeof(*this);
+#endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    return usage;
+  }
+
+ private:
+  LearnedIndexReader(const BlockBasedTable* t,
+                     CachableEntry<Block>&& index_block,
+                     std::unique_ptr<LearnedBlockIndex>&& learned_index)
+      : IndexReaderCommon(t, std::move(index_block)),
+        learned_index_(std::move(learned_index)) {}
+
+  std::unique_ptr<LearnedBlockIndex> learned_index_;
+};
+}  // namespace ROCKSDB_NAMESPACE
@@ -131,6 +131,10 @@ class CompactionMergingIterator : public InternalIterator {
     return current_->type == HeapItem::DELETE_RANGE_START;
   }
 
+  bool GetRawDataBlock(RawDataBlock* block) override;
+
+  void SkipRawDataBlock() override;
+
   // Compaction uses the above subset of InternalIterator interface.
   void SeekToLast() override { assert(false); }
 
@@ -334,6 +338,50 @@ void CompactionMergingIterator::Next() {
   current_ = CurrentForward();
 }
 
+bool CompactionMergingIterator::GetRawDataBlock(RawDataBlock* block) {
+  assert(Valid());
+  assert(current_ == CurrentForward());
+  if (current_->type != HeapItem::ITERATOR) {
+    return false;
+  }
+  if (!current_->iter.GetRawDataBlock(block)) {
+    if (!current_->iter.Valid()) {
+      // Failed with an error
+      considerStatus(current_->iter.status());
+      minHeap_.pop();
+      current_ = CurrentForward();
+    }
+    return false;
+  }
+  // No other child, or range tombstone, can have any of the user keys of the
+  // block
+  minHeap_.pop();
+  HeapItem* next = CurrentForward();
+  const bool overlaps =
+      next != nullptr &&
+      comparator_->user_comparator()->Compare(
+          ExtractUserKey(next->key()), ExtractUserKey(block->last_key)) <= 0;
+  minHeap_.push(current_);
+  assert(current_ == CurrentForward());
+  return !overlaps;
+}
+
+void CompactionMergingIterator::SkipRawDataBlock() {
+  assert(Valid());
+  assert(current_ == CurrentForward());
+  assert(current_->type == HeapItem::ITERATOR);
+  current_->iter.SkipRawDataBlock();
+  if (current_->iter.Valid()) {
+    assert(current_->iter.status().ok());
+    minHeap_.replace_top(current_);
+  } else {
+    considerStatus(current_->iter.status());
+    minHeap_.pop();
+  }
+  FindNextVisibleKey();
+  current_ = CurrentForward();
+}
+
 void CompactionMergingIterator::FindNextVisibleKey() {
   while (!minHeap_.empty()) {
     HeapItem* current = minHeap_.top();
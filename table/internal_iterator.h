@@ -18,6 +18,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 class PinnedIteratorsManager;
+struct RawDataBlock;
 
 enum class IterBoundCheck : char {
   kUnknown = 0,
@@ -212,6 +213,18 @@ class InternalIteratorBase : public Cleanable {
   // used by MergingIterator and LevelIterator for now.
   virtual bool IsDeleteRangeSentinelKey() const { return false; }
 
+  // If the iterator is at the first entry of a data block which can be copied
+  // as is to a compaction output, i.e. a block of a block-based table with
+  // only single versions of values, whose user keys are not in any other
+  // entry of the iterator, fills `block` and returns true. This should only
+  // be used by compactions for now.
+  // REQUIRES: Valid()
+  virtual bool GetRawDataBlock(RawDataBlock* /*block*/) { return false; }
+
+  // Moves to the first entry after the block of the last successful
+  // GetRawDataBlock(), which must have been called at the current position.
+  virtual void SkipRawDataBlock() { assert(false); }
+
  protected:
   void SeekForPrevImpl(const Slice& target, const CompareInterface* cmp) {
     Seek(target);
@@ -226,6 +239,25 @@ class InternalIteratorBase : public Cleanable {
 
 using InternalIterator = InternalIteratorBase<Slice>;
 
+// A data block of a block-based table, as stored in the file, with the
+// information needed to add it to another table without decoding it again.
+// See InternalIteratorBase::GetRawDataBlock().
+struct RawDataBlock {
+  // Block contents, without the block trailer
+  Slice contents;
+  CompressionType compression_type = kNoCompression;
+  // format_version of the table the block is from
+  uint32_t format_version = 0;
+  // Iterator over the entries of the block, at the first one. Only valid
+  // until the iterator the block is from moves.
+  InternalIterator* entries = nullptr;
+  Slice first_key;
+  Slice last_key;
+  uint64_t num_entries = 0;
+  uint64_t raw_key_size = 0;
+  uint64_t raw_value_size = 0;
+};
+
 // Return an empty iterator (yields nothing).
 template <class TValue = Slice>
 InternalIteratorBase<TValue>* NewEmptyInternalIterator();
@@ -195,6 +195,16 @@ class IteratorWrapperBase {
     return iter_->IsDeleteRangeSentinelKey();
   }
 
+  bool GetRawDataBlock(RawDataBlock* block) {
+    assert(Valid());
+    return iter_->GetRawDataBlock(block);
+  }
+  void SkipRawDataBlock() {
+    assert(iter_);
+    iter_->SkipRawDataBlock();
+    Update();
+  }
+
  private:
   void Update() {
     valid_ = iter_->Valid();
@@ -28,6 +28,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 class Slice;
+struct RawDataBlock;
 class Status;
 
 struct TableReaderOptions {
@@ -163,6 +164,12 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
   const uint64_t cur_file_num;
+
+  // For compaction outputs with PrepopulateBlockCache::kFlushAndHotCompaction,
+  // the sorted and disjoint ranges [first, last] of user keys of the input
+  // data blocks found in the block cache. Not owned.
+  const std::vector<std::pair<std::string, std::string>>* hot_key_ranges =
+      nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -182,6 +189,16 @@ class TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   virtual void Add(const Slice& key, const Slice& value) = 0;
 
+  // Adds a data block of another table as is, after the keys added so far.
+  // Returns false, without adding anything, if the block cannot be copied to
+  // this table, e.g. because of a different compression. Consumes
+  // `block.entries`.
+  // REQUIRES: The first key of the block is after any previously added key.
+  // REQUIRES: Finish(), Abandon() have not been called
+  virtual bool AddRawDataBlock(const RawDataBlock& /*block*/) {
+    return false;
+  }
+
   // Return non-ok iff some error has been detected.
   virtual Status status() const = 0;
 
@@ -109,6 +109,17 @@ class TableReader {
     return Status::NotSupported("ApproximateKeyAnchors() not supported.");
   }
 
+  // Appends the ranges [first, last] of user keys of the data blocks in the
+  // block cache, in order, merging those of consecutive blocks. A range
+  // starts at the index key of the block before, or at `smallest_user_key`
+  // for the first block, so it can extend a bit before the keys of its
+  // blocks.
+  virtual Status GetCachedKeyRanges(
+      const ReadOptions& /*read_options*/, const Slice& /*smallest_user_key*/,
+      std::vector<std::pair<std::string, std::string>>* /*ranges*/) {
+    return Status::NotSupported("GetCachedKeyRanges() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
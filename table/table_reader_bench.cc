@@ -36,18 +36,29 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 // Make a key that i determines the first 4 characters and j determines the
-// last 4 characters.
-static std::string MakeKey(int i, int j, bool through_db) {
-  char buf[100];
-  snprintf(buf, sizeof(buf), "%04d__key___%04d", i, j);
+// last 4 characters. With numeric_keys, the key is instead the 8-byte
+// big-endian encoding of i and j, as 32-bit integers.
+static std::string MakeKey(int i, int j, bool through_db, bool numeric_keys) {
+  std::string user_key;
+  if (numeric_keys) {
+    const uint64_t v =
+        (uint64_t{static_cast<uint32_t>(i)} << 32) | static_cast<uint32_t>(j);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+      user_key.push_back(static_cast<char>((v >> shift) & 0xff));
+    }
+  } else {
+    char buf[100];
+    snprintf(buf, sizeof(buf), "%04d__key___%04d", i, j);
+    user_key = buf;
+  }
   if (through_db) {
-    return std::string(buf);
+    return user_key;
   }
   // If we directly query table, which operates on internal keys
   // instead of user keys, we need to add 8 bytes of internal
   // information (row type etc) to user key to make an internal
   // key.
-  InternalKey key(std::string(buf), 0, ValueType::kTypeValue);
+  InternalKey key(user_key, 0, ValueType::kTypeValue);
   return key.Encode().ToString();
 }
 
@@ -69,12 +80,17 @@ uint64_t Now(SystemClock* clock, bool measured_by_nanosecond) {
 //
 // If for_terator=true, instead of just query one key each time, it queries
 // a range sharing the same prefix.
+//
+// When querying the table directly, also print the memory used by the table
+// reader (including the index, when it is not in the block cache) and the
+// size of the index.
 namespace {
 void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
                           ReadOptions& read_options, int num_keys1,
                           int num_keys2, int num_iter, int /*prefix_len*/,
                           bool if_query_empty_keys, bool for_iterator,
-                          bool through_db, bool measured_by_nanosecond) {
+                          bool through_db, bool measured_by_nanosecond,
+                          bool numeric_keys) {
   ROCKSDB_NAMESPACE::InternalKeyComparator ikc(opts.comparator);
 
   std::string file_name =
@@ -114,7 +130,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
   // Populate slightly more than 1M keys
   for (int i = 0; i < num_keys1; i++) {
     for (int j = 0; j < num_keys2; j++) {
-      std::string key = MakeKey(i * 2, j, through_db);
+      std::string key = MakeKey(i * 2, j, through_db, numeric_keys);
       if (!through_db) {
         tb->Add(key, key);
       } else {
@@ -170,7 +186,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
 
         if (!for_iterator) {
           // Query one existing key;
-          std::string key = MakeKey(r1, r2, through_db);
+          std::string key = MakeKey(r1, r2, through_db, numeric_keys);
           uint64_t start_time = Now(clock, measured_by_nanosecond);
           if (!through_db) {
             PinnableSlice value;
@@ -196,8 +212,9 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
               r2_len = num_keys2 - r2;
             }
           }
-          std::string start_key = MakeKey(r1, r2, through_db);
-          std::string end_key = MakeKey(r1, r2 + r2_len, through_db);
+          std::string start_key = MakeKey(r1, r2, through_db, numeric_keys);
+          std::string end_key =
+              MakeKey(r1, r2 + r2_len, through_db, numeric_keys);
           uint64_t total_time = 0;
           uint64_t start_time = Now(clock, measured_by_nanosecond);
           Iterator* iter = nullptr;
@@ -218,7 +235,7 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
             }
             // verify key;
             total_time += Now(clock, measured_by_nanosecond) - start_time;
-            assert(Slice(MakeKey(r1, r2 + count, through_db)) ==
+            assert(Slice(MakeKey(r1, r2 + count, through_db, numeric_keys)) ==
                    (through_db ? iter->key() : iiter->key()));
             start_time = Now(clock, measured_by_nanosecond);
             if (++count >= r2_len) {
@@ -254,6 +271,11 @@ void TableReaderBenchmark(Options& opts, EnvOptions& env_options,
       measured_by_nanosecond ? "nanosecond" : "microsecond",
       hist.ToString().c_str());
   if (!through_db) {
+    fprintf(stderr,
+            "Table reader memory usage: %" ROCKSDB_PRIszt
+            " bytes   index size: %" PRIu64 " bytes\n",
+            table_reader->ApproximateMemoryUsage(),
+            table_reader->GetTableProperties()->index_size);
     env->DeleteFile(file_name);
   } else {
     delete db;
@@ -278,6 +300,14 @@ DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default), `plain_table` or "
               "`cuckoo_hash`.");
+DEFINE_int32(index_type,
+             static_cast<int32_t>(
+                 ROCKSDB_NAMESPACE::BlockBasedTableOptions().index_type),
+             "Index type of the block_based table factory, as an integer "
+             "value of BlockBasedTableOptions::IndexType");
+DEFINE_bool(numeric_keys, false,
+            "Use 8-byte big-endian encoded integers as keys instead of "
+            "16-byte strings.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -309,7 +339,7 @@ int main(int argc, char** argv) {
     env_options.use_mmap_reads = FLAGS_mmap_read;
 
     ROCKSDB_NAMESPACE::PlainTableOptions plain_table_options;
-    plain_table_options.user_key_len = 16;
+    plain_table_options.user_key_len = FLAGS_numeric_keys ? 8 : 16;
     plain_table_options.bloom_bits_per_key = (FLAGS_prefix_len == 16) ? 0 : 8;
     plain_table_options.hash_table_ratio = 0.75;
 
@@ -317,7 +347,11 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(
         ROCKSDB_NAMESPACE::NewFixedPrefixTransform(FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory());
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions table_options;
+    table_options.index_type =
+        static_cast<ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType>(
+            FLAGS_index_type);
+    tf.reset(new ROCKSDB_NAMESPACE::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
@@ -330,7 +364,7 @@ int main(int argc, char** argv) {
     ROCKSDB_NAMESPACE::TableReaderBenchmark(
         options, env_options, ro, FLAGS_num_keys1, FLAGS_num_keys2, FLAGS_iter,
         FLAGS_prefix_len, FLAGS_query_empty, FLAGS_iterator, FLAGS_through_db,
-        measured_by_nanosecond);
+        measured_by_nanosecond, FLAGS_numeric_keys);
   } else {
     return 1;
   }
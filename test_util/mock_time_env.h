@@ -9,6 +9,7 @@
 #include <limits>
 
 #include "port/port.h"
+#include "port/sys_time.h"
 #include "rocksdb/system_clock.h"
 #include "test_util/mock_time_env.h"
 #include "test_util/sync_point.h"
@@ -117,11 +117,13 @@ DEFINE_string(
     "filluniquerandomdeterministic,"
     "overwrite,"
     "readrandom,"
+    "readrandomrepeatedmiss,"
     "newiterator,"
     "newiteratorwhilewriting,"
     "seekrandom,"
     "seekrandomwhilewriting,"
     "seekrandomwhilemerging,"
+    "seekrandomhotprefix,"
     "readseq,"
     "readreverse,"
     "compact,"
@@ -178,13 +180,25 @@ DEFINE_string(
     "sync mode\n"
     "\tfill100K      -- write N/1000 100K values in random order in"
     " async mode\n"
+    "\tfillsortedbatch   -- write N values in random key order, each write"
+    " batch of --batch_size keys sorted by key\n"
+    "\tfillunsortedbatch -- same keys as fillsortedbatch, but the write"
+    " batches are left unsorted\n"
+    "\tfillrandomscaling -- fillrandom with 1, 2, 4, ... up to --threads"
+    " writer threads, reporting the write throughput for each thread count\n"
     "\tdeleteseq     -- delete N keys in sequential order\n"
     "\tdeleterandom  -- delete N keys in random order\n"
     "\treadseq       -- read N times sequentially\n"
     "\treadtocache   -- 1 thread reading database sequentially\n"
     "\treadreverse   -- read N times in reverse order\n"
     "\treadrandom    -- read N times in random order\n"
+    "\treadtosteadystate -- like readrandom, reporting the time until the "
+    "block cache hit rate is stable, e.g. after a restart with "
+    "--block_cache_dump_file\n"
     "\treadmissing   -- read N missing keys in random order\n"
+    "\treadrandomrepeatedmiss -- readrandom with read_miss_percent of the "
+    "reads for missing keys, repeated_miss_percent of those for "
+    "read_miss_hot_keys hot missing keys\n"
     "\treadwhilewriting      -- 1 writer, N threads doing random "
     "reads\n"
     "\treadwhilemerging      -- 1 merger, N threads doing random "
@@ -211,6 +225,8 @@ DEFINE_string(
     "overwrite\n"
     "\tseekrandomwhilemerging -- seekrandom and 1 thread doing "
     "merge\n"
+    "\tseekrandomhotprefix -- seekrandom with seek_hot_prefix_percent of "
+    "the seeks going to the start of seek_hot_prefixes hot prefixes\n"
     "\tcrc32c        -- repeated crc32c of <block size> data\n"
     "\txxhash        -- repeated xxHash of <block size> data\n"
     "\txxhash64      -- repeated xxHash64 of <block size> data\n"
@@ -234,6 +250,14 @@ DEFINE_string(
     "\tstats       -- Print DB stats\n"
     "\tresetstats  -- Reset DB stats\n"
     "\tlevelstats  -- Print the number of files and bytes per level\n"
+    "\tamplification -- Print the write and space amplification so far, and "
+    "the read amplification of the point lookups (with --statistics). E.g. "
+    "compare --compaction_pri values on skewed reads with "
+    "--benchmarks=fillrandom,readwhilewriting,amplification "
+    "--read_random_exp_range=10 --bloom_bits=10 --statistics, or "
+    "--compaction_style values 0, 1 and 4 with "
+    "--benchmarks=fillrandom,overwrite,readrandom,amplification "
+    "--bloom_bits=10 --statistics\n"
     "\tmemstats  -- Print memtable stats\n"
     "\tsstables    -- Print sstable info\n"
     "\theapprofile -- Dump a heap profile (if supported by this port)\n"
@@ -324,6 +348,27 @@ DEFINE_int32(seek_nexts, 0,
              "fillseekseq, seekrandom, seekrandomwhilewriting and "
              "seekrandomwhilemerging");
 
+DEFINE_int64(seek_hot_prefixes, 100,
+             "Number of hot seek keys in seekrandomhotprefix, evenly spread "
+             "over the key space so that each starts a prefix when "
+             "keys_per_prefix divides num / seek_hot_prefixes");
+
+DEFINE_int32(seek_hot_prefix_percent, 90,
+             "Percentage of the seeks to the hot seek keys in "
+             "seekrandomhotprefix. The others are uniformly random.");
+
+DEFINE_int32(read_miss_percent, 40,
+             "Percentage of the reads for keys not in the DB in "
+             "readrandomrepeatedmiss");
+
+DEFINE_int32(repeated_miss_percent, 90,
+             "Percentage of the reads for missing keys going to one of "
+             "read_miss_hot_keys keys in readrandomrepeatedmiss. The others "
+             "are for uniformly random missing keys.");
+
+DEFINE_int64(read_miss_hot_keys, 1000,
+             "Number of hot missing keys in readrandomrepeatedmiss");
+
 DEFINE_bool(reverse_iterator, false,
             "When true use Prev rather than Next for iterators that do "
             "Seek and then Next");
@@ -530,12 +575,15 @@ DEFINE_int32(max_background_flushes,
 static ROCKSDB_NAMESPACE::CompactionStyle FLAGS_compaction_style_e;
 DEFINE_int32(compaction_style,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_style,
-             "style of compaction: level-based, universal and fifo");
+             "style of compaction: level-based, universal, fifo and lazy "
+             "level");
 
 static ROCKSDB_NAMESPACE::CompactionPri FLAGS_compaction_pri_e;
 DEFINE_int32(compaction_pri,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_pri,
-             "priority of files to compaction: by size or by data age");
+             "priority of files to compaction: by size, by data age, by "
+             "overlapping ratio, round-robin, or by read heat and overlapping "
+             "ratio (see CompactionPri)");
 
 DEFINE_int32(universal_size_ratio, 0,
              "Percentage flexibility while comparing file size "
@@ -565,6 +613,22 @@ DEFINE_bool(universal_allow_trivial_move, false,
 DEFINE_bool(universal_incremental, false,
             "Enable incremental compactions in universal compaction.");
 
+DEFINE_uint32(
+    lazy_level_size_ratio,
+    ROCKSDB_NAMESPACE::CompactionOptionsLazyLevel().size_ratio,
+    "The size ratio between the logical levels (for lazy level compaction "
+    "only).");
+
+DEFINE_int32(lazy_level_max_sorted_runs,
+             ROCKSDB_NAMESPACE::CompactionOptionsLazyLevel().max_sorted_runs,
+             "The max number of sorted runs per logical level (for lazy level "
+             "compaction only).");
+
+DEFINE_string(lazy_level_max_sorted_runs_per_level, "",
+              "Comma-separated max number of sorted runs of the logical "
+              "levels 0, 1, ... overriding --lazy_level_max_sorted_runs (for "
+              "lazy level compaction only).");
+
 DEFINE_int32(
     universal_stop_style,
     (int32_t)ROCKSDB_NAMESPACE::CompactionOptionsUniversal().stop_style,
@@ -653,6 +717,11 @@ DEFINE_bool(use_cache_jemalloc_no_dump_allocator, false,
 DEFINE_bool(use_cache_memkind_kmem_allocator, false,
             "Use memkind kmem allocator for block/blob cache.");
 
+DEFINE_bool(use_cache_huge_page_slab_allocator, false,
+            "Use HugePageSlabAllocator for block/blob cache, with a capacity "
+            "of 1.25 times --cache_size to leave room for internal "
+            "fragmentation.");
+
 DEFINE_bool(
     decouple_partitioned_filters,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().decouple_partitioned_filters,
@@ -665,6 +734,10 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(use_learned_index, false,
+            "Locate data blocks with a learned model of the index keys "
+            "(kLearnedIndexSearch)");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -726,8 +799,9 @@ DEFINE_bool(block_align,
             "Align data blocks on page size");
 
 DEFINE_int64(prepopulate_block_cache, 0,
-             "Pre-populate hot/warm blocks in block cache. 0 to disable and 1 "
-             "to insert during flush");
+             "Pre-populate hot/warm blocks in block cache. 0 to disable, 1 "
+             "to insert during flush, and 2 to also insert the data blocks of "
+             "compaction outputs whose keys were in cached input blocks");
 
 DEFINE_uint32(uncache_aggressiveness,
               ROCKSDB_NAMESPACE::ColumnFamilyOptions().uncache_aggressiveness,
@@ -740,6 +814,11 @@ DEFINE_bool(use_data_block_hash_index, false,
             "instead of kDataBlockBinarySearch. "
             "This is valid if only we use BlockTable");
 
+DEFINE_bool(use_data_block_interpolation_index, false,
+            "if use kDataBlockInterpolationSearch "
+            "instead of kDataBlockBinarySearch. "
+            "This is valid if only we use BlockTable");
+
 DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "util ratio for data block hash index table. "
               "This is only valid if use_data_block_hash_index is "
@@ -752,6 +831,18 @@ DEFINE_int64(row_cache_size, 0,
              "Number of bytes to use as a cache of individual rows"
              " (0 = disabled).");
 
+DEFINE_int64(scan_cache_size, 0,
+             "Number of bytes to use as a cache of short scan results"
+             " (0 = disabled). See also --scan_cache_max_entries.");
+
+DEFINE_int32(scan_cache_max_entries, 0,
+             "Sets ReadOptions::scan_cache_max_entries, the number of entries "
+             "from each seek stored in the scan cache (0 = not used).");
+
+DEFINE_int64(negative_lookup_cache_size, 0,
+             "Number of bytes used to remember the recent lookups of missing "
+             "keys (0 = disabled)");
+
 DEFINE_int32(open_files, ROCKSDB_NAMESPACE::Options().max_open_files,
              "Maximum number of files to keep open at the same time"
              " (use default if == 0)");
@@ -761,10 +852,32 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_string(block_cache_dump_file,
+              ROCKSDB_NAMESPACE::Options().block_cache_dump_file,
+              "If not empty, the block cache is saved to this file on close "
+              "and loaded from it on open. See readtosteadystate.");
+
+DEFINE_int64(steady_state_interval, 10000,
+             "Number of reads per interval in readtosteadystate");
+
+DEFINE_double(steady_state_hit_rate_delta, 0.01,
+              "readtosteadystate reaches the steady state when the block "
+              "cache hit rate changes by less than this between intervals");
+
 DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_uint64(compaction_pipeline_buffer_size,
+              ROCKSDB_NAMESPACE::Options().compaction_pipeline_buffer_size,
+              "Size of the buffer between the input and compaction threads "
+              "of a compaction (0 = the input is read on the compaction "
+              "thread)");
+
+DEFINE_bool(compaction_copy_data_blocks,
+            ROCKSDB_NAMESPACE::Options().compaction_copy_data_blocks,
+            "Copy the data blocks output unchanged by compactions as is");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(writable_file_max_buffer_size, 1024 * 1024,
@@ -1012,6 +1125,7 @@ DEFINE_string(
     "\t--statistics\n"
     "\t--row_cache_size\n"
     "\t--row_cache_numshardbits\n"
+    "\t--scan_cache_size\n"
     "\t--enable_io_prio\n"
     "\t--dump_malloc_stats\n"
     "\t--num_multi_db\n");
@@ -1475,6 +1589,17 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_bool(enable_parallel_wal_copy,
+            ROCKSDB_NAMESPACE::Options().enable_parallel_wal_copy,
+            "Let each writer of a write group copy its batch into the WAL "
+            "record in parallel");
+
+DEFINE_bool(enable_lock_free_wal_buffer,
+            ROCKSDB_NAMESPACE::Options().enable_lock_free_wal_buffer,
+            "Let unsynced writes skip the write thread and buffer their WAL "
+            "records lock-free. Requires --manual_wal_flush and "
+            "--enable_pipelined_write=false");
+
 DEFINE_bool(
     unordered_write, false,
     "Enable the unordered write feature, which provides higher throughput but "
@@ -1635,6 +1760,10 @@ DEFINE_bool(use_direct_io_for_flush_and_compaction,
             ROCKSDB_NAMESPACE::Options().use_direct_io_for_flush_and_compaction,
             "Use O_DIRECT for background flush and compaction writes");
 
+DEFINE_bool(use_async_io_for_writes,
+            ROCKSDB_NAMESPACE::Options().use_async_io_for_writes,
+            "Queue WAL, flush and compaction writes on io_uring");
+
 DEFINE_bool(advise_random_on_open,
             ROCKSDB_NAMESPACE::Options().advise_random_on_open,
             "Advise random access on table file open");
@@ -1836,6 +1965,9 @@ static Status CreateMemTableRepFactory(
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(),
                          VectorRepFactory::kNickName())) {
     factory->reset(new VectorRepFactory());
+  } else if (!strcasecmp(FLAGS_memtablerep.c_str(),
+                         BTreeRepFactory::kNickName())) {
+    factory->reset(new BTreeRepFactory());
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(), "hash_linkedlist")) {
     factory->reset(NewHashLinkListRepFactory(FLAGS_hash_bucket_count));
   } else {
@@ -2687,6 +2819,22 @@ class CombinedStats {
     }
   }
 
+  // Reports one line per run, where run i used thread_counts[i] threads.
+  void ReportScaling(const std::string& bench_name,
+                     const std::vector<int>& thread_counts) {
+    assert(thread_counts.size() == throughput_ops_.size());
+    const char* name = bench_name.c_str();
+    for (size_t i = 0; i < throughput_ops_.size(); ++i) {
+      fprintf(stdout, "%s [%3d threads] : %d ops/sec; %.2fx", name,
+              thread_counts[i], static_cast<int>(throughput_ops_[i]),
+              throughput_ops_[i] / throughput_ops_[0]);
+      if (throughput_mbs_.size() == throughput_ops_.size()) {
+        fprintf(stdout, "; %6.1f MB/sec", throughput_mbs_[i]);
+      }
+      fprintf(stdout, "\n");
+    }
+  }
+
   void ReportFinal(const std::string& bench_name) {
     if (throughput_ops_.size() < 2) {
       // skip if there are not enough samples
@@ -3295,6 +3443,18 @@ class Benchmark {
       fprintf(stderr, "Memkind library is not linked with the binary.\n");
       exit(1);
 #endif
+    } else if (FLAGS_use_cache_huge_page_slab_allocator) {
+      HugePageSlabAllocatorOptions slab_options;
+      slab_options.capacity =
+          std::max(static_cast<size_t>(FLAGS_cache_size) / 4 * 5,
+                   slab_options.slab_size);
+      slab_options.statistics = dbstats;
+      Status s = NewHugePageSlabAllocator(slab_options, &allocator);
+      if (!s.ok()) {
+        fprintf(stderr, "Failed to create HugePageSlabAllocator: %s\n",
+                s.ToString().c_str());
+        exit(1);
+      }
     }
 
     return allocator;
@@ -3707,6 +3867,8 @@ class Benchmark {
       read_options_.auto_readahead_size = FLAGS_auto_readahead_size;
       read_options_.auto_refresh_iterator_with_snapshot =
           FLAGS_auto_refresh_iterator_with_snapshot;
+      read_options_.scan_cache_max_entries =
+          static_cast<size_t>(FLAGS_scan_cache_max_entries);
 
       // YCSB valu_size 400으로 고정 (= field_count * field_len)
       field_count_ = 4;
@@ -3792,6 +3954,9 @@ class Benchmark {
       } else if (name == "fillrandom") {
         fresh_db = true;
         method = &Benchmark::WriteRandom;
+      } else if (name == "fillrandomscaling") {
+        fresh_db = true;
+        method = &Benchmark::WriteRandom;
       } else if (name == "filluniquerandom" ||
                  name == "fillanddeleteuniquerandom") {
         fresh_db = true;
@@ -3814,6 +3979,16 @@ class Benchmark {
         num_ /= 1000;
         value_size = 100 * 1000;
         method = &Benchmark::WriteRandom;
+      } else if (name == "fillsortedbatch" || name == "fillunsortedbatch") {
+        fresh_db = true;
+        if (entries_per_batch_ == 1) {
+          entries_per_batch_ = 1000;
+        }
+        if (name == "fillsortedbatch") {
+          method = &Benchmark::WriteSortedBatch;
+        } else {
+          method = &Benchmark::WriteUnsortedBatch;
+        }
       } else if (name == "readseq") {
         method = &Benchmark::ReadSequential;
       } else if (name == "readtorowcache") {
@@ -3836,6 +4011,8 @@ class Benchmark {
                   entries_per_batch_);
         }
         method = &Benchmark::ReadRandom;
+      } else if (name == "readtosteadystate") {
+        method = &Benchmark::ReadToSteadyState;
       } else if (name == "readrandomfast") {
         method = &Benchmark::ReadRandomFast;
       } else if (name == "multireadrandom") {
@@ -3858,6 +4035,8 @@ class Benchmark {
       } else if (name == "readmissing") {
         ++key_size_;
         method = &Benchmark::ReadRandom;
+      } else if (name == "readrandomrepeatedmiss") {
+        method = &Benchmark::ReadRandomRepeatedMiss;
       } else if (name == "newiterator") {
         method = &Benchmark::IteratorCreation;
       } else if (name == "newiteratorwhilewriting") {
@@ -3871,6 +4050,8 @@ class Benchmark {
       } else if (name == "seekrandomwhilemerging") {
         num_threads++;  // Add extra thread for merging
         method = &Benchmark::SeekRandomWhileMerging;
+      } else if (name == "seekrandomhotprefix") {
+        method = &Benchmark::SeekRandomHotPrefix;
       } else if (name == "readrandomsmall") {
         reads_ /= 1000;
         method = &Benchmark::ReadRandom;
@@ -4023,6 +4204,8 @@ class Benchmark {
         VerifyDBFromDB(FLAGS_truth_db);
       } else if (name == "levelstats") {
         PrintStats("rocksdb.levelstats");
+      } else if (name == "amplification") {
+        PrintAmplification();
       } else if (name == "memstats") {
         std::vector<std::string> keys{"rocksdb.num-immutable-mem-table",
                                       "rocksdb.cur-size-active-mem-table",
@@ -4180,6 +4363,8 @@ class Benchmark {
           if (name == "YCSBLOAD" || name == "fillrandom") {
             num_threads = 1;
             stats = RunBenchmark(num_threads, name, method);
+          } else if (name == "fillrandomscaling") {
+            stats = RunWriteScaling(num_threads, name, method);
           } else {
             stats = RunBenchmark(num_threads, name, method);
           }
@@ -4364,6 +4549,26 @@ class Benchmark {
     return merge_stats;
   }
 
+  // Runs `method` with 1, 2, 4, ... up to `max_threads` threads against the
+  // same DB and reports the throughput of each run relative to the single
+  // threaded one. Returns the stats of the run with `max_threads` threads.
+  Stats RunWriteScaling(int max_threads, const std::string& name,
+                        void (Benchmark::*method)(ThreadState*)) {
+    std::vector<int> thread_counts;
+    CombinedStats scaling_stats;
+    Stats stats;
+    for (int n = 1;; n = std::min(n * 2, max_threads)) {
+      stats = RunBenchmark(n, name + "[" + std::to_string(n) + "]", method);
+      thread_counts.push_back(n);
+      scaling_stats.AddStats(stats);
+      if (n >= max_threads) {
+        break;
+      }
+    }
+    scaling_stats.ReportScaling(name, thread_counts);
+    return stats;
+  }
+
   template <OperationType kOpType, typename FnType, typename... Args>
   static inline void ChecksumBenchmark(FnType fn, ThreadState* thread,
                                        Args... args) {
@@ -4573,6 +4778,7 @@ class Benchmark {
     options.use_direct_reads = FLAGS_use_direct_reads;
     options.use_direct_io_for_flush_and_compaction =
         FLAGS_use_direct_io_for_flush_and_compaction;
+    options.use_async_io_for_writes = FLAGS_use_async_io_for_writes;
     options.manual_wal_flush = FLAGS_manual_wal_flush;
     options.wal_compression = FLAGS_wal_compression_e;
     options.ttl = FLAGS_fifo_compaction_ttl;
@@ -4600,8 +4806,14 @@ class Benchmark {
               FLAGS_memtable_insert_with_hint_prefix_size));
     }
     options.bloom_locality = FLAGS_bloom_locality;
+    options.negative_lookup_cache_size =
+        static_cast<size_t>(FLAGS_negative_lookup_cache_size);
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.block_cache_dump_file = FLAGS_block_cache_dump_file;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_pipeline_buffer_size =
+        static_cast<size_t>(FLAGS_compaction_pipeline_buffer_size);
+    options.compaction_copy_data_blocks = FLAGS_compaction_copy_data_blocks;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.use_fsync = FLAGS_use_fsync;
@@ -4698,6 +4910,9 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type =
+            BlockBasedTableOptions::kLearnedIndexSearch;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4793,6 +5008,10 @@ class Benchmark {
           prepopulate_block_cache =
               BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly;
           break;
+        case 2:
+          prepopulate_block_cache = BlockBasedTableOptions::
+              PrepopulateBlockCache::kFlushAndHotCompaction;
+          break;
         default:
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
@@ -4800,6 +5019,9 @@ class Benchmark {
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+      } else if (FLAGS_use_data_block_interpolation_index) {
+        block_based_options.data_block_index_type = ROCKSDB_NAMESPACE::
+            BlockBasedTableOptions::kDataBlockInterpolationSearch;
       } else {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinarySearch;
@@ -4943,6 +5165,8 @@ class Benchmark {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.enable_parallel_wal_copy = FLAGS_enable_parallel_wal_copy;
+    options.enable_lock_free_wal_buffer = FLAGS_enable_lock_free_wal_buffer;
     options.unordered_write = FLAGS_unordered_write;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
@@ -5003,6 +5227,19 @@ class Benchmark {
         FLAGS_universal_incremental;
     options.compaction_options_universal.stop_style =
         static_cast<CompactionStopStyle>(FLAGS_universal_stop_style);
+
+    // set lazy level style compaction configurations, if applicable
+    options.compaction_options_lazy_level.size_ratio =
+        FLAGS_lazy_level_size_ratio;
+    options.compaction_options_lazy_level.max_sorted_runs =
+        FLAGS_lazy_level_max_sorted_runs;
+    for (const auto& runs :
+         StringSplit(FLAGS_lazy_level_max_sorted_runs_per_level, ',')) {
+      if (!runs.empty()) {
+        options.compaction_options_lazy_level.max_sorted_runs_per_level
+            .push_back(std::stoi(runs));
+      }
+    }
     if (FLAGS_thread_status_per_interval > 0) {
       options.enable_thread_tracking = true;
     }
@@ -5104,6 +5341,10 @@ class Benchmark {
       }
     }
 
+    if (options.scan_cache == nullptr && FLAGS_scan_cache_size) {
+      options.scan_cache = NewLRUCache(FLAGS_scan_cache_size);
+    }
+
     if (options.env == Env::Default()) {
       options.env = FLAGS_env;
     }
@@ -6887,6 +7128,157 @@ class Benchmark {
     thread->stats.AddMessage(msg);
   }
 
+  // Reads random keys, read_miss_percent of them past the keys of the DB.
+  // Of those missing keys, repeated_miss_percent are among the first
+  // read_miss_hot_keys ones, so that the same misses repeat.
+  void ReadRandomRepeatedMiss(ThreadState* thread) {
+    int64_t read = 0;
+    int64_t found = 0;
+    int64_t missing = 0;
+    int64_t hot_missing = 0;
+    int64_t bytes = 0;
+    ReadOptions options = read_options_;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    PinnableSlice pinnable_val;
+    const int64_t hot_keys = std::max(FLAGS_read_miss_hot_keys, int64_t{1});
+
+    Duration duration(FLAGS_duration, reads_);
+    while (!duration.Done(1)) {
+      DBWithColumnFamilies* db_with_cfh = SelectDBWithCfh(thread);
+      int64_t key_rand;
+      if (static_cast<int>(thread->rand.Uniform(100)) <
+          FLAGS_read_miss_percent) {
+        missing++;
+        if (static_cast<int>(thread->rand.Uniform(100)) <
+            FLAGS_repeated_miss_percent) {
+          hot_missing++;
+          key_rand = FLAGS_num + static_cast<int64_t>(thread->rand.Next() %
+                                                      hot_keys);
+        } else {
+          key_rand = FLAGS_num + hot_keys +
+                     static_cast<int64_t>(thread->rand.Next() % FLAGS_num);
+        }
+      } else {
+        key_rand = GetRandomKey(&thread->rand);
+      }
+      GenerateKeyFromInt(key_rand, FLAGS_num, &key);
+      read++;
+      pinnable_val.Reset();
+      Status s = db_with_cfh->db->Get(
+          options, db_with_cfh->db->DefaultColumnFamily(), key, &pinnable_val);
+      if (s.ok()) {
+        found++;
+        bytes += key.size() + pinnable_val.size();
+      } else if (!s.IsNotFound()) {
+        fprintf(stderr, "Get returned an error: %s\n", s.ToString().c_str());
+        abort();
+      }
+
+      if (thread->shared->read_rate_limiter.get() != nullptr &&
+          read % 256 == 255) {
+        thread->shared->read_rate_limiter->Request(
+            256, Env::IO_HIGH, nullptr /* stats */, RateLimiter::OpType::kRead);
+      }
+
+      thread->stats.FinishedOps(db_with_cfh, db_with_cfh->db, 1, kRead);
+    }
+
+    char msg[150];
+    snprintf(msg, sizeof(msg),
+             "(%" PRIu64 " of %" PRIu64 " found, %" PRIu64
+             " for missing keys, %" PRIu64 " of them hot)\n",
+             found, read, missing, hot_missing);
+
+    thread->stats.AddBytes(bytes);
+    thread->stats.AddMessage(msg);
+  }
+
+  // Reads random keys, measuring the block cache hit rate of every
+  // --steady_state_interval reads, and reports the time and number of reads
+  // until it changes by less than --steady_state_hit_rate_delta from an
+  // interval to the next. Run right after opening the DB, this measures how
+  // fast the block cache warms up, e.g. with --block_cache_dump_file.
+  void ReadToSteadyState(ThreadState* thread) {
+    int64_t read = 0;
+    int64_t found = 0;
+    int64_t bytes = 0;
+    ReadOptions options = read_options_;
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    PinnableSlice pinnable_val;
+
+    const PerfLevel prev_perf_level = GetPerfLevel();
+    if (prev_perf_level < PerfLevel::kEnableCount) {
+      SetPerfLevel(PerfLevel::kEnableCount);
+    }
+    const PerfContext* perf_ctx = get_perf_context();
+    uint64_t last_hits = perf_ctx->block_cache_hit_count;
+    uint64_t last_misses = perf_ctx->block_read_count;
+    const int64_t interval = std::max(FLAGS_steady_state_interval, int64_t{1});
+    double prev_hit_rate = -1.0;
+    double hit_rate = 0.0;
+    int64_t steady_reads = 0;
+    uint64_t steady_micros = 0;
+    const uint64_t start = FLAGS_env->NowMicros();
+
+    Duration duration(FLAGS_duration, reads_);
+    while (!duration.Done(1)) {
+      DBWithColumnFamilies* db_with_cfh = SelectDBWithCfh(thread);
+      int64_t key_rand = GetRandomKey(&thread->rand);
+      GenerateKeyFromInt(key_rand, FLAGS_num, &key);
+      read++;
+      ColumnFamilyHandle* cfh = FLAGS_num_column_families > 1
+                                    ? db_with_cfh->GetCfh(key_rand)
+                                    : db_with_cfh->db->DefaultColumnFamily();
+      pinnable_val.Reset();
+      Status s = db_with_cfh->db->Get(options, cfh, key, &pinnable_val);
+      if (s.ok()) {
+        found++;
+        bytes += key.size() + pinnable_val.size();
+      } else if (!s.IsNotFound()) {
+        fprintf(stderr, "Get returned an error: %s\n", s.ToString().c_str());
+        abort();
+      }
+      thread->stats.FinishedOps(db_with_cfh, db_with_cfh->db, 1, kRead);
+
+      if (read % interval == 0) {
+        uint64_t hits = perf_ctx->block_cache_hit_count - last_hits;
+        uint64_t misses = perf_ctx->block_read_count - last_misses;
+        last_hits += hits;
+        last_misses += misses;
+        hit_rate = hits + misses > 0
+                       ? static_cast<double>(hits) / (hits + misses)
+                       : 1.0;
+        if (steady_reads == 0 && prev_hit_rate >= 0.0 &&
+            std::abs(hit_rate - prev_hit_rate) <
+                FLAGS_steady_state_hit_rate_delta) {
+          steady_reads = read;
+          steady_micros = FLAGS_env->NowMicros() - start;
+        }
+        prev_hit_rate = hit_rate;
+      }
+    }
+    SetPerfLevel(prev_perf_level);
+
+    char msg[200];
+    if (steady_reads > 0) {
+      snprintf(msg, sizeof(msg),
+               "(%" PRIu64 " of %" PRIu64
+               " found, steady state after %" PRIi64
+               " reads in %.3f seconds, block cache hit rate %.1f%%)\n",
+               found, read, steady_reads, steady_micros / 1e6,
+               hit_rate * 100.0);
+    } else {
+      snprintf(msg, sizeof(msg),
+               "(%" PRIu64 " of %" PRIu64
+               " found, no steady state, block cache hit rate %.1f%%)\n",
+               found, read, hit_rate * 100.0);
+    }
+    thread->stats.AddBytes(bytes);
+    thread->stats.AddMessage(msg);
+  }
+
   // Calls MultiGet over a list of keys from a random distribution.
   // Returns the total number of keys found.
   void MultiReadRandom(ThreadState* thread) {
@@ -7506,6 +7898,16 @@ class Benchmark {
   }
 
   void SeekRandom(ThreadState* thread) {
+    SeekRandomImpl(thread, /*hot_prefix=*/false);
+  }
+
+  // For short, repeated scans of the same prefixes, e.g. with
+  // --scan_cache_size
+  void SeekRandomHotPrefix(ThreadState* thread) {
+    SeekRandomImpl(thread, /*hot_prefix=*/true);
+  }
+
+  void SeekRandomImpl(ThreadState* thread, bool hot_prefix) {
     int64_t read = 0;
     int64_t found = 0;
     int64_t bytes = 0;
@@ -7547,8 +7949,16 @@ class Benchmark {
     } else {
       options.snapshot = nullptr;
     }
+    const int64_t hot_prefixes =
+        std::max(int64_t{1}, std::min(FLAGS_seek_hot_prefixes, FLAGS_num));
     while (!duration.Done(1)) {
       int64_t seek_pos = thread->rand.Next() % FLAGS_num;
+      if (hot_prefix &&
+          static_cast<int64_t>(thread->rand.Uniform(100)) <
+              FLAGS_seek_hot_prefix_percent) {
+        seek_pos = static_cast<int64_t>(thread->rand.Uniform(hot_prefixes)) *
+                   (FLAGS_num / hot_prefixes);
+      }
       GenerateKeyFromIntForSeek(static_cast<uint64_t>(seek_pos), FLAGS_num,
                                 &key);
       if (FLAGS_max_scan_distance != 0) {
@@ -7691,6 +8101,74 @@ class Benchmark {
     }
   }
 
+  // Writes random keys in batches of entries_per_batch_, optionally sorting
+  // each batch by key first. Comparing the two modes shows the benefit of the
+  // sorted run insert path of the memtable.
+  void DoBatchedWrite(ThreadState* thread, bool sorted) {
+    WriteBatch batch(/*reserved_bytes=*/0, /*max_bytes=*/0,
+                     FLAGS_write_batch_protection_bytes_per_key,
+                     user_timestamp_size_);
+    Duration duration(FLAGS_duration, num_);
+    std::unique_ptr<const char[]> key_guard;
+    Slice key = AllocateKey(&key_guard);
+    std::unique_ptr<char[]> ts_guard;
+    Slice ts;
+    if (user_timestamp_size_ > 0) {
+      ts_guard.reset(new char[user_timestamp_size_]);
+    }
+    RandomGenerator gen;
+    const Comparator* ucmp = open_options_.comparator;
+    std::vector<std::string> keys(entries_per_batch_);
+    int64_t bytes = 0;
+
+    while (!duration.Done(entries_per_batch_)) {
+      DB* db = SelectDB(thread);
+      for (int64_t j = 0; j < entries_per_batch_; ++j) {
+        GenerateKeyFromInt(thread->rand.Next() % FLAGS_num, FLAGS_num, &key);
+        keys[j].assign(key.data(), key.size());
+      }
+      if (sorted) {
+        std::sort(keys.begin(), keys.end(),
+                  [ucmp](const std::string& a, const std::string& b) {
+                    return ucmp->CompareWithoutTimestamp(a, false, b, false) <
+                           0;
+                  });
+      }
+      batch.Clear();
+      for (int64_t j = 0; j < entries_per_batch_; ++j) {
+        Status s = batch.Put(keys[j], gen.Generate());
+        if (!s.ok()) {
+          fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+        bytes += keys[j].size() + FLAGS_value_size;
+      }
+      Status s;
+      if (user_timestamp_size_ > 0) {
+        ts = mock_app_clock_->Allocate(ts_guard.get());
+        s = batch.UpdateTimestamps(
+            ts, [this](uint32_t) { return user_timestamp_size_; });
+        if (!s.ok()) {
+          fprintf(stderr, "assign timestamp: %s\n", s.ToString().c_str());
+          ErrorExit();
+        }
+      }
+      s = db->Write(write_options_, &batch);
+      thread->stats.FinishedOps(nullptr, db, entries_per_batch_, kWrite);
+      if (!s.ok()) {
+        fprintf(stderr, "put error: %s\n", s.ToString().c_str());
+        ErrorExit();
+      }
+    }
+    thread->stats.AddBytes(bytes);
+  }
+
+  void WriteSortedBatch(ThreadState* thread) { DoBatchedWrite(thread, true); }
+
+  void WriteUnsortedBatch(ThreadState* thread) {
+    DoBatchedWrite(thread, false);
+  }
+
   void DeleteSeq(ThreadState* thread) { DoDelete(thread, true); }
 
   void DeleteRandom(ThreadState* thread) { DoDelete(thread, false); }
@@ -9220,6 +9698,76 @@ class Benchmark {
     fprintf(stdout, "\n%s\n", stats.c_str());
   }
 
+  // Prints the write and space amplification of the default column family,
+  // and the read amplification of the point lookups: the number of files
+  // checked and read per lookup, from the filter statistics, and with
+  // --read_amp_bytes_per_bit, the ratio of the data block bytes read to the
+  // bytes used.
+  void PrintAmplification() {
+    if (db_.db != nullptr) {
+      PrintWriteAmplification(db_.db, false);
+      PrintSpaceAmplification(db_.db);
+    }
+    for (const auto& db_with_cfh : multi_dbs_) {
+      PrintWriteAmplification(db_with_cfh.db, true);
+      PrintSpaceAmplification(db_with_cfh.db);
+    }
+    if (dbstats == nullptr) {
+      fprintf(stdout, "Read amplification: (needs --statistics)\n");
+      return;
+    }
+    const uint64_t lookups = dbstats->getTickerCount(NUMBER_KEYS_READ);
+    if (lookups > 0) {
+      const uint64_t files_read =
+          dbstats->getTickerCount(BLOOM_FILTER_FULL_POSITIVE);
+      const uint64_t files_checked =
+          files_read + dbstats->getTickerCount(BLOOM_FILTER_USEFUL);
+      fprintf(stdout,
+              "Read amplification: %.2f files checked, %.2f files read per "
+              "lookup\n",
+              static_cast<double>(files_checked) / lookups,
+              static_cast<double>(files_read) / lookups);
+    }
+    const uint64_t useful_bytes =
+        dbstats->getTickerCount(READ_AMP_ESTIMATE_USEFUL_BYTES);
+    if (useful_bytes > 0) {
+      fprintf(stdout, "Block read amplification: %.2f\n",
+              static_cast<double>(
+                  dbstats->getTickerCount(READ_AMP_TOTAL_READ_BYTES)) /
+                  useful_bytes);
+    }
+  }
+
+  void PrintWriteAmplification(DB* db, bool print_header) {
+    if (print_header) {
+      fprintf(stdout, "\n==== DB: %s ===\n", db->GetName().c_str());
+    }
+    std::map<std::string, std::string> cf_stats;
+    if (!db->GetMapProperty(DB::Properties::kCFStats, &cf_stats)) {
+      fprintf(stdout, "Write amplification: (failed)\n");
+      return;
+    }
+    const auto it = cf_stats.find("compaction.Sum.WriteAmp");
+    fprintf(stdout, "Write amplification: %.2f\n",
+            it == cf_stats.end() ? 0.0 : std::stod(it->second));
+  }
+
+  // The space amplification is the size of the live SST files over the
+  // estimated size of the live data.
+  void PrintSpaceAmplification(DB* db) {
+    uint64_t sst_size = 0;
+    uint64_t live_data_size = 0;
+    if (!db->GetIntProperty(DB::Properties::kLiveSstFilesSize, &sst_size) ||
+        !db->GetIntProperty(DB::Properties::kEstimateLiveDataSize,
+                            &live_data_size) ||
+        live_data_size == 0) {
+      fprintf(stdout, "Space amplification: (failed)\n");
+      return;
+    }
+    fprintf(stdout, "Space amplification: %.2f\n",
+            static_cast<double>(sst_size) / live_data_size);
+  }
+
   void PrintStats(const std::vector<std::string>& keys) {
     if (db_.db != nullptr) {
       PrintStats(db_.db, keys);
@@ -71,14 +71,15 @@ default_params = {
     # Disabled because of various likely related failures with
     # "Cannot delete table file #N from level 0 since it is on level X"
     "promote_l0_one_in": 0,
-    "compaction_pri": random.randint(0, 4),
+    "compaction_pri": random.randint(0, 5),
     "key_may_exist_one_in": lambda: random.choice([100, 100000]),
-    "data_block_index_type": lambda: random.choice([0, 1]),
+    "data_block_index_type": lambda: random.choice([0, 1, 2]),
     "decouple_partitioned_filters": lambda: random.choice([0, 1, 1]),
     "delpercent": 4,
     "delrangepercent": 1,
     "destroy_db_initially": 0,
     "enable_pipelined_write": lambda: random.randint(0, 1),
+    "enable_lock_free_wal_buffer": lambda: random.choice([0, 0, 0, 1]),
     "enable_compaction_filter": lambda: random.choice([0, 0, 0, 1]),
     # `inplace_update_support` is incompatible with DB that has delete
     # range data in memtables.
@@ -102,7 +103,7 @@ default_params = {
     "get_sorted_wal_files_one_in": 0,
     "get_current_wal_file_one_in": 0,
     # Temporarily disable hash index
-    "index_type": lambda: random.choice([0, 0, 0, 2, 2, 3]),
+    "index_type": lambda: random.choice([0, 0, 0, 2, 2, 3, 4]),
     "ingest_external_file_one_in": lambda: random.choice([1000, 1000000]),
     "test_ingest_standalone_range_deletion_one_in": lambda: random.choice([0, 5, 10]),
     "iterpercent": 10,
@@ -203,6 +204,8 @@ default_params = {
     # that it won't recover past the WAL data hole created by this option
     "wal_bytes_per_sync": 0,
     "compaction_readahead_size": lambda: random.choice([0, 0, 1024 * 1024]),
+    "compaction_pipeline_buffer_size": lambda: random.choice([0, 0, 64 * 1024]),
+    "compaction_copy_data_blocks": lambda: random.randint(0, 1),
     "db_write_buffer_size": lambda: random.choice(
         [0, 0, 0, 1024 * 1024, 8 * 1024 * 1024, 128 * 1024 * 1024]
     ),
@@ -243,7 +246,7 @@ default_params = {
     "user_timestamp_size": 0,
     "secondary_cache_fault_one_in": lambda: random.choice([0, 0, 32]),
     "compressed_secondary_cache_size": lambda: random.choice([8388608, 16777216]),
-    "prepopulate_block_cache": lambda: random.choice([0, 1]),
+    "prepopulate_block_cache": lambda: random.choice([0, 1, 2]),
     "memtable_prefix_bloom_size_ratio": lambda: random.choice([0.001, 0.01, 0.1, 0.5]),
     "memtable_whole_key_filtering": lambda: random.randint(0, 1),
     "detect_filter_construct_corruption": lambda: random.choice([0, 1]),
@@ -341,6 +344,8 @@ default_params = {
     "check_multiget_entity_consistency": lambda: random.choice([0, 0, 0, 1]),
     "use_timed_put_one_in": lambda: random.choice([0] * 7 + [1, 5, 10]),
     "universal_max_read_amp": lambda: random.choice([-1] * 3 + [0, 4, 10]),
+    "lazy_level_size_ratio": lambda: random.choice([2, 4, 10]),
+    "lazy_level_max_sorted_runs": lambda: random.choice([1, 2, 4]),
     "paranoid_memory_checks": lambda: random.choice([0] * 7 + [1]),
     "allow_unprepared_value": lambda: random.choice([0, 1]),
     # TODO(hx235): enable `track_and_verify_wals` again after resolving the issues
@@ -838,6 +843,12 @@ def finalize_and_sanitize(src_params):
     else:
         # Disable irrelevant tiering options
         dest_params["file_temperature_age_thresholds"] = ""
+    if dest_params.get("compaction_style", 0) == 4:
+        # Lazy level compaction does not pick TTL, periodic or last level
+        # placement compactions
+        dest_params["compaction_ttl"] = 0
+        dest_params["periodic_compaction_seconds"] = 0
+        dest_params["preclude_last_level_data_seconds"] = 0
     if dest_params["partition_filters"] == 1:
         if dest_params["index_type"] != 2:
             dest_params["partition_filters"] = 0
@@ -945,6 +956,23 @@ def finalize_and_sanitize(src_params):
         # disable atomic flush.
         if dest_params["test_best_efforts_recovery"] == 0:
             dest_params["disable_wal"] = 0
+    # The lock-free WAL buffer keeps the guarantees of manual_wal_flush, and
+    # inserts into the memtable concurrently.
+    if dest_params.get("enable_lock_free_wal_buffer", 0) == 1:
+        if (
+            dest_params.get("manual_wal_flush_one_in", 0) == 0
+            or dest_params.get("inplace_update_support", 0) == 1
+            or dest_params.get("two_write_queues", 0) == 1
+            or dest_params.get("unordered_write", 0) == 1
+            or (
+                dest_params.get("user_timestamp_size", 0) > 0
+                and dest_params.get("persist_user_defined_timestamps", 1) == 0
+            )
+        ):
+            dest_params["enable_lock_free_wal_buffer"] = 0
+        else:
+            dest_params["allow_concurrent_memtable_write"] = 1
+            dest_params["enable_pipelined_write"] = 0
     if dest_params.get("allow_concurrent_memtable_write", 1) == 1:
         dest_params["memtablerep"] = "skip_list"
     if (
@@ -1030,6 +1058,8 @@ def finalize_and_sanitize(src_params):
     # Continuous verification fails with secondaries inside NonBatchedOpsStressTest
     if dest_params.get("test_secondary") == 1:
         dest_params["continuous_verification_interval"] = 0
+    if dest_params.get("allow_concurrent_memtable_write", 0) == 0:
+        dest_params["enable_lock_free_wal_buffer"] = 0
     return dest_params
 
 
@@ -1078,12 +1108,14 @@ def gen_cmd_params(args):
         params.update(blob_params)
 
     if "compaction_style" not in params:
-        # Default to leveled compaction
+        # Default to leveled compaction, with some lazy level compaction
         # TODO: Fix "Unsafe to store Seq later" with tiered+leveled and
         # enable that combination rather than falling back to universal.
         # TODO: There is also an alleged bug with leveled compaction
         # infinite looping but that likely would not fail the crash test.
-        params["compaction_style"] = 0 if not args.test_tiered_storage else 1
+        params["compaction_style"] = (
+            random.choice([0] * 9 + [4]) if not args.test_tiered_storage else 1
+        )
 
     for k, v in vars(args).items():
         if v is not None:
@@ -53,6 +53,13 @@ void CompactionJobStats::Reset() {
 
   num_single_del_fallthru = 0;
   num_single_del_mismatch = 0;
+
+  pipeline_input_busy_micros = 0;
+  pipeline_input_stall_micros = 0;
+  pipeline_merge_stall_micros = 0;
+
+  num_data_blocks_copied = 0;
+  num_data_blocks_rewritten = 0;
 }
 
 void CompactionJobStats::Add(const CompactionJobStats& stats) {
@@ -96,6 +103,13 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
 
+  pipeline_input_busy_micros += stats.pipeline_input_busy_micros;
+  pipeline_input_stall_micros += stats.pipeline_input_stall_micros;
+  pipeline_merge_stall_micros += stats.pipeline_merge_stall_micros;
+
+  num_data_blocks_copied += stats.num_data_blocks_copied;
+  num_data_blocks_rewritten += stats.num_data_blocks_rewritten;
+
   is_remote_compaction |= stats.is_remote_compaction;
 }
 
@@ -23,6 +23,7 @@
 #include "rocksdb/utilities/customizable_util.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "util/coding.h"
+#include "util/key_compare.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -34,7 +35,7 @@ class BytewiseComparatorImpl : public Comparator {
   const char* Name() const override { return kClassName(); }
 
   int Compare(const Slice& a, const Slice& b) const override {
-    return a.compare(b);
+    return BytewiseCompare(a, b);
   }
 
   bool Equal(const Slice& a, const Slice& b) const override { return a == b; }
@@ -43,11 +44,7 @@ class BytewiseComparatorImpl : public Comparator {
                              const Slice& limit) const override {
     // Find length of common prefix
     size_t min_length = std::min(start->size(), limit.size());
-    size_t diff_index = 0;
-    while ((diff_index < min_length) &&
-           ((*start)[diff_index] == limit[diff_index])) {
-      diff_index++;
-    }
+    size_t diff_index = SharedPrefixLength(Slice(*start), limit);
 
     if (diff_index >= min_length) {
       // Do not shorten if one string is a prefix of the other
@@ -109,7 +106,7 @@ class BytewiseComparatorImpl : public Comparator {
     if (s.size() != t.size() || s.size() == 0) {
       return false;
     }
-    size_t diff_ind = s.difference_offset(t);
+    size_t diff_ind = SharedPrefixLength(s, t);
     // same slice
     if (diff_ind >= s.size()) {
       return false;
@@ -157,18 +154,14 @@ class ReverseBytewiseComparatorImpl : public BytewiseComparatorImpl {
   const char* Name() const override { return kClassName(); }
 
   int Compare(const Slice& a, const Slice& b) const override {
-    return -a.compare(b);
+    return -BytewiseCompare(a, b);
   }
 
   void FindShortestSeparator(std::string* start,
                              const Slice& limit) const override {
     // Find length of common prefix
     size_t min_length = std::min(start->size(), limit.size());
-    size_t diff_index = 0;
-    while ((diff_index < min_length) &&
-           ((*start)[diff_index] == limit[diff_index])) {
-      diff_index++;
-    }
+    size_t diff_index = SharedPrefixLength(Slice(*start), limit);
 
     assert(diff_index <= min_length);
     if (diff_index == min_length) {
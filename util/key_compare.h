@@ -0,0 +1,182 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// Inline kernels for comparing short byte strings such as keys. Comparisons
+// of user keys sit at the top of profiles of point lookups, memtable inserts
+// and compaction, and are mostly done on keys of a few dozen bytes.
+//
+// SharedPrefixLength() compares 32 (AVX2), 16 (SSE4.2) and 8 bytes at a time
+// inline, picking the widest variant the build targets. Like the rest of the
+// code base (see crc32c.cc), the instruction set is chosen at compile time
+// (see PORTABLE in CMakeLists.txt), so a portable build uses the 8-byte word
+// kernel.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "port/lang.h"
+#include "port/port.h"
+#include "rocksdb/slice.h"
+#include "util/math.h"
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+ASSERT_FEATURE_COMPAT_HEADER();
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace detail {
+// XOR of the words of type T at a and b, which need not be aligned.
+template <typename T>
+inline T LoadWordXor(const char* a, const char* b) {
+  T wa;
+  T wb;
+  memcpy(&wa, a, sizeof(T));
+  memcpy(&wb, b, sizeof(T));
+  return wa ^ wb;
+}
+
+// Index of the lowest addressed non-zero byte of a word loaded from memory.
+// REQUIRES: diff != 0
+template <typename T>
+inline size_t FirstDifferentByte(T diff) {
+  if (port::kLittleEndian) {
+    return static_cast<size_t>(CountTrailingZeroBits(diff)) / 8;
+  } else {
+    return (sizeof(T) * 8 - 1 - static_cast<size_t>(FloorLog2(diff))) / 8;
+  }
+}
+
+// Compares the words of type T at a and b in memory (byte) order.
+template <typename T>
+inline int CompareWords(const char* a, const char* b) {
+  T wa;
+  T wb;
+  memcpy(&wa, a, sizeof(T));
+  memcpy(&wb, b, sizeof(T));
+  if (wa == wb) {
+    return 0;
+  }
+  if (port::kLittleEndian) {
+    wa = EndianSwapValue(wa);
+    wb = EndianSwapValue(wb);
+  }
+  return wa < wb ? -1 : +1;
+}
+}  // namespace detail
+
+// Returns the number of leading bytes that are equal in a[0, n) and b[0, n).
+inline size_t SharedPrefixLength(const char* a, const char* b, size_t n) {
+  using detail::FirstDifferentByte;
+  using detail::LoadWordXor;
+  size_t i = 0;
+#ifdef __AVX2__
+  for (; i + 32 <= n; i += 32) {
+    const __m256i va =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    const uint32_t ne =
+        ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+    if (ne != 0) {
+      return i + CountTrailingZeroBits(ne);
+    }
+  }
+#endif
+#ifdef __SSE4_2__
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const uint32_t ne =
+        ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))) &
+        0xffffU;
+    if (ne != 0) {
+      return i + CountTrailingZeroBits(ne);
+    }
+  }
+#endif
+  for (; i + 8 <= n; i += 8) {
+    const uint64_t diff = LoadWordXor<uint64_t>(a + i, b + i);
+    if (diff != 0) {
+      return i + FirstDifferentByte(diff);
+    }
+  }
+  if (i == n) {
+    return n;
+  }
+  // Less than 8 bytes left. Rather than looping over them, compare the last
+  // word (or two half words) again, overlapping bytes already known equal.
+  if (n >= 8) {
+    const uint64_t diff = LoadWordXor<uint64_t>(a + n - 8, b + n - 8);
+    return diff != 0 ? n - 8 + FirstDifferentByte(diff) : n;
+  }
+  if (n >= 4) {
+    uint32_t diff = LoadWordXor<uint32_t>(a, b);
+    if (diff != 0) {
+      return FirstDifferentByte(diff);
+    }
+    diff = LoadWordXor<uint32_t>(a + n - 4, b + n - 4);
+    return diff != 0 ? n - 4 + FirstDifferentByte(diff) : n;
+  }
+  for (; i < n; ++i) {
+    if (a[i] != b[i]) {
+      break;
+    }
+  }
+  return i;
+}
+
+// Same contract as memcmp(a, b, n): returns a negative, zero or positive
+// value if a[0, n) is respectively before, equal to or after b[0, n) in
+// unsigned byte order.
+//
+// Keys of up to 8 bytes (e.g. big-endian encoded integers) are compared as
+// one or two byte-swapped words. Longer ones are left to memcmp(), whose
+// vectorized implementations in the C library measured faster than the
+// kernels above once the compared length exceeds a word (see
+// microbench/key_compare_bench.cc).
+inline int CompareBytes(const char* a, const char* b, size_t n) {
+  using detail::CompareWords;
+  if (n >= 4 && n <= 8) {
+    int r;
+    if (n == 8) {
+      r = CompareWords<uint64_t>(a, b);
+    } else {
+      r = CompareWords<uint32_t>(a, b);
+      if (r == 0) {
+        r = CompareWords<uint32_t>(a + n - 4, b + n - 4);
+      }
+    }
+    return r;
+  }
+  return memcmp(a, b, n);
+}
+
+// Same result as a.compare(b), using the kernels above.
+inline int BytewiseCompare(const Slice& a, const Slice& b) {
+  const size_t min_len = (a.size() < b.size()) ? a.size() : b.size();
+  int r = CompareBytes(a.data(), b.data(), min_len);
+  if (r == 0) {
+    if (a.size() < b.size()) {
+      r = -1;
+    } else if (a.size() > b.size()) {
+      r = +1;
+    }
+  }
+  return r;
+}
+
+// Same result as a.difference_offset(b), using the kernels above.
+inline size_t SharedPrefixLength(const Slice& a, const Slice& b) {
+  const size_t min_len = (a.size() < b.size()) ? a.size() : b.size();
+  return SharedPrefixLength(a.data(), b.data(), min_len);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -14,6 +14,8 @@
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/cast_util.h"
+#include "util/key_compare.h"
+#include "util/random.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -244,6 +246,38 @@ TEST_F(SmallEnumSetTest, SmallEnumSetTest2) {
   }
 }
 
+// ***************************************************************** //
+// Unit test for key comparison kernels
+TEST(KeyCompareTest, MatchesMemcmp) {
+  Random rnd(301);
+  auto sign = [](int v) { return (v > 0) - (v < 0); };
+  // Cover every tail length of the 32/16/8 byte loops, a difference at every
+  // position, unsigned byte order and unaligned starts.
+  for (size_t len = 0; len <= 80; ++len) {
+    std::string a = rnd.RandomString(static_cast<int>(len + 3));
+    for (size_t pos = 0; pos <= len; ++pos) {
+      for (char delta : {'\x01', '\x80', '\xff'}) {
+        std::string b = a;
+        if (pos < len) {
+          b[pos + 3] = static_cast<char>(b[pos + 3] + delta);
+        }
+        const char* pa = a.data() + 3;
+        const char* pb = b.data() + 3;
+        ASSERT_EQ(pos, SharedPrefixLength(pa, pb, len));
+        ASSERT_EQ(sign(memcmp(pa, pb, len)), sign(CompareBytes(pa, pb, len)));
+        ASSERT_EQ(sign(memcmp(pb, pa, len)), sign(CompareBytes(pb, pa, len)));
+        for (size_t blen : {len / 2, len, len + 1}) {
+          Slice sa(pa, len);
+          Slice sb(pb, std::min(blen, len));
+          ASSERT_EQ(sign(sa.compare(sb)), sign(BytewiseCompare(sa, sb)));
+          ASSERT_EQ(sign(sb.compare(sa)), sign(BytewiseCompare(sb, sa)));
+          ASSERT_EQ(sa.difference_offset(sb), SharedPrefixLength(sa, sb));
+        }
+      }
+    }
+  }
+}
+
 // ***************************************************************** //
 // Unit test for Status
 TEST(StatusTest, Update) {
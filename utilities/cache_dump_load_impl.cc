@@ -5,12 +5,14 @@
 
 #include "utilities/cache_dump_load_impl.h"
 
+#include <atomic>
 #include <limits>
 
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_key.h"
 #include "file/writable_file_writer.h"
 #include "port/lang.h"
+#include "port/port.h"
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/utilities/ldb_cmd.h"
@@ -36,30 +38,36 @@ Status CacheDumperImpl::SetDumpFilter(std::vector<DB*> db_list) {
       return s;
     }
     for (auto id = ptc.begin(); id != ptc.end(); id++) {
-      OffsetableCacheKey base;
-      // We only want to save cache entries that are portable to another
-      // DB::Open, so only save entries with stable keys.
-      bool is_stable;
-      BlockBasedTable::SetupBaseCacheKey(id->second.get(),
-                                         /*cur_db_session_id*/ "",
-                                         /*cur_file_num*/ 0, &base, &is_stable);
-      if (is_stable) {
-        Slice prefix_slice = base.CommonPrefixSlice();
-        assert(prefix_slice.size() == OffsetableCacheKey::kCommonPrefixSize);
-        prefix_filter_.insert(prefix_slice.ToString());
-      }
+      AddDumpFilter(*id->second);
     }
   }
   return s;
 }
 
+void CacheDumperImpl::AddDumpFilter(const TableProperties& props) {
+  dump_all_keys_ = false;
+  OffsetableCacheKey base;
+  // We only want to save cache entries that are portable to another
+  // DB::Open, so only save entries with stable keys.
+  bool is_stable;
+  BlockBasedTable::SetupBaseCacheKey(&props, /*cur_db_session_id*/ "",
+                                     /*cur_file_num*/ 0, &base, &is_stable);
+  if (is_stable) {
+    Slice prefix_slice = base.CommonPrefixSlice();
+    assert(prefix_slice.size() == OffsetableCacheKey::kCommonPrefixSize);
+    prefix_filter_.insert(prefix_slice.ToString());
+  }
+}
+
 // This is the main function to dump out the cache block entries to the writer.
 // The writer may create a file or write to other systems. Currently, we will
 // iterate the whole block cache, get the blocks, and write them to the writer
 IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   // Prepare stage, check the parameters.
-  if (cache_ == nullptr) {
-    return IOStatus::InvalidArgument("Cache is null");
+  for (const auto& cache : caches_) {
+    if (cache == nullptr) {
+      return IOStatus::InvalidArgument("Cache is null");
+    }
   }
   if (writer_ == nullptr) {
     return IOStatus::InvalidArgument("CacheDumpWriter is null");
@@ -84,7 +92,9 @@ IOStatus CacheDumperImpl::DumpCacheEntriesToWriter() {
   // Then, we iterate the block cache and dump out the blocks that are not
   // filtered out.
   std::string buf;
-  cache_->ApplyToAllEntries(DumpOneBlockCallBack(buf), {});
+  for (const auto& cache : caches_) {
+    cache->ApplyToAllEntries(DumpOneBlockCallBack(buf), {});
+  }
 
   // Finally, write the footer
   io_s = WriteFooter();
@@ -304,6 +314,127 @@ IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToSecondaryCache() {
   }
 }
 
+// Like RestoreCacheEntriesToSecondaryCache(), but the blocks are created with
+// the create_cb of the block cache helper for their type, like blocks promoted
+// from a secondary cache, and inserted in the block cache of their table file.
+// The reading thread verifies the checksum of each dump unit and collects them
+// in batches, and the creation and insertion of the blocks of a batch, which
+// take most of the time, are shared by num_threads threads.
+IOStatus CacheDumpedLoaderImpl::RestoreCacheEntriesToBlockCache(
+    const BlockCacheRestoreTargets& targets, int num_threads,
+    uint64_t* num_restored) {
+  static constexpr size_t kRestoreBatchBytes = 16 << 20;
+  assert(num_restored != nullptr);
+  *num_restored = 0;
+  if (reader_ == nullptr) {
+    return IOStatus::InvalidArgument("CacheDumpReader is null");
+  }
+
+  IOStatus io_s;
+  DumpUnit dump_unit;
+  std::string data;
+  io_s = ReadHeader(&data, &dump_unit);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+
+  std::vector<std::string> batch;
+  size_t batch_bytes = 0;
+  std::atomic<uint64_t> restored{0};
+  auto restore_batch = [&]() {
+    std::atomic<size_t> next{0};
+    auto restore_fn = [&]() {
+      size_t i;
+      while ((i = next.fetch_add(1, std::memory_order_relaxed)) <
+             batch.size()) {
+        if (RestoreBlock(batch[i], targets)) {
+          restored.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    };
+    std::vector<port::Thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+      threads.emplace_back(restore_fn);
+    }
+    restore_fn();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    batch.clear();
+    batch_bytes = 0;
+  };
+
+  while (io_s.ok()) {
+    dump_unit.reset();
+    data.clear();
+    io_s = ReadCacheBlock(&data, &dump_unit);
+    if (!io_s.ok() || dump_unit.type == CacheDumpUnitType::kFooter) {
+      break;
+    }
+    if ((dump_unit.type != CacheDumpUnitType::kData &&
+         dump_unit.type != CacheDumpUnitType::kFilter) ||
+        dump_unit.key.size() < OffsetableCacheKey::kCommonPrefixSize ||
+        targets.find(std::string(dump_unit.key.data(),
+                                 OffsetableCacheKey::kCommonPrefixSize)) ==
+            targets.end()) {
+      continue;
+    }
+    batch_bytes += data.size();
+    batch.push_back(std::move(data));
+    if (batch_bytes >= kRestoreBatchBytes) {
+      restore_batch();
+    }
+  }
+  restore_batch();
+  *num_restored = restored.load(std::memory_order_relaxed);
+  if (dump_unit.type == CacheDumpUnitType::kFooter) {
+    return IOStatus::OK();
+  } else {
+    return io_s;
+  }
+}
+
+bool CacheDumpedLoaderImpl::RestoreBlock(
+    const std::string& data, const BlockCacheRestoreTargets& targets) {
+  DumpUnit dump_unit;
+  // Already decoded once by the reading thread
+  Status s = CacheDumperHelper::DecodeDumpUnit(data, &dump_unit);
+  assert(s.ok());
+  s.PermitUncheckedError();
+  auto it = targets.find(std::string(dump_unit.key.data(),
+                                     OffsetableCacheKey::kCommonPrefixSize));
+  assert(it != targets.end());
+  BlockCacheRestoreTarget& target = *it->second;
+  Cache* cache = target.cache.get();
+  if (cache->GetUsage() >= cache->GetCapacity()) {
+    return false;
+  }
+  Cache::Handle* handle = cache->Lookup(dump_unit.key);
+  if (handle != nullptr) {
+    cache->Release(handle);
+    return false;
+  }
+  const Cache::CacheItemHelper* helper = GetCacheItemHelper(
+      dump_unit.type == CacheDumpUnitType::kData ? BlockType::kData
+                                                 : BlockType::kFilter);
+  Cache::ObjectPtr obj = nullptr;
+  size_t charge = 0;
+  s = helper->create_cb(
+      Slice(static_cast<char*>(dump_unit.value), dump_unit.value_len),
+      kNoCompression, CacheTier::kVolatileTier, &target.create_context,
+      cache->memory_allocator(), &obj, &charge);
+  if (!s.ok() || obj == nullptr) {
+    return false;
+  }
+  s = cache->Insert(dump_unit.key, obj, helper, charge,
+                    /*handle*/ nullptr, Cache::Priority::LOW);
+  if (!s.ok()) {
+    helper->del_cb(obj, cache->memory_allocator());
+    return false;
+  }
+  return true;
+}
+
 // Read and copy the dump unit metadata to std::string data, decode and create
 // the unit metadata based on the string
 IOStatus CacheDumpedLoaderImpl::ReadDumpUnitMeta(std::string* data,
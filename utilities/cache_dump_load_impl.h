@@ -11,6 +11,7 @@
 #include "file/writable_file_writer.h"
 #include "rocksdb/utilities/cache_dump_load.h"
 #include "table/block_based/block.h"
+#include "table/block_based/block_cache.h"
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/parsed_full_filter_block.h"
@@ -19,8 +20,9 @@
 
 namespace ROCKSDB_NAMESPACE {
 
-// the read buffer size of for the default CacheDumpReader
-const unsigned int kDumpReaderBufferSize = 1024;  // 1KB
+// the read buffer size of for the default CacheDumpReader. Dump units are
+// served from the buffer, so that the file is read with large sequential reads.
+const unsigned int kDumpReaderBufferSize = 1024 * 1024;  // 1MB
 static const unsigned int kSizePrefixLen = 4;
 
 enum CacheDumpUnitType : unsigned char {
@@ -96,11 +98,24 @@ class CacheDumperImpl : public CacheDumper {
   CacheDumperImpl(const CacheDumpOptions& dump_options,
                   const std::shared_ptr<Cache>& cache,
                   std::unique_ptr<CacheDumpWriter>&& writer)
-      : options_(dump_options), cache_(cache), writer_(std::move(writer)) {
+      : CacheDumperImpl(dump_options,
+                        std::vector<std::shared_ptr<Cache>>{cache},
+                        std::move(writer)) {}
+  // Dumps the entries of several caches, e.g. the block caches of the column
+  // families of a DB
+  CacheDumperImpl(const CacheDumpOptions& dump_options,
+                  std::vector<std::shared_ptr<Cache>> caches,
+                  std::unique_ptr<CacheDumpWriter>&& writer)
+      : options_(dump_options),
+        caches_(std::move(caches)),
+        writer_(std::move(writer)) {
     dumped_size_bytes_ = 0;
   }
   ~CacheDumperImpl() { writer_.reset(); }
   Status SetDumpFilter(std::vector<DB*> db_list) override;
+  // Adds the blocks of one table file to the dump filter, if its cache keys
+  // are stable.
+  void AddDumpFilter(const TableProperties& props);
   IOStatus DumpCacheEntriesToWriter() override;
 
  private:
@@ -114,7 +129,7 @@ class CacheDumperImpl : public CacheDumper {
   DumpOneBlockCallBack(std::string& buf);
 
   CacheDumpOptions options_;
-  std::shared_ptr<Cache> cache_;
+  std::vector<std::shared_ptr<Cache>> caches_;
   std::unique_ptr<CacheDumpWriter> writer_;
   SystemClock* clock_;
   uint32_t sequence_num_;
@@ -130,6 +145,15 @@ class CacheDumperImpl : public CacheDumper {
   bool dump_all_keys_ = true;
 };
 
+// Where CacheDumpedLoaderImpl::RestoreCacheEntriesToBlockCache() inserts the
+// blocks of a table file, keyed by the common prefix of its cache keys
+struct BlockCacheRestoreTarget {
+  std::shared_ptr<Cache> cache;
+  BlockCreateContext create_context;
+};
+using BlockCacheRestoreTargets =
+    UnorderedMap<std::string, std::shared_ptr<BlockCacheRestoreTarget>>;
+
 // The default implementation of CacheDumpedLoader
 class CacheDumpedLoaderImpl : public CacheDumpedLoader {
  public:
@@ -143,7 +167,20 @@ class CacheDumpedLoaderImpl : public CacheDumpedLoader {
   ~CacheDumpedLoaderImpl() {}
   IOStatus RestoreCacheEntriesToSecondaryCache() override;
 
+  // Inserts the data and filter blocks of the table files in `targets` into
+  // their block caches, as long as the caches are not full. The dump is read
+  // sequentially, and the blocks are created and inserted by up to
+  // `num_threads` threads. Blocks of other table files (e.g. no longer live)
+  // are skipped.
+  IOStatus RestoreCacheEntriesToBlockCache(
+      const BlockCacheRestoreTargets& targets, int num_threads,
+      uint64_t* num_restored);
+
  private:
+  // Returns true if the block was inserted
+  bool RestoreBlock(const std::string& data,
+                    const BlockCacheRestoreTargets& targets);
+
   IOStatus ReadDumpUnitMeta(std::string* data, DumpUnitMeta* unit_meta);
   IOStatus ReadDumpUnit(size_t len, std::string* data, DumpUnit* unit);
   IOStatus ReadHeader(std::string* data, DumpUnit* dump_unit);
@@ -208,7 +245,7 @@ class ToFileCacheDumpWriter : public CacheDumpWriter {
 
 // The default implementation of CacheDumpReader. It is implemented based on
 // RandomAccessFileReader. Note that, we keep an internal variable to remember
-// the current offset.
+// the current offset. The file is read kDumpReaderBufferSize bytes at a time.
 class FromFileCacheDumpReader : public CacheDumpReader {
  public:
   explicit FromFileCacheDumpReader(
@@ -254,31 +291,28 @@ class FromFileCacheDumpReader : public CacheDumpReader {
   IOStatus Read(size_t len, std::string* data) {
     assert(file_reader_ != nullptr);
     IOStatus io_s;
-
-    unsigned int bytes_to_read = static_cast<unsigned int>(len);
-    unsigned int to_read = bytes_to_read > kDumpReaderBufferSize
-                               ? kDumpReaderBufferSize
-                               : bytes_to_read;
-
-    while (to_read > 0) {
-      io_s = file_reader_->Read(IOOptions(), offset_, to_read, &result_,
-                                buffer_, nullptr);
-      if (!io_s.ok()) {
-        return io_s;
+    data->reserve(data->size() + len);
+    while (len > 0) {
+      if (result_.empty()) {
+        io_s = file_reader_->Read(IOOptions(), offset_, kDumpReaderBufferSize,
+                                  &result_, buffer_, nullptr);
+        if (!io_s.ok()) {
+          return io_s;
+        }
+        if (result_.empty()) {
+          return IOStatus::Corruption("Corrupted cache dump file.");
+        }
+        offset_ += result_.size();
       }
-      if (result_.size() < to_read) {
-        return IOStatus::Corruption("Corrupted cache dump file.");
-      }
-      data->append(result_.data(), result_.size());
-
-      offset_ += to_read;
-      bytes_to_read -= to_read;
-      to_read = bytes_to_read > kDumpReaderBufferSize ? kDumpReaderBufferSize
-                                                      : bytes_to_read;
+      size_t to_copy = std::min(len, result_.size());
+      data->append(result_.data(), to_copy);
+      result_.remove_prefix(to_copy);
+      len -= to_copy;
     }
     return io_s;
   }
   std::unique_ptr<RandomAccessFileReader> file_reader_;
+  // The part of the last read not returned yet
   Slice result_;
   size_t offset_;
   char* buffer_;